@@ -0,0 +1,600 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#ifndef ICE_ARENA_H
+#define ICE_ARENA_H
+
+#include <IceUtil/Config.h>
+#include <Ice/Config.h>
+#include <Ice/InputStream.h>
+#include <Ice/OutputStream.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <limits>
+#include <utility>
+#include <new>
+#ifdef ICE_CPP11_COMPILER
+#   include <type_traits>
+#endif
+
+namespace Ice
+{
+
+/**
+ * A monotonic memory arena. Memory is allocated from large chunks by bumping a pointer, and
+ * individual allocations are never released: all the memory is released at once when the arena
+ * is destroyed. An arena is not thread-safe.
+ *
+ * Arenas are used to unmarshal the arena-aware types generated for the cpp:arena metadata: the
+ * generated dispatch code creates an arena for each request and unmarshals the in parameters into
+ * it, see InputStream::setArena.
+ * \headerfile Ice/Ice.h
+ */
+class ICE_API Arena : public IceUtil::noncopyable
+{
+public:
+
+    /**
+     * Constructs an arena. No memory is allocated until the first allocation.
+     * @param chunkSize The size of the first chunk, the size of the following chunks grows
+     * geometrically.
+     */
+    explicit Arena(size_t chunkSize = 4096);
+    ~Arena();
+
+    /**
+     * Allocates memory from the arena. The memory is suitably aligned for any Slice type.
+     * @param size The number of bytes to allocate.
+     * @return A pointer to the allocated memory.
+     */
+    void* allocate(size_t size)
+    {
+        size = (size + alignment - 1) & ~(alignment - 1);
+        if(size > static_cast<size_t>(_end - _next))
+        {
+            return allocateChunk(size);
+        }
+        void* p = _next;
+        _next += size;
+        return p;
+    }
+
+    /**
+     * Releases all the memory allocated from the arena. Objects allocated from the arena must
+     * no longer be used.
+     */
+    void release();
+
+    /**
+     * Obtains the number of bytes allocated by the arena for its chunks.
+     * @return The number of bytes.
+     */
+    size_t capacity() const
+    {
+        return _capacity;
+    }
+
+    /** The alignment of the memory returned by allocate. */
+    static const size_t alignment = sizeof(Long) > sizeof(void*) ? sizeof(Long) : sizeof(void*);
+
+private:
+
+    void* allocateChunk(size_t);
+
+    struct Chunk
+    {
+        Chunk* previous;
+    };
+
+    Chunk* _chunks;
+    Byte* _next;
+    Byte* _end;
+    size_t _chunkSize;
+    size_t _capacity;
+};
+
+}
+
+namespace IceInternal
+{
+
+/// \cond INTERNAL
+
+//
+// Allocates memory from the given arena, or from the heap if the arena is
+// null. The memory can be released with arenaDeallocate from any thread,
+// memory from an arena is only released with the arena.
+//
+ICE_API void* arenaAllocate(size_t, Ice::Arena*);
+ICE_API void arenaDeallocate(void*);
+
+ICE_API Ice::Arena* getThreadArena();
+ICE_API void setThreadArena(Ice::Arena*);
+
+//
+// Sets the arena of the calling thread for the lifetime of the scope. The
+// arena-aware stream helpers use it while unmarshaling, so the containers,
+// strings and nested elements allocated by the stream come from the arena of
+// the stream. Nested scopes for the same arena, such as the scopes of the
+// elements of a sequence, don't set the arena again.
+//
+class ArenaScope : public IceUtil::noncopyable
+{
+public:
+
+    ArenaScope(Ice::Arena* arena) :
+        _arena(arena), _previous(0)
+    {
+        if(_arena)
+        {
+            _previous = getThreadArena();
+            if(_previous == _arena)
+            {
+                _arena = 0;
+            }
+            else
+            {
+                setThreadArena(_arena);
+            }
+        }
+    }
+
+    ~ArenaScope()
+    {
+        if(_arena)
+        {
+            setThreadArena(_previous);
+        }
+    }
+
+private:
+
+    Ice::Arena* _arena;
+    Ice::Arena* _previous;
+};
+
+/// \endcond
+
+}
+
+namespace Ice
+{
+
+template<typename T> class ArenaAllocator;
+
+/// \cond INTERNAL
+
+//
+// Rebinds a value of an arena-aware type, and the arena-aware values it
+// contains, to the given arena or to the heap if the arena is null. The
+// helper is specialized for the arena-aware containers and strings below,
+// and for the structs that contain them by the generated code.
+//
+template<typename T>
+struct ArenaHelper
+{
+    static void bind(T&, Arena*)
+    {
+    }
+};
+
+template<typename T>
+inline void arenaBind(T& v, Arena* arena)
+{
+    ArenaHelper<T>::bind(v, arena);
+}
+
+/// \endcond
+
+/**
+ * The allocator of arena-aware types. An allocator is bound to the arena set for the calling thread
+ * when it is constructed: the allocators of the values unmarshaled by the stream are bound to the arena
+ * of the stream, and the other allocators to the heap. An allocator only allocates memory from its
+ * arena while the stream unmarshals into that arena, and from the heap otherwise. Allocators compare
+ * equal if they are bound to the same arena, and the memory allocated by an allocator can be released
+ * by any other, memory allocated from an arena being released with the arena.
+ *
+ * Copies of an unmarshaled value, and values moved or copy-assigned into a value or container
+ * allocated from the heap, are allocated from the heap and can be kept after the dispatch. As with the
+ * standard polymorphic allocators, a value move-constructed from an unmarshaled value and a value
+ * swapped with an unmarshaled value take its arena and must not outlive the dispatch.
+ * \headerfile Ice/Ice.h
+ */
+template<typename T>
+class ArenaAllocator
+{
+public:
+
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    /**
+     * Obtains the allocator type for another type.
+     * \headerfile Ice/Ice.h
+     */
+    template<typename U>
+    struct rebind
+    {
+        /** The allocator type. */
+        typedef ArenaAllocator<U> other;
+    };
+
+#ifdef ICE_CPP11_COMPILER
+    /** Assigning a container doesn't assign its allocator. */
+    typedef ::std::false_type propagate_on_container_copy_assignment;
+
+    /** Assigning a container doesn't assign its allocator. */
+    typedef ::std::false_type propagate_on_container_move_assignment;
+
+    /** Swapping containers swaps their allocators. */
+    typedef ::std::true_type propagate_on_container_swap;
+#endif
+
+    /**
+     * Constructs an allocator bound to the arena of the calling thread, or to the heap if no arena
+     * is set.
+     */
+    ArenaAllocator() :
+        _arena(IceInternal::getThreadArena())
+    {
+    }
+
+    /**
+     * Constructs an allocator bound to an arena.
+     * @param arena The arena, or null for the heap.
+     */
+    explicit ArenaAllocator(Arena* arena) :
+        _arena(arena)
+    {
+    }
+
+    /**
+     * Constructs an allocator from an allocator of another type.
+     * @param other The allocator, the new allocator is bound to the same arena.
+     */
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) :
+        _arena(other.arena())
+    {
+    }
+
+    /**
+     * Obtains the arena of this allocator.
+     * @return The arena, or null if the allocator is bound to the heap.
+     */
+    Arena* arena() const
+    {
+        return _arena;
+    }
+
+    /**
+     * Obtains the address of an object.
+     * @param r The object.
+     * @return The address of the object.
+     */
+    pointer address(reference r) const
+    {
+        return &r;
+    }
+
+    /**
+     * Obtains the address of an object.
+     * @param r The object.
+     * @return The address of the object.
+     */
+    const_pointer address(const_reference r) const
+    {
+        return &r;
+    }
+
+    /**
+     * Allocates memory for n objects.
+     * @param n The number of objects.
+     * @return The address of the allocated memory.
+     */
+    pointer allocate(size_type n, const void* = 0)
+    {
+        if(n > max_size())
+        {
+            throw std::bad_alloc();
+        }
+        //
+        // Outside of the unmarshaling, for example for the copies of a value,
+        // the memory comes from the heap.
+        //
+        Arena* arena = _arena && _arena == IceInternal::getThreadArena() ? _arena : 0;
+        return static_cast<pointer>(IceInternal::arenaAllocate(n * sizeof(T), arena));
+    }
+
+    /**
+     * Releases memory allocated by an arena allocator.
+     * @param p The address of the memory.
+     */
+    void deallocate(pointer p, size_type)
+    {
+        IceInternal::arenaDeallocate(p);
+    }
+
+    /**
+     * Obtains the maximum number of objects that can be allocated.
+     * @return The maximum number of objects.
+     */
+    size_type max_size() const
+    {
+        return (std::numeric_limits<size_type>::max() - Arena::alignment) / sizeof(T);
+    }
+
+#ifdef ICE_CPP11_COMPILER
+    /**
+     * Obtains the allocator of a copy of a container.
+     * @return An allocator bound to the arena of the calling thread.
+     */
+    ArenaAllocator select_on_container_copy_construction() const
+    {
+        return ArenaAllocator();
+    }
+
+    /**
+     * Constructs an object. The object is rebound to the heap if this allocator is bound to the
+     * heap, so the elements moved into a container allocated from the heap don't keep their arena.
+     * @param p The address of the object.
+     * @param args The constructor arguments.
+     */
+    template<typename U, typename... A>
+    void construct(U* p, A&&... args)
+    {
+        ::new(static_cast<void*>(p)) U(::std::forward<A>(args)...);
+        if(!_arena)
+        {
+            arenaBind(*p, 0);
+        }
+    }
+
+    /**
+     * Destroys an object.
+     * @param p The address of the object.
+     */
+    template<typename U>
+    void destroy(U* p)
+    {
+        p->~U();
+    }
+#else
+    /**
+     * Constructs an object.
+     * @param p The address of the object.
+     * @param v The value to copy.
+     */
+    void construct(pointer p, const T& v)
+    {
+        new(static_cast<void*>(p)) T(v);
+    }
+
+    /**
+     * Destroys an object.
+     * @param p The address of the object.
+     */
+    void destroy(pointer p)
+    {
+        p->~T();
+    }
+#endif
+
+private:
+
+    Arena* _arena;
+};
+
+/// \cond INTERNAL
+template<typename T, typename U>
+inline bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+{
+    return lhs.arena() == rhs.arena();
+}
+
+template<typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+{
+    return lhs.arena() != rhs.arena();
+}
+/// \endcond
+
+/**
+ * The mapping of a string for arena-aware types.
+ */
+typedef std::basic_string<char, std::char_traits<char>, ArenaAllocator<char> > ArenaString;
+
+/// \cond INTERNAL
+
+template<>
+struct ArenaHelper<ArenaString>
+{
+    static void bind(ArenaString& v, Arena* arena)
+    {
+        if(v.get_allocator().arena() != arena)
+        {
+#ifdef ICE_CPP11_COMPILER
+            ArenaString(::std::move(v), ArenaAllocator<char>(arena)).swap(v);
+#else
+            ArenaString(v.data(), v.size(), ArenaAllocator<char>(arena)).swap(v);
+#endif
+        }
+    }
+};
+
+template<typename T>
+struct ArenaHelper<std::vector<T, ArenaAllocator<T> > >
+{
+    typedef std::vector<T, ArenaAllocator<T> > Type;
+
+    static void bind(Type& v, Arena* arena)
+    {
+        //
+        // The elements are rebound by the allocator as they are moved.
+        //
+        if(v.get_allocator().arena() != arena)
+        {
+#ifdef ICE_CPP11_COMPILER
+            Type(::std::move(v), ArenaAllocator<T>(arena)).swap(v);
+#else
+            Type(v.begin(), v.end(), ArenaAllocator<T>(arena)).swap(v);
+#endif
+        }
+    }
+};
+
+template<typename K, typename V, typename C>
+struct ArenaHelper<std::map<K, V, C, ArenaAllocator<std::pair<const K, V> > > >
+{
+    typedef std::map<K, V, C, ArenaAllocator<std::pair<const K, V> > > Type;
+
+    static void bind(Type& v, Arena* arena)
+    {
+        if(v.get_allocator().arena() != arena)
+        {
+#ifdef ICE_CPP11_COMPILER
+            Type(::std::move(v), ArenaAllocator<std::pair<const K, V> >(arena)).swap(v);
+#else
+            Type(v.begin(), v.end(), v.key_comp(), ArenaAllocator<std::pair<const K, V> >(arena)).swap(v);
+#endif
+        }
+    }
+};
+
+//
+// The entries of a dictionary, the keys are const and are copied instead.
+//
+template<typename K, typename V>
+struct ArenaHelper<std::pair<const K, V> >
+{
+    static void bind(std::pair<const K, V>& v, Arena* arena)
+    {
+        arenaBind(v.second, arena);
+    }
+};
+
+/// \endcond
+
+/// \cond STREAM
+
+template<>
+struct StreamableTraits<ArenaString>
+{
+    static const StreamHelperCategory helper = StreamHelperCategoryBuiltin;
+    static const int minWireSize = 1;
+    static const bool fixedLength = false;
+};
+
+template<>
+struct StreamHelper<ArenaString, StreamHelperCategoryBuiltin>
+{
+    template<class S> static inline void
+    write(S* stream, const ArenaString& v)
+    {
+        stream->write(v.data(), v.size());
+    }
+
+    template<class S> static inline void
+    read(S* stream, ArenaString& v)
+    {
+        IceInternal::ArenaScope scope(stream->getArena());
+        const char* vdata = 0;
+        size_t vsize = 0;
+#ifdef ICE_CPP11_MAPPING
+        stream->read(vdata, vsize);
+#else
+        std::string holder;
+        stream->read(vdata, vsize, holder);
+#endif
+        if(v.get_allocator() != ArenaAllocator<char>())
+        {
+            ArenaString().swap(v);
+        }
+        if(vsize > 0)
+        {
+            v.assign(vdata, vsize);
+        }
+        else
+        {
+            v.clear();
+        }
+    }
+};
+
+template<>
+struct StreamWireSizeHelper<ArenaString, StreamHelperCategoryBuiltin>
+{
+    static inline size_t iceWireSize(const ArenaString& v)
+    {
+        return iceSizeWireSize(v.size()) + v.size();
+    }
+};
+
+template<typename T>
+struct StreamHelper<std::vector<T, ArenaAllocator<T> >, StreamHelperCategorySequence>
+{
+    typedef std::vector<T, ArenaAllocator<T> > Type;
+
+    template<class S> static inline void
+    write(S* stream, const Type& v)
+    {
+        StreamSequenceHelper<Type, StreamableTraits<T>::helper>::write(stream, v);
+    }
+
+    template<class S> static inline void
+    read(S* stream, Type& v)
+    {
+        IceInternal::ArenaScope scope(stream->getArena());
+        StreamSequenceHelper<Type, StreamableTraits<T>::helper>::read(stream, v);
+    }
+};
+
+template<typename K, typename V, typename C>
+struct StreamHelper<std::map<K, V, C, ArenaAllocator<std::pair<const K, V> > >, StreamHelperCategoryDictionary>
+{
+    typedef std::map<K, V, C, ArenaAllocator<std::pair<const K, V> > > Type;
+
+    template<class S> static inline void
+    write(S* stream, const Type& v)
+    {
+        stream->writeSize(static_cast<Int>(v.size()));
+        for(typename Type::const_iterator p = v.begin(); p != v.end(); ++p)
+        {
+            stream->write(p->first);
+            stream->write(p->second);
+        }
+    }
+
+    template<class S> static inline void
+    read(S* stream, Type& v)
+    {
+        IceInternal::ArenaScope scope(stream->getArena());
+        Int sz = stream->readSize();
+        Type().swap(v);
+
+        //
+        // Reuse the same key across the entries, the arena never reclaims
+        // the memory of a temporary.
+        //
+        K key;
+        while(sz--)
+        {
+            stream->read(key);
+            typename Type::iterator i = v.insert(v.end(), typename Type::value_type(key, V()));
+            stream->read(i->second);
+        }
+    }
+};
+
+/// \endcond
+
+}
+
+#endif
@@ -91,6 +91,17 @@ public:
             _size = n;
         }
 
+        //
+        // Ensures the container can grow to n bytes without being reallocated.
+        //
+        void ensureCapacity(size_type n)
+        {
+            if(n > _capacity)
+            {
+                reserve(n);
+            }
+        }
+
         void reset()
         {
             if(_size > 0 && _size * 2 < _capacity)
@@ -0,0 +1,177 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#ifndef ICE_DECODING_PROGRAM_H
+#define ICE_DECODING_PROGRAM_H
+
+#include <Ice/Config.h>
+#include <Ice/ProxyF.h>
+#include <Ice/InputStream.h>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace Ice
+{
+
+/**
+ * Receives the values decoded by a decoding program, see DecodingProgram::decode. The default
+ * implementation of each callback does nothing.
+ * \headerfile Ice/Ice.h
+ */
+class ICE_API DecodingVisitor
+{
+public:
+
+    virtual ~DecodingVisitor();
+
+    /** Called for a bool value. */
+    virtual void visitBool(bool);
+    /** Called for a byte value. */
+    virtual void visitByte(Byte);
+    /** Called for a short value. */
+    virtual void visitShort(Short);
+    /** Called for an int value. */
+    virtual void visitInt(Int);
+    /** Called for a long value. */
+    virtual void visitLong(Long);
+    /** Called for a float value. */
+    virtual void visitFloat(Float);
+    /** Called for a double value. */
+    virtual void visitDouble(Double);
+    /** Called for a string value. */
+    virtual void visitString(const std::string&);
+    /** Called for an enumerator, with the value of the enumerator. */
+    virtual void visitEnum(Int);
+    /** Called for a proxy, which is nil for a nil proxy. */
+    virtual void visitProxy(const ObjectPrxPtr&);
+
+    /** Called before the members of a structure. */
+    virtual void startStruct();
+    /** Called after the members of a structure. */
+    virtual void endStruct();
+
+    /** Called before the elements of a sequence, with the number of elements. */
+    virtual void startSequence(Int);
+    /** Called after the elements of a sequence. */
+    virtual void endSequence();
+
+    /** Called before the entries of a dictionary, with the number of entries. */
+    virtual void startDictionary(Int);
+    /** Called after the entries of a dictionary, each entry is visited as a key followed by a value. */
+    virtual void endDictionary();
+
+    /**
+     * Called for an optional field, before its value if it's present.
+     * @param tag The tag of the field.
+     * @param present True if the value is present, false otherwise.
+     */
+    virtual void visitOptional(Int tag, bool present);
+};
+
+/**
+ * A decoding program compiled from a type description. The program decodes, skips or extracts
+ * encoded values without generated code, for consumers such as Blobject servants and language
+ * bindings that only know the types of the values they receive at runtime.
+ *
+ * The type description is a comma-separated list of fields, each field being a type optionally
+ * preceded by a tag for an optional field, for example "int, seq<struct{string, long}>, ?1:string".
+ * The types are bool, byte, short, int, long, float, double, string, proxy, enum(max) where max
+ * is the largest enumerator value, seq<T>, dict<K, V> and struct{T, ...}. Optional fields must
+ * follow the required fields in increasing tag order. Classes and exceptions are not supported.
+ *
+ * The fields of the description are decoded from the current position of the stream, which must
+ * be within an encapsulation if the description has optional fields: the fields of a description
+ * obtained from the parameters of an operation are decoded from the parameter encapsulation of a
+ * request or a reply.
+ * \headerfile Ice/Ice.h
+ */
+class ICE_API DecodingProgram
+{
+public:
+
+    /**
+     * Compiles a type description.
+     * @param schema The type description.
+     * @throws IceUtil::IllegalArgumentException Raised if the description is invalid.
+     */
+    explicit DecodingProgram(const std::string& schema);
+
+    /**
+     * Obtains the number of fields of the type description.
+     * @return The number of fields.
+     */
+    size_t fieldCount() const
+    {
+        return _fields.size();
+    }
+
+    /**
+     * Decodes the fields.
+     * @param stream The stream to decode from.
+     * @param visitor The visitor that receives the decoded values.
+     */
+    void decode(InputStream* stream, DecodingVisitor& visitor) const;
+
+    /**
+     * Skips the fields.
+     * @param stream The stream to skip from.
+     */
+    void skip(InputStream* stream) const;
+
+    /**
+     * Extracts the encoded bytes of a field, the preceding fields are skipped. The stream is
+     * positioned after the field.
+     * @param stream The stream to extract from.
+     * @param field The index of the field.
+     * @return The start and the end of the encoded field, or an empty range for an optional field
+     * that is not present. The bytes of an optional field don't include its tag and its size.
+     */
+    std::pair<const Byte*, const Byte*> extract(InputStream* stream, size_t field) const;
+
+private:
+
+    enum OpCode
+    {
+        OpBool, OpByte, OpShort, OpInt, OpLong, OpFloat, OpDouble, OpString, OpEnum, OpProxy,
+        OpStartStruct, OpEndStruct, OpStartSequence, OpEndSequence, OpStartDictionary, OpEndDictionary,
+        OpOptional, OpSkipFixed, OpSkipSize, OpSkipString, OpSkipEnum, OpSkipProxy, OpSkipFixedSequence,
+        OpSkipFixedDictionary, OpSkipOptional
+    };
+
+    struct Instruction
+    {
+        OpCode op;
+        Int arg; // Size, enumerator maximum or tag.
+        Int format; // Optional format.
+        Int jump; // Index of the matching start or end instruction.
+    };
+    typedef std::vector<Instruction> Program;
+
+    struct Type;
+
+    void run(InputStream*, const Program&, size_t, size_t, DecodingVisitor*) const;
+    static Type* parseType(const std::string&, std::string::size_type&);
+    static void emitDecode(const Type*, Program&);
+    static void emitSkip(const Type*, Program&, Int&);
+    static void emit(Program&, OpCode, Int = 0, Int = 0, Int = 0);
+    static void flushSkip(Program&, Int&);
+
+    struct Field
+    {
+        size_t skip; // Index of the first skip instruction of the field.
+        Int tag; // -1 for a required field.
+        OptionalFormat format;
+        bool sizePrefix; // Whether an optional value is preceded by its size.
+    };
+
+    Program _decode;
+    Program _skip;
+    std::vector<Field> _fields;
+    size_t _depth; // Maximum nesting of sequences and dictionaries.
+};
+
+}
+
+#endif
@@ -51,6 +51,18 @@ private:
     const ::std::string _typeId;
 };
 
+template<class V>
+::Ice::ObjectPtr
+#ifdef NDEBUG
+defaultValueFactory(const std::string&)
+#else
+defaultValueFactory(const std::string& typeId)
+#endif
+{
+    assert(typeId == V::ice_staticId());
+    return new V;
+}
+
 #endif
 
 }
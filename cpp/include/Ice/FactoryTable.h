@@ -8,6 +8,7 @@
 #include <IceUtil/Mutex.h>
 #include <Ice/UserExceptionFactory.h>
 #include <Ice/ValueFactory.h>
+#include <vector>
 
 namespace Ice
 {
@@ -35,6 +36,35 @@ typedef IceUtil::Handle<CompactIdResolver> CompactIdResolverPtr;
 namespace IceInternal
 {
 
+#ifdef ICE_CPP11_MAPPING
+typedef ::std::shared_ptr< ::Ice::Value> (*ValueFactoryFunc)(const ::std::string&);
+#else
+typedef ::Ice::ObjectPtr (*ValueFactoryFunc)(const ::std::string&);
+#endif
+typedef void (*UserExceptionFactoryFunc)(const ::std::string&);
+
+//
+// An entry of the factory tables generated by slice2cpp, one table per
+// translation unit. The entries are sorted by type ID, and have either a
+// value factory or a user exception factory.
+//
+struct FactoryTableEntry
+{
+    const char* typeId;
+    ValueFactoryFunc valueFactory;
+    UserExceptionFactoryFunc exceptionFactory;
+};
+
+//
+// An entry of the compact ID tables generated by slice2cpp, sorted by
+// compact ID.
+//
+struct CompactIdTableEntry
+{
+    int compactId;
+    const char* typeId;
+};
+
 class ICE_API FactoryTable : private IceUtil::noncopyable
 {
 public:
@@ -51,8 +81,22 @@ public:
     std::string getTypeId(int) const;
     void removeTypeId(int);
 
+    //
+    // The generated tables are only registered when the program starts or
+    // a library is loaded, they are merged into the lookup indexes below on
+    // first use.
+    //
+    void addFactoryTable(const FactoryTableEntry*, const FactoryTableEntry*);
+    void removeFactoryTable(const FactoryTableEntry*, const FactoryTableEntry*);
+
+    void addCompactIdTable(const CompactIdTableEntry*, const CompactIdTableEntry*);
+    void removeCompactIdTable(const CompactIdTableEntry*, const CompactIdTableEntry*);
+
 private:
 
+    void mergeFactoryTables() const;
+    void mergeCompactIdTables() const;
+
     IceUtil::Mutex _m;
 
     typedef ::std::pair< ICE_DELEGATE(::Ice::UserExceptionFactory), int> EFPair;
@@ -66,6 +110,24 @@ private:
     typedef ::std::pair< ::std::string, int> TypeIdPair;
     typedef ::std::map<int, TypeIdPair> TypeIdTable;
     TypeIdTable _typeIdTable;
+
+    struct FactoryIndexEntry
+    {
+        const FactoryTableEntry* entry;
+        ICE_DELEGATE(::Ice::ValueFactory) valueFactory;
+        ICE_DELEGATE(::Ice::UserExceptionFactory) exceptionFactory;
+    };
+    typedef ::std::vector<FactoryIndexEntry> FactoryIndex;
+    mutable FactoryIndex _factoryIndex;
+
+    typedef ::std::vector< ::std::pair<const FactoryTableEntry*, const FactoryTableEntry*> > FactoryTableList;
+    mutable FactoryTableList _pendingFactoryTables;
+
+    typedef ::std::vector<const CompactIdTableEntry*> CompactIdIndex;
+    mutable CompactIdIndex _compactIdIndex;
+
+    typedef ::std::vector< ::std::pair<const CompactIdTableEntry*, const CompactIdTableEntry*> > CompactIdTableList;
+    mutable CompactIdTableList _pendingCompactIdTables;
 };
 
 }
@@ -35,6 +35,25 @@ private:
     const int _compactId;
 };
 
+//
+// Registers the factory and compact ID tables of a translation unit, the
+// tables must be sorted.
+//
+class ICE_API FactoryTableRegistration
+{
+public:
+
+    FactoryTableRegistration(const FactoryTableEntry*, size_t, const CompactIdTableEntry*, size_t);
+    ~FactoryTableRegistration();
+
+private:
+
+    const FactoryTableEntry* const _factories;
+    const FactoryTableEntry* const _factoriesEnd;
+    const CompactIdTableEntry* const _compactIds;
+    const CompactIdTableEntry* const _compactIdsEnd;
+};
+
 template<class E>
 class DefaultUserExceptionFactoryInit
 {
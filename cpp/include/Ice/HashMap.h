@@ -0,0 +1,351 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#ifndef ICE_HASH_MAP_H
+#define ICE_HASH_MAP_H
+
+#include <IceUtil/Config.h>
+#include <Ice/Config.h>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+namespace IceInternal
+{
+
+/// \cond INTERNAL
+
+//
+// Hash functions for the keys of the HashMap below.
+//
+struct HashMapIntHash
+{
+    size_t operator()(Ice::Int key) const
+    {
+        // Keys are usually consecutive indexes, which linear probing handles best unchanged.
+        return static_cast<size_t>(static_cast<unsigned int>(key));
+    }
+};
+
+struct HashMapStringHash
+{
+    size_t operator()(const std::string& key) const
+    {
+        // FNV-1a
+        unsigned int h = 2166136261U;
+        for(std::string::const_iterator p = key.begin(); p != key.end(); ++p)
+        {
+            h ^= static_cast<unsigned char>(*p);
+            h *= 16777619U;
+        }
+        return h;
+    }
+};
+
+struct HashMapPointerHash
+{
+    template<typename P> size_t operator()(const P& key) const
+    {
+        size_t h = reinterpret_cast<size_t>(key.get());
+        h ^= h >> 16;
+        h *= 0x45d9f3bU;
+        h ^= h >> 16;
+        return h;
+    }
+};
+
+//
+// A hash map with open addressing and linear probing. The entries are stored
+// in a single array instead of a node per entry, and clear() keeps the array
+// so the map can be reused without allocating. It provides the subset of the
+// std::map interface used by the streams to track class graphs; unlike
+// std::map, inserting an entry invalidates the iterators.
+//
+template<typename K, typename V, typename H>
+class HashMap
+{
+public:
+
+    typedef std::pair<K, V> value_type;
+
+private:
+
+    struct Entry
+    {
+        Entry() : used(false)
+        {
+        }
+
+        value_type value;
+        bool used;
+    };
+    typedef std::vector<Entry> EntryList;
+
+public:
+
+    template<typename E, typename T>
+    class Iterator
+    {
+    public:
+
+        Iterator() : _entry(0), _end(0)
+        {
+        }
+
+        Iterator(E* entry, E* end) : _entry(entry), _end(end)
+        {
+            skip();
+        }
+
+        template<typename E2, typename T2>
+        Iterator(const Iterator<E2, T2>& other) : _entry(other._entry), _end(other._end)
+        {
+        }
+
+        T& operator*() const
+        {
+            return _entry->value;
+        }
+
+        T* operator->() const
+        {
+            return &_entry->value;
+        }
+
+        Iterator& operator++()
+        {
+            ++_entry;
+            skip();
+            return *this;
+        }
+
+        bool operator==(const Iterator& rhs) const
+        {
+            return _entry == rhs._entry;
+        }
+
+        bool operator!=(const Iterator& rhs) const
+        {
+            return _entry != rhs._entry;
+        }
+
+    private:
+
+        template<typename, typename> friend class Iterator;
+        friend class HashMap;
+
+        void skip()
+        {
+            while(_entry != _end && !_entry->used)
+            {
+                ++_entry;
+            }
+        }
+
+        E* _entry;
+        E* _end;
+    };
+
+    typedef Iterator<Entry, value_type> iterator;
+    typedef Iterator<const Entry, const value_type> const_iterator;
+
+    HashMap() : _size(0)
+    {
+    }
+
+    size_t size() const
+    {
+        return _size;
+    }
+
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    iterator begin()
+    {
+        return _entries.empty() ? iterator() : iterator(&_entries[0], &_entries[0] + _entries.size());
+    }
+
+    iterator end()
+    {
+        return _entries.empty() ? iterator() : iterator(&_entries[0] + _entries.size(), &_entries[0] + _entries.size());
+    }
+
+    const_iterator begin() const
+    {
+        return _entries.empty() ? const_iterator() :
+            const_iterator(&_entries[0], &_entries[0] + _entries.size());
+    }
+
+    const_iterator end() const
+    {
+        return _entries.empty() ? const_iterator() :
+            const_iterator(&_entries[0] + _entries.size(), &_entries[0] + _entries.size());
+    }
+
+    iterator find(const K& key)
+    {
+        size_t i = lookup(key);
+        return i == _entries.size() ? end() : iterator(&_entries[0] + i, &_entries[0] + _entries.size());
+    }
+
+    const_iterator find(const K& key) const
+    {
+        size_t i = lookup(key);
+        return i == _entries.size() ? end() : const_iterator(&_entries[0] + i, &_entries[0] + _entries.size());
+    }
+
+    std::pair<iterator, bool> insert(const value_type& v)
+    {
+        reserve(_size + 1);
+        size_t mask = _entries.size() - 1;
+        size_t i = H()(v.first) & mask;
+        while(_entries[i].used)
+        {
+            if(_entries[i].value.first == v.first)
+            {
+                return std::make_pair(iterator(&_entries[0] + i, &_entries[0] + _entries.size()), false);
+            }
+            i = (i + 1) & mask;
+        }
+        _entries[i].value = v;
+        _entries[i].used = true;
+        ++_size;
+        return std::make_pair(iterator(&_entries[0] + i, &_entries[0] + _entries.size()), true);
+    }
+
+    template<typename I>
+    void insert(I first, I last)
+    {
+        for(; first != last; ++first)
+        {
+            insert(value_type(first->first, first->second));
+        }
+    }
+
+    V& operator[](const K& key)
+    {
+        return insert(value_type(key, V())).first->second;
+    }
+
+    void erase(iterator pos)
+    {
+        //
+        // Backward shift deletion: move up the entries of the probe sequence
+        // that follows the erased entry, so lookups don't need tombstones.
+        //
+        size_t mask = _entries.size() - 1;
+        size_t i = static_cast<size_t>(pos._entry - &_entries[0]);
+        size_t j = i;
+        while(true)
+        {
+            j = (j + 1) & mask;
+            if(!_entries[j].used)
+            {
+                break;
+            }
+            size_t k = H()(_entries[j].value.first) & mask;
+            if((j > i && (k <= i || k > j)) || (j < i && (k <= i && k > j)))
+            {
+                _entries[i].value.first = _entries[j].value.first;
+                std::swap(_entries[i].value.second, _entries[j].value.second);
+                i = j;
+            }
+        }
+        _entries[i].value = value_type();
+        _entries[i].used = false;
+        --_size;
+    }
+
+    void clear()
+    {
+        if(_size > 0)
+        {
+            for(typename EntryList::iterator p = _entries.begin(); p != _entries.end(); ++p)
+            {
+                if(p->used)
+                {
+                    p->value = value_type();
+                    p->used = false;
+                }
+            }
+            _size = 0;
+        }
+    }
+
+    void swap(HashMap& other)
+    {
+        _entries.swap(other._entries);
+        std::swap(_size, other._size);
+    }
+
+private:
+
+    size_t lookup(const K& key) const
+    {
+        if(_size == 0)
+        {
+            return _entries.size();
+        }
+
+        size_t mask = _entries.size() - 1;
+        size_t i = H()(key) & mask;
+        while(_entries[i].used)
+        {
+            if(_entries[i].value.first == key)
+            {
+                return i;
+            }
+            i = (i + 1) & mask;
+        }
+        return _entries.size();
+    }
+
+    void reserve(size_t size)
+    {
+        //
+        // Keep the load factor under 1/2 to keep the probe sequences short.
+        //
+        if(size * 2 <= _entries.size())
+        {
+            return;
+        }
+
+        size_t capacity = _entries.empty() ? 16 : _entries.size() * 2;
+        while(size * 2 > capacity)
+        {
+            capacity *= 2;
+        }
+
+        EntryList entries(capacity);
+        entries.swap(_entries);
+        size_t mask = capacity - 1;
+        for(typename EntryList::iterator p = entries.begin(); p != entries.end(); ++p)
+        {
+            if(p->used)
+            {
+                size_t i = H()(p->value.first) & mask;
+                while(_entries[i].used)
+                {
+                    i = (i + 1) & mask;
+                }
+                _entries[i].value.first = p->value.first;
+                std::swap(_entries[i].value.second, p->value.second);
+                _entries[i].used = true;
+            }
+        }
+    }
+
+    EntryList _entries;
+    size_t _size;
+};
+
+/// \endcond
+
+}
+
+#endif
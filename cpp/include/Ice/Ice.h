@@ -50,6 +50,8 @@
 #include <Ice/StringConverter.h>
 #include <Ice/IconvStringConverter.h>
 #include <Ice/UUID.h>
+#include <Ice/DecodingProgram.h>
+#include <Ice/PreparedRequest.h>
 #include <IceUtil/PopDisableWarnings.h>
 
 #endif
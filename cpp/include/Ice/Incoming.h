@@ -191,10 +191,27 @@ public:
         // encode the response parameters with the same encoding.
         //
         _current.encoding = _is->startEncapsulation();
+
+        //
+        // Clear the arena of a previous request of the same batch whose
+        // parameters failed to unmarshal.
+        //
+        _is->setArena(0);
+        return _is;
+    }
+    Ice::InputStream* startReadParams(Ice::Arena& arena)
+    {
+        //
+        // Unmarshal the arena-aware parameters into the arena of the
+        // generated dispatch code, it outlives the parameters.
+        //
+        startReadParams();
+        _is->setArena(&arena);
         return _is;
     }
     void endReadParams() const
     {
+        _is->setArena(0);
         _is->endEncapsulation();
     }
     void readEmptyParams()
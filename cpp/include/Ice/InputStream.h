@@ -18,11 +18,13 @@
 #include <Ice/UserExceptionFactory.h>
 #include <Ice/StreamHelpers.h>
 #include <Ice/FactoryTable.h>
+#include <Ice/HashMap.h>
 
 namespace Ice
 {
 
 class UserException;
+class Arena;
 
 /// \cond INTERNAL
 template<typename T> inline void
@@ -271,6 +273,19 @@ public:
      */
     void setSliceValues(bool b);
 
+    /**
+     * Indicates whether to keep the original encoding of preserved slices. In pass-through mode,
+     * the slices of unknown types are preserved as a single run of encoded bytes when none of
+     * the slices refers to class instances or to type IDs encoded earlier in the encapsulation;
+     * the run is written back verbatim when the value or exception is forwarded with the sliced
+     * format, instead of being re-marshaled slice by slice. The bytes of the individual slices
+     * are not kept in this case. If the stream is initialized with a communicator, this setting
+     * defaults to the value of the Ice.PassThroughSlices property, otherwise the setting defaults
+     * to false.
+     * @param b True to enable pass-through mode, false otherwise.
+     */
+    void setPassThroughSlices(bool b);
+
     /**
      * Indicates whether to log messages when instances of Slice classes are sliced. If the stream
      * is initialized with a communicator, this setting defaults to the value of the Ice.Trace.Slicing
@@ -299,6 +314,27 @@ public:
      */
     void* setClosure(void* p);
 
+    /**
+     * Sets the arena used to unmarshal arena-aware types, the types generated for the cpp:arena
+     * metadata. The memory of the containers and strings of these types is allocated from the
+     * arena instead of the heap, so the arena must outlive the unmarshaled values. Other types
+     * are not affected.
+     * @param arena The arena, or nil to allocate from the heap.
+     */
+    void setArena(Arena* arena)
+    {
+        _arena = arena;
+    }
+
+    /**
+     * Obtains the arena used to unmarshal arena-aware types.
+     * @return The arena, or nil if none is set.
+     */
+    Arena* getArena() const
+    {
+        return _arena;
+    }
+
     /**
      * Swaps the contents of one stream with another.
      *
@@ -1263,7 +1299,7 @@ private:
         EncapsDecoder(InputStream* stream, Encaps* encaps, bool sliceValues, size_t classGraphDepthMax,
                       const Ice::ValueFactoryManagerPtr& f) :
             _stream(stream), _encaps(encaps), _sliceValues(sliceValues), _classGraphDepthMax(classGraphDepthMax),
-            _classGraphDepth(0), _valueFactoryManager(f), _typeIdIndex(0)
+            _classGraphDepth(0), _valueFactoryManager(f)
         {
         }
 
@@ -1273,8 +1309,8 @@ private:
         void addPatchEntry(Int, PatchFunc, void*);
         void unmarshal(Int, const ValuePtr&);
 
-        typedef std::map<Int, ValuePtr> IndexToPtrMap;
-        typedef std::map<Int, std::string> TypeIdMap;
+        typedef IceInternal::HashMap<Int, ValuePtr, IceInternal::HashMapIntHash> IndexToPtrMap;
+        typedef std::vector<std::string> TypeIdList;
 
         struct PatchEntry
         {
@@ -1283,7 +1319,7 @@ private:
             size_t classGraphDepth;
         };
         typedef std::vector<PatchEntry> PatchList;
-        typedef std::map<Int, PatchList> PatchMap;
+        typedef IceInternal::HashMap<Int, PatchList, IceInternal::HashMapIntHash> PatchMap;
 
         InputStream* _stream;
         Encaps* _encaps;
@@ -1299,8 +1335,7 @@ private:
 
         // Encapsulation attributes for object un-marshalling
         IndexToPtrMap _unmarshaledMap;
-        TypeIdMap _typeIdMap;
-        Int _typeIdIndex;
+        TypeIdList _typeIds; // Type IDs by index - 1
         ValueList _valueList;
     };
 
@@ -1344,9 +1379,9 @@ private:
     public:
 
         EncapsDecoder11(InputStream* stream, Encaps* encaps, bool sliceValues, size_t classGraphDepthMax,
-                        const Ice::ValueFactoryManagerPtr& f) :
+                        const Ice::ValueFactoryManagerPtr& f, bool passThroughSlices = false) :
             EncapsDecoder(stream, encaps, sliceValues, classGraphDepthMax, f),
-            _preAllocatedInstanceData(0), _current(0), _valueIdIndex(1)
+            _preAllocatedInstanceData(0), _current(0), _valueIdIndex(1), _passThroughSlices(passThroughSlices)
         {
         }
 
@@ -1401,9 +1436,17 @@ private:
             SliceInfoSeq slices; // Preserved slices.
             IndexListList indirectionTables;
 
+            // Pass-through attributes, the bytes of the preserved slices are
+            // only copied by readSlicedData.
+            bool passThrough;
+            Container::iterator passThroughStart;
+            Container::iterator passThroughEnd;
+            std::vector<std::pair<Container::iterator, Container::iterator> > sliceBytes;
+
             // Slice attributes
             Byte sliceFlags;
             Int sliceSize;
+            Container::iterator sliceStart;
             std::string typeId;
             int compactId;
             IndirectPatchList indirectPatchList;
@@ -1426,9 +1469,12 @@ private:
             }
             _current->sliceType = sliceType;
             _current->skipFirstSlice = false;
+            _current->passThrough = _passThroughSlices;
+            _current->sliceBytes.clear();
         }
 
         Int _valueIdIndex; // The ID of the next value to unmarshal.
+        const bool _passThroughSlices;
     };
 
     class Encaps : private ::IceUtil::noncopyable
@@ -1490,8 +1536,12 @@ private:
 
     void* _closure;
 
+    Arena* _arena;
+
     bool _sliceValues;
 
+    bool _passThroughSlices;
+
     int _startSeq;
     int _minSeqSize;
 
@@ -0,0 +1,460 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#ifndef ICE_LAZY_VIEW_H
+#define ICE_LAZY_VIEW_H
+
+#include <IceUtil/Shared.h>
+#include <IceUtil/Handle.h>
+#include <Ice/InputStream.h>
+#include <Ice/OutputStream.h>
+#include <iterator>
+
+namespace IceInternal
+{
+
+/// \cond INTERNAL
+
+//
+// Reads and skips the elements of a lazy view. The generic version skips an
+// element by reading it; strings, sequences and dictionaries are skipped
+// without being decoded.
+//
+template<typename T>
+struct LazyViewElement
+{
+    typedef T Type;
+
+    static const int minWireSize = Ice::StreamableTraits<T>::minWireSize;
+    static const bool fixedLength = Ice::StreamableTraits<T>::fixedLength;
+
+    static void read(Ice::InputStream* stream, Type& v)
+    {
+        stream->read(v);
+    }
+
+    static void skip(Ice::InputStream* stream)
+    {
+        Type v;
+        stream->read(v);
+    }
+};
+
+template<typename T>
+void skipLazyViewElements(Ice::InputStream* stream, Ice::Int size)
+{
+    if(LazyViewElement<T>::fixedLength)
+    {
+        stream->skip(static_cast<size_t>(size) * static_cast<size_t>(LazyViewElement<T>::minWireSize));
+    }
+    else
+    {
+        for(Ice::Int i = 0; i < size; ++i)
+        {
+            LazyViewElement<T>::skip(stream);
+        }
+    }
+}
+
+template<>
+struct LazyViewElement<std::string>
+{
+    typedef std::string Type;
+
+    static const int minWireSize = 1;
+    static const bool fixedLength = false;
+
+    static void read(Ice::InputStream* stream, Type& v)
+    {
+        stream->read(v);
+    }
+
+    static void skip(Ice::InputStream* stream)
+    {
+        stream->skip(static_cast<size_t>(stream->readSize()));
+    }
+};
+
+template<typename T>
+struct LazyViewElement<std::vector<T> >
+{
+    typedef std::vector<T> Type;
+
+    static const int minWireSize = 1;
+    static const bool fixedLength = false;
+
+    static void read(Ice::InputStream* stream, Type& v)
+    {
+        stream->read(v);
+    }
+
+    static void skip(Ice::InputStream* stream)
+    {
+        skipLazyViewElements<T>(stream, stream->readAndCheckSeqSize(LazyViewElement<T>::minWireSize));
+    }
+};
+
+template<typename K, typename V>
+struct LazyViewElement<std::pair<const K, V> >
+{
+    typedef std::pair<K, V> Type;
+
+    static const int minWireSize = LazyViewElement<K>::minWireSize + LazyViewElement<V>::minWireSize;
+    static const bool fixedLength = LazyViewElement<K>::fixedLength && LazyViewElement<V>::fixedLength;
+
+    static void read(Ice::InputStream* stream, Type& v)
+    {
+        stream->read(v.first);
+        stream->read(v.second);
+    }
+
+    static void skip(Ice::InputStream* stream)
+    {
+        LazyViewElement<K>::skip(stream);
+        LazyViewElement<V>::skip(stream);
+    }
+};
+
+template<typename K, typename V, typename C, typename A>
+struct LazyViewElement<std::map<K, V, C, A> >
+{
+    typedef std::map<K, V, C, A> Type;
+
+    static const int minWireSize = 1;
+    static const bool fixedLength = false;
+
+    static void read(Ice::InputStream* stream, Type& v)
+    {
+        stream->read(v);
+    }
+
+    static void skip(Ice::InputStream* stream)
+    {
+        typedef typename Type::value_type Element;
+        skipLazyViewElements<Element>(stream, stream->readAndCheckSeqSize(LazyViewElement<Element>::minWireSize));
+    }
+};
+
+/// \endcond
+
+}
+
+namespace Ice
+{
+
+/**
+ * A view of a sequence or dictionary parameter that is decoded on demand, for parameters with the
+ * cpp:lazy metadata. When unmarshaled, the view only records the position of the parameter in the
+ * request or reply; elements are decoded one at a time while iterating over the view. Like the views
+ * created for cpp:array and cpp:view-type parameters, it refers to the stream buffer, so it can only
+ * be used for the duration of the call or callback that receives it. Iterating over the same view
+ * from several threads requires external synchronization.
+ *
+ * A view can also be created from a container, for example to pass a parameter to a proxy. A view
+ * that is passed to a proxy, such as when forwarding a request, is marshaled by copying its encoded
+ * bytes, without decoding it, if the encodings match.
+ * \headerfile Ice/Ice.h
+ */
+template<typename T>
+class LazyView
+{
+    typedef IceInternal::LazyViewElement<typename T::value_type> Element;
+
+    struct State : public IceUtil::Shared
+    {
+        State(IceInternal::Instance* instance, const EncodingVersion& encoding, const Byte* begin, const Byte* end) :
+            buffer(begin, end),
+            stream(instance, encoding, buffer)
+        {
+        }
+
+        IceInternal::Buffer buffer;
+        InputStream stream;
+    };
+    typedef IceUtil::Handle<State> StatePtr;
+
+public:
+
+    /** The container type of the view. */
+    typedef T container_type;
+
+    /** The type of the decoded elements, a pair for dictionaries. */
+    typedef typename Element::Type value_type;
+
+    /**
+     * Iterates over the elements of a view, decoding each element when it is dereferenced.
+     * \headerfile Ice/Ice.h
+     */
+    class const_iterator
+    {
+    public:
+
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename LazyView::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const value_type* pointer;
+        typedef const value_type& reference;
+
+        const_iterator() :
+            _container(0), _index(0), _pos(0), _next(0), _decoded(false)
+        {
+        }
+
+        reference operator*() const
+        {
+            if(!_decoded)
+            {
+                if(_state)
+                {
+                    _state->stream.i = _state->buffer.b.begin() + _pos;
+                    Element::read(&_state->stream, _value);
+                    _next = static_cast<size_t>(_state->stream.i - _state->buffer.b.begin());
+                }
+                else
+                {
+                    _value = *_iter;
+                }
+                _decoded = true;
+            }
+            return _value;
+        }
+
+        pointer operator->() const
+        {
+            return &operator*();
+        }
+
+        const_iterator& operator++()
+        {
+            if(_state)
+            {
+                if(_decoded)
+                {
+                    _pos = _next;
+                }
+                else if(Element::fixedLength)
+                {
+                    _pos += static_cast<size_t>(Element::minWireSize);
+                }
+                else
+                {
+                    _state->stream.i = _state->buffer.b.begin() + _pos;
+                    Element::skip(&_state->stream);
+                    _pos = static_cast<size_t>(_state->stream.i - _state->buffer.b.begin());
+                }
+            }
+            else
+            {
+                ++_iter;
+            }
+            ++_index;
+            _decoded = false;
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            const_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const const_iterator& rhs) const
+        {
+            return _index == rhs._index;
+        }
+
+        bool operator!=(const const_iterator& rhs) const
+        {
+            return _index != rhs._index;
+        }
+
+    private:
+
+        friend class LazyView;
+
+        StatePtr _state;
+        const T* _container;
+        typename T::const_iterator _iter;
+        size_t _index;
+        size_t _pos;
+        mutable size_t _next;
+        mutable value_type _value;
+        mutable bool _decoded;
+    };
+
+    /**
+     * Constructs an empty view.
+     */
+    LazyView() :
+        _container(0), _size(0), _first(0)
+    {
+    }
+
+    /**
+     * Constructs a view of a container. The container must remain valid while the view is used.
+     * @param container The container.
+     */
+    LazyView(const T& container) :
+        _container(&container), _size(container.size()), _first(0)
+    {
+    }
+
+    /**
+     * Obtains the number of elements.
+     * @return The number of elements.
+     */
+    size_t size() const
+    {
+        return _size;
+    }
+
+    /**
+     * Determines whether the view is empty.
+     * @return True if the view has no elements, false otherwise.
+     */
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    /**
+     * Obtains an iterator to the first element.
+     * @return The iterator.
+     */
+    const_iterator begin() const
+    {
+        const_iterator p;
+        p._state = _state;
+        p._pos = _first;
+        if(_container)
+        {
+            p._container = _container;
+            p._iter = _container->begin();
+        }
+        return p;
+    }
+
+    /**
+     * Obtains an iterator past the last element.
+     * @return The iterator.
+     */
+    const_iterator end() const
+    {
+        const_iterator p;
+        p._index = _size;
+        return p;
+    }
+
+    /**
+     * Decodes all the elements into a container.
+     * @param v The container.
+     */
+    void decode(T& v) const
+    {
+        if(_state)
+        {
+            _state->stream.i = _state->buffer.b.begin();
+            _state->stream.read(v);
+        }
+        else if(_container)
+        {
+            v = *_container;
+        }
+        else
+        {
+            v = T();
+        }
+    }
+
+    /**
+     * Decodes all the elements into a container.
+     * @return The container.
+     */
+    T decode() const
+    {
+        T v;
+        decode(v);
+        return v;
+    }
+
+    /// \cond INTERNAL
+    void iceRead(InputStream* stream)
+    {
+        const Byte* begin = stream->i;
+        Int sz = stream->readAndCheckSeqSize(Element::minWireSize);
+        size_t first = static_cast<size_t>(stream->i - begin);
+        IceInternal::skipLazyViewElements<typename T::value_type>(stream, sz);
+
+        _state = new State(stream->instance(), stream->getEncoding(), begin, stream->i);
+        _container = 0;
+        _size = static_cast<size_t>(sz);
+        _first = first;
+    }
+
+    void iceWrite(OutputStream* stream) const
+    {
+        if(_state && _state->stream.getEncoding() == stream->getEncoding())
+        {
+            //
+            // Copy the encoded elements, the encoding of a sequence or
+            // dictionary of the same encoding version doesn't depend on
+            // the stream.
+            //
+            stream->writeBlob(_state->buffer.b.begin(), _state->buffer.b.size());
+        }
+        else if(_state)
+        {
+            stream->write(decode());
+        }
+        else if(_container)
+        {
+            stream->write(*_container);
+        }
+        else
+        {
+            stream->writeSize(0);
+        }
+    }
+    /// \endcond
+
+private:
+
+    StatePtr _state;
+    const T* _container;
+    size_t _size;
+    size_t _first;
+};
+
+/// \cond STREAM
+
+template<typename T>
+struct StreamableTraits< LazyView<T> >
+{
+    static const StreamHelperCategory helper = StreamHelperCategoryLazyView;
+    static const int minWireSize = 1;
+    static const bool fixedLength = false;
+};
+
+template<typename T>
+struct StreamHelper< LazyView<T>, StreamHelperCategoryLazyView>
+{
+    template<class S> static inline void
+    write(S* stream, const LazyView<T>& v)
+    {
+        v.iceWrite(stream);
+    }
+
+    template<class S> static inline void
+    read(S* stream, LazyView<T>& v)
+    {
+        v.iceRead(stream);
+    }
+};
+
+/// \endcond
+
+}
+
+#endif
@@ -18,6 +18,7 @@
 #include <Ice/ObserverHelper.h>
 #include <Ice/LocalException.h>
 #include <Ice/UniquePtr.h>
+#include <Ice/PreparedRequest.h>
 
 #ifndef ICE_CPP11_MAPPING
 #    include <Ice/AsyncResult.h>
@@ -108,13 +109,13 @@ public:
 
     void attachRemoteObserver(const Ice::ConnectionInfoPtr& c, const Ice::EndpointPtr& endpt, Ice::Int requestId)
     {
-        const Ice::Int size = static_cast<Ice::Int>(_os.b.size() - headerSize - 4);
+        const Ice::Int size = static_cast<Ice::Int>(_os.b.size() + getBodySize() - headerSize - 4);
         _childObserver.attach(getObserver().getRemoteObserver(c, endpt, requestId, size));
     }
 
     void attachCollocatedObserver(const Ice::ObjectAdapterPtr& adapter, Ice::Int requestId)
     {
-        const Ice::Int size = static_cast<Ice::Int>(_os.b.size() - headerSize - 4);
+        const Ice::Int size = static_cast<Ice::Int>(_os.b.size() + getBodySize() - headerSize - 4);
         _childObserver.attach(getObserver().getCollocatedObserver(adapter, requestId, size));
     }
 
@@ -123,6 +124,24 @@ public:
         return &_os;
     }
 
+    //
+    // The prepared request whose in-parameters are sent after the message
+    // in the output stream, or null if the message is entirely in the
+    // output stream.
+    //
+    const Ice::PreparedRequestPtr& getBody() const
+    {
+        return _body;
+    }
+
+    size_t getBodySize() const
+    {
+        return _body ? static_cast<size_t>(_body->_getParams().second - _body->_getParams().first) : 0;
+    }
+
+    // Copies the in-parameters of the prepared request, if any, at the end of the message.
+    void writeBody();
+
     Ice::InputStream* getIs()
     {
         return &_is;
@@ -173,6 +192,7 @@ protected:
     ObserverHelperT<Ice::Instrumentation::ChildInvocationObserver> _childObserver;
 
     Ice::OutputStream _os;
+    Ice::PreparedRequestPtr _body;
     Ice::InputStream _is;
 
     CancellationHandlerPtr _cancellationHandler;
@@ -227,6 +247,7 @@ protected:
     bool responseImpl(bool, bool);
 
     virtual void runTimerTask();
+    virtual void waitForSendWindow(const Ice::ConnectionIPtr&);
 
     const Ice::ObjectPrxPtr _proxy;
     RequestHandlerPtr _handler;
@@ -248,6 +269,7 @@ public:
     OutgoingAsync(const Ice::ObjectPrxPtr&, bool);
 
     void prepare(const std::string&, Ice::OperationMode, const Ice::Context&);
+    void prepare(const Ice::PreparedRequestPtr&);
 
     virtual bool sent();
     virtual bool response();
@@ -290,6 +312,10 @@ public:
 
 protected:
 
+    virtual void waitForSendWindow(const Ice::ConnectionIPtr&);
+
+    void prepareHeader(const std::string&, Ice::OperationMode, const Ice::Context&);
+
     const Ice::EncodingVersion _encoding;
 
 #ifdef ICE_CPP11_MAPPING
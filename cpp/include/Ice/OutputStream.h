@@ -14,6 +14,7 @@
 #include <Ice/Protocol.h>
 #include <Ice/SlicedDataF.h>
 #include <Ice/StreamHelpers.h>
+#include <Ice/HashMap.h>
 
 namespace Ice
 {
@@ -140,6 +141,17 @@ public:
         b.resize(sz);
     }
 
+    /**
+     * Reserves space in the stream buffer, the following writes of up to sz bytes don't
+     * reallocate the buffer.
+     *
+     * @param sz The number of bytes to reserve past the current end of the stream.
+     */
+    void reserve(Container::size_type sz)
+    {
+        b.ensureCapacity(b.size() + sz);
+    }
+
     /**
      * Marks the start of a class instance.
      * @param data Contains the marshaled form of unknown slices from this instance. If not nil,
@@ -925,12 +937,13 @@ private:
         }
 
         Int registerTypeId(const std::string&);
+        void registerWrittenTypeId(const std::string&);
 
         OutputStream* _stream;
         Encaps* _encaps;
 
-        typedef std::map<ValuePtr, Int> PtrToIndexMap;
-        typedef std::map<std::string, Int> TypeIdMap;
+        typedef IceInternal::HashMap<ValuePtr, Int, IceInternal::HashMapPointerHash> PtrToIndexMap;
+        typedef IceInternal::HashMap<std::string, Int, IceInternal::HashMapStringHash> TypeIdMap;
 
         // Encapsulation attributes for value marshaling.
         PtrToIndexMap _marshaledMap;
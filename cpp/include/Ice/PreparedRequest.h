@@ -0,0 +1,170 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#ifndef ICE_PREPARED_REQUEST_H
+#define ICE_PREPARED_REQUEST_H
+
+#include <IceUtil/Shared.h>
+#include <IceUtil/Handle.h>
+#include <Ice/Config.h>
+#include <Ice/CommunicatorF.h>
+#include <Ice/InstanceF.h>
+#include <Ice/Current.h>
+#include <vector>
+#include <utility>
+
+namespace Ice
+{
+
+class OutputStream;
+
+/**
+ * A request marshaled once to be sent to many proxies. The operation name, the operation mode
+ * and the context are marshaled when the prepared request is created. Each invocation of
+ * ice_invoke with a prepared request marshals the request header for the target proxy, its
+ * identity and facet, and copies the marshaled operation name, mode and context into the message.
+ * The in-parameter encapsulation is shared by the messages: over a TCP connection, it is written
+ * from the prepared request after the rest of the message. It is copied into the message when the
+ * message is compressed, traced, batched, sent over a datagram or collocated connection, or when
+ * it is small. To send the request over specific connections, use proxies created with
+ * Connection::createProxy or fixed with ice_fixed.
+ *
+ * The context of a prepared request is sent in place of the proxy context and of the implicit
+ * context. A prepared request is immutable and can be used by several threads; it can only be
+ * sent with the proxies of the communicator that created it.
+ * \headerfile Ice/Ice.h
+ */
+class ICE_API PreparedRequest
+#ifndef ICE_CPP11_MAPPING
+    : public IceUtil::Shared
+#endif
+{
+public:
+
+    /**
+     * Marshals a request.
+     * @param communicator The communicator of the proxies the request is sent with.
+     * @param operation The name of the operation to invoke.
+     * @param mode The operation mode (normal or idempotent).
+     * @param inParams An encapsulation containing the encoded in-parameters for the operation.
+     * @param context The context map sent with the request.
+     */
+    PreparedRequest(const CommunicatorPtr& communicator,
+                    const std::string& operation,
+                    OperationMode mode,
+                    const std::vector<Byte>& inParams,
+                    const Context& context = Context());
+
+    /**
+     * Marshals a request.
+     * @param communicator The communicator of the proxies the request is sent with.
+     * @param operation The name of the operation to invoke.
+     * @param mode The operation mode (normal or idempotent).
+     * @param inParams An encapsulation containing the encoded in-parameters for the operation.
+     * @param context The context map sent with the request.
+     */
+    PreparedRequest(const CommunicatorPtr& communicator,
+                    const std::string& operation,
+                    OperationMode mode,
+                    const std::pair<const Byte*, const Byte*>& inParams,
+                    const Context& context = Context());
+
+#ifdef ICE_CPP11_MAPPING
+    virtual ~PreparedRequest();
+#endif
+
+    /**
+     * Obtains the name of the operation.
+     * @return The operation name.
+     */
+    const std::string& getOperation() const
+    {
+        return _operation;
+    }
+
+    /**
+     * Obtains the operation mode.
+     * @return The operation mode.
+     */
+    OperationMode getMode() const
+    {
+        return _mode;
+    }
+
+    /**
+     * Obtains the context sent with the request.
+     * @return The context map.
+     */
+    const Context& getContext() const
+    {
+        return _context;
+    }
+
+    /**
+     * Obtains the size of the marshaled request body, that is the size of the request without
+     * its header.
+     * @return The size in bytes.
+     */
+    size_t size() const
+    {
+        return _body.size() + static_cast<size_t>(_params.second - _params.first);
+    }
+
+    /// \cond INTERNAL
+    void _write(OutputStream*, const EncodingVersion&) const;
+
+    const std::pair<const Byte*, const Byte*>& _getParams() const
+    {
+        return _params;
+    }
+
+    const IceInternal::InstancePtr& _getInstance() const
+    {
+        return _instance;
+    }
+    /// \endcond
+
+protected:
+
+    /**
+     * Marshals a request without copying its in-parameters. The in-parameters must remain valid
+     * until the prepared request is destroyed, they are usually held by the derived class.
+     * @param communicator The communicator of the proxies the request is sent with.
+     * @param operation The name of the operation to invoke.
+     * @param mode The operation mode (normal or idempotent).
+     * @param context The context map sent with the request.
+     * @param inParams An encapsulation containing the encoded in-parameters for the operation.
+     */
+    PreparedRequest(const CommunicatorPtr& communicator,
+                    const std::string& operation,
+                    OperationMode mode,
+                    const Context& context,
+                    const std::pair<const Byte*, const Byte*>& inParams);
+
+private:
+
+    void init();
+
+    const IceInternal::InstancePtr _instance;
+    const std::string _operation;
+    const OperationMode _mode;
+    const Context _context;
+
+    //
+    // The operation name, the mode and the context, followed by an empty
+    // encapsulation written for each invocation with the encoding of the
+    // proxy if there are no in-parameters, like ice_invoke.
+    //
+    std::vector<Byte> _body;
+
+    // The in-parameter encapsulation, and its copy if it's owned by the prepared request.
+    std::pair<const Byte*, const Byte*> _params;
+    std::vector<Byte> _paramsCopy;
+};
+
+ICE_DEFINE_PTR(PreparedRequestPtr, PreparedRequest);
+
+}
+
+#endif
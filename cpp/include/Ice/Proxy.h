@@ -133,14 +133,7 @@ public:
            const ::std::pair<const ::Ice::Byte*, const ::Ice::Byte*>& inParams,
            const Ice::Context& context)
     {
-        _read = [](bool ok, Ice::InputStream* stream)
-        {
-            const ::Ice::Byte* encaps;
-            ::Ice::Int sz;
-            stream->readEncapsulation(encaps, sz);
-            return R { ok, { encaps, encaps + sz } };
-        };
-
+        initRead();
         try
         {
             prepare(operation, mode, context);
@@ -160,8 +153,35 @@ public:
         }
     }
 
+    void
+    invoke(const ::Ice::PreparedRequestPtr& request)
+    {
+        initRead();
+        try
+        {
+            prepare(request);
+            OutgoingAsync::invoke(request->getOperation());
+        }
+        catch(const Ice::Exception& ex)
+        {
+            abort(ex);
+        }
+    }
+
 protected:
 
+    void
+    initRead()
+    {
+        _read = [](bool ok, Ice::InputStream* stream)
+        {
+            const ::Ice::Byte* encaps;
+            ::Ice::Int sz;
+            stream->readEncapsulation(encaps, sz);
+            return R { ok, { encaps, encaps + sz } };
+        };
+    }
+
     std::function<R(bool, Ice::InputStream*)> _read;
 };
 
@@ -700,6 +720,78 @@ public:
         return [outAsync]() { outAsync->cancel(); };
     }
 
+    /**
+     * Invokes an operation dynamically with a prepared request. The request header is marshaled
+     * for this proxy and the marshaled request body is copied into the message, see PreparedRequest.
+     * @param request The prepared request.
+     * @param outParams An encapsulation containing the encoded results.
+     * @return True if the operation completed successfully, in which case outParams contains
+     * the encoded out parameters. False if the operation raised a user exception, in which
+     * case outParams contains the encoded user exception. If the operation raises a run-time
+     * exception, it throws it directly.
+     */
+    bool
+    ice_invoke(const ::std::shared_ptr<::Ice::PreparedRequest>& request, ::std::vector<::Ice::Byte>& outParams)
+    {
+        using Outgoing = ::IceInternal::InvokePromiseOutgoing<
+            ::std::promise<::Ice::Object::Ice_invokeResult>, ::Ice::Object::Ice_invokeResult>;
+        auto outAsync = ::std::make_shared<Outgoing>(shared_from_this(), true);
+        outAsync->invoke(request);
+        auto result = outAsync->getFuture().get();
+        outParams.swap(result.outParams);
+        return result.returnValue;
+    }
+
+    /**
+     * Invokes an operation dynamically with a prepared request. The request header is marshaled
+     * for this proxy and the marshaled request body is copied into the message, see PreparedRequest.
+     * @param request The prepared request.
+     * @return The future object for the invocation.
+     */
+    template<template<typename> class P = std::promise> auto
+    ice_invokeAsync(const ::std::shared_ptr<::Ice::PreparedRequest>& request)
+        -> decltype(std::declval<P<::Ice::Object::Ice_invokeResult>>().get_future())
+    {
+        using Outgoing =
+            ::IceInternal::InvokePromiseOutgoing<P<::Ice::Object::Ice_invokeResult>, ::Ice::Object::Ice_invokeResult>;
+        auto outAsync = ::std::make_shared<Outgoing>(shared_from_this(), false);
+        outAsync->invoke(request);
+        return outAsync->getFuture();
+    }
+
+    /**
+     * Invokes an operation dynamically with a prepared request. The request header is marshaled
+     * for this proxy and the marshaled request body is copied into the message, see PreparedRequest.
+     * @param request The prepared request.
+     * @param response The response callback.
+     * @param ex The exception callback.
+     * @param sent The sent callback.
+     * @return A function that can be called to cancel the invocation locally.
+     */
+    ::std::function<void()>
+    ice_invokeAsync(const ::std::shared_ptr<::Ice::PreparedRequest>& request,
+                    ::std::function<void(bool, ::std::vector<::Ice::Byte>)> response,
+                    ::std::function<void(::std::exception_ptr)> ex = nullptr,
+                    ::std::function<void(bool)> sent = nullptr)
+    {
+        using Outgoing = ::IceInternal::InvokeLambdaOutgoing<::Ice::Object::Ice_invokeResult>;
+        ::std::function<void(::Ice::Object::Ice_invokeResult&&)> r;
+        if(response)
+        {
+#if ICE_CPLUSPLUS >= 201402L
+            r = [response = std::move(response)](::Ice::Object::Ice_invokeResult&& result)
+#else
+            r = [response](::Ice::Object::Ice_invokeResult&& result)
+#endif
+            {
+                response(result.returnValue, std::move(result.outParams));
+            };
+        }
+        auto outAsync = ::std::make_shared<Outgoing>(shared_from_this(), std::move(r), std::move(ex), std::move(sent));
+        outAsync->invoke(request);
+        return [outAsync]() { outAsync->cancel(); };
+    }
+
     /**
      * Obtains the identity embedded in this proxy.
      * @return The identity of the target object.
@@ -2373,6 +2465,64 @@ public:
     bool _iceI_end_ice_invoke(::std::pair<const ::Ice::Byte*, const ::Ice::Byte*>&, const ::Ice::AsyncResultPtr&);
     /// \endcond
 
+    /**
+     * Invokes an operation dynamically with a prepared request. The request header is marshaled
+     * for this proxy and the marshaled request body is copied into the message, see PreparedRequest.
+     * @param request The prepared request.
+     * @param outParams An encapsulation containing the encoded results.
+     * @return True if the operation completed successfully, in which case outParams contains
+     * the encoded out parameters. False if the operation raised a user exception, in which
+     * case outParams contains the encoded user exception. If the operation raises a run-time
+     * exception, it throws it directly.
+     */
+    bool ice_invoke(const ::Ice::PreparedRequestPtr& request, ::std::vector< ::Ice::Byte>& outParams)
+    {
+        return end_ice_invoke(outParams, _iceI_begin_ice_invoke(request, ::IceInternal::dummyCallback, 0, true));
+    }
+
+    /**
+     * Invokes an operation dynamically with a prepared request. The request header is marshaled
+     * for this proxy and the marshaled request body is copied into the message, see PreparedRequest.
+     * @param request The prepared request.
+     * @param cookie User-defined data to associate with the invocation.
+     * @return The asynchronous result object for the invocation.
+     */
+    ::Ice::AsyncResultPtr begin_ice_invoke(const ::Ice::PreparedRequestPtr& request,
+                                           const ::Ice::LocalObjectPtr& cookie = 0)
+    {
+        return _iceI_begin_ice_invoke(request, ::IceInternal::dummyCallback, cookie);
+    }
+
+    /**
+     * Invokes an operation dynamically with a prepared request. The request header is marshaled
+     * for this proxy and the marshaled request body is copied into the message, see PreparedRequest.
+     * @param request The prepared request.
+     * @param cb Asynchronous callback object.
+     * @param cookie User-defined data to associate with the invocation.
+     * @return The asynchronous result object for the invocation.
+     */
+    ::Ice::AsyncResultPtr begin_ice_invoke(const ::Ice::PreparedRequestPtr& request,
+                                           const ::Ice::CallbackPtr& cb,
+                                           const ::Ice::LocalObjectPtr& cookie = 0)
+    {
+        return _iceI_begin_ice_invoke(request, cb, cookie);
+    }
+
+    /**
+     * Invokes an operation dynamically with a prepared request. The request header is marshaled
+     * for this proxy and the marshaled request body is copied into the message, see PreparedRequest.
+     * @param request The prepared request.
+     * @param cb Asynchronous callback object.
+     * @param cookie User-defined data to associate with the invocation.
+     * @return The asynchronous result object for the invocation.
+     */
+    ::Ice::AsyncResultPtr begin_ice_invoke(const ::Ice::PreparedRequestPtr& request,
+                                           const ::Ice::Callback_Object_ice_invokePtr& cb,
+                                           const ::Ice::LocalObjectPtr& cookie = 0)
+    {
+        return _iceI_begin_ice_invoke(request, cb, cookie);
+    }
+
     /**
      * Obtains the identity embedded in this proxy.
      * @return The identity of the target object.
@@ -2868,6 +3018,11 @@ private:
                                              const ::Ice::LocalObjectPtr&,
                                              bool = false);
 
+    ::Ice::AsyncResultPtr _iceI_begin_ice_invoke(const ::Ice::PreparedRequestPtr&,
+                                             const ::IceInternal::CallbackBasePtr&,
+                                             const ::Ice::LocalObjectPtr&,
+                                             bool = false);
+
     ::Ice::AsyncResultPtr _iceI_begin_ice_getConnection(const ::IceInternal::CallbackBasePtr&,
                                                     const ::Ice::LocalObjectPtr&);
 
@@ -69,9 +69,24 @@ public:
 
     SlicedData(const SliceInfoSeq&);
 
+    /**
+     * Constructs the sliced data of slices preserved in pass-through mode.
+     * @param seq The slices of unknown types.
+     * @param begin The start of the original encoding of the slices.
+     * @param end The end of the original encoding of the slices.
+     */
+    SlicedData(const SliceInfoSeq& seq, const Byte* begin, const Byte* end);
+
     /** The slices of unknown types. */
     const SliceInfoSeq slices;
 
+    /**
+     * The original encoding of the slices if they were preserved in pass-through mode, or
+     * an empty sequence otherwise. If not empty, the bytes of the slices are empty and the
+     * slices are written back from this encoding.
+     */
+    const ::std::vector<Byte> encoding;
+
     /**
      * Clears the slices to break potential cyclic references.
      */
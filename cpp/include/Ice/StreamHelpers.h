@@ -42,6 +42,10 @@ const StreamHelperCategory StreamHelperCategoryProxy = 7;
 const StreamHelperCategory StreamHelperCategoryClass = 8;
 /** For exception types. */
 const StreamHelperCategory StreamHelperCategoryUserException = 9;
+/** For struct types with cpp:packed metadata. */
+const StreamHelperCategory StreamHelperCategoryPackedStruct = 10;
+/** For sequence and dictionary parameters with cpp:lazy metadata. */
+const StreamHelperCategory StreamHelperCategoryLazyView = 11;
 
 /**
  * The optional format.
@@ -533,6 +537,38 @@ struct StreamHelper<T, StreamHelperCategoryStructClass>
     }
 };
 
+/**
+ * Helper for packed structs. The data members of these structs are laid out
+ * in memory as they are on the wire, apart from the tail padding, so they are
+ * copied as a single blob on little-endian platforms.
+ * \headerfile Ice/Ice.h
+ */
+template<typename T>
+struct StreamHelper<T, StreamHelperCategoryPackedStruct>
+{
+    template<class S> static inline void
+    write(S* stream, const T& v)
+    {
+#ifdef ICE_BIG_ENDIAN
+        StreamWriter<T, S>::write(stream, v);
+#else
+        stream->writeBlob(reinterpret_cast<const Byte*>(&v), StreamableTraits<T>::minWireSize);
+#endif
+    }
+
+    template<class S> static inline void
+    read(S* stream, T& v)
+    {
+#ifdef ICE_BIG_ENDIAN
+        StreamReader<T, S>::read(stream, v);
+#else
+        const Byte* p;
+        stream->readBlob(p, StreamableTraits<T>::minWireSize);
+        memcpy(&v, p, StreamableTraits<T>::minWireSize);
+#endif
+    }
+};
+
 /**
  * Helper for enums.
  * \headerfile Ice/Ice.h
@@ -563,11 +599,11 @@ struct StreamHelper<T, StreamHelperCategoryEnum>
 };
 
 /**
- * Helper for sequences.
+ * Reads and writes the elements of a sequence, specialized on the element helper category.
  * \headerfile Ice/Ice.h
  */
-template<typename T>
-struct StreamHelper<T, StreamHelperCategorySequence>
+template<typename T, StreamHelperCategory st>
+struct StreamSequenceHelper
 {
     template<class S> static inline void
     write(S* stream, const T& v)
@@ -591,6 +627,90 @@ struct StreamHelper<T, StreamHelperCategorySequence>
     }
 };
 
+#ifndef ICE_BIG_ENDIAN
+/**
+ * Helper for vectors of packed structs: the elements are copied in bulk when
+ * the struct has no tail padding, and one after the other into a single
+ * allocation of the marshaling buffer otherwise.
+ * \headerfile Ice/Ice.h
+ */
+template<typename T>
+struct StreamSequenceHelper< ::std::vector<T>, StreamHelperCategoryPackedStruct>
+{
+    template<class S> static inline void
+    write(S* stream, const ::std::vector<T>& v)
+    {
+        const size_t wireSize = StreamableTraits<T>::minWireSize;
+        stream->writeSize(static_cast<Int>(v.size()));
+        if(v.empty())
+        {
+            return;
+        }
+
+        if(sizeof(T) == wireSize)
+        {
+            stream->writeBlob(reinterpret_cast<const Byte*>(&v[0]), v.size() * wireSize);
+        }
+        else
+        {
+            size_t pos = stream->b.size();
+            stream->resize(pos + v.size() * wireSize);
+            Byte* dest = &stream->b[pos];
+            for(typename ::std::vector<T>::const_iterator p = v.begin(); p != v.end(); ++p, dest += wireSize)
+            {
+                memcpy(dest, &*p, wireSize);
+            }
+        }
+    }
+
+    template<class S> static inline void
+    read(S* stream, ::std::vector<T>& v)
+    {
+        const size_t wireSize = StreamableTraits<T>::minWireSize;
+        Int sz = stream->readAndCheckSeqSize(static_cast<int>(wireSize));
+        ::std::vector<T>(static_cast<size_t>(sz)).swap(v);
+        if(sz == 0)
+        {
+            return;
+        }
+
+        const Byte* src;
+        stream->readBlob(src, static_cast<size_t>(sz) * wireSize);
+        if(sizeof(T) == wireSize)
+        {
+            memcpy(&v[0], src, static_cast<size_t>(sz) * wireSize);
+        }
+        else
+        {
+            for(typename ::std::vector<T>::iterator p = v.begin(); p != v.end(); ++p, src += wireSize)
+            {
+                memcpy(&*p, src, wireSize);
+            }
+        }
+    }
+};
+#endif
+
+/**
+ * Helper for sequences.
+ * \headerfile Ice/Ice.h
+ */
+template<typename T>
+struct StreamHelper<T, StreamHelperCategorySequence>
+{
+    template<class S> static inline void
+    write(S* stream, const T& v)
+    {
+        StreamSequenceHelper<T, StreamableTraits<typename T::value_type>::helper>::write(stream, v);
+    }
+
+    template<class S> static inline void
+    read(S* stream, T& v)
+    {
+        StreamSequenceHelper<T, StreamableTraits<typename T::value_type>::helper>::read(stream, v);
+    }
+};
+
 /**
  * Helper for array custom sequence parameters.
  * \headerfile Ice/Ice.h
@@ -763,6 +883,242 @@ struct StreamHelper<T, StreamHelperCategoryClass>
     }
 };
 
+//
+// Helpers to estimate the encoded size of values.
+//
+
+/**
+ * Estimates the encoded size of a value, specialized on the helper category. The estimate is
+ * used to reserve the marshaling buffer before marshaling the parameters of an operation: it's
+ * exact for the built-in types, enumerations, structures, sequences and dictionaries (strings
+ * being counted without string conversion). Types that can't be sized cheaply, such as proxies
+ * and classes, only count for their minimum wire size and the stream grows as they are written.
+ * slice2cpp generates specializations for structures.
+ * \headerfile Ice/Ice.h
+ */
+template<typename T, StreamHelperCategory st>
+struct StreamWireSizeHelper
+{
+    static inline size_t iceWireSize(const T&)
+    {
+        return StreamableTraits<T>::minWireSize;
+    }
+};
+
+/**
+ * Obtains the estimated encoded size of a value, see StreamWireSizeHelper.
+ * @param v The value.
+ * @return The estimated size in bytes.
+ */
+template<typename T> inline size_t
+iceWireSize(const T& v)
+{
+    return StreamWireSizeHelper<T, StreamableTraits<T>::helper>::iceWireSize(v);
+}
+
+/// \cond INTERNAL
+inline size_t
+iceSizeWireSize(size_t sz)
+{
+    return sz < 255 ? 1 : 5;
+}
+/// \endcond
+
+/**
+ * Wire size estimator for strings.
+ * \headerfile Ice/Ice.h
+ */
+template<>
+struct StreamWireSizeHelper< ::std::string, StreamHelperCategoryBuiltin>
+{
+    static inline size_t iceWireSize(const ::std::string& v)
+    {
+        return iceSizeWireSize(v.size()) + v.size();
+    }
+};
+
+/**
+ * Wire size estimator for wide strings, which are encoded in UTF-8.
+ * \headerfile Ice/Ice.h
+ */
+template<>
+struct StreamWireSizeHelper< ::std::wstring, StreamHelperCategoryBuiltin>
+{
+    static inline size_t iceWireSize(const ::std::wstring& v)
+    {
+        const size_t sz = v.size() * (sizeof(wchar_t) == 2 ? 3 : 4);
+        return iceSizeWireSize(sz) + sz;
+    }
+};
+
+/**
+ * Wire size estimator for sequence<bool>.
+ * \headerfile Ice/Ice.h
+ */
+template<>
+struct StreamWireSizeHelper< ::std::vector<bool>, StreamHelperCategoryBuiltin>
+{
+    static inline size_t iceWireSize(const ::std::vector<bool>& v)
+    {
+        return iceSizeWireSize(v.size()) + v.size();
+    }
+};
+
+/**
+ * Wire size estimator for enums.
+ * \headerfile Ice/Ice.h
+ */
+template<typename T>
+struct StreamWireSizeHelper<T, StreamHelperCategoryEnum>
+{
+    static inline size_t iceWireSize(const T&)
+    {
+        return StreamableTraits<T>::maxValue < 127 ? 1 : 5;
+    }
+};
+
+/**
+ * Wire size estimator for sequences and dictionaries, specialized on the helper category for
+ * containers. Custom sequence and dictionary types that aren't containers only count for their
+ * minimum wire size.
+ * \headerfile Ice/Ice.h
+ */
+template<typename T, StreamHelperCategory st, bool container = IsContainer<T>::value>
+struct StreamContainerWireSizeHelper
+{
+    static inline size_t iceWireSize(const T&)
+    {
+        return StreamableTraits<T>::minWireSize;
+    }
+};
+
+/**
+ * Wire size estimator for sequence containers.
+ * \headerfile Ice/Ice.h
+ */
+template<typename T>
+struct StreamContainerWireSizeHelper<T, StreamHelperCategorySequence, true>
+{
+    static inline size_t iceWireSize(const T& v)
+    {
+        typedef typename T::value_type E;
+        size_t sz = iceSizeWireSize(v.size());
+        if(StreamableTraits<E>::fixedLength)
+        {
+            return sz + v.size() * static_cast<size_t>(StreamableTraits<E>::minWireSize);
+        }
+        for(typename T::const_iterator p = v.begin(); p != v.end(); ++p)
+        {
+            sz += ::Ice::iceWireSize(*p);
+        }
+        return sz;
+    }
+};
+
+/**
+ * Wire size estimator for dictionary containers.
+ * \headerfile Ice/Ice.h
+ */
+template<typename T>
+struct StreamContainerWireSizeHelper<T, StreamHelperCategoryDictionary, true>
+{
+    static inline size_t iceWireSize(const T& v)
+    {
+        size_t sz = iceSizeWireSize(v.size());
+        for(typename T::const_iterator p = v.begin(); p != v.end(); ++p)
+        {
+            sz += ::Ice::iceWireSize(p->first) + ::Ice::iceWireSize(p->second);
+        }
+        return sz;
+    }
+};
+
+/**
+ * Wire size estimator for sequences.
+ * \headerfile Ice/Ice.h
+ */
+template<typename T>
+struct StreamWireSizeHelper<T, StreamHelperCategorySequence>
+{
+    static inline size_t iceWireSize(const T& v)
+    {
+        return StreamContainerWireSizeHelper<T, StreamHelperCategorySequence>::iceWireSize(v);
+    }
+};
+
+/**
+ * Wire size estimator for array custom sequence parameters.
+ * \headerfile Ice/Ice.h
+ */
+template<typename T>
+struct StreamWireSizeHelper<std::pair<const T*, const T*>, StreamHelperCategorySequence>
+{
+    static inline size_t iceWireSize(const std::pair<const T*, const T*>& v)
+    {
+        const size_t n = static_cast<size_t>(v.second - v.first);
+        size_t sz = iceSizeWireSize(n);
+        if(StreamableTraits<T>::fixedLength)
+        {
+            return sz + n * static_cast<size_t>(StreamableTraits<T>::minWireSize);
+        }
+        for(const T* p = v.first; p != v.second; ++p)
+        {
+            sz += ::Ice::iceWireSize(*p);
+        }
+        return sz;
+    }
+};
+
+#ifndef ICE_CPP11_MAPPING
+/**
+ * Wire size estimator for range custom sequence parameters.
+ * \headerfile Ice/Ice.h
+ */
+template<typename T>
+struct StreamWireSizeHelper<std::pair<T, T>, StreamHelperCategorySequence>
+{
+    static inline size_t iceWireSize(const std::pair<T, T>& v)
+    {
+        size_t n = 0;
+        size_t sz = 0;
+        for(T p = v.first; p != v.second; ++p, ++n)
+        {
+            sz += ::Ice::iceWireSize(*p);
+        }
+        return iceSizeWireSize(n) + sz;
+    }
+};
+
+/**
+ * Wire size estimator for range sequence<bool> parameters, the elements are encoded on one byte.
+ * \headerfile Ice/Ice.h
+ */
+template<>
+struct StreamWireSizeHelper<std::pair< ::std::vector<bool>::const_iterator,
+                                       ::std::vector<bool>::const_iterator>, StreamHelperCategorySequence>
+{
+    static inline size_t iceWireSize(const std::pair< ::std::vector<bool>::const_iterator,
+                                                      ::std::vector<bool>::const_iterator>& v)
+    {
+        const size_t n = static_cast<size_t>(v.second - v.first);
+        return iceSizeWireSize(n) + n;
+    }
+};
+#endif
+
+/**
+ * Wire size estimator for dictionaries.
+ * \headerfile Ice/Ice.h
+ */
+template<typename T>
+struct StreamWireSizeHelper<T, StreamHelperCategoryDictionary>
+{
+    static inline size_t iceWireSize(const T& v)
+    {
+        return StreamContainerWireSizeHelper<T, StreamHelperCategoryDictionary>::iceWireSize(v);
+    }
+};
+
 //
 // Helpers to read/write optional attributes or members.
 //
@@ -937,6 +1293,15 @@ struct StreamOptionalHelper<T, StreamHelperCategoryStructClass, fixedLength> : S
 {
 };
 
+/**
+ * Packed structs are encoded like structs.
+ * \headerfile Ice/Ice.h
+ */
+template<typename T, bool fixedLength>
+struct StreamOptionalHelper<T, StreamHelperCategoryPackedStruct, fixedLength> : StreamOptionalHelper<T, StreamHelperCategoryStruct, fixedLength>
+{
+};
+
 /**
  * Optional proxies are encoded like variable size structs, using the FSize encoding.
  * \headerfile Ice/Ice.h
@@ -82,6 +82,16 @@ private:
     const ::std::string _typeId;
 };
 
+template<class E>
+void
+defaultUserExceptionFactory(const std::string&)
+{
+    //
+    // C++98 exceptions don't have a static type ID to check the type ID against.
+    //
+    throw E();
+}
+
 }
 
 #endif
@@ -0,0 +1,186 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <Ice/Arena.h>
+#include <IceUtil/ThreadException.h>
+
+#ifndef _WIN32
+#   include <pthread.h>
+#endif
+
+using namespace std;
+using namespace Ice;
+using namespace IceInternal;
+
+namespace
+{
+
+const size_t maxChunkSize = 1024 * 1024;
+
+//
+// The header of the blocks returned by arenaAllocate, it records whether the
+// block comes from an arena or from the heap. Its size is a multiple of the
+// arena alignment so the blocks are aligned as well.
+//
+union BlockHeader
+{
+    Arena* arena;
+    Long align;
+};
+
+#ifdef _WIN32
+DWORD threadArenaKey;
+#else
+pthread_key_t threadArenaKey;
+#endif
+
+class Init
+{
+public:
+
+    Init()
+    {
+#ifdef _WIN32
+        threadArenaKey = TlsAlloc();
+        if(threadArenaKey == TLS_OUT_OF_INDEXES)
+        {
+            throw IceUtil::ThreadSyscallException(__FILE__, __LINE__, GetLastError());
+        }
+#else
+        int err = pthread_key_create(&threadArenaKey, 0);
+        if(err != 0)
+        {
+            throw IceUtil::ThreadSyscallException(__FILE__, __LINE__, err);
+        }
+#endif
+    }
+
+    ~Init()
+    {
+#ifdef _WIN32
+        TlsFree(threadArenaKey);
+#else
+        pthread_key_delete(threadArenaKey);
+#endif
+    }
+};
+
+Init init;
+
+}
+
+Ice::Arena::Arena(size_t chunkSize) :
+    _chunks(0),
+    _next(0),
+    _end(0),
+    _chunkSize(chunkSize < 256 ? 256 : chunkSize),
+    _capacity(0)
+{
+}
+
+Ice::Arena::~Arena()
+{
+    release();
+}
+
+void
+Ice::Arena::release()
+{
+    while(_chunks)
+    {
+        Chunk* previous = _chunks->previous;
+        ::operator delete(_chunks);
+        _chunks = previous;
+    }
+    _next = 0;
+    _end = 0;
+    _capacity = 0;
+}
+
+void*
+Ice::Arena::allocateChunk(size_t size)
+{
+    const size_t headerSize = (sizeof(Chunk) + alignment - 1) & ~(alignment - 1);
+
+    //
+    // Allocations larger than a chunk get their own chunk, the remaining
+    // space of the current chunk is kept for the next allocations.
+    //
+    size_t chunkSize = size > _chunkSize ? size : _chunkSize;
+    Chunk* chunk = static_cast<Chunk*>(::operator new(headerSize + chunkSize));
+    chunk->previous = _chunks;
+    _chunks = chunk;
+    _capacity += chunkSize;
+
+    Byte* p = reinterpret_cast<Byte*>(chunk) + headerSize;
+    if(size <= _chunkSize)
+    {
+        _next = p + size;
+        _end = p + chunkSize;
+        if(_chunkSize < maxChunkSize)
+        {
+            _chunkSize *= 2;
+        }
+    }
+    return p;
+}
+
+void*
+IceInternal::arenaAllocate(size_t size, Arena* arena)
+{
+    BlockHeader* header;
+    if(arena)
+    {
+        header = static_cast<BlockHeader*>(arena->allocate(sizeof(BlockHeader) + size));
+    }
+    else
+    {
+        header = static_cast<BlockHeader*>(::operator new(sizeof(BlockHeader) + size));
+    }
+    header->arena = arena;
+    return header + 1;
+}
+
+void
+IceInternal::arenaDeallocate(void* p)
+{
+    if(p)
+    {
+        BlockHeader* header = static_cast<BlockHeader*>(p) - 1;
+        if(!header->arena)
+        {
+            ::operator delete(header);
+        }
+        //
+        // Blocks allocated from an arena are released with the arena.
+        //
+    }
+}
+
+Arena*
+IceInternal::getThreadArena()
+{
+#ifdef _WIN32
+    return static_cast<Arena*>(TlsGetValue(threadArenaKey));
+#else
+    return static_cast<Arena*>(pthread_getspecific(threadArenaKey));
+#endif
+}
+
+void
+IceInternal::setThreadArena(Arena* arena)
+{
+#ifdef _WIN32
+    if(TlsSetValue(threadArenaKey, arena) == 0)
+    {
+        throw IceUtil::ThreadSyscallException(__FILE__, __LINE__, GetLastError());
+    }
+#else
+    int err = pthread_setspecific(threadArenaKey, arena);
+    if(err != 0)
+    {
+        throw IceUtil::ThreadSyscallException(__FILE__, __LINE__, err);
+    }
+#endif
+}
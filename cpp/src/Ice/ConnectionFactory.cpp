@@ -114,6 +114,14 @@ find(const multimap<K,::IceInternal::Handle<V> >& m,
 }
 #endif
 
+typedef pair<IceUtil::Int64, EndpointIPtr> EndpointScore;
+
+bool
+compareScore(const EndpointScore& lhs, const EndpointScore& rhs)
+{
+    return lhs.first < rhs.first;
+}
+
 class StartAcceptor : public IceUtil::TimerTask
 #ifdef ICE_CPP11_MAPPING
                     , public std::enable_shared_from_this<StartAcceptor>
@@ -260,6 +268,7 @@ IceInternal::OutgoingConnectionFactory::waitUntilFinished()
         cons.clear();
         _connections.clear();
         _connectionsByEndpoint.clear();
+        _latencies.clear();
     }
 
     //
@@ -419,7 +428,11 @@ IceInternal::OutgoingConnectionFactory::OutgoingConnectionFactory(const Communic
     _instance(instance),
     _monitor(new FactoryACMMonitor(instance, instance->clientACM())),
     _destroyed(false),
-    _pendingConnectCount(0)
+    _pendingConnectCount(0),
+    _parallelConnect(instance->initializationData().properties->getPropertyAsInt("Ice.ParallelConnect") > 0),
+    _connectStagger(IceUtil::Time::milliSeconds(
+        max(0, instance->initializationData().properties->getPropertyAsIntWithDefault("Ice.ParallelConnect.Stagger",
+                                                                                      250))))
 {
 }
 
@@ -450,6 +463,83 @@ IceInternal::OutgoingConnectionFactory::applyOverrides(const vector<EndpointIPtr
     return endpoints;
 }
 
+void
+IceInternal::OutgoingConnectionFactory::sortByLatency(vector<EndpointIPtr>& endpoints)
+{
+    //
+    // The connections are indexed by the endpoints with the overrides applied.
+    //
+    vector<EndpointIPtr> overridden = applyOverrides(endpoints);
+
+    IceUtil::Monitor<IceUtil::Mutex>::Lock sync(*this);
+    if(_destroyed)
+    {
+        throw CommunicatorDestroyedException(__FILE__, __LINE__);
+    }
+
+    //
+    // The score of an endpoint is the smoothed round-trip time of its
+    // connection weighted by the number of requests waiting for a reply
+    // on this connection. If the endpoint has no connection, the last
+    // round-trip time observed for the endpoint is used instead.
+    // Endpoints with no round-trip time sample are preferred so that
+    // they get a chance to be measured.
+    //
+    vector<EndpointScore> scores;
+    scores.reserve(endpoints.size());
+    for(vector<EndpointIPtr>::size_type i = 0; i < endpoints.size(); ++i)
+    {
+        const EndpointIPtr& endpoint = overridden[i];
+        IceUtil::Int64 score = -1;
+#ifdef ICE_CPP11_MAPPING
+        auto pr = _connectionsByEndpoint.equal_range(endpoint);
+        for(auto q = pr.first; q != pr.second; ++q)
+#else
+        pair<multimap<EndpointIPtr, ConnectionIPtr>::const_iterator,
+             multimap<EndpointIPtr, ConnectionIPtr>::const_iterator> pr = _connectionsByEndpoint.equal_range(endpoint);
+        for(multimap<EndpointIPtr, ConnectionIPtr>::const_iterator q = pr.first; q != pr.second; ++q)
+#endif
+        {
+            if(q->second->isActiveOrHolding())
+            {
+                IceUtil::Time rtt;
+                int outstanding;
+                q->second->latency(rtt, outstanding);
+                if(rtt != IceUtil::Time())
+                {
+                    _latencies[endpoint] = rtt;
+                }
+                IceUtil::Int64 s = (rtt.toMicroSeconds() + 1) * (outstanding + 1);
+                if(score < 0 || s < score)
+                {
+                    score = s;
+                }
+            }
+        }
+
+        if(score < 0)
+        {
+#ifdef ICE_CPP11_MAPPING
+            auto q = _latencies.find(endpoint);
+#else
+            map<EndpointIPtr, IceUtil::Time>::const_iterator q = _latencies.find(endpoint);
+#endif
+            score = q != _latencies.end() ? q->second.toMicroSeconds() + 1 : 0;
+        }
+        scores.push_back(make_pair(score, endpoints[i]));
+    }
+
+    //
+    // The sort is stable to preserve the random order of the endpoints
+    // with the same score.
+    //
+    stable_sort(scores.begin(), scores.end(), compareScore);
+    for(vector<EndpointScore>::size_type i = 0; i < scores.size(); ++i)
+    {
+        endpoints[i] = scores[i].second;
+    }
+}
+
 ConnectionIPtr
 IceInternal::OutgoingConnectionFactory::findConnection(const vector<EndpointIPtr>& endpoints, bool& compress)
 {
@@ -934,7 +1024,9 @@ IceInternal::OutgoingConnectionFactory::ConnectCallback::ConnectCallback(const I
     _endpoints(endpoints),
     _hasMore(hasMore),
     _callback(cb),
-    _selType(selType)
+    _selType(selType),
+    _scheduled(false),
+    _finished(false)
 {
     _endpointsIter = _endpoints.begin();
 }
@@ -945,6 +1037,12 @@ IceInternal::OutgoingConnectionFactory::ConnectCallback::ConnectCallback(const I
 void
 IceInternal::OutgoingConnectionFactory::ConnectCallback::connectionStartCompleted(const ConnectionIPtr& connection)
 {
+    if(_factory->_parallelConnect)
+    {
+        parallelConnectionCompleted(connection);
+        return;
+    }
+
     if(_observer)
     {
         _observer->detach();
@@ -955,9 +1053,18 @@ IceInternal::OutgoingConnectionFactory::ConnectCallback::connectionStartComplete
 }
 
 void
-IceInternal::OutgoingConnectionFactory::ConnectCallback::connectionStartFailed(const ConnectionIPtr& /*connection*/,
+IceInternal::OutgoingConnectionFactory::ConnectCallback::connectionStartFailed(const ConnectionIPtr& connection,
                                                                                const LocalException& ex)
 {
+    if(_factory->_parallelConnect)
+    {
+        if(parallelConnectionFailed(connection->connector(), ex))
+        {
+            nextParallelConnector();
+        }
+        return;
+    }
+
     assert(_iter != _connectors.end());
     if(connectionStartFailedImpl(ex))
     {
@@ -1017,6 +1124,23 @@ IceInternal::OutgoingConnectionFactory::ConnectCallback::exception(const Ice::Lo
     }
 }
 
+//
+// Methods from IceUtil::TimerTask
+//
+void
+IceInternal::OutgoingConnectionFactory::ConnectCallback::runTimerTask()
+{
+    //
+    // The stagger delay expired before the pending attempts completed, start
+    // the next attempt in parallel.
+    //
+    {
+        IceUtil::Mutex::Lock sync(_mutex);
+        _scheduled = false;
+    }
+    nextParallelConnector();
+}
+
 void
 IceInternal::OutgoingConnectionFactory::ConnectCallback::getConnectors()
 {
@@ -1088,6 +1212,12 @@ IceInternal::OutgoingConnectionFactory::ConnectCallback::getConnection()
 void
 IceInternal::OutgoingConnectionFactory::ConnectCallback::nextConnector()
 {
+    if(_factory->_parallelConnect)
+    {
+        nextParallelConnector();
+        return;
+    }
+
     while(true)
     {
         try
@@ -1211,6 +1341,272 @@ IceInternal::OutgoingConnectionFactory::ConnectCallback::connectionStartFailedIm
     return false;
 }
 
+void
+IceInternal::OutgoingConnectionFactory::ConnectCallback::nextParallelConnector()
+{
+    //
+    // Parallel connection establishment in the style of RFC 8305 (Happy Eyeballs): the
+    // connectors are tried in order but a new attempt is started each time the stagger
+    // delay expires or an attempt fails, without waiting for the pending attempts to
+    // complete. The first connection to be validated is used and the others are closed.
+    //
+    while(true)
+    {
+        vector<ConnectorInfo>::const_iterator p;
+        {
+            IceUtil::Mutex::Lock sync(_mutex);
+            if(_finished || _iter == _connectors.end())
+            {
+                return;
+            }
+            p = _iter++;
+
+            Ice::Instrumentation::ObserverPtr observer;
+            const CommunicatorObserverPtr& obsv = _instance->initializationData().observer;
+            if(obsv)
+            {
+                observer = obsv->getConnectionEstablishmentObserver(p->endpoint, p->connector->toString());
+                if(observer)
+                {
+                    observer->attach();
+                }
+            }
+            _attempts.push_back(Attempt(*p, observer));
+
+            if(_iter != _connectors.end() && !_scheduled)
+            {
+                try
+                {
+                    _instance->timer()->schedule(ICE_SHARED_FROM_THIS, _factory->_connectStagger);
+                    _scheduled = true;
+                }
+                catch(const Ice::CommunicatorDestroyedException&)
+                {
+                    // Ignore, the attempt will fail with the same exception.
+                }
+            }
+        }
+
+        try
+        {
+            if(_instance->traceLevels()->network >= 2)
+            {
+                Trace out(_instance->initializationData().logger, _instance->traceLevels()->networkCat);
+                out << "trying to establish " << p->endpoint->protocol() << " connection to "
+                    << p->connector->toString();
+            }
+
+            TransceiverPtr transceiver = p->connector->connect();
+            Ice::ConnectionIPtr connection;
+            Ice::Instrumentation::ObserverPtr observer;
+            {
+                //
+                // The connection is created with the mutex locked: once another attempt
+                // completed, the connectors are no longer pending with the factory.
+                //
+                IceUtil::Mutex::Lock sync(_mutex);
+                vector<Attempt>::iterator q = _attempts.begin();
+                while(q != _attempts.end() && q->connector.connector != p->connector)
+                {
+                    ++q;
+                }
+                assert(q != _attempts.end());
+
+                if(_finished)
+                {
+                    observer = q->observer;
+                    _attempts.erase(q);
+                }
+                else
+                {
+                    connection = _factory->createConnection(transceiver, *p);
+                    q->connection = connection;
+                }
+            }
+
+            if(!connection)
+            {
+                try
+                {
+                    transceiver->close();
+                }
+                catch(const Ice::LocalException&)
+                {
+                    // Ignore
+                }
+                if(observer)
+                {
+                    observer->detach();
+                }
+                return;
+            }
+
+            //
+            // If another attempt completes before the connection is started, it closes
+            // the connection and start() reports the closure through connectionStartFailed.
+            //
+            connection->start(ICE_SHARED_FROM_THIS);
+        }
+        catch(const Ice::LocalException& ex)
+        {
+            if(_instance->traceLevels()->network >= 2)
+            {
+                Trace out(_instance->initializationData().logger, _instance->traceLevels()->networkCat);
+                out << "failed to establish " << p->endpoint->protocol() << " connection to "
+                    << p->connector->toString() << "\n" << ex;
+            }
+
+            if(parallelConnectionFailed(p->connector, ex))
+            {
+                continue; // More connectors to try, continue.
+            }
+        }
+        break;
+    }
+}
+
+bool
+IceInternal::OutgoingConnectionFactory::ConnectCallback::parallelConnectionFailed(const ConnectorPtr& connector,
+                                                                                  const Ice::LocalException& ex)
+{
+    Ice::Instrumentation::ObserverPtr observer;
+    bool more = false;
+    bool finish = false;
+    {
+        IceUtil::Mutex::Lock sync(_mutex);
+        for(vector<Attempt>::iterator p = _attempts.begin(); p != _attempts.end(); ++p)
+        {
+            if(p->connector.connector == connector)
+            {
+                observer = p->observer;
+                _attempts.erase(p);
+                break;
+            }
+        }
+
+        //
+        // Failures of the attempts closed after another attempt succeeded are ignored.
+        //
+        if(!_finished)
+        {
+            more = _iter != _connectors.end();
+            _factory->handleConnectionException(ex, _hasMore || more || !_attempts.empty());
+            if(dynamic_cast<const Ice::CommunicatorDestroyedException*>(&ex) || (!more && _attempts.empty()))
+            {
+                _finished = true;
+                finish = true;
+                more = false;
+            }
+        }
+    }
+
+    if(observer)
+    {
+        observer->failed(ex.ice_id());
+        observer->detach();
+    }
+
+    if(finish || more)
+    {
+        //
+        // If there are more connectors, the next attempt is started right away
+        // rather than when the stagger delay expires.
+        //
+        cancelStagger();
+    }
+
+    if(finish)
+    {
+        _factory->finishGetConnection(_connectors, ex, ICE_SHARED_FROM_THIS);
+    }
+    return more;
+}
+
+void
+IceInternal::OutgoingConnectionFactory::ConnectCallback::parallelConnectionCompleted(const ConnectionIPtr& connection)
+{
+    Ice::Instrumentation::ObserverPtr observer;
+    vector<ConnectorInfo> connector;
+    vector<ConnectionIPtr> cancelled;
+    bool winner = false;
+    {
+        IceUtil::Mutex::Lock sync(_mutex);
+        for(vector<Attempt>::iterator p = _attempts.begin(); p != _attempts.end(); ++p)
+        {
+            if(p->connection == connection)
+            {
+                observer = p->observer;
+                connector.push_back(p->connector);
+                _attempts.erase(p);
+                break;
+            }
+        }
+
+        if(_finished)
+        {
+            cancelled.push_back(connection);
+        }
+        else
+        {
+            _finished = true;
+            winner = true;
+            for(vector<Attempt>::const_iterator p = _attempts.begin(); p != _attempts.end(); ++p)
+            {
+                if(p->connection)
+                {
+                    cancelled.push_back(p->connection);
+                }
+            }
+        }
+    }
+
+    if(observer)
+    {
+        observer->detach();
+    }
+
+    cancelStagger();
+
+    //
+    // Close the connections which completed or are still pending after another
+    // attempt won. They are reaped by the factory once closed.
+    //
+    for(vector<ConnectionIPtr>::const_iterator p = cancelled.begin(); p != cancelled.end(); ++p)
+    {
+        (*p)->close(ICE_SCOPED_ENUM(ConnectionClose, Forcefully));
+    }
+
+    if(winner)
+    {
+        assert(!connector.empty());
+        connection->activate();
+        _factory->finishGetConnection(_connectors, connector.front(), connection, ICE_SHARED_FROM_THIS);
+    }
+}
+
+void
+IceInternal::OutgoingConnectionFactory::ConnectCallback::cancelStagger()
+{
+    IceUtil::Mutex::Lock sync(_mutex);
+    if(_scheduled)
+    {
+        try
+        {
+            _instance->timer()->cancel(ICE_SHARED_FROM_THIS);
+        }
+        catch(const Ice::CommunicatorDestroyedException&)
+        {
+            // Ignore
+        }
+
+        //
+        // If the task couldn't be canceled it's running and will start another
+        // attempt, this is harmless.
+        //
+        _scheduled = false;
+    }
+}
+
 void
 IceInternal::IncomingConnectionFactory::activate()
 {
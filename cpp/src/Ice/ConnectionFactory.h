@@ -23,6 +23,7 @@
 #include <Ice/InstrumentationF.h>
 #include <Ice/ACMF.h>
 #include <Ice/Comparable.h>
+#include <IceUtil/Timer.h>
 
 #include <list>
 #include <set>
@@ -60,6 +61,7 @@ public:
 
     void create(const std::vector<EndpointIPtr>&, bool, Ice::EndpointSelectionType, const CreateConnectionCallbackPtr&);
     void setRouterInfo(const RouterInfoPtr&);
+    void sortByLatency(std::vector<EndpointIPtr>&);
     void removeAdapter(const Ice::ObjectAdapterPtr&);
     void flushAsyncBatchRequests(const CommunicatorFlushBatchAsyncPtr&, Ice::CompressBatch);
 
@@ -82,7 +84,8 @@ private:
     };
 
     class ConnectCallback : public Ice::ConnectionI::StartCallback,
-                            public IceInternal::EndpointI_connectors
+                            public IceInternal::EndpointI_connectors,
+                            public IceUtil::TimerTask
 #ifdef ICE_CPP11_MAPPING
                           , public std::enable_shared_from_this<ConnectCallback>
 #endif
@@ -99,6 +102,8 @@ private:
         virtual void connectors(const std::vector<ConnectorPtr>&);
         virtual void exception(const Ice::LocalException&);
 
+        virtual void runTimerTask();
+
         void getConnectors();
         void nextEndpoint();
 
@@ -118,6 +123,25 @@ private:
 
         bool connectionStartFailedImpl(const Ice::LocalException&);
 
+        //
+        // Parallel connection establishment, enabled with Ice.ParallelConnect.
+        //
+        struct Attempt
+        {
+            Attempt(const ConnectorInfo& c, const Ice::Instrumentation::ObserverPtr& o) : connector(c), observer(o)
+            {
+            }
+
+            ConnectorInfo connector;
+            Ice::ConnectionIPtr connection;
+            Ice::Instrumentation::ObserverPtr observer;
+        };
+
+        void nextParallelConnector();
+        bool parallelConnectionFailed(const ConnectorPtr&, const Ice::LocalException&);
+        void parallelConnectionCompleted(const Ice::ConnectionIPtr&);
+        void cancelStagger();
+
         const InstancePtr _instance;
         const OutgoingConnectionFactoryPtr _factory;
         const std::vector<EndpointIPtr> _endpoints;
@@ -128,6 +152,11 @@ private:
         std::vector<EndpointIPtr>::const_iterator _endpointsIter;
         std::vector<ConnectorInfo> _connectors;
         std::vector<ConnectorInfo>::const_iterator _iter;
+
+        IceUtil::Mutex _mutex;
+        std::vector<Attempt> _attempts;
+        bool _scheduled;
+        bool _finished;
     };
     ICE_DEFINE_PTR(ConnectCallbackPtr, ConnectCallback);
     friend class ConnectCallback;
@@ -162,8 +191,16 @@ private:
     std::multimap<EndpointIPtr, Ice::ConnectionIPtr, Ice::TargetCompare<EndpointIPtr, std::less>> _connectionsByEndpoint;
 #else
     std::multimap<EndpointIPtr, Ice::ConnectionIPtr> _connectionsByEndpoint;
+#endif
+#ifdef ICE_CPP11_MAPPING
+    std::map<EndpointIPtr, IceUtil::Time, Ice::TargetCompare<EndpointIPtr, std::less>> _latencies;
+#else
+    std::map<EndpointIPtr, IceUtil::Time> _latencies;
 #endif
     int _pendingConnectCount;
+
+    const bool _parallelConnect;
+    const IceUtil::Time _connectStagger;
 };
 
 class IncomingConnectionFactory : public EventHandler,
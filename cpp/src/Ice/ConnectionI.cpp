@@ -22,6 +22,7 @@
 #include <Ice/ReferenceFactory.h> // For createProxy().
 #include <Ice/ProxyFactory.h> // For createProxy().
 #include <Ice/BatchRequestQueue.h>
+#include <Ice/InstrumentationI.h> // For ConnectionObserverI.
 
 #ifdef ICE_HAS_BZIP2
 #  include <bzlib.h>
@@ -41,6 +42,18 @@ namespace
 
 const ::std::string flushBatchRequests_name = "flushBatchRequests";
 
+//
+// The in-parameters of a prepared request smaller than this are copied in
+// the message rather than written separately.
+//
+const size_t minWriteBodySize = 1024;
+
+size_t
+bodySize(const Ice::PreparedRequestPtr& body)
+{
+    return body ? static_cast<size_t>(body->_getParams().second - body->_getParams().first) : 0;
+}
+
 class TimeoutCallback : public IceUtil::TimerTask
 {
 public:
@@ -60,6 +73,25 @@ private:
     Ice::ConnectionI* _connection;
 };
 
+class CoalesceCallback : public IceUtil::TimerTask
+{
+public:
+
+    CoalesceCallback(Ice::ConnectionI* connection) : _connection(connection)
+    {
+    }
+
+    void
+    runTimerTask()
+    {
+        _connection->coalesceTimedOut();
+    }
+
+private:
+
+    Ice::ConnectionI* _connection;
+};
+
 class DispatchCall : public DispatchWorkItem
 {
 public:
@@ -278,6 +310,20 @@ Ice::ConnectionI::Observer::finishWrite(const Buffer& buf)
     _writeStreamPos = 0;
 }
 
+void
+Ice::ConnectionI::Observer::queuedBytes(Int num, bool windowFull)
+{
+    //
+    // The queued bytes are only reported to the metrics observer, they
+    // aren't part of the Ice::Instrumentation::ConnectionObserver API.
+    //
+    ConnectionObserverI* observer = dynamic_cast<ConnectionObserverI*>(_observer.get());
+    if(observer)
+    {
+        observer->queuedBytes(num, windowFull);
+    }
+}
+
 void
 Ice::ConnectionI::Observer::attach(const Ice::Instrumentation::ConnectionObserverPtr& observer)
 {
@@ -529,6 +575,47 @@ Ice::ConnectionI::isActiveOrHolding() const
     return _state > StateNotValidated && _state < StateClosing;
 }
 
+bool
+Ice::ConnectionI::waitForSendWindow(int timeout)
+{
+    IceUtil::Monitor<IceUtil::Mutex>::Lock sync(*this);
+
+    //
+    // Wait for the messages queued for sending to drop below the flow
+    // control window. The peer's TCP receive window throttles the sending
+    // of these messages, waiting here throttles the producer. The timeout
+    // is in milliseconds, a negative timeout waits without limit. Returns
+    // false if the window is still full when the timeout expires.
+    //
+    if(timeout < 0)
+    {
+        while(_sendQueueSize >= _flowControlWindow && _state < StateClosing)
+        {
+            wait();
+        }
+        return true;
+    }
+
+    IceUtil::Time deadline = IceUtil::Time::now(IceUtil::Time::Monotonic) + IceUtil::Time::milliSeconds(timeout);
+    while(_sendQueueSize >= _flowControlWindow && _state < StateClosing)
+    {
+        IceUtil::Time remaining = deadline - IceUtil::Time::now(IceUtil::Time::Monotonic);
+        if(remaining <= IceUtil::Time() || !timedWait(remaining))
+        {
+            return _sendQueueSize < _flowControlWindow || _state >= StateClosing;
+        }
+    }
+    return true;
+}
+
+void
+Ice::ConnectionI::latency(IceUtil::Time& rtt, int& outstanding) const
+{
+    IceUtil::Monitor<IceUtil::Mutex>::Lock sync(*this);
+    rtt = _rtt;
+    outstanding = static_cast<int>(_asyncRequests.size());
+}
+
 bool
 Ice::ConnectionI::isFinished() const
 {
@@ -701,6 +788,24 @@ Ice::ConnectionI::sendAsyncRequest(const OutgoingAsyncBasePtr& out, bool compres
     assert(_state > StateNotValidated);
     assert(_state < StateClosing);
 
+    //
+    // The in-parameters of a prepared request are written from the prepared
+    // request after the message. They are copied in the message if it's
+    // compressed or traced, if the transport is a datagram transport or if
+    // they are small.
+    //
+    if(out->getBody())
+    {
+#if defined(ICE_USE_IOCP) || defined(ICE_OS_UWP)
+        out->writeBody();
+#else
+        if(compress || _endpoint->datagram() || _traceLevels->protocol >= 1 || out->getBodySize() < minWriteBodySize)
+        {
+            out->writeBody();
+        }
+#endif
+    }
+
     //
     // Ensure the message isn't bigger than what we can send with the
     // transport.
@@ -767,6 +872,16 @@ Ice::ConnectionI::sendAsyncRequest(const OutgoingAsyncBasePtr& out, bool compres
         //
         _asyncRequestsHint = _asyncRequests.insert(_asyncRequests.end(),
                                                    pair<const Int, OutgoingAsyncBasePtr>(requestId, out));
+
+        //
+        // Time the request if no other request is being timed to sample the
+        // round-trip time, the sample is discarded if the request is canceled.
+        //
+        if(_rttRequestId == 0 || _asyncRequests.find(_rttRequestId) == _asyncRequests.end())
+        {
+            _rttRequestId = requestId;
+            _rttStart = IceUtil::Time::now(IceUtil::Time::Monotonic);
+        }
     }
     return status;
 }
@@ -1235,6 +1350,7 @@ Ice::ConnectionI::asyncRequestCanceled(const OutgoingAsyncBasePtr& outAsync, con
                 else
                 {
                     o->canceled(false);
+                    _sendQueueSize -= o->size;
                     _sendStreams.erase(o);
                 }
                 if(outAsync->exception(ex))
@@ -1315,9 +1431,19 @@ Ice::ConnectionI::sendResponse(Int, OutputStream* os, Byte compressFlag, bool /*
             _exception->ice_throw();
         }
 
+        if(_coalesceWindow != IceUtil::Time())
+        {
+            cork(os->b.size());
+        }
+
         OutgoingMessage message(os, compressFlag > 0);
         sendMessage(message);
 
+        if(_corked && _coalesceSize > 0 && _corkedSize >= _coalesceSize)
+        {
+            uncork();
+        }
+
         if(_state == StateClosing && _dispatchCount == 0)
         {
             initiateShutdown();
@@ -2001,6 +2127,11 @@ Ice::ConnectionI::finished(ThreadPoolCurrent& current, bool close)
         IceUtil::Monitor<IceUtil::Mutex>::Lock sync(*this);
         assert(_state == StateClosed);
         unscheduleTimeout(static_cast<SocketOperation>(SocketOperationRead | SocketOperationWrite));
+        if(_corked)
+        {
+            _timer->cancel(_coalesceTimeout);
+            _corked = false;
+        }
     }
 
     //
@@ -2130,6 +2261,7 @@ Ice::ConnectionI::finish(bool close)
         }
 
         _sendStreams.clear();
+        _sendQueueSize = 0;
     }
 
     for(map<Int, OutgoingAsyncBasePtr>::const_iterator q = _asyncRequests.begin(); q != _asyncRequests.end(); ++q)
@@ -2147,6 +2279,7 @@ Ice::ConnectionI::finish(bool close)
     //
     _writeStream.clear();
     _writeStream.b.clear();
+    setWriteBody(0);
     _readStream.clear();
     _readStream.b.clear();
 
@@ -2203,6 +2336,16 @@ Ice::ConnectionI::timedOut()
     }
 }
 
+void
+Ice::ConnectionI::coalesceTimedOut()
+{
+    IceUtil::Monitor<IceUtil::Mutex>::Lock sync(*this);
+    if(_corked && _state < StateClosed)
+    {
+        uncork();
+    }
+}
+
 string
 Ice::ConnectionI::type() const ICE_NOEXCEPT
 {
@@ -2269,11 +2412,18 @@ Ice::ConnectionI::ConnectionI(const CommunicatorPtr& communicator,
     _writeTimeoutScheduled(false),
     _readTimeout(new TimeoutCallback(this)),
     _readTimeoutScheduled(false),
+    _flowControlWindow(_instance->flowControlWindow()),
+    _sendQueueSize(0),
+    _coalesceWindow(adapter ? adapter->coalesceWindow() : IceUtil::Time()),
+    _coalesceSize(adapter ? adapter->coalesceSize() : 0),
+    _corked(false),
+    _corkedSize(0),
     _warn(_instance->initializationData().properties->getPropertyAsInt("Ice.Warn.Connections") > 0),
     _warnUdp(_instance->initializationData().properties->getPropertyAsInt("Ice.Warn.Datagrams") > 0),
     _compressionLevel(1),
     _nextRequestId(1),
     _asyncRequestsHint(_asyncRequests.end()),
+    _rttRequestId(0),
     _messageSizeMax(adapter ? adapter->messageSizeMax() : _instance->messageSizeMax()),
     _batchRequestQueue(new BatchRequestQueue(instance, endpoint->datagram())),
     _readStream(_instance.get(), Ice::currentProtocolEncoding),
@@ -2821,6 +2971,7 @@ Ice::ConnectionI::sendNextMessage(vector<OutgoingMessage>& callbacks)
         // Message wasn't sent, empty the _writeStream, we're not going to send more data.
         OutgoingMessage* message = &_sendStreams.front();
         _writeStream.swap(*message->stream);
+        setWriteBody(0);
         return SocketOperationNone;
     }
 
@@ -2841,6 +2992,13 @@ Ice::ConnectionI::sendNextMessage(vector<OutgoingMessage>& callbacks)
                     callbacks.push_back(*message);
                 }
             }
+            setWriteBody(0);
+            if(_flowControlWindow > 0 && _sendQueueSize >= _flowControlWindow &&
+               _sendQueueSize - message->size < _flowControlWindow)
+            {
+                notifyAll(); // Wake up the threads waiting for the send queue to drop below the window.
+            }
+            _sendQueueSize -= message->size;
             _sendStreams.pop_front();
 
             //
@@ -2871,6 +3029,8 @@ Ice::ConnectionI::sendNextMessage(vector<OutgoingMessage>& callbacks)
 #ifdef ICE_HAS_BZIP2
             if(message->compress && message->stream->b.size() >= 100) // Only compress messages > 100 bytes.
             {
+                assert(!message->body);
+
                 //
                 // Message compressed. Request compressed response, if any.
                 //
@@ -2901,7 +3061,7 @@ Ice::ConnectionI::sendNextMessage(vector<OutgoingMessage>& callbacks)
                 //
                 // No compression, just fill in the message size.
                 //
-                Int sz = static_cast<Int>(message->stream->b.size());
+                Int sz = static_cast<Int>(message->stream->b.size() + bodySize(message->body));
                 const Byte* p = reinterpret_cast<const Byte*>(&sz);
 #ifdef ICE_BIG_ENDIAN
                 reverse_copy(p, p + sizeof(Int), message->stream->b.begin() + 10);
@@ -2910,6 +3070,7 @@ Ice::ConnectionI::sendNextMessage(vector<OutgoingMessage>& callbacks)
 #endif
                 message->stream->i = message->stream->b.begin();
                 traceSend(*message->stream, _logger, _traceLevels);
+                setWriteBody(message);
 
 #ifdef ICE_HAS_BZIP2
             }
@@ -2968,8 +3129,7 @@ Ice::ConnectionI::sendMessage(OutgoingMessage& message)
 
     if(!_sendStreams.empty())
     {
-        _sendStreams.push_back(message);
-        _sendStreams.back().adopt(0);
+        queueMessage(message, 0);
         return AsyncStatusQueued;
     }
 
@@ -2983,6 +3143,8 @@ Ice::ConnectionI::sendMessage(OutgoingMessage& message)
 #ifdef ICE_HAS_BZIP2
     if(message.compress && message.stream->b.size() >= 100) // Only compress messages larger than 100 bytes.
     {
+        assert(!message.body);
+
         //
         // Message compressed. Request compressed response, if any.
         //
@@ -3024,8 +3186,7 @@ Ice::ConnectionI::sendMessage(OutgoingMessage& message)
             return status;
         }
 
-        _sendStreams.push_back(message);
-        _sendStreams.back().adopt(&stream);
+        queueMessage(message, &stream);
     }
     else
     {
@@ -3041,7 +3202,7 @@ Ice::ConnectionI::sendMessage(OutgoingMessage& message)
         //
         // No compression, just fill in the message size.
         //
-        Int sz = static_cast<Int>(message.stream->b.size());
+        Int sz = static_cast<Int>(message.stream->b.size() + bodySize(message.body));
         const Byte* p = reinterpret_cast<const Byte*>(&sz);
 #ifdef ICE_BIG_ENDIAN
         reverse_copy(p, p + sizeof(Int), message.stream->b.begin() + 10);
@@ -3059,9 +3220,11 @@ Ice::ConnectionI::sendMessage(OutgoingMessage& message)
         {
             _observer.startWrite(*message.stream);
         }
+        setWriteBody(&message);
         op = write(*message.stream);
         if(!op)
         {
+            setWriteBody(0);
             if(_observer)
             {
                 _observer.finishWrite(*message.stream);
@@ -3078,8 +3241,7 @@ Ice::ConnectionI::sendMessage(OutgoingMessage& message)
             return status;
         }
 
-        _sendStreams.push_back(message);
-        _sendStreams.back().adopt(0); // Adopt the stream.
+        queueMessage(message, 0); // Adopt the stream.
 #ifdef ICE_HAS_BZIP2
     }
 #endif
@@ -3090,6 +3252,48 @@ Ice::ConnectionI::sendMessage(OutgoingMessage& message)
     return AsyncStatusQueued;
 }
 
+void
+Ice::ConnectionI::queueMessage(OutgoingMessage& message, OutputStream* stream)
+{
+    _sendStreams.push_back(message);
+    OutgoingMessage& queued = _sendStreams.back();
+    queued.adopt(stream);
+    queued.size = queued.stream->b.size() + bodySize(queued.body);
+
+    if(_flowControlWindow > 0)
+    {
+        bool windowFull = _sendQueueSize < _flowControlWindow && _sendQueueSize + queued.size >= _flowControlWindow;
+        if(windowFull && _traceLevels->network >= 2)
+        {
+            Trace out(_logger, _traceLevels->networkCat);
+            out << "send queue reached the flow control window of " << _flowControlWindow << " bytes with "
+                << (_sendQueueSize + queued.size) << " bytes queued\n" << toString();
+        }
+
+        if(_observer)
+        {
+            _observer.queuedBytes(static_cast<Int>(queued.size), windowFull);
+        }
+    }
+    _sendQueueSize += queued.size;
+}
+
+void
+Ice::ConnectionI::setWriteBody(const OutgoingMessage* message)
+{
+    if(message && message->body)
+    {
+        const pair<const Byte*, const Byte*>& params = message->body->_getParams();
+        Buffer body(params.first, params.second);
+        _writeBody.swapBuffer(body);
+    }
+    else if(!_writeBody.b.empty())
+    {
+        _writeBody.b.clear();
+        _writeBody.i = _writeBody.b.begin();
+    }
+}
+
 #ifdef ICE_HAS_BZIP2
 static string
 getBZ2Error(int bzError)
@@ -3375,6 +3579,17 @@ Ice::ConnectionI::parseMessage(InputStream& stream, Int& invokeNum, Int& request
                 {
                     outAsync = q->second;
 
+                    if(requestId == _rttRequestId)
+                    {
+                        //
+                        // Smooth the round-trip time samples with the same gain as
+                        // the TCP retransmission timer (RFC 6298).
+                        //
+                        IceUtil::Time sample = IceUtil::Time::now(IceUtil::Time::Monotonic) - _rttStart;
+                        _rtt = _rtt == IceUtil::Time() ? sample : (_rtt * 7 + sample) / 8;
+                        _rttRequestId = 0;
+                    }
+
                     if(q == _asyncRequestsHint)
                     {
                         _asyncRequests.erase(q++);
@@ -3582,6 +3797,53 @@ Ice::ConnectionI::unscheduleTimeout(SocketOperation status)
     }
 }
 
+void
+Ice::ConnectionI::cork(size_t size)
+{
+    //
+    // Cork the socket to coalesce the responses sent within the coalescing
+    // window. The first response opens the window.
+    //
+    if(!_corked)
+    {
+        if(!setTcpCork(_transceiver->getNativeInfo()->fd(), true))
+        {
+            _coalesceWindow = IceUtil::Time(); // Not supported by the transport or the platform.
+            return;
+        }
+
+        if(!_coalesceTimeout)
+        {
+            _coalesceTimeout = ICE_MAKE_SHARED(CoalesceCallback, this);
+        }
+
+        try
+        {
+            _timer->schedule(_coalesceTimeout, _coalesceWindow);
+        }
+        catch(const IceUtil::Exception&)
+        {
+            assert(false);
+        }
+        _corked = true;
+        _corkedSize = 0;
+    }
+    _corkedSize += size;
+}
+
+void
+Ice::ConnectionI::uncork()
+{
+    assert(_corked);
+    _timer->cancel(_coalesceTimeout);
+    _corked = false;
+
+    //
+    // Clearing the option sends the pending partial segments right away.
+    //
+    setTcpCork(_transceiver->getNativeInfo()->fd(), false);
+}
+
 Ice::ConnectionInfoPtr
 Ice::ConnectionI::initConnectionInfo() const
 {
@@ -3642,15 +3904,37 @@ SocketOperation
 ConnectionI::write(Buffer& buf)
 {
     Buffer::Container::iterator start = buf.i;
-    SocketOperation op = _transceiver->write(buf);
-    if(_instance->traceLevels()->network >= 3 && buf.i != start)
+    if(_writeBody.b.empty())
     {
-        Trace out(_instance->initializationData().logger, _instance->traceLevels()->networkCat);
-        out << "sent " << (buf.i - start);
-        if(!_endpoint->datagram())
+        SocketOperation op = _transceiver->write(buf);
+        if(_instance->traceLevels()->network >= 3 && buf.i != start)
         {
-            out << " of " << (buf.b.end() - start);
+            Trace out(_instance->initializationData().logger, _instance->traceLevels()->networkCat);
+            out << "sent " << (buf.i - start);
+            if(!_endpoint->datagram())
+            {
+                out << " of " << (buf.b.end() - start);
+            }
+            out << " bytes via " << _endpoint->protocol() << "\n" << toString();
         }
+        return op;
+    }
+
+    //
+    // Write the message and the in-parameters of its prepared request. The
+    // observer is notified of the bytes of the message by the caller.
+    //
+    Buffer::Container::iterator bodyStart = _writeBody.i;
+    SocketOperation op = _transceiver->writeGather(buf, _writeBody);
+    if(_observer && _writeBody.i != bodyStart)
+    {
+        _observer->sentBytes(static_cast<Int>(_writeBody.i - bodyStart));
+    }
+    if(_instance->traceLevels()->network >= 3 && (buf.i != start || _writeBody.i != bodyStart))
+    {
+        Trace out(_instance->initializationData().logger, _instance->traceLevels()->networkCat);
+        out << "sent " << ((buf.i - start) + (_writeBody.i - bodyStart));
+        out << " of " << ((buf.b.end() - start) + (_writeBody.b.end() - bodyStart));
         out << " bytes via " << _endpoint->protocol() << "\n" << toString();
     }
     return op;
@@ -67,6 +67,7 @@ class ConnectionI : public Connection,
         void finishRead(const IceInternal::Buffer&);
         void startWrite(const IceInternal::Buffer&);
         void finishWrite(const IceInternal::Buffer&);
+        void queuedBytes(Ice::Int, bool);
 
         void attach(const Ice::Instrumentation::ConnectionObserverPtr&);
 
@@ -88,7 +89,7 @@ public:
     struct OutgoingMessage
     {
         OutgoingMessage(Ice::OutputStream* str, bool comp) :
-            stream(str), compress(comp), requestId(0), adopted(false)
+            stream(str), compress(comp), requestId(0), adopted(false), size(0)
 #if defined(ICE_USE_IOCP) || defined(ICE_OS_UWP)
             , isSent(false), invokeSent(false), receivedReply(false)
 #endif
@@ -97,7 +98,7 @@ public:
 
         OutgoingMessage(const IceInternal::OutgoingAsyncBasePtr& o, Ice::OutputStream* str,
                         bool comp, int rid) :
-            stream(str), outAsync(o), compress(comp), requestId(rid), adopted(false)
+            stream(str), outAsync(o), body(o->getBody()), compress(comp), requestId(rid), adopted(false), size(0)
 #if defined(ICE_USE_IOCP) || defined(ICE_OS_UWP)
             , isSent(false), invokeSent(false), receivedReply(false)
 #endif
@@ -111,9 +112,11 @@ public:
 
         Ice::OutputStream* stream;
         IceInternal::OutgoingAsyncBasePtr outAsync;
+        Ice::PreparedRequestPtr body; // The prepared request whose in-parameters are sent after the stream, if any.
         bool compress;
         int requestId;
         bool adopted;
+        size_t size;
 #if defined(ICE_USE_IOCP) || defined(ICE_OS_UWP)
         bool isSent;
         bool invokeSent;
@@ -155,6 +158,8 @@ public:
 
     bool isActiveOrHolding() const;
     bool isFinished() const;
+    void latency(IceUtil::Time&, int&) const;
+    bool waitForSendWindow(int);
 
     virtual void throwException() const; // From Connection. Throws the connection exception if destroyed.
 
@@ -237,6 +242,7 @@ public:
     virtual IceInternal::NativeInfoPtr getNativeInfo();
 
     void timedOut();
+    void coalesceTimedOut();
 
     virtual std::string type() const ICE_NOEXCEPT; // From Connection.
     virtual Ice::Int timeout() const ICE_NOEXCEPT; // From Connection.
@@ -292,6 +298,8 @@ private:
     bool validate(IceInternal::SocketOperation = IceInternal::SocketOperationNone);
     IceInternal::SocketOperation sendNextMessage(std::vector<OutgoingMessage>&);
     IceInternal::AsyncStatus sendMessage(OutgoingMessage&);
+    void queueMessage(OutgoingMessage&, Ice::OutputStream*);
+    void setWriteBody(const OutgoingMessage*);
 
 #ifdef ICE_HAS_BZIP2
     void doCompress(Ice::OutputStream&, Ice::OutputStream&);
@@ -308,6 +316,9 @@ private:
     void scheduleTimeout(IceInternal::SocketOperation status);
     void unscheduleTimeout(IceInternal::SocketOperation status);
 
+    void cork(size_t);
+    void uncork();
+
     Ice::ConnectionInfoPtr initConnectionInfo() const;
     Ice::Instrumentation::ConnectionState toConnectionState(State) const;
 
@@ -348,6 +359,15 @@ private:
     const IceUtil::TimerTaskPtr _readTimeout;
     bool _readTimeoutScheduled;
 
+    const size_t _flowControlWindow;
+    size_t _sendQueueSize;
+
+    IceUtil::Time _coalesceWindow;
+    const size_t _coalesceSize;
+    IceUtil::TimerTaskPtr _coalesceTimeout;
+    bool _corked;
+    size_t _corkedSize;
+
     StartCallbackPtr _startCallback;
 
     const bool _warn;
@@ -362,6 +382,10 @@ private:
     std::map<Int, IceInternal::OutgoingAsyncBasePtr> _asyncRequests;
     std::map<Int, IceInternal::OutgoingAsyncBasePtr>::iterator _asyncRequestsHint;
 
+    Int _rttRequestId;
+    IceUtil::Time _rttStart;
+    IceUtil::Time _rtt;
+
     IceInternal::UniquePtr<LocalException> _exception;
 
     const size_t _messageSizeMax;
@@ -372,6 +396,7 @@ private:
     Ice::InputStream _readStream;
     bool _readHeader;
     Ice::OutputStream _writeStream;
+    IceInternal::Buffer _writeBody; // The in-parameters of a prepared request written after _writeStream, if any.
 
     Observer _observer;
 
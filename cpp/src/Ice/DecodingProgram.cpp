@@ -0,0 +1,975 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <Ice/DecodingProgram.h>
+#include <Ice/Proxy.h>
+#include <Ice/UniquePtr.h>
+#include <IceUtil/Exception.h>
+#include <cctype>
+#include <sstream>
+
+using namespace std;
+using namespace Ice;
+using namespace IceInternal;
+
+struct Ice::DecodingProgram::Type : private IceUtil::noncopyable
+{
+    enum Kind
+    {
+        KindBool, KindByte, KindShort, KindInt, KindLong, KindFloat, KindDouble, KindString, KindEnum,
+        KindProxy, KindStruct, KindSequence, KindDictionary
+    };
+
+    Type(Kind k) :
+        kind(k), maxValue(0)
+    {
+    }
+
+    ~Type()
+    {
+        for(vector<Type*>::const_iterator p = members.begin(); p != members.end(); ++p)
+        {
+            delete *p;
+        }
+    }
+
+    //
+    // The size of a fixed-size type, 0 for a variable-size type.
+    //
+    Int fixedSize() const
+    {
+        switch(kind)
+        {
+            case KindBool:
+            case KindByte:
+            {
+                return 1;
+            }
+            case KindShort:
+            {
+                return 2;
+            }
+            case KindInt:
+            case KindFloat:
+            {
+                return 4;
+            }
+            case KindLong:
+            case KindDouble:
+            {
+                return 8;
+            }
+            case KindStruct:
+            {
+                Int sz = 0;
+                for(vector<Type*>::const_iterator p = members.begin(); p != members.end(); ++p)
+                {
+                    Int memberSize = (*p)->fixedSize();
+                    if(memberSize == 0)
+                    {
+                        return 0;
+                    }
+                    sz += memberSize;
+                }
+                return sz;
+            }
+            default:
+            {
+                return 0;
+            }
+        }
+    }
+
+    Int minWireSize() const
+    {
+        switch(kind)
+        {
+            case KindProxy:
+            {
+                return 2;
+            }
+            case KindStruct:
+            {
+                Int sz = 0;
+                for(vector<Type*>::const_iterator p = members.begin(); p != members.end(); ++p)
+                {
+                    sz += (*p)->minWireSize();
+                }
+                return sz;
+            }
+            case KindString:
+            case KindEnum:
+            case KindSequence:
+            case KindDictionary:
+            {
+                return 1;
+            }
+            default:
+            {
+                return fixedSize();
+            }
+        }
+    }
+
+    size_t depth() const
+    {
+        size_t d = 0;
+        for(vector<Type*>::const_iterator p = members.begin(); p != members.end(); ++p)
+        {
+            d = max(d, (*p)->depth());
+        }
+        return kind == KindSequence || kind == KindDictionary ? d + 1 : d;
+    }
+
+    //
+    // The optional format of the type, and whether the value of an optional
+    // is preceded by its size, as written by the generated code.
+    //
+    OptionalFormat optionalFormat(bool& sizePrefix) const
+    {
+        sizePrefix = false;
+        switch(kind)
+        {
+            case KindBool:
+            case KindByte:
+            {
+                return ICE_SCOPED_ENUM(OptionalFormat, F1);
+            }
+            case KindShort:
+            {
+                return ICE_SCOPED_ENUM(OptionalFormat, F2);
+            }
+            case KindInt:
+            case KindFloat:
+            {
+                return ICE_SCOPED_ENUM(OptionalFormat, F4);
+            }
+            case KindLong:
+            case KindDouble:
+            {
+                return ICE_SCOPED_ENUM(OptionalFormat, F8);
+            }
+            case KindString:
+            {
+                return ICE_SCOPED_ENUM(OptionalFormat, VSize);
+            }
+            case KindEnum:
+            {
+                return ICE_SCOPED_ENUM(OptionalFormat, Size);
+            }
+            case KindProxy:
+            {
+                return ICE_SCOPED_ENUM(OptionalFormat, FSize);
+            }
+            case KindSequence:
+            {
+                Int elementSize = members[0]->fixedSize();
+                if(elementSize == 0)
+                {
+                    return ICE_SCOPED_ENUM(OptionalFormat, FSize);
+                }
+                sizePrefix = elementSize > 1;
+                return ICE_SCOPED_ENUM(OptionalFormat, VSize);
+            }
+            case KindDictionary:
+            {
+                if(members[0]->fixedSize() == 0 || members[1]->fixedSize() == 0)
+                {
+                    return ICE_SCOPED_ENUM(OptionalFormat, FSize);
+                }
+                sizePrefix = true;
+                return ICE_SCOPED_ENUM(OptionalFormat, VSize);
+            }
+            default:
+            {
+                if(fixedSize() == 0)
+                {
+                    return ICE_SCOPED_ENUM(OptionalFormat, FSize);
+                }
+                sizePrefix = true;
+                return ICE_SCOPED_ENUM(OptionalFormat, VSize);
+            }
+        }
+    }
+
+    const Kind kind;
+    Int maxValue;
+    vector<Type*> members;
+};
+
+namespace
+{
+
+void
+skipWhitespace(const string& schema, string::size_type& pos)
+{
+    while(pos < schema.size() && isspace(static_cast<unsigned char>(schema[pos])))
+    {
+        ++pos;
+    }
+}
+
+void
+throwInvalid(const string& schema, string::size_type pos, const string& reason)
+{
+    ostringstream os;
+    os << "invalid type description `" << schema << "': " << reason << " at position " << pos;
+    throw IceUtil::IllegalArgumentException(__FILE__, __LINE__, os.str());
+}
+
+void
+expect(const string& schema, string::size_type& pos, char c)
+{
+    skipWhitespace(schema, pos);
+    if(pos >= schema.size() || schema[pos] != c)
+    {
+        throwInvalid(schema, pos, string("expected `") + c + "'");
+    }
+    ++pos;
+}
+
+Int
+readNumber(const string& schema, string::size_type& pos)
+{
+    skipWhitespace(schema, pos);
+    string::size_type start = pos;
+    Long value = 0;
+    while(pos < schema.size() && isdigit(static_cast<unsigned char>(schema[pos])))
+    {
+        value = value * 10 + (schema[pos++] - '0');
+        if(value > 0x7fffffff)
+        {
+            throwInvalid(schema, start, "number out of range");
+        }
+    }
+    if(pos == start)
+    {
+        throwInvalid(schema, pos, "expected a number");
+    }
+    return static_cast<Int>(value);
+}
+
+void
+skipString(InputStream* stream)
+{
+    stream->skip(static_cast<size_t>(stream->readSize()));
+}
+
+//
+// Skips a proxy without unmarshaling it, see ReferenceFactory::create.
+//
+void
+skipProxy(InputStream* stream)
+{
+    Int nameSize = stream->readSize();
+    stream->skip(static_cast<size_t>(nameSize));
+    skipString(stream); // Category
+    if(nameSize == 0)
+    {
+        return; // Nil proxy
+    }
+
+    Int facetPathSize = stream->readAndCheckSeqSize(1);
+    for(Int i = 0; i < facetPathSize; ++i)
+    {
+        skipString(stream);
+    }
+
+    stream->skip(2); // Mode and secure
+    if(stream->getEncoding() != Ice::Encoding_1_0)
+    {
+        stream->skip(4); // Protocol and encoding
+    }
+
+    Int endpointCount = stream->readSize();
+    if(endpointCount > 0)
+    {
+        for(Int i = 0; i < endpointCount; ++i)
+        {
+            stream->skip(2); // Endpoint type
+            stream->skipEncapsulation();
+        }
+    }
+    else
+    {
+        skipString(stream); // Adapter ID
+    }
+}
+
+}
+
+Ice::DecodingVisitor::~DecodingVisitor()
+{
+    // Out of line to avoid weak vtable
+}
+
+void
+Ice::DecodingVisitor::visitBool(bool)
+{
+}
+
+void
+Ice::DecodingVisitor::visitByte(Byte)
+{
+}
+
+void
+Ice::DecodingVisitor::visitShort(Short)
+{
+}
+
+void
+Ice::DecodingVisitor::visitInt(Int)
+{
+}
+
+void
+Ice::DecodingVisitor::visitLong(Long)
+{
+}
+
+void
+Ice::DecodingVisitor::visitFloat(Float)
+{
+}
+
+void
+Ice::DecodingVisitor::visitDouble(Double)
+{
+}
+
+void
+Ice::DecodingVisitor::visitString(const string&)
+{
+}
+
+void
+Ice::DecodingVisitor::visitEnum(Int)
+{
+}
+
+void
+Ice::DecodingVisitor::visitProxy(const ObjectPrxPtr&)
+{
+}
+
+void
+Ice::DecodingVisitor::startStruct()
+{
+}
+
+void
+Ice::DecodingVisitor::endStruct()
+{
+}
+
+void
+Ice::DecodingVisitor::startSequence(Int)
+{
+}
+
+void
+Ice::DecodingVisitor::endSequence()
+{
+}
+
+void
+Ice::DecodingVisitor::startDictionary(Int)
+{
+}
+
+void
+Ice::DecodingVisitor::endDictionary()
+{
+}
+
+void
+Ice::DecodingVisitor::visitOptional(Int, bool)
+{
+}
+
+Ice::DecodingProgram::DecodingProgram(const string& schema) :
+    _depth(0)
+{
+    string::size_type pos = 0;
+    skipWhitespace(schema, pos);
+    Int lastTag = -1;
+    while(pos < schema.size())
+    {
+        Field field;
+        field.skip = _skip.size();
+        field.tag = -1;
+        field.format = ICE_SCOPED_ENUM(OptionalFormat, F1);
+        field.sizePrefix = false;
+
+        if(schema[pos] == '?')
+        {
+            ++pos;
+            field.tag = readNumber(schema, pos);
+            if(field.tag <= lastTag)
+            {
+                throwInvalid(schema, pos, "optional fields must be in increasing tag order");
+            }
+            lastTag = field.tag;
+            expect(schema, pos, ':');
+        }
+        else if(lastTag >= 0)
+        {
+            throwInvalid(schema, pos, "required fields must precede optional fields");
+        }
+
+        UniquePtr<Type> type(parseType(schema, pos));
+        _depth = max(_depth, type->depth());
+
+        if(field.tag >= 0)
+        {
+            field.format = type->optionalFormat(field.sizePrefix);
+
+            //
+            // The decode program skips the size of the optional value, the
+            // skip program skips the whole value with its tag.
+            //
+            size_t start = _decode.size();
+            emit(_decode, OpOptional, field.tag, static_cast<Int>(field.format));
+            if(field.format == ICE_SCOPED_ENUM(OptionalFormat, FSize))
+            {
+                emit(_decode, OpSkipFixed, 4);
+            }
+            else if(field.sizePrefix)
+            {
+                emit(_decode, OpSkipSize);
+            }
+            emitDecode(type.get(), _decode);
+            _decode[start].jump = static_cast<Int>(_decode.size());
+
+            emit(_skip, OpSkipOptional, field.tag, static_cast<Int>(field.format));
+        }
+        else
+        {
+            emitDecode(type.get(), _decode);
+
+            Int pending = 0;
+            emitSkip(type.get(), _skip, pending);
+            flushSkip(_skip, pending);
+        }
+        _fields.push_back(field);
+
+        skipWhitespace(schema, pos);
+        if(pos < schema.size())
+        {
+            expect(schema, pos, ',');
+            skipWhitespace(schema, pos);
+            if(pos == schema.size())
+            {
+                throwInvalid(schema, pos, "expected a field");
+            }
+        }
+    }
+}
+
+void
+Ice::DecodingProgram::decode(InputStream* stream, DecodingVisitor& visitor) const
+{
+    run(stream, _decode, 0, _decode.size(), &visitor);
+}
+
+void
+Ice::DecodingProgram::skip(InputStream* stream) const
+{
+    run(stream, _skip, 0, _skip.size(), 0);
+}
+
+pair<const Byte*, const Byte*>
+Ice::DecodingProgram::extract(InputStream* stream, size_t field) const
+{
+    if(field >= _fields.size())
+    {
+        throw IceUtil::IllegalArgumentException(__FILE__, __LINE__, "invalid field index");
+    }
+
+    const Field& f = _fields[field];
+    run(stream, _skip, 0, f.skip, 0);
+
+    const Byte* start = stream->i;
+    if(f.tag < 0)
+    {
+        run(stream, _skip, f.skip, field + 1 < _fields.size() ? _fields[field + 1].skip : _skip.size(), 0);
+    }
+    else if(stream->readOptional(f.tag, f.format))
+    {
+        switch(f.format)
+        {
+            case ICE_SCOPED_ENUM(OptionalFormat, FSize):
+            {
+                Int sz;
+                stream->read(sz);
+                start = stream->i;
+                stream->skip(static_cast<size_t>(sz));
+                break;
+            }
+            case ICE_SCOPED_ENUM(OptionalFormat, VSize):
+            {
+                if(f.sizePrefix)
+                {
+                    Int sz = stream->readSize();
+                    start = stream->i;
+                    stream->skip(static_cast<size_t>(sz));
+                }
+                else
+                {
+                    start = stream->i;
+                    skipString(stream);
+                }
+                break;
+            }
+            default:
+            {
+                start = stream->i;
+                stream->skipOptional(f.format);
+                break;
+            }
+        }
+    }
+    else
+    {
+        start = stream->i;
+    }
+    return make_pair(start, static_cast<const Byte*>(stream->i));
+}
+
+void
+Ice::DecodingProgram::run(InputStream* stream, const Program& program, size_t begin, size_t end,
+                          DecodingVisitor* visitor) const
+{
+    //
+    // The remaining elements or entries of the enclosing sequences and
+    // dictionaries.
+    //
+    Int stackCounts[16];
+    vector<Int> heapCounts;
+    Int* counts = stackCounts;
+    if(_depth > sizeof(stackCounts) / sizeof(Int))
+    {
+        heapCounts.resize(_depth);
+        counts = &heapCounts[0];
+    }
+    size_t depth = 0;
+
+    size_t pc = begin;
+    while(pc < end)
+    {
+        const Instruction& instruction = program[pc];
+        switch(instruction.op)
+        {
+            case OpBool:
+            {
+                bool v;
+                stream->read(v);
+                visitor->visitBool(v);
+                break;
+            }
+            case OpByte:
+            {
+                Byte v;
+                stream->read(v);
+                visitor->visitByte(v);
+                break;
+            }
+            case OpShort:
+            {
+                Short v;
+                stream->read(v);
+                visitor->visitShort(v);
+                break;
+            }
+            case OpInt:
+            {
+                Int v;
+                stream->read(v);
+                visitor->visitInt(v);
+                break;
+            }
+            case OpLong:
+            {
+                Long v;
+                stream->read(v);
+                visitor->visitLong(v);
+                break;
+            }
+            case OpFloat:
+            {
+                Float v;
+                stream->read(v);
+                visitor->visitFloat(v);
+                break;
+            }
+            case OpDouble:
+            {
+                Double v;
+                stream->read(v);
+                visitor->visitDouble(v);
+                break;
+            }
+            case OpString:
+            {
+                string v;
+                stream->read(v);
+                visitor->visitString(v);
+                break;
+            }
+            case OpEnum:
+            {
+                visitor->visitEnum(stream->readEnum(instruction.arg));
+                break;
+            }
+            case OpProxy:
+            {
+                ObjectPrxPtr v;
+                stream->read(v);
+                visitor->visitProxy(v);
+                break;
+            }
+            case OpStartStruct:
+            {
+                visitor->startStruct();
+                break;
+            }
+            case OpEndStruct:
+            {
+                visitor->endStruct();
+                break;
+            }
+            case OpStartSequence:
+            case OpStartDictionary:
+            {
+                bool sequence = instruction.op == OpStartSequence;
+                Int sz = sequence ? stream->readAndCheckSeqSize(instruction.arg) : stream->readSize();
+                if(visitor)
+                {
+                    if(sequence)
+                    {
+                        visitor->startSequence(sz);
+                    }
+                    else
+                    {
+                        visitor->startDictionary(sz);
+                    }
+                }
+                if(sz == 0)
+                {
+                    //
+                    // Continue with the end instruction, it doesn't loop for
+                    // an empty container.
+                    //
+                    counts[depth++] = 1;
+                    pc = static_cast<size_t>(instruction.jump);
+                    continue;
+                }
+                counts[depth++] = sz;
+                break;
+            }
+            case OpEndSequence:
+            case OpEndDictionary:
+            {
+                if(--counts[depth - 1] > 0)
+                {
+                    pc = static_cast<size_t>(instruction.jump) + 1;
+                    continue;
+                }
+                --depth;
+                if(visitor)
+                {
+                    if(instruction.op == OpEndSequence)
+                    {
+                        visitor->endSequence();
+                    }
+                    else
+                    {
+                        visitor->endDictionary();
+                    }
+                }
+                break;
+            }
+            case OpOptional:
+            {
+                bool present = stream->readOptional(instruction.arg, static_cast<OptionalFormat>(instruction.format));
+                visitor->visitOptional(instruction.arg, present);
+                if(!present)
+                {
+                    pc = static_cast<size_t>(instruction.jump);
+                    continue;
+                }
+                break;
+            }
+            case OpSkipFixed:
+            {
+                stream->skip(static_cast<size_t>(instruction.arg));
+                break;
+            }
+            case OpSkipSize:
+            {
+                stream->skipSize();
+                break;
+            }
+            case OpSkipString:
+            {
+                skipString(stream);
+                break;
+            }
+            case OpSkipEnum:
+            {
+                stream->readEnum(instruction.arg);
+                break;
+            }
+            case OpSkipProxy:
+            {
+                skipProxy(stream);
+                break;
+            }
+            case OpSkipFixedSequence:
+            {
+                Int sz = stream->readAndCheckSeqSize(instruction.arg);
+                stream->skip(static_cast<size_t>(sz) * static_cast<size_t>(instruction.arg));
+                break;
+            }
+            case OpSkipFixedDictionary:
+            {
+                Int sz = stream->readSize();
+                stream->skip(static_cast<size_t>(sz) * static_cast<size_t>(instruction.arg));
+                break;
+            }
+            case OpSkipOptional:
+            {
+                OptionalFormat format = static_cast<OptionalFormat>(instruction.format);
+                if(stream->readOptional(instruction.arg, format))
+                {
+                    stream->skipOptional(format);
+                }
+                break;
+            }
+        }
+        ++pc;
+    }
+}
+
+Ice::DecodingProgram::Type*
+Ice::DecodingProgram::parseType(const string& schema, string::size_type& pos)
+{
+    skipWhitespace(schema, pos);
+    string::size_type start = pos;
+    while(pos < schema.size() && isalpha(static_cast<unsigned char>(schema[pos])))
+    {
+        ++pos;
+    }
+    const string name = schema.substr(start, pos - start);
+
+    static const char* builtins[] =
+    {
+        "bool", "byte", "short", "int", "long", "float", "double", "string"
+    };
+    for(size_t i = 0; i < sizeof(builtins) / sizeof(builtins[0]); ++i)
+    {
+        if(name == builtins[i])
+        {
+            return new Type(static_cast<Type::Kind>(Type::KindBool + i));
+        }
+    }
+
+    if(name == "proxy")
+    {
+        return new Type(Type::KindProxy);
+    }
+    else if(name == "enum")
+    {
+        UniquePtr<Type> type(new Type(Type::KindEnum));
+        expect(schema, pos, '(');
+        type->maxValue = readNumber(schema, pos);
+        expect(schema, pos, ')');
+        return type.release();
+    }
+    else if(name == "seq")
+    {
+        UniquePtr<Type> type(new Type(Type::KindSequence));
+        expect(schema, pos, '<');
+        type->members.push_back(parseType(schema, pos));
+        expect(schema, pos, '>');
+        return type.release();
+    }
+    else if(name == "dict")
+    {
+        UniquePtr<Type> type(new Type(Type::KindDictionary));
+        expect(schema, pos, '<');
+        type->members.push_back(parseType(schema, pos));
+        expect(schema, pos, ',');
+        type->members.push_back(parseType(schema, pos));
+        expect(schema, pos, '>');
+        return type.release();
+    }
+    else if(name == "struct")
+    {
+        UniquePtr<Type> type(new Type(Type::KindStruct));
+        expect(schema, pos, '{');
+        while(true)
+        {
+            type->members.push_back(parseType(schema, pos));
+            skipWhitespace(schema, pos);
+            if(pos < schema.size() && schema[pos] == '}')
+            {
+                ++pos;
+                break;
+            }
+            expect(schema, pos, ',');
+        }
+        return type.release();
+    }
+
+    throwInvalid(schema, start, name.empty() ? string("expected a type") : "unknown type `" + name + "'");
+    return 0; // Keep the compiler happy.
+}
+
+void
+Ice::DecodingProgram::emitDecode(const Type* type, Program& program)
+{
+    switch(type->kind)
+    {
+        case Type::KindEnum:
+        {
+            emit(program, OpEnum, type->maxValue);
+            break;
+        }
+        case Type::KindStruct:
+        {
+            emit(program, OpStartStruct);
+            for(vector<Type*>::const_iterator p = type->members.begin(); p != type->members.end(); ++p)
+            {
+                emitDecode(*p, program);
+            }
+            emit(program, OpEndStruct);
+            break;
+        }
+        case Type::KindSequence:
+        case Type::KindDictionary:
+        {
+            bool sequence = type->kind == Type::KindSequence;
+            size_t start = program.size();
+            emit(program, sequence ? OpStartSequence : OpStartDictionary, type->members[0]->minWireSize());
+            for(vector<Type*>::const_iterator p = type->members.begin(); p != type->members.end(); ++p)
+            {
+                emitDecode(*p, program);
+            }
+            program[start].jump = static_cast<Int>(program.size());
+            emit(program, sequence ? OpEndSequence : OpEndDictionary, 0, 0, static_cast<Int>(start));
+            break;
+        }
+        default:
+        {
+            //
+            // The opcodes of the builtin types and proxies follow the order of
+            // the type kinds.
+            //
+            emit(program, static_cast<OpCode>(OpBool + type->kind));
+            break;
+        }
+    }
+}
+
+void
+Ice::DecodingProgram::emitSkip(const Type* type, Program& program, Int& pending)
+{
+    //
+    // Consecutive fixed-size values are skipped at once.
+    //
+    Int sz = type->fixedSize();
+    if(sz > 0)
+    {
+        pending += sz;
+        return;
+    }
+
+    switch(type->kind)
+    {
+        case Type::KindString:
+        {
+            flushSkip(program, pending);
+            emit(program, OpSkipString);
+            break;
+        }
+        case Type::KindEnum:
+        {
+            flushSkip(program, pending);
+            emit(program, OpSkipEnum, type->maxValue);
+            break;
+        }
+        case Type::KindProxy:
+        {
+            flushSkip(program, pending);
+            emit(program, OpSkipProxy);
+            break;
+        }
+        case Type::KindStruct:
+        {
+            for(vector<Type*>::const_iterator p = type->members.begin(); p != type->members.end(); ++p)
+            {
+                emitSkip(*p, program, pending);
+            }
+            break;
+        }
+        default:
+        {
+            flushSkip(program, pending);
+            bool sequence = type->kind == Type::KindSequence;
+            Int elementSize = 0;
+            for(vector<Type*>::const_iterator p = type->members.begin(); p != type->members.end(); ++p)
+            {
+                Int memberSize = (*p)->fixedSize();
+                if(memberSize == 0)
+                {
+                    elementSize = 0;
+                    break;
+                }
+                elementSize += memberSize;
+            }
+
+            if(elementSize > 0)
+            {
+                emit(program, sequence ? OpSkipFixedSequence : OpSkipFixedDictionary, elementSize);
+            }
+            else
+            {
+                size_t start = program.size();
+                emit(program, sequence ? OpStartSequence : OpStartDictionary, type->members[0]->minWireSize());
+                Int elementPending = 0;
+                for(vector<Type*>::const_iterator p = type->members.begin(); p != type->members.end(); ++p)
+                {
+                    emitSkip(*p, program, elementPending);
+                }
+                flushSkip(program, elementPending);
+                program[start].jump = static_cast<Int>(program.size());
+                emit(program, sequence ? OpEndSequence : OpEndDictionary, 0, 0, static_cast<Int>(start));
+            }
+            break;
+        }
+    }
+}
+
+void
+Ice::DecodingProgram::emit(Program& program, OpCode op, Int arg, Int format, Int jump)
+{
+    Instruction instruction;
+    instruction.op = op;
+    instruction.arg = arg;
+    instruction.format = format;
+    instruction.jump = jump;
+    program.push_back(instruction);
+}
+
+void
+Ice::DecodingProgram::flushSkip(Program& program, Int& pending)
+{
+    if(pending > 0)
+    {
+        emit(program, OpSkipFixed, pending);
+        pending = 0;
+    }
+}
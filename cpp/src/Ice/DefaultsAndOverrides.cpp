@@ -104,6 +104,7 @@ IceInternal::DefaultsAndOverrides::DefaultsAndOverrides(const PropertiesPtr& pro
         properties->getPropertyAsIntWithDefault("Ice.Default.CollocationOptimized", 1) > 0;
 
     value = properties->getPropertyWithDefault("Ice.Default.EndpointSelection", "Random");
+    defaultLatencySelection = false;
     if(value == "Random")
     {
         defaultEndpointSelection = ICE_ENUM(EndpointSelectionType, Random);
@@ -112,10 +113,20 @@ IceInternal::DefaultsAndOverrides::DefaultsAndOverrides(const PropertiesPtr& pro
     {
         defaultEndpointSelection = ICE_ENUM(EndpointSelectionType, Ordered);
     }
+    else if(value == "Latency")
+    {
+        //
+        // Latency isn't an EndpointSelectionType, it's only supported by
+        // the C++ run time. The endpoints are shuffled like with Random
+        // before being sorted by latency.
+        //
+        defaultEndpointSelection = ICE_ENUM(EndpointSelectionType, Random);
+        defaultLatencySelection = true;
+    }
     else
     {
         throw EndpointSelectionTypeParseException(__FILE__, __LINE__, "illegal value `" + value +
-                                                  "'; expected `Random' or `Ordered'");
+                                                  "'; expected `Random', `Ordered' or `Latency'");
     }
 
     const_cast<int&>(defaultTimeout) =
@@ -28,6 +28,7 @@ public:
     std::string defaultProtocol;
     bool defaultCollocationOptimization;
     Ice::EndpointSelectionType defaultEndpointSelection;
+    bool defaultLatencySelection; // Set with the C++ only Latency endpoint selection.
     int defaultTimeout;
     int defaultInvocationTimeout;
     int defaultLocatorCacheTimeout;
@@ -4,8 +4,13 @@
 
 #include <Ice/FactoryTable.h>
 #include <Ice/ValueFactory.h>
+#include <Ice/Object.h>
+
+#include <algorithm>
+#include <cstring>
 
 using namespace std;
+using namespace IceInternal;
 
 #ifndef ICE_CPP11_MAPPING
 
@@ -16,6 +21,112 @@ Ice::UserExceptionFactory::~UserExceptionFactory()
 
 #endif
 
+namespace
+{
+
+#ifndef ICE_CPP11_MAPPING
+
+class FunctionValueFactory : public Ice::ValueFactory
+{
+public:
+
+    FunctionValueFactory(ValueFactoryFunc factory) :
+        _factory(factory)
+    {
+    }
+
+    virtual Ice::ObjectPtr create(const string& typeId)
+    {
+        return _factory(typeId);
+    }
+
+private:
+
+    const ValueFactoryFunc _factory;
+};
+
+class FunctionUserExceptionFactory : public Ice::UserExceptionFactory
+{
+public:
+
+    FunctionUserExceptionFactory(UserExceptionFactoryFunc factory) :
+        _factory(factory)
+    {
+    }
+
+    virtual void createAndThrow(const string& typeId)
+    {
+        _factory(typeId);
+    }
+
+private:
+
+    const UserExceptionFactoryFunc _factory;
+};
+
+#endif
+
+struct FactoryIndexCompare
+{
+    template<typename T>
+    bool operator()(const T& lhs, const T& rhs) const
+    {
+        return strcmp(lhs.entry->typeId, rhs.entry->typeId) < 0;
+    }
+
+    template<typename T>
+    bool operator()(const T& lhs, const char* rhs) const
+    {
+        return strcmp(lhs.entry->typeId, rhs) < 0;
+    }
+};
+
+struct CompactIdIndexCompare
+{
+    bool operator()(const CompactIdTableEntry* lhs, const CompactIdTableEntry* rhs) const
+    {
+        return lhs->compactId < rhs->compactId;
+    }
+
+    bool operator()(const CompactIdTableEntry* lhs, int rhs) const
+    {
+        return lhs->compactId < rhs;
+    }
+};
+
+template<typename T>
+struct InTable
+{
+    InTable(const T* begin, const T* end) :
+        _begin(begin), _end(end)
+    {
+    }
+
+    template<typename E>
+    bool operator()(const E& e) const
+    {
+        return entry(e) >= _begin && entry(e) < _end;
+    }
+
+private:
+
+    template<typename E>
+    static const T* entry(const E& e)
+    {
+        return e.entry;
+    }
+
+    static const T* entry(const T* e)
+    {
+        return e;
+    }
+
+    const T* _begin;
+    const T* _end;
+};
+
+}
+
 //
 // Add a factory to the exception factory table.
 // If the factory is present already, increment its reference count.
@@ -44,7 +155,29 @@ IceInternal::FactoryTable::getExceptionFactory(const string& t) const
 {
     IceUtil::Mutex::Lock lock(_m);
     EFTable::const_iterator i = _eft.find(t);
-    return i != _eft.end() ? i->second.first : ICE_DELEGATE(::Ice::UserExceptionFactory)();
+    if(i != _eft.end())
+    {
+        return i->second.first;
+    }
+
+    mergeFactoryTables();
+    FactoryIndex::iterator p = lower_bound(_factoryIndex.begin(), _factoryIndex.end(), t.c_str(), FactoryIndexCompare());
+    for(; p != _factoryIndex.end() && t == p->entry->typeId; ++p)
+    {
+        if(p->entry->exceptionFactory)
+        {
+            if(!p->exceptionFactory)
+            {
+#ifdef ICE_CPP11_MAPPING
+                p->exceptionFactory = p->entry->exceptionFactory;
+#else
+                p->exceptionFactory = new FunctionUserExceptionFactory(p->entry->exceptionFactory);
+#endif
+            }
+            return p->exceptionFactory;
+        }
+    }
+    return ICE_DELEGATE(::Ice::UserExceptionFactory)();
 }
 
 //
@@ -94,7 +227,29 @@ IceInternal::FactoryTable::getValueFactory(const string& t) const
 {
     IceUtil::Mutex::Lock lock(_m);
     VFTable::const_iterator i = _vft.find(t);
-    return i != _vft.end() ? i->second.first : ICE_DELEGATE(::Ice::ValueFactory)();
+    if(i != _vft.end())
+    {
+        return i->second.first;
+    }
+
+    mergeFactoryTables();
+    FactoryIndex::iterator p = lower_bound(_factoryIndex.begin(), _factoryIndex.end(), t.c_str(), FactoryIndexCompare());
+    for(; p != _factoryIndex.end() && t == p->entry->typeId; ++p)
+    {
+        if(p->entry->valueFactory)
+        {
+            if(!p->valueFactory)
+            {
+#ifdef ICE_CPP11_MAPPING
+                p->valueFactory = p->entry->valueFactory;
+#else
+                p->valueFactory = new FunctionValueFactory(p->entry->valueFactory);
+#endif
+            }
+            return p->valueFactory;
+        }
+    }
+    return ICE_DELEGATE(::Ice::ValueFactory)();
 }
 
 //
@@ -144,7 +299,15 @@ IceInternal::FactoryTable::getTypeId(int compactId) const
 {
     IceUtil::Mutex::Lock lock(_m);
     TypeIdTable::const_iterator i = _typeIdTable.find(compactId);
-    return i != _typeIdTable.end() ? i->second.first : string();
+    if(i != _typeIdTable.end())
+    {
+        return i->second.first;
+    }
+
+    mergeCompactIdTables();
+    CompactIdIndex::const_iterator p = lower_bound(_compactIdIndex.begin(), _compactIdIndex.end(), compactId,
+                                                   CompactIdIndexCompare());
+    return p != _compactIdIndex.end() && (*p)->compactId == compactId ? string((*p)->typeId) : string();
 }
 
 void
@@ -160,3 +323,110 @@ IceInternal::FactoryTable::removeTypeId(int compactId)
         }
     }
 }
+
+void
+IceInternal::FactoryTable::addFactoryTable(const FactoryTableEntry* begin, const FactoryTableEntry* end)
+{
+    IceUtil::Mutex::Lock lock(_m);
+    _pendingFactoryTables.push_back(make_pair(begin, end));
+}
+
+void
+IceInternal::FactoryTable::removeFactoryTable(const FactoryTableEntry* begin, const FactoryTableEntry* end)
+{
+    IceUtil::Mutex::Lock lock(_m);
+    FactoryTableList::iterator p = find(_pendingFactoryTables.begin(), _pendingFactoryTables.end(),
+                                        make_pair(begin, end));
+    if(p != _pendingFactoryTables.end())
+    {
+        _pendingFactoryTables.erase(p);
+    }
+    else
+    {
+        _factoryIndex.erase(remove_if(_factoryIndex.begin(), _factoryIndex.end(),
+                                      InTable<FactoryTableEntry>(begin, end)),
+                            _factoryIndex.end());
+    }
+}
+
+void
+IceInternal::FactoryTable::addCompactIdTable(const CompactIdTableEntry* begin, const CompactIdTableEntry* end)
+{
+    IceUtil::Mutex::Lock lock(_m);
+    _pendingCompactIdTables.push_back(make_pair(begin, end));
+}
+
+void
+IceInternal::FactoryTable::removeCompactIdTable(const CompactIdTableEntry* begin, const CompactIdTableEntry* end)
+{
+    IceUtil::Mutex::Lock lock(_m);
+    CompactIdTableList::iterator p = find(_pendingCompactIdTables.begin(), _pendingCompactIdTables.end(),
+                                          make_pair(begin, end));
+    if(p != _pendingCompactIdTables.end())
+    {
+        _pendingCompactIdTables.erase(p);
+    }
+    else
+    {
+        _compactIdIndex.erase(remove_if(_compactIdIndex.begin(), _compactIdIndex.end(),
+                                        InTable<CompactIdTableEntry>(begin, end)),
+                              _compactIdIndex.end());
+    }
+}
+
+//
+// Merge the tables registered since the last lookup into the index. The
+// tables are sorted, so each one is merged in linear time. Called with the
+// mutex locked.
+//
+void
+IceInternal::FactoryTable::mergeFactoryTables() const
+{
+    if(_pendingFactoryTables.empty())
+    {
+        return;
+    }
+
+    size_t size = _factoryIndex.size();
+    for(FactoryTableList::const_iterator p = _pendingFactoryTables.begin(); p != _pendingFactoryTables.end(); ++p)
+    {
+        size += static_cast<size_t>(p->second - p->first);
+    }
+    _factoryIndex.reserve(size);
+
+    for(FactoryTableList::const_iterator p = _pendingFactoryTables.begin(); p != _pendingFactoryTables.end(); ++p)
+    {
+        FactoryIndex::difference_type middle = static_cast<FactoryIndex::difference_type>(_factoryIndex.size());
+        for(const FactoryTableEntry* q = p->first; q != p->second; ++q)
+        {
+            FactoryIndexEntry e;
+            e.entry = q;
+            _factoryIndex.push_back(e);
+        }
+        inplace_merge(_factoryIndex.begin(), _factoryIndex.begin() + middle, _factoryIndex.end(),
+                      FactoryIndexCompare());
+    }
+    _pendingFactoryTables.clear();
+}
+
+void
+IceInternal::FactoryTable::mergeCompactIdTables() const
+{
+    if(_pendingCompactIdTables.empty())
+    {
+        return;
+    }
+
+    for(CompactIdTableList::const_iterator p = _pendingCompactIdTables.begin(); p != _pendingCompactIdTables.end();
+        ++p)
+    {
+        CompactIdIndex::difference_type middle = static_cast<CompactIdIndex::difference_type>(_compactIdIndex.size());
+        for(const CompactIdTableEntry* q = p->first; q != p->second; ++q)
+        {
+            _compactIdIndex.push_back(q);
+        }
+        inplace_merge(_compactIdIndex.begin(), _compactIdIndex.begin() + middle, _compactIdIndex.end(),
+                      CompactIdIndexCompare());
+    }
+    _pendingCompactIdTables.clear();
+}
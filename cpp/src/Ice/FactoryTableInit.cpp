@@ -86,3 +86,34 @@ IceInternal::CompactIdInit::~CompactIdInit()
 {
     factoryTable->removeTypeId(_compactId);
 }
+
+IceInternal::FactoryTableRegistration::FactoryTableRegistration(const FactoryTableEntry* factories,
+                                                                size_t factoryCount,
+                                                                const CompactIdTableEntry* compactIds,
+                                                                size_t compactIdCount) :
+    _factories(factories),
+    _factoriesEnd(factories + factoryCount),
+    _compactIds(compactIds),
+    _compactIdsEnd(compactIds + compactIdCount)
+{
+    if(_factories != _factoriesEnd)
+    {
+        factoryTable->addFactoryTable(_factories, _factoriesEnd);
+    }
+    if(_compactIds != _compactIdsEnd)
+    {
+        factoryTable->addCompactIdTable(_compactIds, _compactIdsEnd);
+    }
+}
+
+IceInternal::FactoryTableRegistration::~FactoryTableRegistration()
+{
+    if(_factories != _factoriesEnd)
+    {
+        factoryTable->removeFactoryTable(_factories, _factoriesEnd);
+    }
+    if(_compactIds != _compactIdsEnd)
+    {
+        factoryTable->removeCompactIdTable(_compactIds, _compactIdsEnd);
+    }
+}
@@ -7,10 +7,29 @@
 #include <Ice/LocalException.h>
 #include <IceUtil/StringUtil.h>
 
+#include <cstring>
+
 using namespace std;
 using namespace Ice;
 using namespace IceInternal;
 
+namespace
+{
+
+inline char
+toLowerASCII(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+inline bool
+isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+}
+
 IceInternal::WebSocketException::WebSocketException(const string& r) :
     reason(r)
 {
@@ -18,6 +37,8 @@ IceInternal::WebSocketException::WebSocketException(const string& r) :
 
 IceInternal::HttpParser::HttpParser() :
     _type(TypeUnknown),
+    _header(-1),
+    _start(0),
     _versionMajor(0),
     _versionMinor(0),
     _status(0),
@@ -73,8 +94,6 @@ IceInternal::HttpParser::isCompleteMessage(const Ice::Byte* begin, const Ice::By
 bool
 IceInternal::HttpParser::parse(const Ice::Byte* begin, const Ice::Byte* end)
 {
-    const Ice::Byte* p = begin;
-    const Ice::Byte* start = 0;
     const string::value_type CR = '\r';
     const string::value_type LF = '\n';
 
@@ -83,23 +102,44 @@ IceInternal::HttpParser::parse(const Ice::Byte* begin, const Ice::Byte* end)
         _state = StateInit;
     }
 
-    while(p != end && _state != StateComplete)
+    if(_state == StateInit)
     {
-        char c = static_cast<char>(*p);
+        //
+        // Clear the previous message, the storage is kept for reuse.
+        //
+        _data.clear();
+        _folded.clear();
+        _headers.clear();
+        _header = -1;
+        _start = 0;
+        _method = Range();
+        _uri = Range();
+        _versionMajor = -1;
+        _versionMinor = -1;
+        _status = -1;
+        _reason = Range();
+        _state = StateType;
+    }
+
+    //
+    // The parser is incremental, the new data is appended to the data
+    // received so far and parsing resumes where it stopped.
+    //
+    size_t p = _data.size();
+    _data.insert(_data.end(), begin, end);
+    const size_t last = _data.size();
+    size_t start = _start;
+
+    while(p != last && _state != StateComplete)
+    {
+        char c = _data[p];
 
         switch(_state)
         {
         case StateInit:
         {
-            _method.clear();
-            _uri.clear();
-            _versionMajor = -1;
-            _versionMinor = -1;
-            _status = -1;
-            _reason.clear();
-            _headers.clear();
-            _state = StateType;
-            continue;
+            assert(false); // Shouldn't reach
+            break;
         }
         case StateType:
         {
@@ -107,7 +147,9 @@ IceInternal::HttpParser::parse(const Ice::Byte* begin, const Ice::Byte* end)
             {
                 break;
             }
-            else if(c == 'H')
+
+            _method.begin = p;
+            if(c == 'H')
             {
                 //
                 // Could be the start of "HTTP/1.1" or "HEAD".
@@ -130,8 +172,6 @@ IceInternal::HttpParser::parse(const Ice::Byte* begin, const Ice::Byte* end)
             else if(c == 'E') // Expecting "HEAD"
             {
                 _state = StateRequest;
-                _method.push_back('H');
-                _method.push_back('E');
             }
             else
             {
@@ -149,10 +189,10 @@ IceInternal::HttpParser::parse(const Ice::Byte* begin, const Ice::Byte* end)
         {
             if(c == ' ' || c == CR || c == LF)
             {
+                _method.end = p;
                 _state = StateRequestMethodSP;
                 continue;
             }
-            _method.push_back(c);
             break;
         }
         case StateRequestMethodSP:
@@ -165,6 +205,7 @@ IceInternal::HttpParser::parse(const Ice::Byte* begin, const Ice::Byte* end)
             {
                 throw WebSocketException("malformed request");
             }
+            _uri.begin = p;
             _state = StateRequestURI;
             continue;
         }
@@ -172,10 +213,10 @@ IceInternal::HttpParser::parse(const Ice::Byte* begin, const Ice::Byte* end)
         {
             if(c == ' ' || c == CR || c == LF)
             {
+                _uri.end = p;
                 _state = StateRequestURISP;
                 continue;
             }
-            _uri.push_back(c);
             break;
         }
         case StateRequestURISP:
@@ -246,13 +287,11 @@ IceInternal::HttpParser::parse(const Ice::Byte* begin, const Ice::Byte* end)
             {
                 if(p > start)
                 {
-                    if(_headerName.empty())
+                    if(_header == -1)
                     {
                         throw WebSocketException("malformed header");
                     }
-                    HeaderFields::iterator q = _headers.find(_headerName);
-                    assert(q != _headers.end());
-                    q->second.second = q->second.second + " " + string(start, p);
+                    appendValue(_headers[static_cast<size_t>(_header)], start, p, " ");
                     _state = c == CR ? StateHeaderFieldLF : StateHeaderFieldStart;
                 }
                 else
@@ -270,7 +309,7 @@ IceInternal::HttpParser::parse(const Ice::Byte* begin, const Ice::Byte* end)
         {
             assert(c != ' ');
             start = p;
-            _headerName.clear();
+            _header = -1;
             _state = StateHeaderFieldName;
             continue;
         }
@@ -289,16 +328,24 @@ IceInternal::HttpParser::parse(const Ice::Byte* begin, const Ice::Byte* end)
         }
         case StateHeaderFieldNameEnd:
         {
-            if(_headerName.empty())
+            if(_header == -1 && p > start)
             {
-                _headerName = IceUtilInternal::toLower(string(start, p));
-                HeaderFields::iterator q = _headers.find(_headerName);
-                //
-                // Add a placeholder entry if necessary.
-                //
-                if(q == _headers.end())
+                const HeaderField* q = findHeader(&_data[start], p - start);
+                if(q)
                 {
-                    _headers[_headerName] = make_pair(string(start, p), "");
+                    _header = static_cast<int>(q - &_headers[0]);
+                }
+                else
+                {
+                    //
+                    // Add a placeholder entry.
+                    //
+                    HeaderField field;
+                    field.name.begin = start;
+                    field.name.end = p;
+                    field.folded = false;
+                    _headers.push_back(field);
+                    _header = static_cast<int>(_headers.size()) - 1;
                 }
             }
 
@@ -353,19 +400,11 @@ IceInternal::HttpParser::parse(const Ice::Byte* begin, const Ice::Byte* end)
             assert(c == CR || c == LF);
             if(p > start)
             {
-                HeaderFields::iterator q = _headers.find(_headerName);
-                if(q == _headers.end())
+                if(_header == -1)
                 {
                     throw WebSocketException("malformed header");
                 }
-                else if(q->second.second.empty())
-                {
-                    q->second.second = string(start, p);
-                }
-                else
-                {
-                    q->second.second = q->second.second + ", " + string(start, p);
-                }
+                appendValue(_headers[static_cast<size_t>(_header)], start, p, ", ");
             }
 
             if(c == CR)
@@ -583,7 +622,8 @@ IceInternal::HttpParser::parse(const Ice::Byte* begin, const Ice::Byte* end)
             {
                 if(p > start)
                 {
-                    _reason = string(start, p);
+                    _reason.begin = start;
+                    _reason.end = p;
                 }
                 _state = c == CR ? StateResponseLF : StateHeaderFieldStart;
             }
@@ -608,6 +648,7 @@ IceInternal::HttpParser::parse(const Ice::Byte* begin, const Ice::Byte* end)
         ++p;
     }
 
+    _start = start;
     return _state == StateComplete;
 }
 
@@ -621,14 +662,14 @@ string
 IceInternal::HttpParser::method() const
 {
     assert(_type == TypeRequest);
-    return _method;
+    return string(data(_method.begin, false), data(_method.end, false));
 }
 
 string
 IceInternal::HttpParser::uri() const
 {
     assert(_type == TypeRequest);
-    return _uri;
+    return string(data(_uri.begin, false), data(_uri.end, false));
 }
 
 int
@@ -652,16 +693,17 @@ IceInternal::HttpParser::status() const
 string
 IceInternal::HttpParser::reason() const
 {
-    return _reason;
+    return string(data(_reason.begin, false), data(_reason.end, false));
 }
 
 bool
 IceInternal::HttpParser::getHeader(const string& name, string& value, bool toLower) const
 {
-    HeaderFields::const_iterator q = _headers.find(IceUtilInternal::toLower(name));
-    if(q != _headers.end())
+    const char* begin;
+    const char* end;
+    if(getHeader(name.c_str(), begin, end))
     {
-        value = IceUtilInternal::trim(q->second.second);
+        value.assign(begin, end);
         if(toLower)
         {
             value = IceUtilInternal::toLower(value);
@@ -672,13 +714,111 @@ IceInternal::HttpParser::getHeader(const string& name, string& value, bool toLow
     return false;
 }
 
+bool
+IceInternal::HttpParser::getHeader(const char* name, const char*& begin, const char*& end) const
+{
+    const HeaderField* q = findHeader(name, strlen(name));
+    if(!q)
+    {
+        return false;
+    }
+
+    begin = data(q->value.begin, q->folded);
+    end = data(q->value.end, q->folded);
+    while(begin != end && isSpace(*begin))
+    {
+        ++begin;
+    }
+    while(end != begin && isSpace(*(end - 1)))
+    {
+        --end;
+    }
+    return true;
+}
+
 map<string, string>
 IceInternal::HttpParser::getHeaders() const
 {
     map<string, string> headers;
-    for(HeaderFields::const_iterator q = _headers.begin(); q != _headers.end(); ++q)
+    for(vector<HeaderField>::const_iterator q = _headers.begin(); q != _headers.end(); ++q)
     {
-        headers.insert(make_pair(q->second.first, IceUtilInternal::trim(q->second.second)));
+        const char* begin = data(q->value.begin, q->folded);
+        const char* end = data(q->value.end, q->folded);
+        headers.insert(make_pair(string(data(q->name.begin, false), data(q->name.end, false)),
+                                 IceUtilInternal::trim(string(begin, end))));
     }
     return headers;
 }
+
+const char*
+IceInternal::HttpParser::data(size_t offset, bool folded) const
+{
+    const vector<char>& v = folded ? _folded : _data;
+    return v.empty() ? 0 : &v[0] + offset;
+}
+
+const IceInternal::HttpParser::HeaderField*
+IceInternal::HttpParser::findHeader(const char* name, size_t length) const
+{
+    //
+    // A request or response only has a handful of header fields, a linear
+    // search is cheaper than maintaining an index.
+    //
+    for(vector<HeaderField>::const_iterator q = _headers.begin(); q != _headers.end(); ++q)
+    {
+        if(q->name.end - q->name.begin != length)
+        {
+            continue;
+        }
+
+        const char* p = &_data[q->name.begin];
+        size_t i = 0;
+        while(i < length && toLowerASCII(p[i]) == toLowerASCII(name[i]))
+        {
+            ++i;
+        }
+        if(i == length)
+        {
+            return &*q;
+        }
+    }
+    return 0;
+}
+
+void
+IceInternal::HttpParser::appendValue(HeaderField& field, size_t begin, size_t end, const char* separator)
+{
+    if(field.value.begin == field.value.end)
+    {
+        field.value.begin = begin;
+        field.value.end = end;
+        field.folded = false;
+        return;
+    }
+
+    //
+    // The value spans several lines or header fields, the parts are joined
+    // in _folded. This is uncommon so we don't try to avoid the copy.
+    //
+    const size_t separatorLength = strlen(separator);
+    const size_t length = field.value.end - field.value.begin;
+    const size_t offset = _folded.size();
+    _folded.reserve(offset + length + separatorLength + end - begin);
+    if(field.folded && field.value.end == offset)
+    {
+        _folded.insert(_folded.end(), separator, separator + separatorLength);
+        _folded.insert(_folded.end(), _data.begin() + static_cast<ptrdiff_t>(begin),
+                       _data.begin() + static_cast<ptrdiff_t>(end));
+        field.value.end = _folded.size();
+        return;
+    }
+
+    const char* value = data(field.value.begin, field.folded);
+    _folded.insert(_folded.end(), value, value + length);
+    _folded.insert(_folded.end(), separator, separator + separatorLength);
+    _folded.insert(_folded.end(), _data.begin() + static_cast<ptrdiff_t>(begin),
+                   _data.begin() + static_cast<ptrdiff_t>(end));
+    field.value.begin = offset;
+    field.value.end = _folded.size();
+    field.folded = true;
+}
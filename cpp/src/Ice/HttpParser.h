@@ -14,8 +14,6 @@ namespace IceInternal
 
 std::vector<unsigned char> calcSHA1(const std::vector<unsigned char>&);
 
-typedef std::map<std::string, std::pair<std::string, std::string> > HeaderFields;
-
 class WebSocketException
 {
 public:
@@ -53,23 +51,63 @@ public:
 
     bool getHeader(const std::string&, std::string&, bool) const;
 
+    //
+    // Allocation-free lookup, the header name is matched case-insensitively and
+    // the returned range is trimmed. The range points to memory owned by the
+    // parser and remains valid until the next call to parse().
+    //
+    bool getHeader(const char*, const char*&, const char*&) const;
+
     std::map<std::string, std::string> getHeaders() const;
 
 private:
 
+    //
+    // Offsets of a range of characters in _data, or in _folded for header
+    // values which span several lines or several header fields.
+    //
+    struct Range
+    {
+        Range() : begin(0), end(0)
+        {
+        }
+
+        size_t begin;
+        size_t end;
+    };
+
+    struct HeaderField
+    {
+        Range name;
+        Range value;
+        bool folded;
+    };
+
+    const char* data(size_t, bool) const;
+    const HeaderField* findHeader(const char*, size_t) const;
+    void appendValue(HeaderField&, size_t, size_t, const char*);
+
     Type _type;
 
-    std::string _method;
-    std::string _uri;
+    //
+    // The message is copied once into _data as it's parsed, the method, URI,
+    // reason and header fields are offsets into it. The vectors are cleared
+    // rather than released between messages to reuse their storage.
+    //
+    std::vector<char> _data;
+    std::vector<char> _folded;
+    std::vector<HeaderField> _headers;
+    int _header;
+    size_t _start;
 
-    HeaderFields _headers;
-    std::string _headerName;
+    Range _method;
+    Range _uri;
 
     int _versionMajor;
     int _versionMinor;
 
     int _status;
-    std::string _reason;
+    Range _reason;
 
     enum State
     {
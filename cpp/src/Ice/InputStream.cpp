@@ -162,6 +162,7 @@ Ice::InputStream::initialize(Instance* instance, const EncodingVersion& encoding
 #endif
     _traceSlicing = _instance->traceLevels()->slicing > 0;
     _classGraphDepthMax = _instance->classGraphDepthMax();
+    _passThroughSlices = _instance->passThroughSlices();
 }
 
 void
@@ -176,7 +177,9 @@ Ice::InputStream::initialize(const EncodingVersion& encoding)
     _traceSlicing = false;
     _classGraphDepthMax = 0x7fffffff;
     _closure = 0;
+    _arena = 0;
     _sliceValues = true;
+    _passThroughSlices = false;
     _startSeq = -1;
     _minSeqSize = 0;
 }
@@ -231,6 +234,12 @@ Ice::InputStream::setSliceValues(bool on)
     _sliceValues = on;
 }
 
+void
+Ice::InputStream::setPassThroughSlices(bool on)
+{
+    _passThroughSlices = on;
+}
+
 void
 Ice::InputStream::setTraceSlicing(bool on)
 {
@@ -277,7 +286,9 @@ Ice::InputStream::swap(InputStream& other)
     std::swap(_traceSlicing, other._traceSlicing);
     std::swap(_classGraphDepthMax, other._classGraphDepthMax);
     std::swap(_closure, other._closure);
+    std::swap(_arena, other._arena);
     std::swap(_sliceValues, other._sliceValues);
+    std::swap(_passThroughSlices, other._passThroughSlices);
 
     //
     // Swap is never called for streams that have encapsulations being read. However,
@@ -1711,7 +1722,8 @@ Ice::InputStream::initEncaps()
         }
         else
         {
-            _currentEncaps->decoder = new EncapsDecoder11(this, _currentEncaps, _sliceValues, _classGraphDepthMax, vfm);
+            _currentEncaps->decoder = new EncapsDecoder11(this, _currentEncaps, _sliceValues, _classGraphDepthMax, vfm,
+                                                          _passThroughSlices);
         }
     }
 }
@@ -1727,18 +1739,17 @@ Ice::InputStream::EncapsDecoder::readTypeId(bool isIndex)
     if(isIndex)
     {
         Int index = _stream->readSize();
-        TypeIdMap::const_iterator k = _typeIdMap.find(index);
-        if(k == _typeIdMap.end())
+        if(index <= 0 || static_cast<size_t>(index) > _typeIds.size())
         {
             throw UnmarshalOutOfBoundsException(__FILE__, __LINE__);
         }
-        return k->second;
+        return _typeIds[static_cast<size_t>(index - 1)];
     }
     else
     {
         string typeId;
         _stream->read(typeId, false);
-        _typeIdMap.insert(make_pair(++_typeIdIndex, typeId));
+        _typeIds.push_back(typeId);
         return typeId;
     }
 }
@@ -2381,6 +2392,7 @@ Ice::InputStream::EncapsDecoder11::endInstance(bool preserve)
     }
     _current->slices.clear();
     _current->indirectionTables.clear();
+    _current->sliceBytes.clear();
     _current = _current->previous;
     return slicedData;
 }
@@ -2398,6 +2410,7 @@ Ice::InputStream::EncapsDecoder11::startSlice()
         return _current->typeId;
     }
 
+    _current->sliceStart = _stream->i;
     _stream->read(_current->sliceFlags);
 
     //
@@ -2533,17 +2546,38 @@ Ice::InputStream::EncapsDecoder11::skipSlice()
     info->compactId = _current->compactId;
     info->hasOptionalMembers = _current->sliceFlags & FLAG_HAS_OPTIONAL_MEMBERS;
     info->isLastSlice = _current->sliceFlags & FLAG_IS_LAST_SLICE;
-    if(info->hasOptionalMembers)
+
+    //
+    // Don't include the optional member end marker. It will be re-written by
+    // endSlice when the sliced data is re-written.
+    //
+    Container::iterator end = info->hasOptionalMembers ? _stream->i - 1 : _stream->i;
+    if(_current->passThrough)
     {
         //
-        // Don't include the optional member end marker. It will be re-written by
-        // endSlice when the sliced data is re-written.
+        // The slices can be written back verbatim only if they don't refer to
+        // instances or to type IDs through indexes, both are only valid in this
+        // encapsulation. The bytes are copied by readSlicedData once we know
+        // whether the whole run of preserved slices is kept.
         //
-        vector<Byte>(start, _stream->i - 1).swap(info->bytes);
+        if(_current->slices.empty())
+        {
+            _current->passThroughStart = _current->sliceStart;
+        }
+        if(_current->sliceFlags & (FLAG_HAS_INDIRECTION_TABLE | FLAG_HAS_TYPE_ID_INDEX))
+        {
+            _current->passThrough = false;
+        }
+        _current->passThroughEnd = _stream->i;
+        _current->sliceBytes.push_back(make_pair(start, end));
+    }
+    else if(_current->sliceBytes.empty())
+    {
+        vector<Byte>(start, end).swap(info->bytes);
     }
     else
     {
-        vector<Byte>(start, _stream->i).swap(info->bytes);
+        _current->sliceBytes.push_back(make_pair(start, end));
     }
 
     _current->indirectionTables.push_back(IndexList());
@@ -2737,5 +2771,20 @@ Ice::InputStream::EncapsDecoder11::readSlicedData()
 #endif
         }
     }
+    if(!_current->sliceBytes.empty())
+    {
+        if(_current->passThrough)
+        {
+            return ICE_MAKE_SHARED(SlicedData, _current->slices, _current->passThroughStart,
+                                   _current->passThroughEnd);
+        }
+
+        assert(_current->sliceBytes.size() == _current->slices.size());
+        for(SliceInfoSeq::size_type n = 0; n < _current->slices.size(); ++n)
+        {
+            vector<Byte>(_current->sliceBytes[n].first, _current->sliceBytes[n].second).swap(
+                _current->slices[n]->bytes);
+        }
+    }
     return ICE_MAKE_SHARED(SlicedData, _current->slices);
 }
@@ -948,7 +948,10 @@ IceInternal::Instance::Instance(const CommunicatorPtr& communicator, const Initi
     _messageSizeMax(0),
     _batchAutoFlushSize(0),
     _classGraphDepthMax(0),
+    _flowControlWindow(0),
+    _flowControlBlock(true),
     _collectObjects(false),
+    _passThroughSlices(false),
     _toStringMode(ICE_ENUM(ToStringMode, Unicode)),
     _acceptClassCycles(false),
     _implicitContext(0),
@@ -1212,8 +1215,38 @@ IceInternal::Instance::Instance(const CommunicatorPtr& communicator, const Initi
             }
         }
 
+        {
+            Int num = _initData.properties->getPropertyAsInt("Ice.FlowControl.Window");
+            if(num < 1)
+            {
+                const_cast<size_t&>(_flowControlWindow) = 0; // Disabled
+            }
+            else if(static_cast<size_t>(num) > static_cast<size_t>(0x7fffffff / 1024))
+            {
+                const_cast<size_t&>(_flowControlWindow) = static_cast<size_t>(0x7fffffff);
+            }
+            else
+            {
+                // Property is in kilobytes, convert in bytes.
+                const_cast<size_t&>(_flowControlWindow) = static_cast<size_t>(num) * 1024;
+            }
+
+            string policy = _initData.properties->getPropertyWithDefault("Ice.FlowControl.Policy", "Block");
+            if(policy == "Fail")
+            {
+                const_cast<bool&>(_flowControlBlock) = false;
+            }
+            else if(policy != "Block")
+            {
+                throw InitializationException(__FILE__, __LINE__, "The value for Ice.FlowControl.Policy must be Block or Fail");
+            }
+        }
+
         const_cast<bool&>(_collectObjects) = _initData.properties->getPropertyAsInt("Ice.CollectObjects") > 0;
 
+        const_cast<bool&>(_passThroughSlices) =
+            _initData.properties->getPropertyAsInt("Ice.PassThroughSlices") > 0;
+
         string toStringModeStr = _initData.properties->getPropertyWithDefault("Ice.ToStringMode", "Unicode");
         if(toStringModeStr == "ASCII")
         {
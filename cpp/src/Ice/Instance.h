@@ -104,7 +104,10 @@ public:
     size_t messageSizeMax() const { return _messageSizeMax; }
     size_t batchAutoFlushSize() const { return _batchAutoFlushSize; }
     size_t classGraphDepthMax() const { return _classGraphDepthMax; }
+    size_t flowControlWindow() const { return _flowControlWindow; }
+    bool flowControlBlock() const { return _flowControlBlock; }
     bool collectObjects() const { return _collectObjects; }
+    bool passThroughSlices() const { return _passThroughSlices; }
     Ice::ToStringMode toStringMode() const { return _toStringMode; }
     bool acceptClassCycles() const { return _acceptClassCycles; }
     const ACMConfig& clientACM() const;
@@ -174,7 +177,10 @@ private:
     const size_t _messageSizeMax; // Immutable, not reset by destroy().
     const size_t _batchAutoFlushSize; // Immutable, not reset by destroy().
     const size_t _classGraphDepthMax; // Immutable, not reset by destroy().
+    const size_t _flowControlWindow; // Immutable, not reset by destroy().
+    const bool _flowControlBlock; // Immutable, not reset by destroy().
     const bool _collectObjects; // Immutable, not reset by destroy().
+    const bool _passThroughSlices; // Immutable, not reset by destroy().
     const Ice::ToStringMode _toStringMode; // Immutable, not reset by destroy()
     const bool _acceptClassCycles; // Immutable, not reset by destroy()
     ACMConfig _clientACM;
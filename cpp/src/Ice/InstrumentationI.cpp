@@ -67,6 +67,22 @@ struct ThreadStateChanged
     ThreadState newState;
 };
 
+struct QueuedBytes
+{
+    QueuedBytes(Int numP, bool windowFullP) : num(numP), windowFull(windowFullP)
+    {
+    }
+
+    void operator()(const ConnectionMetricsPtr& v)
+    {
+        v->queuedBytes = (v->queuedBytes ? *v->queuedBytes : 0) + num;
+        v->sendWindowFull = (v->sendWindowFull ? *v->sendWindowFull : 0) + (windowFull ? 1 : 0);
+    }
+
+    Int num;
+    bool windowFull;
+};
+
 IPConnectionInfo*
 getIPConnectionInfo(const ConnectionInfoPtr& info)
 {
@@ -788,6 +804,12 @@ ConnectionObserverI::receivedBytes(Int num)
     }
 }
 
+void
+ConnectionObserverI::queuedBytes(Int num, bool windowFull)
+{
+    forEach(QueuedBytes(num, windowFull));
+}
+
 void
 ThreadObserverI::stateChanged(ThreadState oldState, ThreadState newState)
 {
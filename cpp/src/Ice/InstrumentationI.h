@@ -153,6 +153,9 @@ public:
 
     virtual void sentBytes(Ice::Int);
     virtual void receivedBytes(Ice::Int);
+
+    // Called by the connection when flow control is enabled.
+    void queuedBytes(Ice::Int, bool);
 };
 
 class ThreadObserverI : public ObserverWithDelegateT<IceMX::ThreadMetrics, Ice::Instrumentation::ThreadObserver>
@@ -2062,6 +2062,25 @@ IceInternal::setBlock(SOCKET fd, bool block)
 }
 #endif
 
+#if defined(TCP_CORK) && !defined(ICE_OS_UWP)
+bool
+IceInternal::setTcpCork(SOCKET fd, bool cork)
+{
+    //
+    // Unlike the other socket options, failures aren't fatal: the socket
+    // might not be a TCP socket, the caller just doesn't cork the socket.
+    //
+    int flag = cork ? 1 : 0;
+    return setsockopt(fd, IPPROTO_TCP, TCP_CORK, reinterpret_cast<char*>(&flag), int(sizeof(int))) != SOCKET_ERROR;
+}
+#else
+bool
+IceInternal::setTcpCork(SOCKET, bool)
+{
+    return false;
+}
+#endif
+
 void
 IceInternal::setSendBufferSize(SOCKET fd, int sz)
 {
@@ -290,6 +290,7 @@ ICE_API void setTcpBufSize(SOCKET, const ProtocolInstancePtr&);
 ICE_API void setTcpBufSize(SOCKET, int, int, const ProtocolInstancePtr&);
 
 ICE_API void setBlock(SOCKET, bool);
+ICE_API bool setTcpCork(SOCKET, bool);
 ICE_API void setSendBufferSize(SOCKET, int);
 ICE_API int getSendBufferSize(SOCKET);
 ICE_API void setRecvBufferSize(SOCKET, int);
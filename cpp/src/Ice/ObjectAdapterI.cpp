@@ -946,7 +946,8 @@ Ice::ObjectAdapterI::ObjectAdapterI(const InstancePtr& instance, const Communica
     _name(name),
     _directCount(0),
     _noConfig(noConfig),
-    _messageSizeMax(0)
+    _messageSizeMax(0),
+    _coalesceSize(0)
 {
 }
 
@@ -1021,6 +1022,18 @@ Ice::ObjectAdapterI::initialize(const RouterPrxPtr& router)
             }
         }
 
+        {
+            //
+            // The responses sent within the coalescing window (in microseconds) are
+            // coalesced in as few TCP segments as possible, the window is closed
+            // early once the given number of bytes is reached.
+            //
+            Int window = properties->getPropertyAsInt(_name + ".Coalesce.Window");
+            Int size = properties->getPropertyAsInt(_name + ".Coalesce.Size");
+            _coalesceWindow = IceUtil::Time::microSeconds(window > 0 ? window : 0);
+            _coalesceSize = size > 0 ? static_cast<size_t>(size) : 0;
+        }
+
         int threadPoolSize = properties->getPropertyAsInt(_name + ".ThreadPool.Size");
         int threadPoolSizeMax = properties->getPropertyAsInt(_name + ".ThreadPool.SizeMax");
         bool hasPriority = properties->getProperty(_name + ".ThreadPool.ThreadPriority") != "";
@@ -1454,6 +1467,8 @@ Ice::ObjectAdapterI::filterProperties(StringSeq& unknownProps)
         "ACM.Heartbeat",
         "ACM.Timeout",
         "AdapterId",
+        "Coalesce.Size",
+        "Coalesce.Window",
         "Endpoints",
         "Locator",
         "Locator.EncodingVersion",
@@ -104,6 +104,8 @@ public:
     IceInternal::ACMConfig getACM() const;
     void setAdapterOnConnection(const Ice::ConnectionIPtr&);
     size_t messageSizeMax() const { return _messageSizeMax; }
+    const IceUtil::Time& coalesceWindow() const { return _coalesceWindow; }
+    size_t coalesceSize() const { return _coalesceSize; }
 
     ObjectAdapterI(const IceInternal::InstancePtr&, const CommunicatorPtr&,
                    const IceInternal::ObjectAdapterFactoryPtr&, const std::string&, bool);
@@ -152,6 +154,8 @@ private:
     int _directCount; // The number of direct proxies dispatching on this object adapter.
     bool _noConfig;
     size_t _messageSizeMax;
+    IceUtil::Time _coalesceWindow;
+    size_t _coalesceSize;
 };
 
 }
@@ -261,6 +261,17 @@ OutgoingAsyncBase::cancel()
     cancel(Ice::InvocationCanceledException(__FILE__, __LINE__));
 }
 
+void
+OutgoingAsyncBase::writeBody()
+{
+    if(_body)
+    {
+        const pair<const Byte*, const Byte*>& params = _body->_getParams();
+        _os.writeBlob(params.first, static_cast<size_t>(params.second - params.first));
+        _body = ICE_NULLPTR;
+    }
+}
+
 OutgoingAsyncBase::OutgoingAsyncBase(const InstancePtr& instance) :
     _instance(instance),
     _sentSynchronously(false),
@@ -737,6 +748,14 @@ ProxyOutgoingAsyncBase::invokeImpl(bool userThread)
             {
                 _sent = false;
                 _handler = _proxy->_getRequestHandler();
+                if(userThread && _instance->flowControlWindow() > 0)
+                {
+                    Ice::ConnectionIPtr connection = _handler->getConnection();
+                    if(connection)
+                    {
+                        waitForSendWindow(connection);
+                    }
+                }
                 AsyncStatus status = _handler->sendAsyncRequest(ICE_SHARED_FROM_THIS);
                 if(status & AsyncStatusSent)
                 {
@@ -846,6 +865,11 @@ ProxyOutgoingAsyncBase::runTimerTask()
     }
 }
 
+void
+ProxyOutgoingAsyncBase::waitForSendWindow(const Ice::ConnectionIPtr&)
+{
+}
+
 OutgoingAsync::OutgoingAsync(const ObjectPrxPtr& prx, bool synchronous) :
     ProxyOutgoingAsyncBase(prx),
     _encoding(getCompatibleEncoding(prx->_getReference()->getEncoding())),
@@ -856,46 +880,10 @@ OutgoingAsync::OutgoingAsync(const ObjectPrxPtr& prx, bool synchronous) :
 void
 OutgoingAsync::prepare(const string& operation, OperationMode mode, const Context& context)
 {
-    checkSupportedProtocol(getCompatibleProtocol(_proxy->_getReference()->getProtocol()));
-
-    _mode = mode;
-    _observer.attach(_proxy, operation, context);
-
-    switch(_proxy->_getReference()->getMode())
-    {
-        case Reference::ModeTwoway:
-        case Reference::ModeOneway:
-        case Reference::ModeDatagram:
-        {
-            _os.writeBlob(requestHdr, sizeof(requestHdr));
-            break;
-        }
-
-        case Reference::ModeBatchOneway:
-        case Reference::ModeBatchDatagram:
-        {
-            _proxy->_getBatchRequestQueue()->prepareBatchRequest(&_os);
-            break;
-        }
-    }
+    prepareHeader(operation, mode, context);
 
     Reference* ref = _proxy->_getReference().get();
 
-    _os.write(ref->getIdentity());
-
-    //
-    // For compatibility with the old FacetPath.
-    //
-    if(ref->getFacet().empty())
-    {
-        _os.write(static_cast<string*>(0), static_cast<string*>(0));
-    }
-    else
-    {
-        string facet = ref->getFacet();
-        _os.write(&facet, &facet + 1);
-    }
-
     _os.write(operation, false);
 
     _os.write(static_cast<Byte>(_mode));
@@ -935,6 +923,77 @@ OutgoingAsync::prepare(const string& operation, OperationMode mode, const Contex
     }
 }
 
+void
+OutgoingAsync::prepare(const PreparedRequestPtr& request)
+{
+    if(request->_getInstance().get() != _instance.get())
+    {
+        throw IceUtil::IllegalArgumentException(__FILE__, __LINE__,
+                                                "prepared request created by another communicator");
+    }
+
+    prepareHeader(request->getOperation(), request->getMode(), request->getContext());
+    request->_write(&_os, _encoding);
+
+    //
+    // The in-parameters are sent from the prepared request, except for batch
+    // requests which are copied in the batch request queue.
+    //
+    if(request->_getParams().first != request->_getParams().second)
+    {
+        _body = request;
+        const Reference::Mode mode = _proxy->_getReference()->getMode();
+        if(mode == Reference::ModeBatchOneway || mode == Reference::ModeBatchDatagram)
+        {
+            writeBody();
+        }
+    }
+}
+
+void
+OutgoingAsync::prepareHeader(const string& operation, OperationMode mode, const Context& context)
+{
+    checkSupportedProtocol(getCompatibleProtocol(_proxy->_getReference()->getProtocol()));
+
+    _mode = mode;
+    _observer.attach(_proxy, operation, context);
+
+    switch(_proxy->_getReference()->getMode())
+    {
+        case Reference::ModeTwoway:
+        case Reference::ModeOneway:
+        case Reference::ModeDatagram:
+        {
+            _os.writeBlob(requestHdr, sizeof(requestHdr));
+            break;
+        }
+
+        case Reference::ModeBatchOneway:
+        case Reference::ModeBatchDatagram:
+        {
+            _proxy->_getBatchRequestQueue()->prepareBatchRequest(&_os);
+            break;
+        }
+    }
+
+    Reference* ref = _proxy->_getReference().get();
+
+    _os.write(ref->getIdentity());
+
+    //
+    // For compatibility with the old FacetPath.
+    //
+    if(ref->getFacet().empty())
+    {
+        _os.write(static_cast<string*>(0), static_cast<string*>(0));
+    }
+    else
+    {
+        string facet = ref->getFacet();
+        _os.write(&facet, &facet + 1);
+    }
+}
+
 bool
 OutgoingAsync::sent()
 {
@@ -1088,6 +1147,39 @@ OutgoingAsync::response()
     }
 }
 
+void
+OutgoingAsync::waitForSendWindow(const Ice::ConnectionIPtr& connection)
+{
+    //
+    // With the Fail policy, the invocation fails if the send queue of the
+    // connection is over the flow control window. With the Block policy,
+    // only the synchronous invocations of application threads wait for the
+    // queue to drain, for at most the invocation timeout. Blocking an Ice
+    // thread could prevent the queued messages from being sent, and the
+    // asynchronous invocations are throttled by waiting for the sent
+    // callback.
+    //
+    int timeout;
+    if(!_instance->flowControlBlock())
+    {
+        timeout = 0;
+    }
+    else if(_synchronous && !ThreadPool::isThreadPoolThread())
+    {
+        int invocationTimeout = _proxy->_getReference()->getInvocationTimeout();
+        timeout = invocationTimeout > 0 ? invocationTimeout : -1;
+    }
+    else
+    {
+        return;
+    }
+
+    if(!connection->waitForSendWindow(timeout))
+    {
+        throw InvocationTimeoutException(__FILE__, __LINE__);
+    }
+}
+
 AsyncStatus
 OutgoingAsync::invokeRemote(const ConnectionIPtr& connection, bool compress, bool response)
 {
@@ -1098,6 +1190,7 @@ OutgoingAsync::invokeRemote(const ConnectionIPtr& connection, bool compress, boo
 AsyncStatus
 OutgoingAsync::invokeCollocated(CollocatedRequestHandler* handler)
 {
+    writeBody(); // The collocated dispatch reads the request from the output stream.
     return handler->invokeAsyncRequest(this, 0, _synchronous);
 }
 
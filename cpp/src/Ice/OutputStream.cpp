@@ -904,6 +904,16 @@ Ice::OutputStream::EncapsEncoder::registerTypeId(const string& typeId)
     }
 }
 
+void
+Ice::OutputStream::EncapsEncoder::registerWrittenTypeId(const string& typeId)
+{
+    //
+    // The type ID was written as a string by another encoder, the receiver
+    // assigns it the next index even if it was already registered.
+    //
+    _typeIdMap.insert(make_pair(typeId, ++_typeIdIndex));
+}
+
 void
 Ice::OutputStream::EncapsEncoder10::write(const ValuePtr& v)
 {
@@ -1303,6 +1313,29 @@ Ice::OutputStream::EncapsEncoder11::writeSlicedData(const SlicedDataPtr& slicedD
         return;
     }
 
+    if(!slicedData->encoding.empty())
+    {
+        //
+        // The slices were preserved in pass-through mode, write them back
+        // verbatim. The string type IDs of value slices are registered as the
+        // receiver registers them when reading the slices, the slices don't
+        // refer to type IDs through indexes or to instances.
+        //
+        if(_current->sliceType == ValueSlice)
+        {
+            for(SliceInfoSeq::const_iterator p = slicedData->slices.begin(); p != slicedData->slices.end(); ++p)
+            {
+                if((*p)->compactId < 0)
+                {
+                    registerWrittenTypeId((*p)->typeId);
+                }
+            }
+        }
+        _stream->writeBlob(slicedData->encoding);
+        _current->firstSlice = false;
+        return;
+    }
+
     for(SliceInfoSeq::const_iterator p = slicedData->slices.begin(); p != slicedData->slices.end(); ++p)
     {
         startSlice((*p)->typeId, (*p)->compactId, (*p)->isLastSlice);
@@ -0,0 +1,106 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <Ice/PreparedRequest.h>
+#include <Ice/OutputStream.h>
+#include <Ice/Initialize.h>
+#include <Ice/Instance.h>
+#include <Ice/LocalException.h>
+
+using namespace std;
+using namespace Ice;
+using namespace IceInternal;
+
+Ice::PreparedRequest::PreparedRequest(const CommunicatorPtr& communicator,
+                                      const string& operation,
+                                      OperationMode mode,
+                                      const vector<Byte>& inParams,
+                                      const Context& context) :
+    _instance(getInstance(communicator)),
+    _operation(operation),
+    _mode(mode),
+    _context(context),
+    _params(static_cast<const Byte*>(0), static_cast<const Byte*>(0)),
+    _paramsCopy(inParams)
+{
+    if(!_paramsCopy.empty())
+    {
+        _params.first = &_paramsCopy[0];
+        _params.second = _params.first + _paramsCopy.size();
+    }
+    init();
+}
+
+Ice::PreparedRequest::PreparedRequest(const CommunicatorPtr& communicator,
+                                      const string& operation,
+                                      OperationMode mode,
+                                      const pair<const Byte*, const Byte*>& inParams,
+                                      const Context& context) :
+    _instance(getInstance(communicator)),
+    _operation(operation),
+    _mode(mode),
+    _context(context),
+    _params(static_cast<const Byte*>(0), static_cast<const Byte*>(0)),
+    _paramsCopy(inParams.first, inParams.second)
+{
+    if(!_paramsCopy.empty())
+    {
+        _params.first = &_paramsCopy[0];
+        _params.second = _params.first + _paramsCopy.size();
+    }
+    init();
+}
+
+Ice::PreparedRequest::PreparedRequest(const CommunicatorPtr& communicator,
+                                      const string& operation,
+                                      OperationMode mode,
+                                      const Context& context,
+                                      const pair<const Byte*, const Byte*>& inParams) :
+    _instance(getInstance(communicator)),
+    _operation(operation),
+    _mode(mode),
+    _context(context),
+    _params(inParams.first == inParams.second ? static_cast<const Byte*>(0) : inParams.first,
+            inParams.first == inParams.second ? static_cast<const Byte*>(0) : inParams.second)
+{
+    init();
+}
+
+#ifdef ICE_CPP11_MAPPING
+Ice::PreparedRequest::~PreparedRequest()
+{
+    // Out of line to avoid weak vtable
+}
+#endif
+
+void
+Ice::PreparedRequest::_write(OutputStream* os, const EncodingVersion& encoding) const
+{
+    os->writeBlob(_body);
+    if(_params.first == _params.second)
+    {
+        os->writeEmptyEncapsulation(encoding);
+    }
+}
+
+void
+Ice::PreparedRequest::init()
+{
+    if(_params.first != _params.second && _params.second - _params.first < 6)
+    {
+        throw EncapsulationException(__FILE__, __LINE__);
+    }
+
+    //
+    // The operation name, mode and context are marshaled like
+    // OutgoingAsync::prepare marshals them, with the string converters of
+    // the communicator.
+    //
+    OutputStream os(_instance.get(), currentProtocolEncoding);
+    os.reserve(_operation.size() + 16);
+    os.write(_operation, false);
+    os.write(static_cast<Byte>(_mode));
+    os.write(_context);
+    os.finished(_body);
+}
@@ -1,7 +1,7 @@
 //
 // Copyright (c) ZeroC, Inc. All rights reserved.
 //
-// Generated by makeprops.py from file ./config/PropertyNames.xml, Thu Jul  2 14:55:02 2020
+// Generated by makeprops.py from file ./config/PropertyNames.xml, Mon Oct 19 05:31:33 2026
 
 // IMPORTANT: Do not edit this file -- any edits made here will be lost!
 
@@ -29,6 +29,8 @@ const IceInternal::Property IcePropsData[] =
     IceInternal::Property("Ice.Admin.ACM.Close", false, 0),
     IceInternal::Property("Ice.Admin.ACM", false, 0),
     IceInternal::Property("Ice.Admin.AdapterId", false, 0),
+    IceInternal::Property("Ice.Admin.Coalesce.Size", false, 0),
+    IceInternal::Property("Ice.Admin.Coalesce.Window", false, 0),
     IceInternal::Property("Ice.Admin.Endpoints", false, 0),
     IceInternal::Property("Ice.Admin.Locator.EndpointSelection", false, 0),
     IceInternal::Property("Ice.Admin.Locator.ConnectionCached", false, 0),
@@ -113,6 +115,8 @@ const IceInternal::Property IcePropsData[] =
     IceInternal::Property("Ice.Default.Timeout", false, 0),
     IceInternal::Property("Ice.EventLog.Source", false, 0),
     IceInternal::Property("Ice.FactoryAssemblies", false, 0),
+    IceInternal::Property("Ice.FlowControl.Policy", false, 0),
+    IceInternal::Property("Ice.FlowControl.Window", false, 0),
     IceInternal::Property("Ice.HTTPProxyHost", false, 0),
     IceInternal::Property("Ice.HTTPProxyPort", false, 0),
     IceInternal::Property("Ice.ImplicitContext", false, 0),
@@ -131,6 +135,9 @@ const IceInternal::Property IcePropsData[] =
     IceInternal::Property("Ice.Override.Timeout", false, 0),
     IceInternal::Property("Ice.Override.Secure", false, 0),
     IceInternal::Property("Ice.Package.*", false, 0),
+    IceInternal::Property("Ice.ParallelConnect", false, 0),
+    IceInternal::Property("Ice.ParallelConnect.Stagger", false, 0),
+    IceInternal::Property("Ice.PassThroughSlices", false, 0),
     IceInternal::Property("Ice.Plugin.*", false, 0),
     IceInternal::Property("Ice.PluginLoadOrder", false, 0),
     IceInternal::Property("Ice.PreferIPv6Address", false, 0),
@@ -216,6 +223,8 @@ const IceInternal::Property IceDiscoveryPropsData[] =
     IceInternal::Property("IceDiscovery.Multicast.ACM.Close", false, 0),
     IceInternal::Property("IceDiscovery.Multicast.ACM", false, 0),
     IceInternal::Property("IceDiscovery.Multicast.AdapterId", false, 0),
+    IceInternal::Property("IceDiscovery.Multicast.Coalesce.Size", false, 0),
+    IceInternal::Property("IceDiscovery.Multicast.Coalesce.Window", false, 0),
     IceInternal::Property("IceDiscovery.Multicast.Endpoints", false, 0),
     IceInternal::Property("IceDiscovery.Multicast.Locator.EndpointSelection", false, 0),
     IceInternal::Property("IceDiscovery.Multicast.Locator.ConnectionCached", false, 0),
@@ -253,6 +262,8 @@ const IceInternal::Property IceDiscoveryPropsData[] =
     IceInternal::Property("IceDiscovery.Reply.ACM.Close", false, 0),
     IceInternal::Property("IceDiscovery.Reply.ACM", false, 0),
     IceInternal::Property("IceDiscovery.Reply.AdapterId", false, 0),
+    IceInternal::Property("IceDiscovery.Reply.Coalesce.Size", false, 0),
+    IceInternal::Property("IceDiscovery.Reply.Coalesce.Window", false, 0),
     IceInternal::Property("IceDiscovery.Reply.Endpoints", false, 0),
     IceInternal::Property("IceDiscovery.Reply.Locator.EndpointSelection", false, 0),
     IceInternal::Property("IceDiscovery.Reply.Locator.ConnectionCached", false, 0),
@@ -290,6 +301,8 @@ const IceInternal::Property IceDiscoveryPropsData[] =
     IceInternal::Property("IceDiscovery.Locator.ACM.Close", false, 0),
     IceInternal::Property("IceDiscovery.Locator.ACM", false, 0),
     IceInternal::Property("IceDiscovery.Locator.AdapterId", false, 0),
+    IceInternal::Property("IceDiscovery.Locator.Coalesce.Size", false, 0),
+    IceInternal::Property("IceDiscovery.Locator.Coalesce.Window", false, 0),
     IceInternal::Property("IceDiscovery.Locator.Endpoints", false, 0),
     IceInternal::Property("IceDiscovery.Locator.Locator.EndpointSelection", false, 0),
     IceInternal::Property("IceDiscovery.Locator.Locator.ConnectionCached", false, 0),
@@ -343,6 +356,8 @@ const IceInternal::Property IceLocatorDiscoveryPropsData[] =
     IceInternal::Property("IceLocatorDiscovery.Reply.ACM.Close", false, 0),
     IceInternal::Property("IceLocatorDiscovery.Reply.ACM", false, 0),
     IceInternal::Property("IceLocatorDiscovery.Reply.AdapterId", false, 0),
+    IceInternal::Property("IceLocatorDiscovery.Reply.Coalesce.Size", false, 0),
+    IceInternal::Property("IceLocatorDiscovery.Reply.Coalesce.Window", false, 0),
     IceInternal::Property("IceLocatorDiscovery.Reply.Endpoints", false, 0),
     IceInternal::Property("IceLocatorDiscovery.Reply.Locator.EndpointSelection", false, 0),
     IceInternal::Property("IceLocatorDiscovery.Reply.Locator.ConnectionCached", false, 0),
@@ -380,6 +395,8 @@ const IceInternal::Property IceLocatorDiscoveryPropsData[] =
     IceInternal::Property("IceLocatorDiscovery.Locator.ACM.Close", false, 0),
     IceInternal::Property("IceLocatorDiscovery.Locator.ACM", false, 0),
     IceInternal::Property("IceLocatorDiscovery.Locator.AdapterId", false, 0),
+    IceInternal::Property("IceLocatorDiscovery.Locator.Coalesce.Size", false, 0),
+    IceInternal::Property("IceLocatorDiscovery.Locator.Coalesce.Window", false, 0),
     IceInternal::Property("IceLocatorDiscovery.Locator.Endpoints", false, 0),
     IceInternal::Property("IceLocatorDiscovery.Locator.Locator.EndpointSelection", false, 0),
     IceInternal::Property("IceLocatorDiscovery.Locator.Locator.ConnectionCached", false, 0),
@@ -477,6 +494,8 @@ const IceInternal::Property IceBridgePropsData[] =
     IceInternal::Property("IceBridge.Source.ACM.Close", false, 0),
     IceInternal::Property("IceBridge.Source.ACM", false, 0),
     IceInternal::Property("IceBridge.Source.AdapterId", false, 0),
+    IceInternal::Property("IceBridge.Source.Coalesce.Size", false, 0),
+    IceInternal::Property("IceBridge.Source.Coalesce.Window", false, 0),
     IceInternal::Property("IceBridge.Source.Endpoints", false, 0),
     IceInternal::Property("IceBridge.Source.Locator.EndpointSelection", false, 0),
     IceInternal::Property("IceBridge.Source.Locator.ConnectionCached", false, 0),
@@ -532,6 +551,8 @@ const IceInternal::Property IceGridAdminPropsData[] =
     IceInternal::Property("IceGridAdmin.Server.ACM.Close", false, 0),
     IceInternal::Property("IceGridAdmin.Server.ACM", false, 0),
     IceInternal::Property("IceGridAdmin.Server.AdapterId", false, 0),
+    IceInternal::Property("IceGridAdmin.Server.Coalesce.Size", false, 0),
+    IceInternal::Property("IceGridAdmin.Server.Coalesce.Window", false, 0),
     IceInternal::Property("IceGridAdmin.Server.Endpoints", false, 0),
     IceInternal::Property("IceGridAdmin.Server.Locator.EndpointSelection", false, 0),
     IceInternal::Property("IceGridAdmin.Server.Locator.ConnectionCached", false, 0),
@@ -572,6 +593,8 @@ const IceInternal::Property IceGridAdminPropsData[] =
     IceInternal::Property("IceGridAdmin.Discovery.Reply.ACM.Close", false, 0),
     IceInternal::Property("IceGridAdmin.Discovery.Reply.ACM", false, 0),
     IceInternal::Property("IceGridAdmin.Discovery.Reply.AdapterId", false, 0),
+    IceInternal::Property("IceGridAdmin.Discovery.Reply.Coalesce.Size", false, 0),
+    IceInternal::Property("IceGridAdmin.Discovery.Reply.Coalesce.Window", false, 0),
     IceInternal::Property("IceGridAdmin.Discovery.Reply.Endpoints", false, 0),
     IceInternal::Property("IceGridAdmin.Discovery.Reply.Locator.EndpointSelection", false, 0),
     IceInternal::Property("IceGridAdmin.Discovery.Reply.Locator.ConnectionCached", false, 0),
@@ -609,6 +632,8 @@ const IceInternal::Property IceGridAdminPropsData[] =
     IceInternal::Property("IceGridAdmin.Discovery.Locator.ACM.Close", false, 0),
     IceInternal::Property("IceGridAdmin.Discovery.Locator.ACM", false, 0),
     IceInternal::Property("IceGridAdmin.Discovery.Locator.AdapterId", false, 0),
+    IceInternal::Property("IceGridAdmin.Discovery.Locator.Coalesce.Size", false, 0),
+    IceInternal::Property("IceGridAdmin.Discovery.Locator.Coalesce.Window", false, 0),
     IceInternal::Property("IceGridAdmin.Discovery.Locator.Endpoints", false, 0),
     IceInternal::Property("IceGridAdmin.Discovery.Locator.Locator.EndpointSelection", false, 0),
     IceInternal::Property("IceGridAdmin.Discovery.Locator.Locator.ConnectionCached", false, 0),
@@ -656,6 +681,8 @@ const IceInternal::Property IceGridPropsData[] =
     IceInternal::Property("IceGrid.AdminRouter.ACM.Close", false, 0),
     IceInternal::Property("IceGrid.AdminRouter.ACM", false, 0),
     IceInternal::Property("IceGrid.AdminRouter.AdapterId", false, 0),
+    IceInternal::Property("IceGrid.AdminRouter.Coalesce.Size", false, 0),
+    IceInternal::Property("IceGrid.AdminRouter.Coalesce.Window", false, 0),
     IceInternal::Property("IceGrid.AdminRouter.Endpoints", false, 0),
     IceInternal::Property("IceGrid.AdminRouter.Locator.EndpointSelection", false, 0),
     IceInternal::Property("IceGrid.AdminRouter.Locator.ConnectionCached", false, 0),
@@ -694,6 +721,8 @@ const IceInternal::Property IceGridPropsData[] =
     IceInternal::Property("IceGrid.Node.ACM.Close", false, 0),
     IceInternal::Property("IceGrid.Node.ACM", false, 0),
     IceInternal::Property("IceGrid.Node.AdapterId", false, 0),
+    IceInternal::Property("IceGrid.Node.Coalesce.Size", false, 0),
+    IceInternal::Property("IceGrid.Node.Coalesce.Window", false, 0),
     IceInternal::Property("IceGrid.Node.Endpoints", false, 0),
     IceInternal::Property("IceGrid.Node.Locator.EndpointSelection", false, 0),
     IceInternal::Property("IceGrid.Node.Locator.ConnectionCached", false, 0),
@@ -772,6 +801,8 @@ const IceInternal::Property IceGridPropsData[] =
     IceInternal::Property("IceGrid.Registry.AdminSessionManager.ACM.Close", false, 0),
     IceInternal::Property("IceGrid.Registry.AdminSessionManager.ACM", false, 0),
     IceInternal::Property("IceGrid.Registry.AdminSessionManager.AdapterId", false, 0),
+    IceInternal::Property("IceGrid.Registry.AdminSessionManager.Coalesce.Size", false, 0),
+    IceInternal::Property("IceGrid.Registry.AdminSessionManager.Coalesce.Window", false, 0),
     IceInternal::Property("IceGrid.Registry.AdminSessionManager.Endpoints", false, 0),
     IceInternal::Property("IceGrid.Registry.AdminSessionManager.Locator.EndpointSelection", false, 0),
     IceInternal::Property("IceGrid.Registry.AdminSessionManager.Locator.ConnectionCached", false, 0),
@@ -819,6 +850,8 @@ const IceInternal::Property IceGridPropsData[] =
     IceInternal::Property("IceGrid.Registry.Client.ACM.Close", false, 0),
     IceInternal::Property("IceGrid.Registry.Client.ACM", false, 0),
     IceInternal::Property("IceGrid.Registry.Client.AdapterId", false, 0),
+    IceInternal::Property("IceGrid.Registry.Client.Coalesce.Size", false, 0),
+    IceInternal::Property("IceGrid.Registry.Client.Coalesce.Window", false, 0),
     IceInternal::Property("IceGrid.Registry.Client.Endpoints", false, 0),
     IceInternal::Property("IceGrid.Registry.Client.Locator.EndpointSelection", false, 0),
     IceInternal::Property("IceGrid.Registry.Client.Locator.ConnectionCached", false, 0),
@@ -858,6 +891,8 @@ const IceInternal::Property IceGridPropsData[] =
     IceInternal::Property("IceGrid.Registry.Discovery.ACM.Close", false, 0),
     IceInternal::Property("IceGrid.Registry.Discovery.ACM", false, 0),
     IceInternal::Property("IceGrid.Registry.Discovery.AdapterId", false, 0),
+    IceInternal::Property("IceGrid.Registry.Discovery.Coalesce.Size", false, 0),
+    IceInternal::Property("IceGrid.Registry.Discovery.Coalesce.Window", false, 0),
     IceInternal::Property("IceGrid.Registry.Discovery.Endpoints", false, 0),
     IceInternal::Property("IceGrid.Registry.Discovery.Locator.EndpointSelection", false, 0),
     IceInternal::Property("IceGrid.Registry.Discovery.Locator.ConnectionCached", false, 0),
@@ -900,6 +935,8 @@ const IceInternal::Property IceGridPropsData[] =
     IceInternal::Property("IceGrid.Registry.Internal.ACM.Close", false, 0),
     IceInternal::Property("IceGrid.Registry.Internal.ACM", false, 0),
     IceInternal::Property("IceGrid.Registry.Internal.AdapterId", false, 0),
+    IceInternal::Property("IceGrid.Registry.Internal.Coalesce.Size", false, 0),
+    IceInternal::Property("IceGrid.Registry.Internal.Coalesce.Window", false, 0),
     IceInternal::Property("IceGrid.Registry.Internal.Endpoints", false, 0),
     IceInternal::Property("IceGrid.Registry.Internal.Locator.EndpointSelection", false, 0),
     IceInternal::Property("IceGrid.Registry.Internal.Locator.ConnectionCached", false, 0),
@@ -954,6 +991,8 @@ const IceInternal::Property IceGridPropsData[] =
     IceInternal::Property("IceGrid.Registry.Server.ACM.Close", false, 0),
     IceInternal::Property("IceGrid.Registry.Server.ACM", false, 0),
     IceInternal::Property("IceGrid.Registry.Server.AdapterId", false, 0),
+    IceInternal::Property("IceGrid.Registry.Server.Coalesce.Size", false, 0),
+    IceInternal::Property("IceGrid.Registry.Server.Coalesce.Window", false, 0),
     IceInternal::Property("IceGrid.Registry.Server.Endpoints", false, 0),
     IceInternal::Property("IceGrid.Registry.Server.Locator.EndpointSelection", false, 0),
     IceInternal::Property("IceGrid.Registry.Server.Locator.ConnectionCached", false, 0),
@@ -992,6 +1031,8 @@ const IceInternal::Property IceGridPropsData[] =
     IceInternal::Property("IceGrid.Registry.SessionManager.ACM.Close", false, 0),
     IceInternal::Property("IceGrid.Registry.SessionManager.ACM", false, 0),
     IceInternal::Property("IceGrid.Registry.SessionManager.AdapterId", false, 0),
+    IceInternal::Property("IceGrid.Registry.SessionManager.Coalesce.Size", false, 0),
+    IceInternal::Property("IceGrid.Registry.SessionManager.Coalesce.Window", false, 0),
     IceInternal::Property("IceGrid.Registry.SessionManager.Endpoints", false, 0),
     IceInternal::Property("IceGrid.Registry.SessionManager.Locator.EndpointSelection", false, 0),
     IceInternal::Property("IceGrid.Registry.SessionManager.Locator.ConnectionCached", false, 0),
@@ -1063,6 +1104,8 @@ const IceInternal::Property IcePatch2PropsData[] =
     IceInternal::Property("IcePatch2.ACM.Close", false, 0),
     IceInternal::Property("IcePatch2.ACM", false, 0),
     IceInternal::Property("IcePatch2.AdapterId", false, 0),
+    IceInternal::Property("IcePatch2.Coalesce.Size", false, 0),
+    IceInternal::Property("IcePatch2.Coalesce.Window", false, 0),
     IceInternal::Property("IcePatch2.Endpoints", false, 0),
     IceInternal::Property("IcePatch2.Locator.EndpointSelection", false, 0),
     IceInternal::Property("IcePatch2.Locator.ConnectionCached", false, 0),
@@ -1196,6 +1239,8 @@ const IceInternal::Property Glacier2PropsData[] =
     IceInternal::Property("Glacier2.Client.ACM.Close", false, 0),
     IceInternal::Property("Glacier2.Client.ACM", false, 0),
     IceInternal::Property("Glacier2.Client.AdapterId", false, 0),
+    IceInternal::Property("Glacier2.Client.Coalesce.Size", false, 0),
+    IceInternal::Property("Glacier2.Client.Coalesce.Window", false, 0),
     IceInternal::Property("Glacier2.Client.Endpoints", false, 0),
     IceInternal::Property("Glacier2.Client.Locator.EndpointSelection", false, 0),
     IceInternal::Property("Glacier2.Client.Locator.ConnectionCached", false, 0),
@@ -1271,6 +1316,8 @@ const IceInternal::Property Glacier2PropsData[] =
     IceInternal::Property("Glacier2.Server.ACM.Close", false, 0),
     IceInternal::Property("Glacier2.Server.ACM", false, 0),
     IceInternal::Property("Glacier2.Server.AdapterId", false, 0),
+    IceInternal::Property("Glacier2.Server.Coalesce.Size", false, 0),
+    IceInternal::Property("Glacier2.Server.Coalesce.Window", false, 0),
     IceInternal::Property("Glacier2.Server.Endpoints", false, 0),
     IceInternal::Property("Glacier2.Server.Locator.EndpointSelection", false, 0),
     IceInternal::Property("Glacier2.Server.Locator.ConnectionCached", false, 0),
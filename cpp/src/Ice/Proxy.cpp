@@ -531,6 +531,25 @@ IceProxy::Ice::Object::_iceI_begin_ice_invoke(const string& operation,
     return result;
 }
 
+AsyncResultPtr
+IceProxy::Ice::Object::_iceI_begin_ice_invoke(const PreparedRequestPtr& request,
+                                              const ::IceInternal::CallbackBasePtr& del,
+                                              const ::Ice::LocalObjectPtr& cookie,
+                                              bool sync)
+{
+    OutgoingAsyncPtr result = new CallbackOutgoing(this, ice_invoke_name, del, cookie, sync);
+    try
+    {
+        result->prepare(request);
+        result->invoke(request->getOperation());
+    }
+    catch(const Exception& ex)
+    {
+        result->abort(ex);
+    }
+    return result;
+}
+
 bool
 IceProxy::Ice::Object::_iceI_end_ice_invoke(pair<const Byte*, const Byte*>& outEncaps, const AsyncResultPtr& result)
 {
@@ -892,14 +911,19 @@ ICE_OBJECT_PRX::ice_getEndpointSelection() const
 ObjectPrxPtr
 ICE_OBJECT_PRX::ice_endpointSelection(EndpointSelectionType newType) const
 {
-    if(newType == _reference->getEndpointSelection())
+    //
+    // The reference decides if it changes, the C++ only Latency selection
+    // is reset even if the selection type is the same.
+    //
+    ReferencePtr ref = _reference->changeEndpointSelection(newType);
+    if(ref == _reference)
     {
         return CONST_POINTER_CAST_OBJECT_PRX;
     }
     else
     {
         ObjectPrxPtr proxy = _newInstance();
-        proxy->setup(_reference->changeEndpointSelection(newType));
+        proxy->setup(ref);
         return proxy;
     }
 }
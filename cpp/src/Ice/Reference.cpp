@@ -706,8 +706,12 @@ IceInternal::FixedReference::changePreferSecure(bool) const
 }
 
 ReferencePtr
-IceInternal::FixedReference::changeEndpointSelection(EndpointSelectionType) const
+IceInternal::FixedReference::changeEndpointSelection(EndpointSelectionType newType) const
 {
+    if(newType == getEndpointSelection())
+    {
+        return FixedReferencePtr(const_cast<FixedReference*>(this));
+    }
     throw FixedProxyException(__FILE__, __LINE__);
 }
 
@@ -903,6 +907,7 @@ IceInternal::RoutableReference::RoutableReference(const InstancePtr& instance,
                                                   bool cacheConnection,
                                                   bool preferSecure,
                                                   EndpointSelectionType endpointSelection,
+                                                  bool latencySelection,
                                                   int locatorCacheTimeout,
                                                   int invocationTimeout,
                                                   const Ice::Context& ctx) :
@@ -915,6 +920,7 @@ IceInternal::RoutableReference::RoutableReference(const InstancePtr& instance,
     _cacheConnection(cacheConnection),
     _preferSecure(preferSecure),
     _endpointSelection(endpointSelection),
+    _latencySelection(latencySelection),
     _locatorCacheTimeout(locatorCacheTimeout),
     _overrideTimeout(false),
     _timeout(-1)
@@ -1112,12 +1118,13 @@ IceInternal::RoutableReference::changePreferSecure(bool newPreferSecure) const
 ReferencePtr
 IceInternal::RoutableReference::changeEndpointSelection(EndpointSelectionType newType) const
 {
-    if(newType == _endpointSelection)
+    if(newType == _endpointSelection && !_latencySelection)
     {
         return RoutableReferencePtr(const_cast<RoutableReference*>(this));
     }
     RoutableReferencePtr r = RoutableReferencePtr::dynamicCast(getInstance()->referenceFactory()->copy(this));
     r->_endpointSelection = newType;
+    r->_latencySelection = false;
     return r;
 }
 
@@ -1288,7 +1295,15 @@ IceInternal::RoutableReference::toProperty(const string& prefix) const
     properties[prefix + ".CollocationOptimized"] = _collocationOptimized ? "1" : "0";
     properties[prefix + ".ConnectionCached"] = _cacheConnection ? "1" : "0";
     properties[prefix + ".PreferSecure"] = _preferSecure ? "1" : "0";
-    properties[prefix + ".EndpointSelection"] = _endpointSelection == ICE_ENUM(EndpointSelectionType, Random) ? "Random" : "Ordered";
+    if(_latencySelection)
+    {
+        properties[prefix + ".EndpointSelection"] = "Latency";
+    }
+    else
+    {
+        properties[prefix + ".EndpointSelection"] =
+            _endpointSelection == ICE_ENUM(EndpointSelectionType, Random) ? "Random" : "Ordered";
+    }
     {
         ostringstream s;
         s << _locatorCacheTimeout;
@@ -1360,6 +1375,10 @@ IceInternal::RoutableReference::operator==(const Reference& r) const
     {
         return false;
     }
+    if(_latencySelection != rhs->_latencySelection)
+    {
+        return false;
+    }
     if(_connectionId != rhs->_connectionId)
     {
         return false;
@@ -1456,6 +1475,14 @@ IceInternal::RoutableReference::operator<(const Reference& r) const
     {
         return false;
     }
+    if(!_latencySelection && rhs->_latencySelection)
+    {
+        return true;
+    }
+    else if(rhs->_latencySelection < _latencySelection)
+    {
+        return false;
+    }
     if(_connectionId < rhs->_connectionId)
     {
         return true;
@@ -1873,6 +1900,7 @@ IceInternal::RoutableReference::RoutableReference(const RoutableReference& r) :
     _cacheConnection(r._cacheConnection),
     _preferSecure(r._preferSecure),
     _endpointSelection(r._endpointSelection),
+    _latencySelection(r._latencySelection),
     _locatorCacheTimeout(r._locatorCacheTimeout),
     _overrideTimeout(r._overrideTimeout),
     _timeout(r._timeout),
@@ -1972,6 +2000,15 @@ IceInternal::RoutableReference::filterEndpoints(const vector<EndpointIPtr>& allE
         case ICE_ENUM(EndpointSelectionType, Random):
         {
             IceUtilInternal::shuffle(endpoints.begin(), endpoints.end());
+            if(_latencySelection)
+            {
+                //
+                // The shuffle spreads the connections over the endpoints with
+                // the same latency, the outgoing connection factory keeps track
+                // of the latency of the endpoints.
+                //
+                getInstance()->outgoingConnectionFactory()->sortByLatency(endpoints);
+            }
             break;
         }
         case ICE_ENUM(EndpointSelectionType, Ordered):
@@ -241,7 +241,7 @@ public:
     RoutableReference(const InstancePtr&, const Ice::CommunicatorPtr&, const Ice::Identity&, const std::string&, Mode,
                       bool, const Ice::ProtocolVersion&, const Ice::EncodingVersion&, const std::vector<EndpointIPtr>&,
                       const std::string&, const LocatorInfoPtr&, const RouterInfoPtr&, bool, bool, bool,
-                      Ice::EndpointSelectionType, int, int, const Ice::Context&);
+                      Ice::EndpointSelectionType, bool, int, int, const Ice::Context&);
 
     virtual std::vector<EndpointIPtr> getEndpoints() const;
     virtual std::string getAdapterId() const;
@@ -311,6 +311,7 @@ private:
     bool _cacheConnection;
     bool _preferSecure;
     Ice::EndpointSelectionType _endpointSelection;
+    bool _latencySelection; // The endpoints are sorted by latency after being shuffled (C++ only).
     int _locatorCacheTimeout;
 
     bool _overrideTimeout;
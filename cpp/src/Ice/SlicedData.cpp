@@ -25,11 +25,18 @@ Ice::SlicedData::SlicedData(const SliceInfoSeq& seq) :
 {
 }
 
+Ice::SlicedData::SlicedData(const SliceInfoSeq& seq, const Byte* begin, const Byte* end) :
+    slices(seq),
+    encoding(begin, end)
+{
+}
+
 void
 Ice::SlicedData::clear()
 {
     SliceInfoSeq tmp;
     tmp.swap(const_cast<SliceInfoSeq&>(slices));
+    vector<Byte>().swap(const_cast<vector<Byte>&>(encoding));
     for(SliceInfoSeq::const_iterator p = tmp.begin(); p != tmp.end(); ++p)
     {
         for(vector<ValuePtr>::const_iterator q = (*p)->instances.begin(); q != (*p)->instances.end(); ++q)
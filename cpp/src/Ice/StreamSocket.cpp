@@ -6,6 +6,10 @@
 #include <Ice/NetworkProxy.h>
 #include <Ice/ProtocolInstance.h>
 
+#if !defined(_WIN32)
+#   include <sys/uio.h>
+#endif
+
 using namespace IceInternal;
 
 #if defined(ICE_OS_UWP)
@@ -222,6 +226,86 @@ StreamSocket::write(Buffer& buf)
     return buf.i != buf.b.end() ? SocketOperationWrite : SocketOperationNone;
 }
 
+SocketOperation
+StreamSocket::writeGather(Buffer& buf, Buffer& body)
+{
+#if !defined(_WIN32)
+    if(_state == StateConnected)
+    {
+        //
+        // Write the two buffers with a single system call.
+        //
+        while(buf.i != buf.b.end() || body.i != body.b.end())
+        {
+            struct iovec iov[2];
+            int count = 0;
+            if(buf.i != buf.b.end())
+            {
+                iov[count].iov_base = &*buf.i;
+                iov[count].iov_len = static_cast<size_t>(buf.b.end() - buf.i);
+                ++count;
+            }
+            if(body.i != body.b.end())
+            {
+                iov[count].iov_base = &*body.i;
+                iov[count].iov_len = static_cast<size_t>(body.b.end() - body.i);
+                ++count;
+            }
+
+            ssize_t ret = ::writev(_fd, iov, count);
+            if(ret == 0)
+            {
+                throw Ice::ConnectionLostException(__FILE__, __LINE__, 0);
+            }
+            else if(ret == SOCKET_ERROR)
+            {
+                if(interrupted())
+                {
+                    continue;
+                }
+
+                if(wouldBlock())
+                {
+                    return SocketOperationWrite;
+                }
+
+                if(connectionLost())
+                {
+                    throw Ice::ConnectionLostException(__FILE__, __LINE__, getSocketErrno());
+                }
+                else
+                {
+                    throw Ice::SocketException(__FILE__, __LINE__, getSocketErrno());
+                }
+            }
+
+            size_t n = static_cast<size_t>(ret);
+            size_t remaining = static_cast<size_t>(buf.b.end() - buf.i);
+            if(n <= remaining)
+            {
+                buf.i += n;
+            }
+            else
+            {
+                buf.i = buf.b.end();
+                body.i += n - remaining;
+            }
+        }
+        return SocketOperationNone;
+    }
+#endif
+
+    if(buf.i != buf.b.end())
+    {
+        SocketOperation op = write(buf);
+        if(op)
+        {
+            return op;
+        }
+    }
+    return body.i != body.b.end() ? write(body) : SocketOperationNone;
+}
+
 #if !defined(ICE_OS_UWP)
 ssize_t
 StreamSocket::read(char* buf, size_t length)
@@ -30,6 +30,7 @@ public:
 
     SocketOperation read(Buffer&);
     SocketOperation write(Buffer&);
+    SocketOperation writeGather(Buffer&, Buffer&);
 
 #if !defined(ICE_OS_UWP)
     ssize_t read(char*, size_t);
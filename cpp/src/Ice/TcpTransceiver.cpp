@@ -49,6 +49,12 @@ IceInternal::TcpTransceiver::write(Buffer& buf)
     return _stream->write(buf);
 }
 
+SocketOperation
+IceInternal::TcpTransceiver::writeGather(Buffer& buf, Buffer& body)
+{
+    return _stream->writeGather(buf, body);
+}
+
 SocketOperation
 IceInternal::TcpTransceiver::read(Buffer& buf)
 {
@@ -12,11 +12,16 @@
 #include <Ice/ObjectAdapterFactory.h>
 #include <Ice/Properties.h>
 #include <Ice/TraceLevels.h>
+#include <IceUtil/ThreadException.h>
 
 #if defined(ICE_OS_UWP)
 #   include <Ice/StringConverter.h>
 #endif
 
+#ifndef _WIN32
+#   include <pthread.h>
+#endif
+
 using namespace std;
 using namespace Ice;
 using namespace Ice::Instrumentation;
@@ -27,6 +32,48 @@ ICE_API IceUtil::Shared* IceInternal::upCast(ThreadPool* p) { return p; }
 namespace
 {
 
+//
+// Set to the thread pool of the thread pool threads.
+//
+#ifdef _WIN32
+DWORD threadPoolKey;
+#else
+pthread_key_t threadPoolKey;
+#endif
+
+class Init
+{
+public:
+
+    Init()
+    {
+#ifdef _WIN32
+        threadPoolKey = TlsAlloc();
+        if(threadPoolKey == TLS_OUT_OF_INDEXES)
+        {
+            throw IceUtil::ThreadSyscallException(__FILE__, __LINE__, GetLastError());
+        }
+#else
+        int err = pthread_key_create(&threadPoolKey, 0);
+        if(err != 0)
+        {
+            throw IceUtil::ThreadSyscallException(__FILE__, __LINE__, err);
+        }
+#endif
+    }
+
+    ~Init()
+    {
+#ifdef _WIN32
+        TlsFree(threadPoolKey);
+#else
+        pthread_key_delete(threadPoolKey);
+#endif
+    }
+};
+
+Init init;
+
 class ShutdownWorkItem : public ThreadPoolWorkItem
 {
 public:
@@ -653,6 +700,16 @@ IceInternal::ThreadPool::prefix() const
     return _prefix;
 }
 
+bool
+IceInternal::ThreadPool::isThreadPoolThread()
+{
+#ifdef _WIN32
+    return TlsGetValue(threadPoolKey) != 0;
+#else
+    return pthread_getspecific(threadPoolKey) != 0;
+#endif
+}
+
 #ifdef ICE_SWIFT
 
 dispatch_queue_t
@@ -1237,6 +1294,19 @@ IceInternal::ThreadPool::EventHandlerThread::setState(Ice::Instrumentation::Thre
 void
 IceInternal::ThreadPool::EventHandlerThread::run()
 {
+#ifdef _WIN32
+    if(TlsSetValue(threadPoolKey, _pool.get()) == 0)
+    {
+        throw IceUtil::ThreadSyscallException(__FILE__, __LINE__, GetLastError());
+    }
+#else
+    int err = pthread_setspecific(threadPoolKey, _pool.get());
+    if(err != 0)
+    {
+        throw IceUtil::ThreadSyscallException(__FILE__, __LINE__, err);
+    }
+#endif
+
 #ifdef ICE_CPP11_MAPPING
     if(_pool->_instance->initializationData().threadStart)
 #else
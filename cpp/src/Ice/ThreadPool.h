@@ -110,6 +110,11 @@ public:
 
     std::string prefix() const;
 
+    //
+    // Returns true if the calling thread is a thread of a thread pool.
+    //
+    static bool isThreadPoolThread();
+
 #ifdef ICE_SWIFT
     dispatch_queue_t getDispatchQueue() const ICE_NOEXCEPT;
 #endif
@@ -3,6 +3,7 @@
 //
 
 #include <Ice/Transceiver.h>
+#include <Ice/Buffer.h>
 
 using namespace std;
 using namespace Ice;
@@ -16,3 +17,17 @@ IceInternal::Transceiver::bind()
     assert(false);
     return 0;
 }
+
+SocketOperation
+IceInternal::Transceiver::writeGather(Buffer& buf, Buffer& body)
+{
+    if(buf.i != buf.b.end())
+    {
+        SocketOperation op = write(buf);
+        if(op)
+        {
+            return op;
+        }
+    }
+    return body.i != body.b.end() ? write(body) : SocketOperationNone;
+}
@@ -29,6 +29,13 @@ public:
     virtual EndpointIPtr bind();
     virtual SocketOperation write(Buffer&) = 0;
     virtual SocketOperation read(Buffer&) = 0;
+
+    //
+    // Writes a message from two buffers, the second buffer is written once
+    // the first buffer is written. By default, the buffers are written with
+    // successive calls to write.
+    //
+    virtual SocketOperation writeGather(Buffer&, Buffer&);
 #if defined(ICE_USE_IOCP) || defined(ICE_OS_UWP)
     virtual bool startWrite(Buffer&) = 0;
     virtual void finishWrite(Buffer&) = 0;
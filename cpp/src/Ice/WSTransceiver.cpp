@@ -62,6 +62,122 @@ namespace
 const string _iceProtocol = "ice.zeroc.com";
 const string _wsUUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
 
+//
+// Helpers to check the upgrade request and response header fields in place,
+// without copying them to temporary strings.
+//
+inline char
+toLowerASCII(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+bool
+equalsIgnoreCase(const char* begin, const char* end, const string& value)
+{
+    if(static_cast<size_t>(end - begin) != value.size())
+    {
+        return false;
+    }
+    for(string::const_iterator p = value.begin(); p != value.end(); ++p, ++begin)
+    {
+        if(toLowerASCII(*begin) != toLowerASCII(*p))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool
+containsIgnoreCase(const char* begin, const char* end, const string& value)
+{
+    for(; static_cast<size_t>(end - begin) >= value.size(); ++begin)
+    {
+        if(equalsIgnoreCase(begin, begin + value.size(), value))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//
+// Returns the number of bytes Base64::decode would produce for the given
+// range, characters which are not part of the Base64 alphabet are ignored.
+//
+size_t
+decodedBase64Length(const char* begin, const char* end)
+{
+    size_t length = 0;
+    size_t count = 0;
+    for(; begin != end; ++begin)
+    {
+        if(Base64::isBase64(*begin))
+        {
+            //
+            // Each group of 4 characters decodes to 3 bytes minus the padding.
+            //
+            size_t n = count++ % 4;
+            if(n == 0 || ((n == 2 || n == 3) && *begin != '='))
+            {
+                ++length;
+            }
+        }
+    }
+
+    //
+    // A partial group is decoded as if padded with 'A'.
+    //
+    if(count % 4 == 1 || count % 4 == 2)
+    {
+        length += 2;
+    }
+    else if(count % 4 == 3)
+    {
+        ++length;
+    }
+    return length;
+}
+
+//
+// Computes the Base64-encoded SHA-1 hash of the key concatenated with the
+// WebSocket GUID.
+//
+string
+computeAccept(const char* begin, const char* end)
+{
+    //
+    // A valid key is 24 characters long, the stack buffer is large enough
+    // for any key that passed the length check of the decoded key.
+    //
+    char input[256];
+    const size_t keyLength = static_cast<size_t>(end - begin);
+    if(keyLength + _wsUUID.size() > sizeof(input))
+    {
+        throw WebSocketException("invalid value `" + string(begin, end) + "' for WebSocket key");
+    }
+    memcpy(input, begin, keyLength);
+    memcpy(input + keyLength, _wsUUID.c_str(), _wsUUID.size());
+
+    vector<unsigned char> hash;
+    sha1(reinterpret_cast<const unsigned char*>(input), keyLength + _wsUUID.size(), hash);
+    return Base64::encode(hash);
+}
+
+inline void
+append(char*& p, const char* s, size_t length)
+{
+    memcpy(p, s, length);
+    p += length;
+}
+
+inline void
+append(char*& p, const char* s)
+{
+    append(p, s, strlen(s));
+}
+
 //
 // Rename to avoid conflict with OS 10.10 htonll
 //
@@ -909,7 +1025,8 @@ IceInternal::WSTransceiver::~WSTransceiver()
 void
 IceInternal::WSTransceiver::handleRequest(Buffer& responseBuffer)
 {
-    string val;
+    const char* begin;
+    const char* end;
 
     //
     // HTTP/1.1
@@ -923,38 +1040,38 @@ IceInternal::WSTransceiver::handleRequest(Buffer& responseBuffer)
     // "An |Upgrade| header field containing the value 'websocket',
     //  treated as an ASCII case-insensitive value."
     //
-    if(!_parser->getHeader("Upgrade", val, true))
+    if(!_parser->getHeader("Upgrade", begin, end))
     {
         throw WebSocketException("missing value for Upgrade field");
     }
-    else if(val != "websocket")
+    else if(!equalsIgnoreCase(begin, end, "websocket"))
     {
-        throw WebSocketException("invalid value `" + val + "' for Upgrade field");
+        throw WebSocketException("invalid value `" + string(begin, end) + "' for Upgrade field");
     }
 
     //
     // "A |Connection| header field that includes the token 'Upgrade',
     //  treated as an ASCII case-insensitive value.
     //
-    if(!_parser->getHeader("Connection", val, true))
+    if(!_parser->getHeader("Connection", begin, end))
     {
         throw WebSocketException("missing value for Connection field");
     }
-    else if(val.find("upgrade") == string::npos)
+    else if(!containsIgnoreCase(begin, end, "upgrade"))
     {
-        throw WebSocketException("invalid value `" + val + "' for Connection field");
+        throw WebSocketException("invalid value `" + string(begin, end) + "' for Connection field");
     }
 
     //
     // "A |Sec-WebSocket-Version| header field, with a value of 13."
     //
-    if(!_parser->getHeader("Sec-WebSocket-Version", val, false))
+    if(!_parser->getHeader("Sec-WebSocket-Version", begin, end))
     {
         throw WebSocketException("missing value for WebSocket version");
     }
-    else if(val != "13")
+    else if(end - begin != 2 || begin[0] != '1' || begin[1] != '3')
     {
-        throw WebSocketException("unsupported WebSocket version `" + val + "'");
+        throw WebSocketException("unsupported WebSocket version `" + string(begin, end) + "'");
     }
 
     //
@@ -963,18 +1080,29 @@ IceInternal::WSTransceiver::handleRequest(Buffer& responseBuffer)
     //  speak, ordered by preference."
     //
     bool addProtocol = false;
-    if(_parser->getHeader("Sec-WebSocket-Protocol", val, true))
+    if(_parser->getHeader("Sec-WebSocket-Protocol", begin, end))
     {
-        vector<string> protocols;
-        if(!IceUtilInternal::splitString(val, ",", protocols))
-        {
-            throw WebSocketException("invalid value `" + val + "' for WebSocket protocol");
-        }
-        for(vector<string>::iterator p = protocols.begin(); p != protocols.end(); ++p)
+        while(begin != end)
         {
-            if(IceUtilInternal::trim(*p) != _iceProtocol)
+            const char* q = find(begin, end, ',');
+            const char* b = begin;
+            const char* e = q;
+            while(b != e && (*b == ' ' || *b == '\t'))
+            {
+                ++b;
+            }
+            while(e != b && (*(e - 1) == ' ' || *(e - 1) == '\t'))
+            {
+                --e;
+            }
+            begin = q == end ? q : q + 1;
+            if(b == e)
+            {
+                continue;
+            }
+            else if(!equalsIgnoreCase(b, e, _iceProtocol))
             {
-                throw WebSocketException("unknown value `" + *p + "' for WebSocket protocol");
+                throw WebSocketException("unknown value `" + string(b, e) + "' for WebSocket protocol");
             }
             addProtocol = true;
         }
@@ -984,33 +1112,14 @@ IceInternal::WSTransceiver::handleRequest(Buffer& responseBuffer)
     // "A |Sec-WebSocket-Key| header field with a base64-encoded
     //  value that, when decoded, is 16 bytes in length."
     //
-    string key;
-    if(!_parser->getHeader("Sec-WebSocket-Key", key, false))
+    if(!_parser->getHeader("Sec-WebSocket-Key", begin, end))
     {
         throw WebSocketException("missing value for WebSocket key");
     }
 
-    vector<unsigned char> decodedKey = Base64::decode(key);
-    if(decodedKey.size() != 16)
+    if(decodedBase64Length(begin, end) != 16)
     {
-        throw WebSocketException("invalid value `" + key + "' for WebSocket key");
-    }
-
-    //
-    // Retain the target resource.
-    //
-    const_cast<string&>(_resource) = _parser->uri();
-
-    //
-    // Compose the response.
-    //
-    ostringstream out;
-    out << "HTTP/1.1 101 Switching Protocols\r\n"
-        << "Upgrade: websocket\r\n"
-        << "Connection: Upgrade\r\n";
-    if(addProtocol)
-    {
-        out << "Sec-WebSocket-Protocol: " << _iceProtocol << "\r\n";
+        throw WebSocketException("invalid value `" + string(begin, end) + "' for WebSocket key");
     }
 
     //
@@ -1023,22 +1132,44 @@ IceInternal::WSTransceiver::handleRequest(Buffer& responseBuffer)
     //  concatenated value to obtain a 20-byte value and base64-
     //  encoding (see Section 4 of [RFC4648]) this 20-byte hash.
     //
-    out << "Sec-WebSocket-Accept: ";
-    string input = key + _wsUUID;
-    vector<unsigned char> hash;
-    sha1(reinterpret_cast<const unsigned char*>(&input[0]), input.size(), hash);
-    out << IceInternal::Base64::encode(hash) << "\r\n" << "\r\n"; // EOM
+    const string accept = computeAccept(begin, end);
 
-    string str = out.str();
-    responseBuffer.b.resize(str.size());
-    memcpy(&responseBuffer.b[0], str.c_str(), str.size());
+    //
+    // Retain the target resource.
+    //
+    const_cast<string&>(_resource) = _parser->uri();
+
+    //
+    // Compose the response directly in a stack buffer, the response only
+    // includes fixed fields, the protocol and the 28 characters accept value.
+    //
+    char response[256];
+    char* p = response;
+    append(p, "HTTP/1.1 101 Switching Protocols\r\n"
+              "Upgrade: websocket\r\n"
+              "Connection: Upgrade\r\n");
+    if(addProtocol)
+    {
+        append(p, "Sec-WebSocket-Protocol: ");
+        append(p, _iceProtocol.c_str(), _iceProtocol.size());
+        append(p, "\r\n");
+    }
+    append(p, "Sec-WebSocket-Accept: ");
+    append(p, accept.c_str(), accept.size());
+    append(p, "\r\n\r\n"); // EOM
+    assert(p <= response + sizeof(response));
+
+    const size_t size = static_cast<size_t>(p - response);
+    responseBuffer.b.resize(size);
+    memcpy(&responseBuffer.b[0], response, size);
     responseBuffer.i = responseBuffer.b.begin();
 }
 
 void
 IceInternal::WSTransceiver::handleResponse()
 {
-    string val;
+    const char* begin;
+    const char* end;
 
     //
     // HTTP/1.1
@@ -1073,13 +1204,13 @@ IceInternal::WSTransceiver::handleResponse()
     //  insensitive match for the value "websocket", the client MUST
     //  _Fail the WebSocket Connection_."
     //
-    if(!_parser->getHeader("Upgrade", val, true))
+    if(!_parser->getHeader("Upgrade", begin, end))
     {
         throw WebSocketException("missing value for Upgrade field");
     }
-    else if(val != "websocket")
+    else if(!equalsIgnoreCase(begin, end, "websocket"))
     {
-        throw WebSocketException("invalid value `" + val + "' for Upgrade field");
+        throw WebSocketException("invalid value `" + string(begin, end) + "' for Upgrade field");
     }
 
     //
@@ -1088,13 +1219,13 @@ IceInternal::WSTransceiver::handleResponse()
     //  ASCII case-insensitive match for the value "Upgrade", the client
     //  MUST _Fail the WebSocket Connection_."
     //
-    if(!_parser->getHeader("Connection", val, true))
+    if(!_parser->getHeader("Connection", begin, end))
     {
         throw WebSocketException("missing value for Connection field");
     }
-    else if(val.find("upgrade") == string::npos)
+    else if(!containsIgnoreCase(begin, end, "upgrade"))
     {
-        throw WebSocketException("invalid value `" + val + "' for Connection field");
+        throw WebSocketException("invalid value `" + string(begin, end) + "' for Connection field");
     }
 
     //
@@ -1104,9 +1235,9 @@ IceInternal::WSTransceiver::handleResponse()
     //  subprotocol not requested by the client), the client MUST _Fail
     //  the WebSocket Connection_."
     //
-    if(_parser->getHeader("Sec-WebSocket-Protocol", val, true) && val != _iceProtocol)
+    if(_parser->getHeader("Sec-WebSocket-Protocol", begin, end) && !equalsIgnoreCase(begin, end, _iceProtocol))
     {
-        throw WebSocketException("invalid value `" + val + "' for WebSocket protocol");
+        throw WebSocketException("invalid value `" + string(begin, end) + "' for WebSocket protocol");
     }
 
     //
@@ -1118,16 +1249,14 @@ IceInternal::WSTransceiver::handleResponse()
     //  trailing whitespace, the client MUST _Fail the WebSocket
     //  Connection_."
     //
-    if(!_parser->getHeader("Sec-WebSocket-Accept", val, false))
+    if(!_parser->getHeader("Sec-WebSocket-Accept", begin, end))
     {
         throw WebSocketException("missing value for Sec-WebSocket-Accept");
     }
-    string input = _key + _wsUUID;
-    vector<unsigned char> hash;
-    sha1(reinterpret_cast<const unsigned char*>(&input[0]), input.size(), hash);
-    if(val != IceInternal::Base64::encode(hash))
+    const string accept = computeAccept(_key.c_str(), _key.c_str() + _key.size());
+    if(static_cast<size_t>(end - begin) != accept.size() || !equal(begin, end, accept.begin()))
     {
-        throw WebSocketException("invalid value `" + val + "' for Sec-WebSocket-Accept");
+        throw WebSocketException("invalid value `" + string(begin, end) + "' for Sec-WebSocket-Accept");
     }
 }
 
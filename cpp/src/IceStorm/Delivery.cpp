@@ -0,0 +1,243 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <IceStorm/Delivery.h>
+#include <Ice/LocalException.h>
+#include <Ice/UniquePtr.h>
+
+using namespace std;
+using namespace IceStorm;
+
+namespace
+{
+
+void
+queue(vector<SubscriberPtr>::const_iterator p, vector<SubscriberPtr>::const_iterator end, bool forwarded,
+      const PreparedEventSeq& events, vector<Ice::Identity>& reap)
+{
+    for(; p != end; ++p)
+    {
+        if(!(*p)->queue(forwarded, events) && (*p)->reap())
+        {
+            reap.push_back((*p)->id());
+        }
+    }
+}
+
+}
+
+namespace IceStorm
+{
+
+//
+// The events of a publish call to queue to the shards of a snapshot. The
+// events are only referenced: the publishing thread waits for the shards,
+// including the shards that failed. The first failure is raised to the
+// publishing thread.
+//
+class DeliveryJob : public IceUtil::Shared, public IceUtil::Monitor<IceUtil::Mutex>
+{
+public:
+
+    DeliveryJob(const SubscriberSnapshotPtr& snapshot, bool forwarded, const PreparedEventSeq& events, size_t shards) :
+        _snapshot(snapshot),
+        _forwarded(forwarded),
+        _events(events),
+        _reap(shards),
+        _pending(shards)
+    {
+    }
+
+    void
+    run(size_t shard)
+    {
+        const vector<SubscriberPtr>& subscribers = _snapshot->subscribers;
+        const size_t shards = _reap.size();
+        vector<SubscriberPtr>::const_iterator begin = subscribers.begin() + subscribers.size() * shard / shards;
+        vector<SubscriberPtr>::const_iterator end = subscribers.begin() + subscribers.size() * (shard + 1) / shards;
+
+        vector<Ice::Identity> reap;
+        IceInternal::UniquePtr<IceUtil::Exception> exception;
+        try
+        {
+            queue(begin, end, _forwarded, _events, reap);
+        }
+        catch(const IceUtil::Exception& ex)
+        {
+            exception.reset(ex.ice_clone());
+        }
+        catch(const std::exception& ex)
+        {
+            exception.reset(new Ice::UnknownException(__FILE__, __LINE__, ex.what()));
+        }
+        catch(...)
+        {
+            exception.reset(new Ice::UnknownException(__FILE__, __LINE__, "unknown c++ exception"));
+        }
+
+        Lock sync(*this);
+        _reap[shard].swap(reap);
+        if(exception.get() && !_exception.get())
+        {
+            _exception.reset(exception.release());
+        }
+        if(--_pending == 0)
+        {
+            notify();
+        }
+    }
+
+    void
+    wait(vector<Ice::Identity>& reap)
+    {
+        Lock sync(*this);
+        while(_pending > 0)
+        {
+            IceUtil::Monitor<IceUtil::Mutex>::wait();
+        }
+
+        for(vector<vector<Ice::Identity> >::const_iterator p = _reap.begin(); p != _reap.end(); ++p)
+        {
+            reap.insert(reap.end(), p->begin(), p->end());
+        }
+
+        if(_exception.get())
+        {
+            _exception->ice_throw();
+        }
+    }
+
+private:
+
+    const SubscriberSnapshotPtr _snapshot;
+    const bool _forwarded;
+    const PreparedEventSeq& _events;
+    vector<vector<Ice::Identity> > _reap;
+    size_t _pending;
+    IceInternal::UniquePtr<IceUtil::Exception> _exception;
+};
+typedef IceUtil::Handle<DeliveryJob> DeliveryJobPtr;
+
+class DeliveryWorker : public IceUtil::Thread, public IceUtil::Monitor<IceUtil::Mutex>
+{
+public:
+
+    DeliveryWorker() :
+        IceUtil::Thread("IceStorm delivery worker"),
+        _destroy(false)
+    {
+    }
+
+    void
+    add(const DeliveryJobPtr& job, size_t shard)
+    {
+        Lock sync(*this);
+        if(_jobs.empty())
+        {
+            notify();
+        }
+        _jobs.push_back(make_pair(job, shard));
+    }
+
+    void
+    destroy()
+    {
+        {
+            Lock sync(*this);
+            _destroy = true;
+            notify();
+        }
+
+        try
+        {
+            getThreadControl().join();
+        }
+        catch(const IceUtil::ThreadNotStartedException&)
+        {
+            // Expected if start() failed.
+        }
+    }
+
+    virtual void
+    run()
+    {
+        while(true)
+        {
+            pair<DeliveryJobPtr, size_t> job;
+            {
+                Lock sync(*this);
+
+                //
+                // The pending jobs are run before the worker exits, a
+                // publishing thread waits for them.
+                //
+                while(!_destroy && _jobs.empty())
+                {
+                    wait();
+                }
+                if(_jobs.empty())
+                {
+                    return;
+                }
+                job = _jobs.front();
+                _jobs.pop_front();
+            }
+            job.first->run(job.second);
+        }
+    }
+
+private:
+
+    bool _destroy;
+    deque<pair<DeliveryJobPtr, size_t> > _jobs;
+};
+
+}
+
+IceStorm::DeliveryWorkers::DeliveryWorkers(int workers, int minShardSize) :
+    _minShardSize(static_cast<size_t>(max(minShardSize, 1)))
+{
+    for(int i = 0; i < workers; ++i)
+    {
+        DeliveryWorkerPtr worker = new DeliveryWorker();
+        worker->start();
+        _workers.push_back(worker);
+    }
+}
+
+IceStorm::DeliveryWorkers::~DeliveryWorkers()
+{
+    assert(_workers.empty());
+}
+
+void
+IceStorm::DeliveryWorkers::deliver(const SubscriberSnapshotPtr& snapshot, bool forwarded, const PreparedEventSeq& events,
+                                   vector<Ice::Identity>& reap)
+{
+    const vector<SubscriberPtr>& subscribers = snapshot->subscribers;
+    const size_t shards = min(_workers.size() + 1, subscribers.size() / _minShardSize);
+    if(shards <= 1)
+    {
+        queue(subscribers.begin(), subscribers.end(), forwarded, events, reap);
+        return;
+    }
+
+    DeliveryJobPtr job = new DeliveryJob(snapshot, forwarded, events, shards);
+    for(size_t i = 1; i < shards; ++i)
+    {
+        _workers[i - 1]->add(job, i);
+    }
+    job->run(0);
+    job->wait(reap);
+}
+
+void
+IceStorm::DeliveryWorkers::destroy()
+{
+    for(vector<DeliveryWorkerPtr>::const_iterator p = _workers.begin(); p != _workers.end(); ++p)
+    {
+        (*p)->destroy();
+    }
+    _workers.clear();
+}
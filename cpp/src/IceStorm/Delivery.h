@@ -0,0 +1,66 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#ifndef DELIVERY_H
+#define DELIVERY_H
+
+#include <IceStorm/Subscriber.h>
+#include <IceUtil/Thread.h>
+#include <IceUtil/Monitor.h>
+#include <deque>
+
+namespace IceStorm
+{
+
+//
+// An immutable copy of the subscribers of a topic. A topic shares its
+// snapshot with the publish calls until its subscribers change, publishing
+// doesn't copy the subscribers.
+//
+class SubscriberSnapshot : public IceUtil::Shared
+{
+public:
+
+    SubscriberSnapshot(const std::vector<SubscriberPtr>& s) :
+        subscribers(s)
+    {
+    }
+
+    const std::vector<SubscriberPtr> subscribers;
+};
+typedef IceUtil::Handle<SubscriberSnapshot> SubscriberSnapshotPtr;
+
+class DeliveryWorker;
+typedef IceUtil::Handle<DeliveryWorker> DeliveryWorkerPtr;
+
+//
+// Queues the events of a publish call to the subscribers of a topic. With
+// delivery workers, the subscribers of a large topic are partitioned in
+// shards of consecutive subscribers: the publishing thread queues the events
+// to the first shard and each worker to one of the other shards. The call
+// returns once the events are queued to all the shards, so the events of a
+// publisher are still queued in order.
+//
+class DeliveryWorkers : public IceUtil::Shared
+{
+public:
+
+    DeliveryWorkers(int, int);
+    ~DeliveryWorkers();
+
+    // Queues the events and adds the subscribers to reap to the given list.
+    void deliver(const SubscriberSnapshotPtr&, bool, const PreparedEventSeq&, std::vector<Ice::Identity>&);
+
+    void destroy();
+
+private:
+
+    const size_t _minShardSize;
+    std::vector<DeliveryWorkerPtr> _workers;
+};
+typedef IceUtil::Handle<DeliveryWorkers> DeliveryWorkersPtr;
+
+} // End namespace IceStorm
+
+#endif
@@ -0,0 +1,367 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#ifndef EVENT_BUFFER_H
+#define EVENT_BUFFER_H
+
+#include <IceUtil/Shared.h>
+#include <IceUtil/Handle.h>
+#include <IceUtil/Mutex.h>
+#include <Ice/Current.h>
+#include <Ice/StreamHelpers.h>
+#include <algorithm>
+
+namespace IceStorm
+{
+
+//
+// The encoded in-parameters of an event. The bytes are copied once when the
+// event is received and are immutable, the copies of the event share them.
+//
+class EventBytes
+{
+public:
+
+    typedef Ice::Byte value_type;
+    typedef const Ice::Byte* const_iterator;
+
+    EventBytes() :
+        _begin(0),
+        _end(0)
+    {
+    }
+
+    EventBytes(const Ice::Byte* begin, const Ice::Byte* end)
+    {
+        init(begin, end);
+    }
+
+    EventBytes(const Ice::ByteSeq& bytes)
+    {
+        init(bytes.empty() ? 0 : &bytes[0], bytes.empty() ? 0 : &bytes[0] + bytes.size());
+    }
+
+    const_iterator begin() const
+    {
+        return _begin;
+    }
+
+    const_iterator end() const
+    {
+        return _end;
+    }
+
+    size_t size() const
+    {
+        return static_cast<size_t>(_end - _begin);
+    }
+
+    bool empty() const
+    {
+        return _begin == _end;
+    }
+
+    std::pair<const Ice::Byte*, const Ice::Byte*> range() const
+    {
+        return std::make_pair(_begin, _end);
+    }
+
+    void swap(EventBytes& other)
+    {
+        _buffer.swap(other._buffer);
+        std::swap(_begin, other._begin);
+        std::swap(_end, other._end);
+    }
+
+    bool operator==(const EventBytes& other) const
+    {
+        return size() == other.size() && std::equal(_begin, _end, other._begin);
+    }
+
+    bool operator!=(const EventBytes& other) const
+    {
+        return !operator==(other);
+    }
+
+    bool operator<(const EventBytes& other) const
+    {
+        return std::lexicographical_compare(_begin, _end, other._begin, other._end);
+    }
+
+private:
+
+    //
+    // The bytes are stored after the buffer, the buffer and the bytes are
+    // allocated with a single allocation and released with the last copy
+    // of the event.
+    //
+    class Buffer : public IceUtil::Shared
+    {
+    public:
+
+        static Buffer* create(const Ice::Byte* begin, const Ice::Byte* end)
+        {
+            Buffer* buffer = ::new(::operator new(sizeof(Buffer) + static_cast<size_t>(end - begin))) Buffer();
+            std::copy(begin, end, buffer->bytes());
+            return buffer;
+        }
+
+        static void operator delete(void* p)
+        {
+            ::operator delete(p);
+        }
+
+        Ice::Byte* bytes()
+        {
+            return reinterpret_cast<Ice::Byte*>(this + 1);
+        }
+
+    private:
+
+        Buffer()
+        {
+        }
+    };
+
+    void init(const Ice::Byte* begin, const Ice::Byte* end)
+    {
+        if(begin == end)
+        {
+            _begin = _end = 0;
+            return;
+        }
+
+        _buffer = Buffer::create(begin, end);
+        _begin = _buffer->bytes();
+        _end = _begin + (end - begin);
+    }
+
+    IceUtil::Handle<Buffer> _buffer;
+    const Ice::Byte* _begin;
+    const Ice::Byte* _end;
+};
+
+//
+// The context of an event. The context is immutable and shared by the
+// copies of the event and, when interned, by the events with the same
+// context. An entry is set by copying the context.
+//
+class EventContext
+{
+public:
+
+    typedef Ice::Context::const_iterator const_iterator;
+
+    EventContext()
+    {
+    }
+
+    EventContext(const Ice::Context& context)
+    {
+        if(!context.empty())
+        {
+            _context = new Context(context);
+        }
+    }
+
+    const Ice::Context& get() const
+    {
+        return _context ? _context->context : empty();
+    }
+
+    const_iterator begin() const
+    {
+        return get().begin();
+    }
+
+    const_iterator end() const
+    {
+        return get().end();
+    }
+
+    const_iterator find(const std::string& key) const
+    {
+        return get().find(key);
+    }
+
+    size_t size() const
+    {
+        return get().size();
+    }
+
+    //
+    // Sets an entry of the context. The context is updated in place if it's
+    // not shared with other events, otherwise the entry is set in a copy.
+    //
+    void set(const std::string& key, const std::string& value)
+    {
+        if(!_context)
+        {
+            Ice::Context context;
+            context[key] = value;
+            _context = new Context(context);
+        }
+        else if(_context->__getRef() == 1)
+        {
+            _context->context[key] = value;
+        }
+        else
+        {
+            Ice::Context context = get();
+            context[key] = value;
+            _context = new Context(context);
+        }
+    }
+
+    void swap(EventContext& other)
+    {
+        _context.swap(other._context);
+    }
+
+    bool operator==(const EventContext& other) const
+    {
+        return _context.get() == other._context.get() || get() == other.get();
+    }
+
+    bool operator!=(const EventContext& other) const
+    {
+        return !operator==(other);
+    }
+
+    bool operator<(const EventContext& other) const
+    {
+        return get() < other.get();
+    }
+
+private:
+
+    class Context : public IceUtil::Shared
+    {
+    public:
+
+        Context(const Ice::Context& c) :
+            context(c)
+        {
+        }
+
+        Ice::Context context; // Only updated by set if not shared.
+    };
+
+    static const Ice::Context& empty()
+    {
+        static const Ice::Context context;
+        return context;
+    }
+
+    IceUtil::Handle<Context> _context;
+};
+
+//
+// Interns the contexts of the events received by a publisher: the events
+// share the context of the previous event dispatched by the same thread if
+// their contexts are equal, which is the usual case for the events of a
+// publisher. The previous context is cached per thread so interning doesn't
+// lock, compilers without thread_local support fall back to a context cached
+// per interner.
+//
+class EventContextInterner
+{
+public:
+
+    EventContext intern(const Ice::Context& context)
+    {
+        if(context.empty())
+        {
+            return EventContext();
+        }
+
+#ifdef ICE_CPP11_COMPILER
+        static thread_local EventContext last;
+        if(last.get() != context)
+        {
+            last = EventContext(context);
+        }
+        return last;
+#else
+        IceUtil::Mutex::Lock sync(_mutex);
+        if(_last.get() != context)
+        {
+            _last = EventContext(context);
+        }
+        return _last;
+#endif
+    }
+
+#ifndef ICE_CPP11_COMPILER
+private:
+
+    IceUtil::Mutex _mutex;
+    EventContext _last;
+#endif
+};
+
+}
+
+namespace Ice
+{
+
+//
+// The event bytes and context are marshaled like the byte sequence and
+// the context they replace.
+//
+template<>
+struct StreamableTraits< ::IceStorm::EventBytes>
+{
+    static const StreamHelperCategory helper = StreamHelperCategorySequence;
+    static const int minWireSize = 1;
+    static const bool fixedLength = false;
+};
+
+template<>
+struct StreamHelper< ::IceStorm::EventBytes, StreamHelperCategorySequence>
+{
+    template<class S> static inline void
+    write(S* stream, const ::IceStorm::EventBytes& v)
+    {
+        stream->write(v.begin(), v.end());
+    }
+
+    template<class S> static inline void
+    read(S* stream, ::IceStorm::EventBytes& v)
+    {
+        std::pair<const Byte*, const Byte*> p;
+        stream->read(p);
+        ::IceStorm::EventBytes(p.first, p.second).swap(v);
+    }
+};
+
+template<>
+struct StreamableTraits< ::IceStorm::EventContext>
+{
+    static const StreamHelperCategory helper = StreamHelperCategoryDictionary;
+    static const int minWireSize = 1;
+    static const bool fixedLength = false;
+};
+
+template<>
+struct StreamHelper< ::IceStorm::EventContext, StreamHelperCategoryDictionary>
+{
+    template<class S> static inline void
+    write(S* stream, const ::IceStorm::EventContext& v)
+    {
+        stream->write(v.get());
+    }
+
+    template<class S> static inline void
+    read(S* stream, ::IceStorm::EventContext& v)
+    {
+        Context context;
+        stream->read(context);
+        ::IceStorm::EventContext(context).swap(v);
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,359 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <IceStorm/EventFilter.h>
+#include <IceStorm/PreparedEvent.h>
+#include <IceUtil/StringUtil.h>
+#include <IceUtil/InputUtil.h>
+#include <Ice/InputStream.h>
+#include <Ice/LocalException.h>
+
+using namespace std;
+using namespace IceStorm;
+
+namespace
+{
+
+const string filterPrefix = "filter.";
+
+//
+// Records the values of the leading parameters. The parameters that are
+// not of a basic type or an enumeration, and the optional parameters,
+// are recorded as not comparable.
+//
+class ParamVisitor : public Ice::DecodingVisitor
+{
+public:
+
+    ParamVisitor(const EventParamsPtr& params) :
+        _params(params),
+        _depth(0),
+        _optional(false)
+    {
+    }
+
+    virtual void visitBool(bool v)
+    {
+        add(v ? "true" : "false");
+    }
+
+    virtual void visitByte(Ice::Byte v)
+    {
+        add(static_cast<Ice::Long>(v));
+    }
+
+    virtual void visitShort(Ice::Short v)
+    {
+        add(static_cast<Ice::Long>(v));
+    }
+
+    virtual void visitInt(Ice::Int v)
+    {
+        add(static_cast<Ice::Long>(v));
+    }
+
+    virtual void visitLong(Ice::Long v)
+    {
+        add(v);
+    }
+
+    virtual void visitFloat(Ice::Float v)
+    {
+        add(EventParams::KindFloat, v);
+    }
+
+    virtual void visitDouble(Ice::Double v)
+    {
+        add(EventParams::KindDouble, v);
+    }
+
+    virtual void visitString(const string& v)
+    {
+        add(v);
+    }
+
+    virtual void visitEnum(Ice::Int v)
+    {
+        add(static_cast<Ice::Long>(v));
+    }
+
+    virtual void visitProxy(const Ice::ObjectPrx&)
+    {
+        skip();
+    }
+
+    virtual void startStruct()
+    {
+        start();
+    }
+
+    virtual void endStruct()
+    {
+        --_depth;
+    }
+
+    virtual void startSequence(Ice::Int)
+    {
+        start();
+    }
+
+    virtual void endSequence()
+    {
+        --_depth;
+    }
+
+    virtual void startDictionary(Ice::Int)
+    {
+        start();
+    }
+
+    virtual void endDictionary()
+    {
+        --_depth;
+    }
+
+    virtual void visitOptional(Ice::Int, bool)
+    {
+        //
+        // The optional parameters follow the required parameters.
+        //
+        if(_depth == 0)
+        {
+            _optional = true;
+        }
+    }
+
+private:
+
+    void
+    add(Ice::Long v)
+    {
+        if(EventParams::Value* value = next(EventParams::KindInteger))
+        {
+            value->integer = v;
+        }
+    }
+
+    void
+    add(EventParams::Kind kind, Ice::Double v)
+    {
+        if(EventParams::Value* value = next(kind))
+        {
+            value->real = v;
+        }
+    }
+
+    void
+    add(const string& v)
+    {
+        if(EventParams::Value* value = next(EventParams::KindString))
+        {
+            value->text = v;
+        }
+    }
+
+    void
+    skip()
+    {
+        next(EventParams::KindNone);
+    }
+
+    void
+    start()
+    {
+        skip();
+        ++_depth;
+    }
+
+    EventParams::Value*
+    next(EventParams::Kind kind)
+    {
+        if(_depth != 0 || _optional)
+        {
+            return 0;
+        }
+
+        EventParams::Value value;
+        value.kind = kind;
+        value.integer = 0;
+        value.real = 0;
+        _params->values.push_back(value);
+        return &_params->values.back();
+    }
+
+    const EventParamsPtr _params;
+    int _depth;
+    bool _optional;
+};
+
+}
+
+EventFilterPtr
+IceStorm::EventFilter::create(const Ice::CommunicatorPtr& communicator, const QoS& qos)
+{
+    EventFilterPtr filter;
+    for(QoS::const_iterator p = qos.lower_bound(filterPrefix);
+        p != qos.end() && p->first.compare(0, filterPrefix.size(), filterPrefix) == 0; ++p)
+    {
+        if(!filter)
+        {
+            filter = new EventFilter(communicator);
+        }
+
+        const string key = p->first.substr(filterPrefix.size());
+        if(key == "operations")
+        {
+            vector<string> operations;
+            if(!IceUtilInternal::splitString(p->second, ", \t\r\n", operations) || operations.empty())
+            {
+                throw BadQoS("invalid filter operations: `" + p->second + "'");
+            }
+            filter->_operations.insert(operations.begin(), operations.end());
+        }
+        else if(key.compare(0, 8, "context.") == 0 && key.size() > 8)
+        {
+            filter->_context.push_back(make_pair(key.substr(8), p->second));
+        }
+        else if(key == "params")
+        {
+            try
+            {
+                filter->_params.reset(new Ice::DecodingProgram(p->second));
+                filter->_paramsDescription = p->second;
+            }
+            catch(const IceUtil::IllegalArgumentException& ex)
+            {
+                throw BadQoS("invalid filter params: " + ex.reason());
+            }
+        }
+        else if(key.compare(0, 6, "param.") == 0)
+        {
+            istringstream is(key.substr(6));
+            ParamValue value;
+            if(!(is >> value.index) || !is.eof())
+            {
+                throw BadQoS("invalid filter parameter: `" + p->first + "'");
+            }
+            value.text = p->second;
+            value.isInteger = IceUtilInternal::stringToInt64(p->second, value.integer);
+
+            istringstream vs(p->second);
+            vs.imbue(locale::classic());
+            value.isReal = (vs >> value.real) && (vs >> ws).eof();
+            filter->_paramValues.push_back(value);
+        }
+        else
+        {
+            throw BadQoS("invalid filter: `" + p->first + "'");
+        }
+    }
+
+    if(filter && !filter->_paramValues.empty())
+    {
+        if(!filter->_params.get())
+        {
+            throw BadQoS("invalid filter: the parameters are compared without filter.params");
+        }
+
+        for(vector<ParamValue>::const_iterator p = filter->_paramValues.begin(); p != filter->_paramValues.end(); ++p)
+        {
+            if(p->index >= filter->_params->fieldCount())
+            {
+                ostringstream os;
+                os << "invalid filter: no parameter with index " << p->index << " in filter.params";
+                throw BadQoS(os.str());
+            }
+        }
+    }
+    return filter;
+}
+
+bool
+IceStorm::EventFilter::match(const PreparedEventPtr& event) const
+{
+    if(!_operations.empty() && _operations.find(event->op) == _operations.end())
+    {
+        return false;
+    }
+
+    for(vector<pair<string, string> >::const_iterator p = _context.begin(); p != _context.end(); ++p)
+    {
+        Ice::Context::const_iterator q = event->context.find(p->first);
+        if(q == event->context.end() || q->second != p->second)
+        {
+            return false;
+        }
+    }
+
+    if(_params.get() && !_paramValues.empty())
+    {
+        //
+        // The parameters of an event delivered to several subscribers are
+        // decoded once for the filters with the same description.
+        //
+        EventParamsPtr params = event->findParams(_paramsDescription);
+        if(!params)
+        {
+            params = event->addParams(_paramsDescription, decode(event));
+        }
+
+        if(!params->valid)
+        {
+            return false;
+        }
+
+        for(vector<ParamValue>::const_iterator p = _paramValues.begin(); p != _paramValues.end(); ++p)
+        {
+            if(p->index >= params->values.size() || !equals(params->values[p->index], *p))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+EventParamsPtr
+IceStorm::EventFilter::decode(const PreparedEventPtr& event) const
+{
+    EventParamsPtr params = new EventParams;
+    ParamVisitor visitor(params);
+    try
+    {
+        Ice::InputStream in(_communicator, event->data.range());
+        in.startEncapsulation();
+        _params->decode(&in, visitor);
+    }
+    catch(const Ice::LocalException&)
+    {
+        //
+        // The parameters of the event don't match the description.
+        //
+        params->valid = false;
+    }
+    return params;
+}
+
+bool
+IceStorm::EventFilter::equals(const EventParams::Value& value, const ParamValue& filterValue) const
+{
+    switch(value.kind)
+    {
+    case EventParams::KindInteger:
+        return filterValue.isInteger && value.integer == filterValue.integer;
+    case EventParams::KindFloat:
+        return filterValue.isReal && static_cast<Ice::Float>(value.real) == static_cast<Ice::Float>(filterValue.real);
+    case EventParams::KindDouble:
+        return filterValue.isReal && value.real == filterValue.real;
+    case EventParams::KindString:
+        return value.text == filterValue.text;
+    default:
+        return false;
+    }
+}
+
+IceStorm::EventFilter::EventFilter(const Ice::CommunicatorPtr& communicator) :
+    _communicator(communicator)
+{
+}
@@ -0,0 +1,114 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#ifndef EVENT_FILTER_H
+#define EVENT_FILTER_H
+
+#include <IceStorm/IceStormInternal.h>
+#include <Ice/DecodingProgram.h>
+#include <Ice/UniquePtr.h>
+#include <set>
+
+namespace IceStorm
+{
+
+class EventFilter;
+typedef IceUtil::Handle<EventFilter> EventFilterPtr;
+
+class PreparedEvent;
+typedef IceUtil::Handle<PreparedEvent> PreparedEventPtr;
+
+//
+// The values of the leading parameters of an event, decoded by a filter.
+//
+class EventParams : public IceUtil::Shared
+{
+public:
+
+    enum Kind
+    {
+        KindNone, // Not comparable.
+        KindInteger,
+        KindFloat,
+        KindDouble,
+        KindString
+    };
+
+    struct Value
+    {
+        Kind kind;
+        Ice::Long integer;
+        Ice::Double real;
+        std::string text;
+    };
+
+    EventParams() :
+        valid(true)
+    {
+    }
+
+    bool valid; // False if the parameters don't match the description.
+    std::vector<Value> values;
+};
+typedef IceUtil::Handle<EventParams> EventParamsPtr;
+
+//
+// The events a subscriber accepts, from the filter.* entries of its QoS:
+//
+// - filter.operations: the names of the operations, separated by commas
+//   or whitespace.
+// - filter.context.<key>: the value of the context entry <key>.
+// - filter.params: the type description of the leading parameters of the
+//   operations (see Ice::DecodingProgram), and filter.param.<index>: the
+//   value of the parameter with the given index. Only required parameters
+//   of a basic type or an enumeration can be compared, an enumerator is
+//   compared with its value. The numeric parameters are compared with the
+//   number of the value, a float parameter with the value converted to
+//   float.
+//
+// The events that don't match the filter are not queued to the subscriber.
+//
+class EventFilter : public IceUtil::Shared
+{
+public:
+
+    // Returns the filter of the QoS, or null if the QoS doesn't filter
+    // the events. Raises BadQoS if the filter is invalid.
+    static EventFilterPtr create(const Ice::CommunicatorPtr&, const QoS&);
+
+    bool match(const PreparedEventPtr&) const;
+
+private:
+
+    EventFilter(const Ice::CommunicatorPtr&);
+
+    EventParamsPtr decode(const PreparedEventPtr&) const;
+
+    //
+    // The value of a parameter from the QoS, with its number if the value
+    // is an integer or a floating point number.
+    //
+    struct ParamValue
+    {
+        size_t index;
+        std::string text;
+        bool isInteger;
+        Ice::Long integer;
+        bool isReal;
+        Ice::Double real;
+    };
+
+    bool equals(const EventParams::Value&, const ParamValue&) const;
+
+    const Ice::CommunicatorPtr _communicator;
+    std::set<std::string> _operations;
+    std::vector<std::pair<std::string, std::string> > _context;
+    IceInternal::UniquePtr<Ice::DecodingProgram> _params;
+    std::string _paramsDescription;
+    std::vector<ParamValue> _paramValues;
+};
+
+} // End namespace IceStorm
+
+#endif
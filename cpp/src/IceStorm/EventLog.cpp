@@ -0,0 +1,434 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <IceStorm/EventLog.h>
+#include <IceStorm/Instance.h>
+#include <IceStorm/Util.h>
+#include <IceStorm/TraceLevels.h>
+#include <Ice/LoggerUtil.h>
+#include <IceUtil/Timer.h>
+#include <algorithm>
+
+using namespace std;
+using namespace IceStorm;
+
+namespace
+{
+
+typedef IceDB::Cursor<EventRecordKey, EventRecord, IceDB::IceContext, Ice::OutputStream> EventMapCursor;
+typedef IceDB::ReadOnlyCursor<EventRecordKey, EventRecord, IceDB::IceContext, Ice::OutputStream> EventMapROCursor;
+
+class FlushTask : public IceUtil::TimerTask
+{
+public:
+
+    FlushTask(const EventLogPtr& log, const Ice::CommunicatorPtr& communicator) :
+        _log(log), _communicator(communicator)
+    {
+    }
+
+    virtual void runTimerTask()
+    {
+        try
+        {
+            _log->flush();
+        }
+        catch(const IceDB::LMDBException& ex)
+        {
+            Ice::Error error(_communicator->getLogger());
+            error << "LMDB error: " << ex;
+        }
+    }
+
+private:
+
+    const EventLogPtr _log;
+    const Ice::CommunicatorPtr _communicator;
+};
+
+size_t
+recordSize(const EventRecord& record)
+{
+    size_t sz = record.op.size() + record.data.size();
+    for(Ice::Context::const_iterator p = record.context.begin(); p != record.context.end(); ++p)
+    {
+        sz += p->first.size() + p->second.size();
+    }
+    return sz;
+}
+
+}
+
+bool
+IceStorm::EventLog::enabled(const PersistentInstancePtr& instance, const string& topic)
+{
+    Ice::StringSeq topics = instance->properties()->getPropertyAsList(instance->serviceName() + ".EventLog.Topics");
+    if(std::find(topics.begin(), topics.end(), topic) == topics.end())
+    {
+        return false;
+    }
+
+    //
+    // Each replica would log the events it receives with its own numbering,
+    // the events of a replicated topic aren't logged.
+    //
+    if(instance->nodeAdapter())
+    {
+        Ice::Warning warn(instance->traceLevels()->logger);
+        warn << "the events of topic `" << topic << "' are not logged: `" << instance->serviceName()
+             << ".EventLog.Topics' is not supported with replication";
+        return false;
+    }
+    return true;
+}
+
+IceStorm::EventLog::EventLog(const PersistentInstancePtr& instance, const Ice::Identity& topic) :
+    _instance(instance),
+    _topic(topic),
+    // default one megabyte.
+    _maxSize(static_cast<size_t>(max(instance->properties()->getPropertyAsIntWithDefault(
+                                         instance->serviceName() + ".EventLog.MaxSize", 1024), 1)) * 1024),
+    _maxAge(IceUtil::Time::seconds(instance->properties()->getPropertyAsInt(
+                                       instance->serviceName() + ".EventLog.MaxAge"))), // default no limit.
+    _replayBatchSize(static_cast<size_t>(max(instance->properties()->getPropertyAsIntWithDefault(
+                                                 instance->serviceName() + ".EventLog.ReplayBatchSize", 100), 1))),
+    _flushInterval(IceUtil::Time::milliSeconds(instance->properties()->getPropertyAsInt(
+                                                   instance->serviceName() + ".EventLog.FlushInterval"))),
+    _eventMap(instance->eventMap()),
+    _first(0),
+    _next(0),
+    _committed(0),
+    _firstTime(0),
+    _size(0),
+    _destroyed(false),
+    _loaded(false),
+    _flushScheduled(false)
+{
+}
+
+void
+IceStorm::EventLog::append(const PreparedEventSeq& events)
+{
+    Lock sync(*this);
+    if(_destroyed || events.empty())
+    {
+        return;
+    }
+
+    if(!_loaded)
+    {
+        IceDB::ReadOnlyTxn txn(_instance->dbEnv());
+        load(txn);
+    }
+
+    PendingEvent pending;
+    pending.time = IceUtil::Time::now().toMilliSeconds();
+    for(PreparedEventSeq::const_iterator p = events.begin(); p != events.end(); ++p)
+    {
+        ostringstream os;
+        os << _next++;
+        (*p)->context.set(eventSequenceContextKey, os.str());
+
+        //
+        // The copy shares the data and the context of the event, it is
+        // replayed until the event is committed.
+        //
+        pending.event = new PreparedEvent((*p)->op, (*p)->mode, (*p)->data, (*p)->context);
+        _pending.push_back(pending);
+    }
+}
+
+void
+IceStorm::EventLog::commit()
+{
+    if(_flushInterval <= IceUtil::Time())
+    {
+        flush();
+        return;
+    }
+
+    Lock sync(*this);
+    if(_flushScheduled || _pending.empty() || _destroyed)
+    {
+        return;
+    }
+    try
+    {
+        _instance->timer()->schedule(new FlushTask(this, _instance->communicator()), _flushInterval);
+        _flushScheduled = true;
+    }
+    catch(const IceUtil::IllegalArgumentException&)
+    {
+        // The timer is destroyed, the topic commits the events on shutdown.
+    }
+}
+
+void
+IceStorm::EventLog::flush()
+{
+    IceUtil::Mutex::Lock flushSync(_flushMutex);
+
+    //
+    // The events appended while the previous commit was in progress are
+    // committed together. Only the commits update the committed events,
+    // the pending events are kept until committed to be replayed.
+    //
+    vector<PendingEvent> events;
+    Ice::Long first;
+    Ice::Long next;
+    Ice::Long firstTime;
+    size_t size;
+    {
+        Lock sync(*this);
+        _flushScheduled = false; // The events appended from now on schedule another commit.
+        if(_pending.empty())
+        {
+            return;
+        }
+        events.assign(_pending.begin(), _pending.end());
+        first = _first;
+        next = _committed;
+        firstTime = _first == _committed ? events.front().time : _firstTime;
+        size = _size;
+    }
+
+    try
+    {
+        IceDB::ReadWriteTxn txn(_instance->dbEnv());
+        {
+            //
+            // The log can be destroyed by another transaction while this
+            // transaction waits to start.
+            //
+            Lock sync(*this);
+            if(_destroyed)
+            {
+                return;
+            }
+        }
+
+        EventRecordKey key;
+        key.topic = _topic;
+        for(vector<PendingEvent>::const_iterator p = events.begin(); p != events.end(); ++p)
+        {
+            EventRecord record;
+            record.time = p->time;
+            record.op = p->event->op;
+            record.mode = p->event->mode;
+            record.data.assign(p->event->data.begin(), p->event->data.end());
+            record.context = p->event->context.get();
+
+            key.seq = next++;
+            _eventMap.put(txn, key, record);
+            size += recordSize(record);
+        }
+
+        //
+        // Remove the oldest events if the log is too large or if they are too
+        // old, the events just logged are the most recent.
+        //
+        const Ice::Long now = events.back().time;
+        const Ice::Long maxAge = _maxAge.toMilliSeconds();
+        if(size > _maxSize || (maxAge > 0 && firstTime < now - maxAge))
+        {
+            firstTime = now;
+            while(first + 1 < next)
+            {
+                EventRecord record;
+                key.seq = first;
+                if(_eventMap.get(txn, key, record))
+                {
+                    if(size <= _maxSize && (maxAge <= 0 || record.time >= now - maxAge))
+                    {
+                        firstTime = record.time;
+                        break;
+                    }
+                    size -= min(size, recordSize(record));
+                    _eventMap.del(txn, key);
+                }
+                ++first;
+            }
+        }
+
+        txn.commit();
+    }
+    catch(const IceDB::LMDBException&)
+    {
+        //
+        // The events are not logged, their sequence numbers are skipped.
+        //
+        Lock sync(*this);
+        if(!_destroyed)
+        {
+            _pending.erase(_pending.begin(), _pending.begin() + static_cast<ptrdiff_t>(events.size()));
+            _committed += static_cast<Ice::Long>(events.size());
+        }
+        throw;
+    }
+
+    Lock sync(*this);
+    if(_destroyed)
+    {
+        return;
+    }
+    _pending.erase(_pending.begin(), _pending.begin() + static_cast<ptrdiff_t>(events.size()));
+    _committed = next;
+    _first = first;
+    _firstTime = firstTime;
+    _size = size;
+}
+
+Ice::Long
+IceStorm::EventLog::next() const
+{
+    Lock sync(*this);
+    if(!_loaded)
+    {
+        IceDB::ReadOnlyTxn txn(_instance->dbEnv());
+        load(txn);
+    }
+    return _next;
+}
+
+Ice::Long
+IceStorm::EventLog::find(const IceUtil::Time& time) const
+{
+    Lock sync(*this);
+
+    IceDB::ReadOnlyTxn txn(_instance->dbEnv());
+    load(txn);
+
+    const Ice::Long t = time.toMilliSeconds();
+    if(_first == _next || _firstTime >= t)
+    {
+        return _first;
+    }
+
+    //
+    // The events are logged in time order, search the first event logged
+    // at or after the given time.
+    //
+    EventRecordKey key;
+    key.topic = _topic;
+    Ice::Long low = _first + 1;
+    Ice::Long high = _next;
+    while(low < high)
+    {
+        key.seq = low + (high - low) / 2;
+        EventRecord record;
+        if(!_eventMap.get(txn, key, record) || record.time >= t)
+        {
+            high = key.seq;
+        }
+        else
+        {
+            low = key.seq + 1;
+        }
+    }
+    return low;
+}
+
+Ice::Long
+IceStorm::EventLog::read(Ice::Long seq, Ice::Long end, PreparedEventSeq& events) const
+{
+    Lock sync(*this);
+
+    IceDB::ReadOnlyTxn txn(_instance->dbEnv());
+    load(txn);
+
+    seq = max(seq, _first);
+    end = min(end, _next);
+    if(seq >= end)
+    {
+        return seq;
+    }
+
+    //
+    // The committed events are read from the database, the events skipped
+    // by a failed commit are missing. The events not yet committed are
+    // read from the pending events.
+    //
+    if(seq < _committed)
+    {
+        const Ice::Long committedEnd = min(end, _committed);
+        EventMapROCursor cursor(_eventMap, txn);
+
+        EventRecordKey key;
+        key.topic = _topic;
+        key.seq = seq;
+        EventRecord record;
+        bool found = cursor.findRange(key, record);
+        while(found && key.topic == _topic && key.seq < committedEnd)
+        {
+            events.push_back(new PreparedEvent(record.op, record.mode, record.data, record.context));
+            seq = key.seq + 1;
+            if(events.size() >= _replayBatchSize)
+            {
+                return seq;
+            }
+            found = cursor.get(key, record, MDB_NEXT);
+        }
+        seq = committedEnd;
+    }
+
+    for(Ice::Long p = seq - _committed; seq < end; ++p, ++seq)
+    {
+        events.push_back(_pending[static_cast<size_t>(p)].event);
+        if(events.size() >= _replayBatchSize)
+        {
+            return seq + 1;
+        }
+    }
+    return end;
+}
+
+void
+IceStorm::EventLog::destroy(const IceDB::ReadWriteTxn& txn)
+{
+    Lock sync(*this);
+    load(txn);
+
+    EventRecordKey key;
+    key.topic = _topic;
+    for(key.seq = _first; key.seq < _committed; ++key.seq)
+    {
+        _eventMap.del(txn, key);
+    }
+    _pending.clear();
+    _destroyed = true;
+}
+
+void
+IceStorm::EventLog::load(const IceDB::Txn& txn) const
+{
+    if(_loaded)
+    {
+        return;
+    }
+
+    //
+    // Load the bounds and the size of the log from the events of the topic.
+    // The log is loaded with the transaction of its first use, the topics
+    // are created while the topic manager reads the database.
+    //
+    EventMapCursor cursor(_eventMap, txn);
+
+    EventRecordKey key;
+    key.topic = _topic;
+    key.seq = 0;
+    EventRecord record;
+    if(cursor.findRange(key, record) && key.topic == _topic)
+    {
+        _first = key.seq;
+        _firstTime = record.time;
+        do
+        {
+            _next = key.seq + 1;
+            _size += recordSize(record);
+        }
+        while(cursor.get(key, record, MDB_NEXT) && key.topic == _topic);
+    }
+    _committed = _next;
+    _loaded = true;
+}
@@ -0,0 +1,116 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <IceStorm/PreparedEvent.h>
+#include <IceStorm/Util.h>
+#include <IceUtil/Mutex.h>
+#include <deque>
+
+namespace IceStorm
+{
+
+class PersistentInstance;
+typedef IceUtil::Handle<PersistentInstance> PersistentInstancePtr;
+
+//
+// The context entry set to the sequence number of the events of a topic
+// with an event log.
+//
+const std::string eventSequenceContextKey = "IceStorm.Sequence";
+
+//
+// The append-only log of the events of a persistent topic, stored in the
+// database of the service. The events are numbered from 0 and the oldest
+// events are removed when the log exceeds its maximum size or age, the
+// last event is always kept so that the numbering continues after a
+// restart. New subscribers can replay the events still in the log.
+//
+// The events are numbered by append and committed to the database by
+// commit, so that the topic numbers its events with its subscribers locked
+// and commits them without. The events appended by concurrent publishers
+// are committed together. The events not yet committed are replayed from
+// memory.
+//
+// By default the events are committed before they are queued to the
+// subscribers. With <service>.EventLog.FlushInterval set, the events are
+// committed in the background at most every given number of milliseconds,
+// the events not yet committed are lost if the service stops abruptly.
+//
+// The events of replicated topics are not logged.
+//
+class EventLog : public IceUtil::Shared, private IceUtil::Mutex
+{
+public:
+
+    // Returns true if the events of the given topic are logged.
+    static bool enabled(const PersistentInstancePtr&, const std::string&);
+
+    EventLog(const PersistentInstancePtr&, const Ice::Identity&);
+
+    // Numbers the events, sets their sequence number in their context and
+    // adds them to the events to commit.
+    void append(const PreparedEventSeq&);
+
+    // Commits the appended events, or schedules their commit if the log is
+    // committed in the background.
+    void commit();
+
+    // Commits the appended events, returns once they are committed.
+    void flush();
+
+    // The sequence number of the next event.
+    Ice::Long next() const;
+
+    // Returns the sequence number of the first event logged at or after
+    // the given time.
+    Ice::Long find(const IceUtil::Time&) const;
+
+    //
+    // Reads a batch of events from the given sequence number and before the
+    // given end, and returns the sequence number of the next event to read.
+    // The events removed from the log are skipped.
+    //
+    Ice::Long read(Ice::Long, Ice::Long, PreparedEventSeq&) const;
+
+    // Removes all the events of the log.
+    void destroy(const IceDB::ReadWriteTxn&);
+
+private:
+
+    void load(const IceDB::Txn&) const;
+
+    const PersistentInstancePtr _instance;
+    const Ice::Identity _topic;
+    const size_t _maxSize;
+    const IceUtil::Time _maxAge;
+    const size_t _replayBatchSize;
+    const IceUtil::Time _flushInterval;
+    EventMap _eventMap;
+
+    mutable Ice::Long _first; // The sequence number of the first event.
+    mutable Ice::Long _next; // The sequence number of the next event.
+    mutable Ice::Long _committed; // The sequence number of the first event not yet committed.
+    mutable Ice::Long _firstTime; // The time of the first event.
+    mutable size_t _size; // The size of the committed events.
+    bool _destroyed;
+    mutable bool _loaded;
+    bool _flushScheduled; // True if a background commit is scheduled.
+
+    struct PendingEvent
+    {
+        Ice::Long time;
+        PreparedEventPtr event;
+    };
+    std::deque<PendingEvent> _pending; // The events from _committed to _next.
+
+    IceUtil::Mutex _flushMutex; // Serializes the commits.
+};
+typedef IceUtil::Handle<EventLog> EventLogPtr;
+
+} // End namespace IceStorm
+
+#endif
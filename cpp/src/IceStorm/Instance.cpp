@@ -7,6 +7,7 @@
 #include <IceStorm/Observers.h>
 #include <IceStorm/NodeI.h>
 #include <IceStorm/InstrumentationI.h>
+#include <IceStorm/Delivery.h>
 #include <IceUtil/Timer.h>
 
 #include <Ice/InstrumentationI.h>
@@ -50,7 +51,7 @@ PersistentInstance::PersistentInstance(
     const NodePrx& nodeProxy) :
     Instance(instanceName, name, communicator, publishAdapter, topicAdapter, nodeAdapter, nodeProxy),
     _dbLock(communicator->getProperties()->getPropertyWithDefault(name + ".LMDB.Path", name) + "/icedb.lock"),
-    _dbEnv(communicator->getProperties()->getPropertyWithDefault(name + ".LMDB.Path", name), 2,
+    _dbEnv(communicator->getProperties()->getPropertyWithDefault(name + ".LMDB.Path", name), 3,
            IceDB::getMapSize(communicator->getProperties()->getPropertyAsInt(name + ".LMDB.MapSize")))
 {
     try
@@ -63,6 +64,7 @@ PersistentInstance::PersistentInstance(
 
         _lluMap = LLUMap(txn, "llu", dbContext, MDB_CREATE);
         _subscriberMap = SubscriberMap(txn, "subscribers", dbContext, MDB_CREATE, compareSubscriberRecordKey);
+        _eventMap = EventMap(txn, "events", dbContext, MDB_CREATE, compareEventRecordKey);
 
         txn.commit();
     }
@@ -108,6 +110,13 @@ Instance::Instance(
     _sendTimeout(communicator->getProperties()->getPropertyAsIntWithDefault(name + ".Send.Timeout", 60 * 1000)),
     _sendQueueSizeMax(communicator->getProperties()->getPropertyAsIntWithDefault(name + ".Send.QueueSizeMax", -1)),
     _sendQueueSizeMaxPolicy(RemoveSubscriber),
+    // The memory limits are in kilobytes, default no limit.
+    _sendQueueMemoryMax(static_cast<Ice::Long>(communicator->getProperties()->getPropertyAsIntWithDefault(
+                                                   name + ".Send.QueueMemoryMax", -1)) * 1024),
+    _sendTopicMemoryMax(static_cast<Ice::Long>(communicator->getProperties()->getPropertyAsIntWithDefault(
+                                                   name + ".Send.TopicMemoryMax", -1)) * 1024),
+    _memoryMaxPolicy(MemoryBudget::EvictOldest),
+    _partitioned(communicator->getProperties()->getPropertyAsInt(name + ".Partitioned") > 0),
     _topicReaper(new TopicReaper())
 {
     try
@@ -132,6 +141,14 @@ Instance::Instance(
         _batchFlusher = new IceUtil::Timer();
         _timer = new IceUtil::Timer();
 
+        //
+        // By default, the publishing thread queues the events to all the
+        // subscribers of a topic.
+        //
+        _deliveryWorkers = new DeliveryWorkers(properties->getPropertyAsInt(name + ".Delivery.Workers"),
+                                               properties->getPropertyAsIntWithDefault(name + ".Delivery.MinShardSize",
+                                                                                       64));
+
         string policy = properties->getProperty(name + ".Send.QueueSizeMaxPolicy");
         if(policy == "RemoveSubscriber")
         {
@@ -147,6 +164,31 @@ Instance::Instance(
             warn << "invalid value `" << policy << "' for `" << name << ".Send.QueueSizeMaxPolicy'";
         }
 
+        policy = properties->getProperty(name + ".Send.MemoryMaxPolicy");
+        if(policy == "DropEvents")
+        {
+            const_cast<MemoryBudget::Policy&>(_memoryMaxPolicy) = MemoryBudget::DropEvents;
+        }
+        else if(policy == "RemoveSubscriber")
+        {
+            const_cast<MemoryBudget::Policy&>(_memoryMaxPolicy) = MemoryBudget::RemoveSubscriber;
+        }
+        else if(policy == "EvictOldest")
+        {
+            const_cast<MemoryBudget::Policy&>(_memoryMaxPolicy) = MemoryBudget::EvictOldest;
+        }
+        else if(!policy.empty())
+        {
+            Ice::Warning warn(_traceLevels->logger);
+            warn << "invalid value `" << policy << "' for `" << name << ".Send.MemoryMaxPolicy'";
+        }
+
+        int memoryMax = properties->getPropertyAsIntWithDefault(name + ".Send.MemoryMax", -1);
+        if(memoryMax >= 0)
+        {
+            _memoryBudget = new MemoryBudget(static_cast<Ice::Long>(memoryMax) * 1024, _memoryMaxPolicy);
+        }
+
         //
         // If an Ice metrics observer is setup on the communicator, also
         // enable metrics for IceStorm.
@@ -277,6 +319,12 @@ Instance::topicReaper() const
     return _topicReaper;
 }
 
+DeliveryWorkersPtr
+Instance::deliveryWorkers() const
+{
+    return _deliveryWorkers;
+}
+
 IceUtil::Time
 Instance::discardInterval() const
 {
@@ -307,6 +355,34 @@ Instance::sendQueueSizeMaxPolicy() const
     return _sendQueueSizeMaxPolicy;
 }
 
+Ice::Long
+Instance::sendQueueMemoryMax() const
+{
+    return _sendQueueMemoryMax;
+}
+
+bool
+Instance::partitioned() const
+{
+    return _partitioned;
+}
+
+MemoryBudgetPtr
+Instance::memoryBudget() const
+{
+    return _memoryBudget;
+}
+
+MemoryBudgetPtr
+Instance::newTopicMemoryBudget() const
+{
+    if(_sendTopicMemoryMax < 0)
+    {
+        return 0;
+    }
+    return new MemoryBudget(_sendTopicMemoryMax, _memoryMaxPolicy);
+}
+
 void
 Instance::shutdown()
 {
@@ -324,6 +400,14 @@ Instance::shutdown()
     {
         _timer->destroy();
     }
+
+    //
+    // The publish adapter is destroyed, no more events are delivered.
+    //
+    if(_deliveryWorkers)
+    {
+        _deliveryWorkers->destroy();
+    }
 }
 
 void
@@ -344,4 +428,9 @@ Instance::destroy()
     // cyclic reference.
     //
     _observer = 0;
+    //
+    // The memory budget must be cleared as it holds the subscribers
+    // with queued events which hold the instance.
+    //
+    _memoryBudget = 0;
 }
@@ -12,6 +12,7 @@
 #include <IceStorm/Election.h>
 #include <IceStorm/Instrumentation.h>
 #include <IceStorm/Util.h>
+#include <IceStorm/MemoryBudget.h>
 
 namespace IceUtil
 {
@@ -38,6 +39,9 @@ namespace IceStorm
 class TraceLevels;
 typedef IceUtil::Handle<TraceLevels> TraceLevelsPtr;
 
+class DeliveryWorkers;
+typedef IceUtil::Handle<DeliveryWorkers> DeliveryWorkersPtr;
+
 class TopicReaper : public IceUtil::Shared, private IceUtil::Mutex
 {
 public:
@@ -83,12 +87,23 @@ public:
     Ice::ObjectPrx publisherReplicaProxy() const;
     IceStorm::Instrumentation::TopicManagerObserverPtr observer() const;
     TopicReaperPtr topicReaper() const;
+    DeliveryWorkersPtr deliveryWorkers() const;
 
     IceUtil::Time discardInterval() const;
     IceUtil::Time flushInterval() const;
     int sendTimeout() const;
     int sendQueueSizeMax() const;
     SendQueueSizeMaxPolicy sendQueueSizeMaxPolicy() const;
+    Ice::Long sendQueueMemoryMax() const;
+
+    // Returns true if the topics are partitioned across the replicas.
+    bool partitioned() const;
+
+    // The memory budget of the service, or null if the memory isn't limited.
+    MemoryBudgetPtr memoryBudget() const;
+
+    // Returns a new memory budget for a topic, or null if the memory of the topics isn't limited.
+    MemoryBudgetPtr newTopicMemoryBudget() const;
 
     void shutdown();
     virtual void destroy();
@@ -108,6 +123,11 @@ private:
     const int _sendTimeout;
     const int _sendQueueSizeMax;
     const SendQueueSizeMaxPolicy _sendQueueSizeMaxPolicy;
+    const Ice::Long _sendQueueMemoryMax;
+    const Ice::Long _sendTopicMemoryMax;
+    const MemoryBudget::Policy _memoryMaxPolicy;
+    const bool _partitioned;
+    MemoryBudgetPtr _memoryBudget;
     const Ice::ObjectPrx _topicReplicaProxy;
     const Ice::ObjectPrx _publisherReplicaProxy;
     const TopicReaperPtr _topicReaper;
@@ -115,6 +135,7 @@ private:
     IceStormElection::ObserversPtr _observers;
     IceUtil::TimerPtr _batchFlusher;
     IceUtil::TimerPtr _timer;
+    DeliveryWorkersPtr _deliveryWorkers;
     IceStorm::Instrumentation::TopicManagerObserverPtr _observer;
 
 };
@@ -134,6 +155,7 @@ public:
     const IceDB::Env& dbEnv() const { return _dbEnv; }
     LLUMap lluMap() const { return _lluMap; }
     SubscriberMap subscriberMap() const { return _subscriberMap; }
+    EventMap eventMap() const { return _eventMap; }
 
     virtual void destroy();
 
@@ -143,6 +165,7 @@ private:
     IceDB::Env _dbEnv;
     LLUMap _lluMap;
     SubscriberMap _subscriberMap;
+    EventMap _eventMap;
 };
 typedef IceUtil::Handle<PersistentInstance> PersistentInstancePtr;
 
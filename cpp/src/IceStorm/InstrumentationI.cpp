@@ -266,10 +266,7 @@ struct OutstandingUpdate
 
     void operator()(const SubscriberMetricsPtr& v)
     {
-        if(v->queued > 0)
-        {
-            v->queued -= count;
-        }
+        v->queued -= count;
         v->outstanding += count;
     }
 
@@ -313,6 +310,86 @@ SubscriberObserverI::delivered(int count)
     forEach(DeliveredUpdate(count));
 }
 
+namespace
+{
+
+struct DroppedUpdate
+{
+    DroppedUpdate(int countP) : count(countP)
+    {
+    }
+
+    void operator()(const SubscriberMetricsPtr& v)
+    {
+        v->queued -= count;
+        v->dropped = *v->dropped + count;
+    }
+
+    int count;
+};
+
+struct QueuedBytesUpdate
+{
+    QueuedBytesUpdate(Ice::Long bytesP) : bytes(bytesP)
+    {
+    }
+
+    void operator()(const SubscriberMetricsPtr& v)
+    {
+        v->queuedBytes = *v->queuedBytes + bytes;
+    }
+
+    Ice::Long bytes;
+};
+
+struct BatchedUpdate
+{
+    BatchedUpdate(int countP) : count(countP)
+    {
+    }
+
+    void operator()(const SubscriberMetricsPtr& v)
+    {
+        size_t bucket = 0;
+        for(int n = count; n > 1; n >>= 1)
+        {
+            ++bucket;
+        }
+        if(!v->batchSizes)
+        {
+            v->batchSizes = Ice::LongSeq();
+        }
+        Ice::LongSeq& batchSizes = *v->batchSizes;
+        if(batchSizes.size() <= bucket)
+        {
+            batchSizes.resize(bucket + 1, 0);
+        }
+        ++batchSizes[bucket];
+    }
+
+    int count;
+};
+
+}
+
+void
+SubscriberObserverI::dropped(int count)
+{
+    forEach(DroppedUpdate(count));
+}
+
+void
+SubscriberObserverI::queuedBytes(Ice::Long bytes)
+{
+    forEach(QueuedBytesUpdate(bytes));
+}
+
+void
+SubscriberObserverI::batched(int count)
+{
+    forEach(BatchedUpdate(count));
+}
+
 TopicManagerObserverI::TopicManagerObserverI(const IceInternal::MetricsAdminIPtr& metrics) :
     _metrics(metrics),
     _topics(metrics, "Topic"),
@@ -30,6 +30,9 @@ public:
     virtual void queued(int);
     virtual void outstanding(int);
     virtual void delivered(int);
+    virtual void dropped(int);
+    virtual void queuedBytes(Ice::Long);
+    virtual void batched(int);
 };
 
 class TopicManagerObserverI : public IceStorm::Instrumentation::TopicManagerObserver
@@ -12,8 +12,12 @@ IceStormService_targetdir       := $(libdir)
 IceStormService_dependencies    := IceGrid Glacier2 IceBox IceDB
 IceStormService_cppflags        := $(if $(lmdb_includedir),-I$(lmdb_includedir))
 IceStormService_devinstall      := no
-IceStormService_sources         := $(addprefix $(currentdir)/,Instance.cpp \
+IceStormService_sources         := $(addprefix $(currentdir)/,Delivery.cpp \
+                                                             EventFilter.cpp \
+                                                             EventLog.cpp \
+                                                             Instance.cpp \
                                                              InstrumentationI.cpp \
+                                                             MemoryBudget.cpp \
                                                              NodeI.cpp \
                                                              Observers.cpp \
                                                              Service.cpp \
@@ -25,6 +29,7 @@ IceStormService_sources         := $(addprefix $(currentdir)/,Instance.cpp \
                                                              TransientTopicManagerI.cpp \
                                                              Util.cpp \
                                                              Election.ice \
+                                                             EventRecord.ice \
                                                              IceStormInternal.ice \
                                                              Instrumentation.ice \
                                                              LinkRecord.ice \
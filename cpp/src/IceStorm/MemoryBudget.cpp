@@ -0,0 +1,161 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <IceStorm/MemoryBudget.h>
+#include <IceStorm/Subscriber.h>
+
+using namespace std;
+using namespace IceStorm;
+
+IceStorm::MemoryBudget::MemoryBudget(Ice::Long max, Policy policy) :
+    _max(max),
+    _policy(policy),
+    _used(0)
+{
+}
+
+bool
+IceStorm::MemoryBudget::add(const SubscriberPtr& subscriber, PreparedEventSeq::const_iterator first,
+                            PreparedEventSeq::const_iterator last)
+{
+    Lock sync(*this);
+    Ice::Long bytes = 0;
+    for(PreparedEventSeq::const_iterator p = first; p != last; ++p)
+    {
+        QueuedEvent& event = _events[p->get()];
+        if(event.count++ == 0)
+        {
+            event.size = eventSize(*p);
+            _used += event.size;
+        }
+        bytes += event.size;
+    }
+    if(bytes > 0)
+    {
+        _subscribers[subscriber] += bytes;
+    }
+    return _used <= _max;
+}
+
+void
+IceStorm::MemoryBudget::remove(const SubscriberPtr& subscriber, PreparedEventSeq::const_iterator first,
+                               PreparedEventSeq::const_iterator last)
+{
+    Lock sync(*this);
+    Ice::Long bytes = 0;
+    for(PreparedEventSeq::const_iterator p = first; p != last; ++p)
+    {
+        map<const EventData*, QueuedEvent>::iterator q = _events.find(p->get());
+        if(q == _events.end())
+        {
+            continue;
+        }
+
+        bytes += q->second.size;
+        if(--q->second.count == 0)
+        {
+            _used -= q->second.size;
+            _events.erase(q);
+        }
+    }
+
+    map<SubscriberPtr, Ice::Long>::iterator p = _subscribers.find(subscriber);
+    if(p != _subscribers.end())
+    {
+        p->second -= bytes;
+        if(p->second <= 0)
+        {
+            _subscribers.erase(p);
+        }
+    }
+}
+
+void
+IceStorm::MemoryBudget::shed()
+{
+    while(true)
+    {
+        //
+        // The subscribers are called without the budget locked, they
+        // update the budget with their own mutex locked.
+        //
+        SubscriberPtr victim;
+        Ice::Long excess;
+        vector<SubscriberPtr> subscribers;
+        {
+            Lock sync(*this);
+            if(_used <= _max || _subscribers.empty())
+            {
+                return;
+            }
+
+            excess = _used - _max;
+            if(_policy == EvictOldest)
+            {
+                for(map<SubscriberPtr, Ice::Long>::const_iterator p = _subscribers.begin(); p != _subscribers.end(); ++p)
+                {
+                    subscribers.push_back(p->first);
+                }
+            }
+            else
+            {
+                Ice::Long largest = 0;
+                for(map<SubscriberPtr, Ice::Long>::const_iterator p = _subscribers.begin(); p != _subscribers.end(); ++p)
+                {
+                    if(p->second > largest)
+                    {
+                        victim = p->first;
+                        largest = p->second;
+                    }
+                }
+            }
+        }
+
+        //
+        // With EvictOldest, the subscriber with the oldest queued event
+        // sheds its events queued before the oldest event of the other
+        // subscribers.
+        //
+        Ice::Long before = 0;
+        if(_policy == EvictOldest)
+        {
+            Ice::Long oldest = 0;
+            bool next = false;
+            for(vector<SubscriberPtr>::const_iterator p = subscribers.begin(); p != subscribers.end(); ++p)
+            {
+                Ice::Long time;
+                if(!(*p)->oldest(time))
+                {
+                    continue;
+                }
+
+                if(!victim || time < oldest)
+                {
+                    if(victim)
+                    {
+                        before = oldest;
+                        next = true;
+                    }
+                    victim = *p;
+                    oldest = time;
+                }
+                else if(!next || time < before)
+                {
+                    before = time;
+                    next = true;
+                }
+            }
+
+            if(!next)
+            {
+                before = IceUtil::Time::now(IceUtil::Time::Monotonic).toMicroSeconds();
+            }
+        }
+
+        if(!victim || victim->shed(_policy, excess, before) == 0)
+        {
+            return;
+        }
+    }
+}
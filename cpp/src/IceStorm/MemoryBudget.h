@@ -0,0 +1,79 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#ifndef MEMORY_BUDGET_H
+#define MEMORY_BUDGET_H
+
+#include <IceStorm/PreparedEvent.h>
+#include <IceUtil/Mutex.h>
+#include <map>
+
+namespace IceStorm
+{
+
+class Subscriber;
+typedef IceUtil::Handle<Subscriber> SubscriberPtr;
+
+//
+// The size in bytes of the events queued for the subscribers of a topic or
+// of the service, and its maximum. The subscribers report the size of the
+// events they queue and dequeue. Once the maximum is exceeded, queued events
+// are shed according to the policy until the budget is met again:
+//
+// - DropEvents: the oldest events of the subscriber with the largest queue
+//   are dropped.
+// - RemoveSubscriber: the subscriber with the largest queue is removed.
+// - EvictOldest: the oldest events queued for any of the subscribers are
+//   dropped.
+//
+// An event shared by several subscribers, such as an event published to a
+// topic with several subscribers, is counted once: the budget counts the
+// subscribers that queue each event. The size of the queue of a subscriber,
+// used to pick the subscriber that sheds its events, includes its shared
+// events.
+//
+class MemoryBudget : public IceUtil::Shared, private IceUtil::Mutex
+{
+public:
+
+    enum Policy
+    {
+        DropEvents,
+        RemoveSubscriber,
+        EvictOldest
+    };
+
+    MemoryBudget(Ice::Long, Policy);
+
+    //
+    // Adds the given events to the events queued for the subscriber,
+    // returns false if the budget is exceeded.
+    //
+    bool add(const SubscriberPtr&, PreparedEventSeq::const_iterator, PreparedEventSeq::const_iterator);
+
+    // Removes the given events from the events queued for the subscriber.
+    void remove(const SubscriberPtr&, PreparedEventSeq::const_iterator, PreparedEventSeq::const_iterator);
+
+    // Sheds queued events until the budget is met.
+    void shed();
+
+private:
+
+    const Ice::Long _max;
+    const Policy _policy;
+    Ice::Long _used;
+    std::map<SubscriberPtr, Ice::Long> _subscribers; // The subscribers with queued events.
+
+    struct QueuedEvent
+    {
+        Ice::Int count; // The number of times the event is queued.
+        Ice::Long size; // The size in bytes of the event.
+    };
+    std::map<const EventData*, QueuedEvent> _events; // The queued events.
+};
+typedef IceUtil::Handle<MemoryBudget> MemoryBudgetPtr;
+
+} // End namespace IceStorm
+
+#endif
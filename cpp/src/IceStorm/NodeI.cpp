@@ -67,6 +67,20 @@ public:
     }
 };
 
+class RefreshReplicasTask : public IceUtil::TimerTask
+{
+    const NodeIPtr _node;
+    const Ice::Long _generation;
+
+public:
+
+    RefreshReplicasTask(const NodeIPtr& node, Ice::Long generation) : _node(node), _generation(generation) { }
+    virtual void runTimerTask()
+    {
+        _node->refreshReplicas(_generation);
+    }
+};
+
 }
 
 namespace
@@ -156,6 +170,7 @@ NodeI::NodeI(const InstancePtr& instance,
     _observers(instance->observers()),
     _replica(replica),
     _replicaProxy(replicaProxy),
+    _partitioned(instance->partitioned()),
     _id(id),
     _nodes(nodes),
     _state(NodeStateInactive),
@@ -688,11 +703,11 @@ NodeI::mergeContinue()
             out << "replication commencing with " << _up.size()+1 << "/" << _nodes.size()
                 << " nodes with llu generation: " << maxllu.generation;
         }
+        _generation = maxllu.generation;
+
         setState(NodeStateNormal);
         _coordinatorProxy = 0;
 
-        _generation = maxllu.generation;
-
         assert(!_checkTask);
         _checkTask = new CheckTask(this);
         _timer->schedule(_checkTask, _electionTimeout);
@@ -993,6 +1008,102 @@ NodeI::query(const Ice::Current&) const
     return info;
 }
 
+Ice::ObjectPrx
+NodeI::partitionOwner(const string& topic) const
+{
+    const int owner = partitionOwnerId(topic);
+    if(owner == _id)
+    {
+        return _replicaProxy;
+    }
+
+    Lock sync(*this);
+    map<int, Ice::ObjectPrx>::const_iterator p = _replicas.find(owner);
+    return p != _replicas.end() ? p->second : Ice::ObjectPrx();
+}
+
+bool
+NodeI::ownsPartition(const string& topic) const
+{
+    return partitionOwnerId(topic) == _id;
+}
+
+void
+NodeI::refreshReplicas(Ice::Long generation)
+{
+    //
+    // Query the other nodes without the mutex locked, the nodes of another
+    // group or not yet active are ignored.
+    //
+    string group;
+    {
+        Lock sync(*this);
+        if(_destroy || _state != NodeStateNormal || _generation != generation)
+        {
+            return;
+        }
+        group = _group;
+    }
+
+    map<int, Ice::ObjectPrx> replicas;
+    for(map<int, NodePrx>::const_iterator p = _nodes.begin(); p != _nodes.end(); ++p)
+    {
+        if(p->first == _id)
+        {
+            continue;
+        }
+        try
+        {
+            QueryInfo info = p->second->query();
+            if(info.group == group && info.state == NodeStateNormal)
+            {
+                replicas[p->first] = info.replica;
+            }
+        }
+        catch(const Ice::Exception& ex)
+        {
+            if(_traceLevels->replication > 0)
+            {
+                Ice::Trace out(_traceLevels->logger, _traceLevels->replicationCat);
+                out << "node " << _id << ": query on node " << p->first << " failed: " << ex;
+            }
+        }
+    }
+
+    Lock sync(*this);
+    if(_destroy || _state != NodeStateNormal || _generation != generation)
+    {
+        return;
+    }
+    _replicas.swap(replicas);
+
+    //
+    // The nodes that are not yet active or not reachable are queried again
+    // later, their topics use the replicated proxies meanwhile.
+    //
+    if(_replicas.size() + 1 < _nodes.size())
+    {
+        _timer->schedule(new RefreshReplicasTask(this, generation), _electionTimeout);
+    }
+}
+
+int
+NodeI::partitionOwnerId(const string& topic) const
+{
+    //
+    // The topics are assigned to the nodes from the FNV-1a hash of their
+    // name, all the replicas compute the same owner.
+    //
+    unsigned int hash = 2166136261U;
+    for(string::const_iterator p = topic.begin(); p != topic.end(); ++p)
+    {
+        hash = (hash ^ static_cast<unsigned char>(*p)) * 16777619U;
+    }
+    map<int, NodePrx>::const_iterator owner = _nodes.begin();
+    advance(owner, static_cast<ptrdiff_t>(hash % _nodes.size()));
+    return owner->first;
+}
+
 void
 NodeI::recovery(Ice::Long generation)
 {
@@ -1246,5 +1357,19 @@ NodeI::setState(NodeState s)
         {
             notifyAll();
         }
+
+        //
+        // The replicas of the group can change with each election, the
+        // owners of the partitioned topics are refreshed once the group
+        // is active.
+        //
+        if(_partitioned)
+        {
+            _replicas.clear();
+            if(_state == NodeStateNormal)
+            {
+                _timer->schedule(new RefreshReplicasTask(this, _generation), IceUtil::Time());
+            }
+        }
     }
 }
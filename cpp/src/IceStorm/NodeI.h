@@ -52,12 +52,27 @@ public:
     void startObserverUpdate(Ice::Long, const char*, int);
     bool updateMaster(const char*, int);
 
+    //
+    // Returns the proxy of the replica that owns the topic with the given
+    // name when the topics are partitioned, or null if its owner isn't
+    // known to be in the replica group. The proxies of the other replicas
+    // are refreshed after each election.
+    //
+    Ice::ObjectPrx partitionOwner(const std::string&) const;
+
+    // Returns true if this replica owns the topic with the given name.
+    bool ownsPartition(const std::string&) const;
+
+    // Refreshes the proxies of the other replicas of the group.
+    void refreshReplicas(Ice::Long);
+
     // The node has completed the update.
     void finishUpdate();
 
 private:
 
     void setState(NodeState);
+    int partitionOwnerId(const std::string&) const;
 
     const IceUtil::TimerPtr _timer;
     const IceStorm::TraceLevelsPtr _traceLevels;
@@ -65,6 +80,7 @@ private:
     const ReplicaPtr _replica; // The replica.
     const Ice::ObjectPrx _replicaProxy; // A proxy to the individual replica.
 
+    const bool _partitioned; // True if the topics are partitioned.
     const int _id; // My node id.
     const std::map<int, NodePrx> _nodes; // The nodes indexed by their id.
     const std::map<int, NodePrx> _nodesOneway; // The nodes indexed by their id (as oneway proxies).
@@ -87,6 +103,7 @@ private:
     Ice::Long _generation; // The current generation (or -1 if not set).
 
     Ice::ObjectPrx _coordinatorProxy;
+    std::map<int, Ice::ObjectPrx> _replicas; // The proxies of the other replicas of the group, by node id.
     bool _destroy;
 
     // Various timers.
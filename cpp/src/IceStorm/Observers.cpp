@@ -5,6 +5,7 @@
 #include <IceStorm/Observers.h>
 #include <IceStorm/Instance.h>
 #include <IceStorm/TraceLevels.h>
+#include <algorithm>
 
 using namespace std;
 using namespace IceStorm;
@@ -12,7 +13,8 @@ using namespace IceStormElection;
 
 Observers::Observers(const InstancePtr& instance) :
     _traceLevels(instance->traceLevels()),
-    _majority(0)
+    _majority(0),
+    _committing(false)
 {
 }
 
@@ -62,6 +64,10 @@ void
 Observers::clear()
 {
     Lock sync(*this);
+    while(_committing)
+    {
+        wait();
+    }
     _observers.clear();
 }
 
@@ -81,6 +87,10 @@ Observers::init(const set<GroupNodeInfo>& slaves, const LogUpdate& llu, const To
     }
 
     Lock sync(*this);
+    while(_committing)
+    {
+        wait();
+    }
     _observers.clear();
 
     vector<ObserverInfo> observers;
@@ -131,80 +141,286 @@ Observers::init(const set<GroupNodeInfo>& slaves, const LogUpdate& llu, const To
 void
 Observers::createTopic(const LogUpdate& llu, const string& name)
 {
-    Lock sync(*this);
-    for(vector<ObserverInfo>::iterator p = _observers.begin(); p != _observers.end(); ++p)
-    {
-        p->result = p->observer->begin_createTopic(llu, name);
-    }
-    wait("createTopic");
+    ReplicaUpdate update;
+    update.kind = CreateTopicUpdate;
+    update.llu = llu;
+    update.topic = name;
+    commit(update);
 }
 
 void
 Observers::destroyTopic(const LogUpdate& llu, const string& id)
 {
-    Lock sync(*this);
-    for(vector<ObserverInfo>::iterator p = _observers.begin(); p != _observers.end(); ++p)
-    {
-        p->result = p->observer->begin_destroyTopic(llu, id);
-    }
-    wait("destroyTopic");
+    ReplicaUpdate update;
+    update.kind = DestroyTopicUpdate;
+    update.llu = llu;
+    update.topic = id;
+    commit(update);
 }
 
 void
 Observers::addSubscriber(const LogUpdate& llu, const string& name, const SubscriberRecord& rec)
 {
-    Lock sync(*this);
-    for(vector<ObserverInfo>::iterator p = _observers.begin(); p != _observers.end(); ++p)
+    ReplicaUpdate update;
+    update.kind = AddSubscriberUpdate;
+    update.llu = llu;
+    update.topic = name;
+    update.record = rec;
+    commit(update);
+}
+
+void
+Observers::removeSubscriber(const LogUpdate& llu, const string& name, const Ice::IdentitySeq& id)
+{
+    ReplicaUpdate update;
+    update.kind = RemoveSubscriberUpdate;
+    update.llu = llu;
+    update.topic = name;
+    update.subscribers = id;
+    commit(update);
+}
+
+namespace
+{
+
+struct PendingUpdateLess
+{
+    template<typename T> bool
+    operator()(const T* lhs, const T* rhs) const
     {
-        p->result = p->observer->begin_addSubscriber(llu, name, rec);
+        const LogUpdate& l = lhs->update.llu;
+        const LogUpdate& r = rhs->update.llu;
+        return l.generation < r.generation || (l.generation == r.generation && l.iteration < r.iteration);
     }
-    wait("addSubscriber");
+};
+
 }
 
 void
-Observers::removeSubscriber(const LogUpdate& llu, const string& name, const Ice::IdentitySeq& id)
+Observers::commit(const ReplicaUpdate& update)
 {
+    PendingUpdate pending(update);
+
     Lock sync(*this);
-    for(vector<ObserverInfo>::iterator p = _observers.begin(); p != _observers.end(); ++p)
+    _pending.push_back(&pending);
+    while(!pending.done)
     {
-        p->result = p->observer->begin_removeSubscriber(llu, name, id);
+        if(_committing)
+        {
+            wait();
+            continue;
+        }
+
+        //
+        // Replicate the queued updates, including this update, as a group.
+        // The updates queued meanwhile are replicated by the next group.
+        //
+        vector<PendingUpdate*> group;
+        group.swap(_pending);
+        _committing = true;
+        try
+        {
+            replicate(sync, group);
+        }
+        catch(...)
+        {
+            for(vector<PendingUpdate*>::const_iterator p = group.begin(); p != group.end(); ++p)
+            {
+                (*p)->done = true;
+                (*p)->failed = true;
+            }
+            _committing = false;
+            notifyAll();
+            throw;
+        }
+        _committing = false;
+        notifyAll();
+    }
+
+    // If we no longer have the majority of observers we raise.
+    if(pending.failed)
+    {
+        throw Ice::UnknownException(__FILE__, __LINE__);
     }
-    wait("removeSubscriber");
 }
 
 void
-Observers::wait(const string& op)
+Observers::replicate(Lock& sync, vector<PendingUpdate*>& group)
 {
-    vector<ObserverInfo>::iterator p = _observers.begin();
-    while(p != _observers.end())
+    //
+    // The updates of different topics can be queued out of the order of
+    // their log update, the replicas apply them in order.
+    //
+    stable_sort(group.begin(), group.end(), PendingUpdateLess());
+
+    ReplicaUpdateSeq updates;
+    updates.reserve(group.size());
+    for(vector<PendingUpdate*>::const_iterator p = group.begin(); p != group.end(); ++p)
     {
-        try
+        updates.push_back((*p)->update);
+    }
+
+    if(_traceLevels->replication > 1 && !_observers.empty())
+    {
+        Ice::Trace out(_traceLevels->logger, _traceLevels->replicationCat);
+        out << "replicating " << updates.size() << " update(s) to " << _observers.size() << " replica(s)";
+    }
+
+    //
+    // The observers are called without the mutex locked, the updates made
+    // meanwhile are queued.
+    //
+    vector<ObserverInfo> observers = _observers;
+    vector<int> failed;
+    vector<int> legacy;
+    sync.release();
+    try
+    {
+        for(vector<ObserverInfo>::iterator p = observers.begin(); p != observers.end(); ++p)
+        {
+            if(p->legacy)
+            {
+                continue;
+            }
+
+            try
+            {
+                p->result = p->observer->begin_update(updates);
+            }
+            catch(const Ice::Exception& ex)
+            {
+                if(_traceLevels->replication > 0)
+                {
+                    Ice::Trace out(_traceLevels->logger, _traceLevels->replicationCat);
+                    out << "update: " << ex;
+                }
+                failed.push_back(p->id);
+            }
+        }
+
+        for(vector<ObserverInfo>::iterator p = observers.begin(); p != observers.end(); ++p)
         {
-            p->result->waitForCompleted();
-            p->result->throwLocalException();
+            if(!p->result && !p->legacy)
+            {
+                continue;
+            }
+
+            try
+            {
+                if(p->result)
+                {
+                    try
+                    {
+                        p->observer->end_update(p->result);
+                    }
+                    catch(const ObserverInconsistencyException&)
+                    {
+                        // The replica recovers from the inconsistency.
+                    }
+                    catch(const Ice::OperationNotExistException&)
+                    {
+                        //
+                        // The replica runs a version without update, for
+                        // example during a rolling upgrade. The updates are
+                        // sent to this replica one by one from now on.
+                        //
+                        if(_traceLevels->replication > 0)
+                        {
+                            Ice::Trace out(_traceLevels->logger, _traceLevels->replicationCat);
+                            out << "replica " << p->id << " doesn't support update, sending the updates one by one";
+                        }
+                        p->legacy = true;
+                        legacy.push_back(p->id);
+                    }
+                    p->result = 0;
+                }
+                if(p->legacy)
+                {
+                    updateEach(p->observer, updates);
+                }
+            }
+            catch(const Ice::Exception& ex)
+            {
+                if(_traceLevels->replication > 0)
+                {
+                    Ice::Trace out(_traceLevels->logger, _traceLevels->replicationCat);
+                    out << "update: " << ex;
+                }
+                failed.push_back(p->id);
+            }
         }
-        catch(const Ice::Exception& ex)
+    }
+    catch(...)
+    {
+        sync.acquire();
+        throw;
+    }
+    sync.acquire();
+
+    for(vector<int>::const_iterator p = legacy.begin(); p != legacy.end(); ++p)
+    {
+        for(vector<ObserverInfo>::iterator q = _observers.begin(); q != _observers.end(); ++q)
         {
-            if(_traceLevels->replication > 0)
+            if(q->id == *p)
             {
-                Ice::Trace out(_traceLevels->logger, _traceLevels->replicationCat);
-                out << op << ": " << ex;
+                q->legacy = true;
+                break;
             }
-            int id = p->id;
-            p = _observers.erase(p);
+        }
+    }
 
-            IceUtil::Mutex::Lock sync(_reapedMutex);
-            _reaped.push_back(id);
-            continue;
+    for(vector<int>::const_iterator p = failed.begin(); p != failed.end(); ++p)
+    {
+        for(vector<ObserverInfo>::iterator q = _observers.begin(); q != _observers.end(); ++q)
+        {
+            if(q->id == *p)
+            {
+                _observers.erase(q);
+
+                IceUtil::Mutex::Lock reaped(_reapedMutex);
+                _reaped.push_back(*p);
+                break;
+            }
         }
-        ++p;
     }
-    // If we now no longer have the majority of observers we raise.
-    if(_observers.size() < _majority)
+
+    const bool lost = _observers.size() < _majority;
+    for(vector<PendingUpdate*>::const_iterator p = group.begin(); p != group.end(); ++p)
+    {
+        (*p)->done = true;
+        (*p)->failed = lost;
+    }
+}
+
+void
+Observers::updateEach(const ReplicaObserverPrx& observer, const ReplicaUpdateSeq& updates)
+{
+    //
+    // The updates are independent, the replica recovers from an
+    // inconsistent update and the next updates are still sent.
+    //
+    for(ReplicaUpdateSeq::const_iterator p = updates.begin(); p != updates.end(); ++p)
     {
-        // TODO: Trace here?
-        //Ice::Trace out(_traceLevels->logger, _traceLevels->replicationCat);
-        //out << op;
-        throw Ice::UnknownException(__FILE__, __LINE__);
+        try
+        {
+            switch(p->kind)
+            {
+            case CreateTopicUpdate:
+                observer->createTopic(p->llu, p->topic);
+                break;
+            case DestroyTopicUpdate:
+                observer->destroyTopic(p->llu, p->topic);
+                break;
+            case AddSubscriberUpdate:
+                observer->addSubscriber(p->llu, p->topic, p->record);
+                break;
+            case RemoveSubscriberUpdate:
+                observer->removeSubscriber(p->llu, p->topic, p->subscribers);
+                break;
+            }
+        }
+        catch(const ObserverInconsistencyException&)
+        {
+        }
     }
 }
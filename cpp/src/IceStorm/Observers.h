@@ -25,7 +25,15 @@ typedef IceUtil::Handle<TraceLevels> TraceLevelsPtr;
 namespace IceStormElection
 {
 
-class Observers : public IceUtil::Shared, public IceUtil::Mutex
+//
+// Replicates the updates of the master to the replicas. The updates are
+// committed in groups: the updates made while a group is replicated are
+// queued and sent together in a single call to each replica once the
+// group is acknowledged, each update waits for the acknowledgment of its
+// group. The replicas without the update operation, such as the replicas
+// not yet upgraded during a rolling upgrade, get the updates one by one.
+//
+class Observers : public IceUtil::Shared, public IceUtil::Monitor<IceUtil::Mutex>
 {
 public:
     Observers(const IceStorm::InstancePtr&);
@@ -45,19 +53,33 @@ public:
 
 private:
 
-    void wait(const std::string&);
+    struct PendingUpdate
+    {
+        PendingUpdate(const ReplicaUpdate& u) :
+            update(u), done(false), failed(false) {}
+        const ReplicaUpdate& update;
+        bool done;
+        bool failed;
+    };
+
+    void commit(const ReplicaUpdate&);
+    void replicate(Lock&, std::vector<PendingUpdate*>&);
+    void updateEach(const ReplicaObserverPrx&, const ReplicaUpdateSeq&);
 
     const IceStorm::TraceLevelsPtr _traceLevels;
     unsigned int _majority;
     struct ObserverInfo
     {
         ObserverInfo(int i, const ReplicaObserverPrx& o, const Ice::AsyncResultPtr& r = 0) :
-            id(i), observer(o), result (r) {}
+            id(i), observer(o), result (r), legacy(false) {}
         int id;
         ReplicaObserverPrx observer;
         ::Ice::AsyncResultPtr result;
+        bool legacy; // True if the replica doesn't support update, the updates are sent one by one.
     };
     std::vector<ObserverInfo> _observers;
+    std::vector<PendingUpdate*> _pending; // The updates queued while a group is replicated.
+    bool _committing; // True if a group is replicated.
     IceUtil::Mutex _reapedMutex;
     std::vector<int> _reaped;
 };
@@ -0,0 +1,88 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#ifndef PREPARED_EVENT_H
+#define PREPARED_EVENT_H
+
+#include <IceStorm/IceStormInternal.h>
+#include <IceStorm/EventFilter.h>
+#include <Ice/PreparedRequest.h>
+#include <IceUtil/Mutex.h>
+#include <map>
+
+namespace IceStorm
+{
+
+//
+// The request of an event delivered to several subscribers. The request
+// refers to the data of the event instead of copying it, the messages sent
+// to the subscribers over TCP share the data.
+//
+class EventRequest : public Ice::PreparedRequest
+{
+public:
+
+    EventRequest(const Ice::CommunicatorPtr& communicator, const EventData& event) :
+        Ice::PreparedRequest(communicator, event.op, event.mode, event.context.get(), event.data.range()),
+        _data(event.data)
+    {
+    }
+
+private:
+
+    const EventBytes _data; // Holds the data the request refers to.
+};
+
+//
+// An event queued to subscribers. When the event is delivered to several
+// subscribers, prepareEvents sets its request and the subscribers send the
+// request instead of marshaling the event.
+//
+// The parameters decoded by the subscriber filters are kept with the event,
+// so that they are decoded once for the filters with the same parameter
+// description.
+//
+class PreparedEvent : public EventData
+{
+public:
+
+    PreparedEvent()
+    {
+    }
+
+    PreparedEvent(const std::string& operation, Ice::OperationMode operationMode, const EventBytes& eventData,
+                  const EventContext& eventContext) :
+        EventData(operation, operationMode, eventData, eventContext)
+    {
+    }
+
+    Ice::PreparedRequestPtr request; // Set before the event is queued, if any.
+
+    // Returns the parameters decoded with the given description, or null.
+    EventParamsPtr findParams(const std::string& description)
+    {
+        IceUtil::Mutex::Lock sync(_paramsMutex);
+        std::map<std::string, EventParamsPtr>::const_iterator p = _params.find(description);
+        return p != _params.end() ? p->second : EventParamsPtr();
+    }
+
+    // Adds the parameters decoded with the given description, returns the
+    // parameters already added by another filter if any.
+    EventParamsPtr addParams(const std::string& description, const EventParamsPtr& params)
+    {
+        IceUtil::Mutex::Lock sync(_paramsMutex);
+        return _params.insert(std::make_pair(description, params)).first->second;
+    }
+
+private:
+
+    IceUtil::Mutex _paramsMutex;
+    std::map<std::string, EventParamsPtr> _params;
+};
+typedef IceUtil::Handle<PreparedEvent> PreparedEventPtr;
+typedef std::deque<PreparedEventPtr> PreparedEventSeq;
+
+} // End namespace IceStorm
+
+#endif
@@ -472,6 +472,7 @@ ServiceI::validateProperties(const string& name, const PropertiesPtr& properties
         "Nodes.*",
         "Transient",
         "NodeId",
+        "Partitioned",
         "Flush.Timeout",
         "InstanceName",
         "Election.MasterTimeout",
@@ -523,7 +524,18 @@ ServiceI::validateProperties(const string& name, const PropertiesPtr& properties
         "Send.Timeout",
         "Send.QueueSizeMax",
         "Send.QueueSizeMaxPolicy",
+        "Send.QueueMemoryMax",
+        "Send.TopicMemoryMax",
+        "Send.MemoryMax",
+        "Send.MemoryMaxPolicy",
         "Discard.Interval",
+        "Delivery.MinShardSize",
+        "Delivery.Workers",
+        "EventLog.FlushInterval",
+        "EventLog.MaxAge",
+        "EventLog.MaxSize",
+        "EventLog.ReplayBatchSize",
+        "EventLog.Topics",
         "LMDB.Path",
         "LMDB.MapSize"
     };
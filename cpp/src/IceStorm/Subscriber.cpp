@@ -6,6 +6,8 @@
 #include <IceStorm/Instance.h>
 #include <IceStorm/TraceLevels.h>
 #include <IceStorm/NodeI.h>
+#include <IceStorm/EventLog.h>
+#include <IceStorm/EventFilter.h>
 #include <IceStorm/Util.h>
 #include <Ice/LoggerUtil.h>
 #include <IceUtil/StringUtil.h>
@@ -15,6 +17,26 @@ using namespace std;
 using namespace IceStorm;
 using namespace IceStormElection;
 
+Ice::Long
+IceStorm::eventSize(const PreparedEventPtr& event)
+{
+    size_t sz = event->op.size() + event->data.size();
+    for(Ice::Context::const_iterator p = event->context.begin(); p != event->context.end(); ++p)
+    {
+        sz += p->first.size() + p->second.size();
+    }
+
+    //
+    // The request of a prepared event refers to the data of the event, it
+    // adds its marshaled operation name, mode and context.
+    //
+    if(event->request)
+    {
+        sz += event->request->size() - event->data.size();
+    }
+    return static_cast<Ice::Long>(sz);
+}
+
 //
 // Per Subscriber object.
 //
@@ -44,20 +66,13 @@ public:
         // Use cached reads.
         CachedReadHelper unlock(_instance->node(), __FILE__, __LINE__);
 
-        EventDataPtr event = new EventData(
+        PreparedEventPtr event = new PreparedEvent(
             current.operation,
             current.mode,
-            Ice::ByteSeq(),
-            current.ctx);
+            EventBytes(inParams.first, inParams.second),
+            _contexts.intern(current.ctx));
 
-        //
-        // COMPILERBUG: gcc 4.0.1 doesn't like this.
-        //
-        //event->data.swap(Ice::ByteSeq(inParams.first, inParams.second));
-        Ice::ByteSeq data(inParams.first, inParams.second);
-        event->data.swap(data);
-
-        EventDataSeq e;
+        PreparedEventSeq e;
         e.push_back(event);
         _subscriber->queue(false, e);
         return true;
@@ -67,6 +82,7 @@ private:
 
     const InstancePtr _instance;
     /*const*/ SubscriberPtr _subscriber;
+    EventContextInterner _contexts;
 };
 typedef IceUtil::Handle<PerSubscriberPublisherI> PerSubscriberPublisherIPtr;
 
@@ -88,17 +104,58 @@ toSubscriberState(Subscriber::SubscriberState s)
     }
 }
 
+//
+// Sends an event with its prepared request if the event was prepared for
+// several subscribers, or marshals the event otherwise.
+//
+template<typename C> Ice::AsyncResultPtr
+beginInvoke(const Ice::ObjectPrx& obj, const PreparedEventPtr& event, const C& cb)
+{
+    if(event->request)
+    {
+        return obj->begin_ice_invoke(event->request, cb);
+    }
+    return obj->begin_ice_invoke(event->op, event->mode, event->data.range(), event->context.get(), cb);
+}
+
+void
+invoke(const Ice::ObjectPrx& obj, const PreparedEventPtr& event, vector<Ice::Byte>& outParams)
+{
+    if(event->request)
+    {
+        obj->ice_invoke(event->request, outParams);
+    }
+    else
+    {
+        obj->ice_invoke(event->op, event->mode, event->data.range(), outParams, event->context.get());
+    }
+}
+
 }
 
 // Each of the various Subscriber types.
 namespace
 {
 
+//
+// The batching of a subscriber with the batch-adaptive reliability: the
+// batches are flushed once the latency target expires, or sooner when they
+// reach the number of events expected within the latency target at the
+// observed event rate, or the maximum count or size of a batch.
+//
+struct AdaptiveBatching
+{
+    IceUtil::Time latency; // The latency target.
+    size_t maxSize; // The maximum number of events of a batch, 0 for no limit.
+    Ice::Long maxBytes; // The maximum size in bytes of a batch, 0 for no limit.
+};
+
 class SubscriberBatch : public Subscriber
 {
 public:
 
-    SubscriberBatch(const InstancePtr&, const SubscriberRecord&, const Ice::ObjectPrx&, int, const Ice::ObjectPrx&);
+    SubscriberBatch(const InstancePtr&, const SubscriberRecord&, const Ice::ObjectPrx&, int, const Ice::ObjectPrx&,
+                    const AdaptiveBatching* = 0);
 
     virtual void flush();
 
@@ -112,8 +169,17 @@ public:
 
 private:
 
+    bool full() const;
+
     const Ice::ObjectPrx _obj;
     const IceUtil::Time _interval;
+
+    const bool _adaptive;
+    const size_t _maxBatchSize;
+    const Ice::Long _maxBatchBytes;
+    double _rate; // The average number of events per second.
+    IceUtil::Time _lastFlush;
+    IceUtil::TimerTaskPtr _flushTask; // The scheduled flush, if any.
 };
 typedef IceUtil::Handle<SubscriberBatch> SubscriberBatchPtr;
 
@@ -191,10 +257,15 @@ SubscriberBatch::SubscriberBatch(
     const SubscriberRecord& rec,
     const Ice::ObjectPrx& proxy,
     int retryCount,
-    const Ice::ObjectPrx& obj) :
+    const Ice::ObjectPrx& obj,
+    const AdaptiveBatching* adaptive) :
     Subscriber(instance, rec, proxy, retryCount, 1),
     _obj(obj),
-    _interval(instance->flushInterval())
+    _interval(adaptive ? adaptive->latency : instance->flushInterval()),
+    _adaptive(adaptive != 0),
+    _maxBatchSize(adaptive ? adaptive->maxSize : 0),
+    _maxBatchBytes(adaptive ? adaptive->maxBytes : 0),
+    _rate(0)
 {
 }
 
@@ -209,7 +280,26 @@ SubscriberBatch::flush()
     if(_outstanding == 0)
     {
         ++_outstanding;
-        _instance->batchFlusher()->schedule(new FlushTimerTask(this), _interval);
+        if(_adaptive && full())
+        {
+            doFlush();
+        }
+        else
+        {
+            _flushTask = new FlushTimerTask(this);
+            _instance->batchFlusher()->schedule(_flushTask, _interval);
+        }
+    }
+    else if(_adaptive && _flushTask && full())
+    {
+        //
+        // Flush the batch before the latency target expires, unless the
+        // flush task is already running.
+        //
+        if(_instance->batchFlusher()->cancel(_flushTask))
+        {
+            doFlush();
+        }
     }
 }
 
@@ -218,6 +308,8 @@ SubscriberBatch::doFlush()
 {
     IceUtil::Monitor<IceUtil::RecMutex>::Lock sync(_lock);
 
+    _flushTask = 0;
+
     //
     // If the subscriber isn't online we're done.
     //
@@ -226,22 +318,49 @@ SubscriberBatch::doFlush()
         return;
     }
 
-    EventDataSeq v;
-    v.swap(_events);
-    assert(!v.empty());
+    PreparedEventSeq v;
+    dequeue(v);
+    if(v.empty())
+    {
+        //
+        // The queued events were dropped to free memory.
+        //
+        --_outstanding;
+        if(_shutdown)
+        {
+            _lock.notify();
+        }
+        return;
+    }
+
+    if(_adaptive)
+    {
+        //
+        // Update the average event rate with the events queued since the
+        // last flush.
+        //
+        IceUtil::Time now = IceUtil::Time::now(IceUtil::Time::Monotonic);
+        if(_lastFlush != IceUtil::Time())
+        {
+            double elapsed = max((now - _lastFlush).toSecondsDouble(), 0.001);
+            _rate = _rate * 0.75 + static_cast<double>(v.size()) / elapsed * 0.25;
+        }
+        _lastFlush = now;
+    }
 
     if(_observer)
     {
         _outstandingCount = static_cast<Ice::Int>(v.size());
         _observer->outstanding(_outstandingCount);
+        _observer->batched(_outstandingCount);
     }
 
     try
     {
         vector<Ice::Byte> dummy;
-        for(EventDataSeq::const_iterator p = v.begin(); p != v.end(); ++p)
+        for(PreparedEventSeq::const_iterator p = v.begin(); p != v.end(); ++p)
         {
-            _obj->ice_invoke((*p)->op, (*p)->mode, (*p)->data, dummy, (*p)->context);
+            invoke(_obj, *p, dummy);
         }
 
         Ice::AsyncResultPtr result = _obj->begin_ice_flushBatchRequests(
@@ -268,6 +387,14 @@ SubscriberBatch::doFlush()
     {
         _lock.notify();
     }
+    else if(!_events.empty())
+    {
+        //
+        // The next batch of the replayed events, flushed once the batch
+        // requests are sent.
+        //
+        flush();
+    }
 
     // This is significantly faster than the async version, but it can
     // block the calling thread. Bad news!
@@ -275,6 +402,26 @@ SubscriberBatch::doFlush()
     //_obj->ice_flushBatchRequests();
 }
 
+bool
+SubscriberBatch::full() const
+{
+    if(_maxBatchBytes > 0 && _queuedBytes >= _maxBatchBytes)
+    {
+        return true;
+    }
+
+    //
+    // The expected number of events within the latency target, a single
+    // event is sent right away if the event rate is low.
+    //
+    size_t threshold = static_cast<size_t>(_rate * _interval.toSecondsDouble());
+    if(_maxBatchSize > 0)
+    {
+        threshold = min(threshold, _maxBatchSize);
+    }
+    return _events.size() >= max(threshold, static_cast<size_t>(1));
+}
+
 void
 SubscriberBatch::sent(bool sentSynchronously)
 {
@@ -335,8 +482,7 @@ SubscriberOneway::flush()
         // Dequeue the head event, count one more outstanding AMI
         // request.
         //
-        EventDataPtr e = _events.front();
-        _events.erase(_events.begin());
+        PreparedEventPtr e = dequeue();
         if(_observer)
         {
             _observer->outstanding(1);
@@ -344,8 +490,8 @@ SubscriberOneway::flush()
 
         try
         {
-            Ice::AsyncResultPtr result = _obj->begin_ice_invoke(
-                e->op, e->mode, e->data, e->context, Ice::newCallback_Object_ice_invoke(this,
+            Ice::AsyncResultPtr result = beginInvoke(_obj, e,
+                                                     Ice::newCallback_Object_ice_invoke(this,
                                                                                         &SubscriberOneway::exception,
                                                                                         &SubscriberOneway::sent));
             if(!result->sentSynchronously())
@@ -430,8 +576,7 @@ SubscriberTwoway::flush()
         // Dequeue the head event, count one more outstanding AMI
         // request.
         //
-        EventDataPtr e = _events.front();
-        _events.erase(_events.begin());
+        PreparedEventPtr e = dequeue();
         ++_outstanding;
         if(_observer)
         {
@@ -440,8 +585,7 @@ SubscriberTwoway::flush()
 
         try
         {
-            _obj->begin_ice_invoke(e->op, e->mode, e->data, e->context,
-                                   Ice::newCallback(static_cast<Subscriber*>(this), &Subscriber::completed));
+            beginInvoke(_obj, e, Ice::newCallback(static_cast<Subscriber*>(this), &Subscriber::completed));
         }
         catch(const Ice::Exception& ex)
         {
@@ -472,28 +616,11 @@ SubscriberLink::flush()
         return;
     }
 
-    EventDataSeq v;
-    v.swap(_events);
+    PreparedEventSeq queued;
+    dequeue(queued);
 
-    EventDataSeq::iterator p = v.begin();
-    while(p != v.end())
-    {
-        if(_rec.cost != 0)
-        {
-            int cost = 0;
-            Ice::Context::const_iterator q = (*p)->context.find("cost");
-            if(q != (*p)->context.end())
-            {
-                cost = atoi(q->second.c_str());
-            }
-            if(cost > _rec.cost)
-            {
-                p = v.erase(p);
-                continue;
-            }
-        }
-        ++p;
-    }
+    // The events are forwarded without their prepared requests.
+    EventDataSeq v(queued.begin(), queued.end());
 
     if(!v.empty())
     {
@@ -519,11 +646,14 @@ SubscriberLink::flush()
 SubscriberPtr
 Subscriber::create(
     const InstancePtr& instance,
-    const SubscriberRecord& rec)
+    const SubscriberRecord& rec,
+    const MemoryBudgetPtr& topicBudget)
 {
     if(rec.link)
     {
-        return new SubscriberLink(instance, rec);
+        SubscriberPtr subscriber = new SubscriberLink(instance, rec);
+        subscriber->_topicBudget = topicBudget;
+        return subscriber;
     }
     else
     {
@@ -551,11 +681,54 @@ Subscriber::create(
             {
                 reliability = p->second;
             }
-            if(!reliability.empty() && reliability != "ordered")
+            if(!reliability.empty() && reliability != "ordered" && reliability != "batch-adaptive")
             {
                 throw BadQoS("invalid reliability: " + reliability);
             }
 
+            AdaptiveBatching adaptive;
+            adaptive.latency = instance->flushInterval();
+            adaptive.maxSize = 0;
+            adaptive.maxBytes = 0;
+            if(reliability == "batch-adaptive")
+            {
+                p = rec.theQoS.find("batchLatency");
+                if(p != rec.theQoS.end())
+                {
+                    istringstream is(IceUtilInternal::trim(p->second));
+                    int latency;
+                    if(!(is >> latency) || !is.eof() || latency <= 0)
+                    {
+                        throw BadQoS("invalid batch latency (positive numeric value required): " + p->second);
+                    }
+                    adaptive.latency = IceUtil::Time::milliSeconds(latency);
+                }
+
+                p = rec.theQoS.find("batchSize");
+                if(p != rec.theQoS.end())
+                {
+                    istringstream is(IceUtilInternal::trim(p->second));
+                    int batchSize;
+                    if(!(is >> batchSize) || !is.eof() || batchSize < 0)
+                    {
+                        throw BadQoS("invalid batch size (numeric value required): " + p->second);
+                    }
+                    adaptive.maxSize = static_cast<size_t>(batchSize);
+                }
+
+                p = rec.theQoS.find("batchBytes");
+                if(p != rec.theQoS.end())
+                {
+                    istringstream is(IceUtilInternal::trim(p->second));
+                    Ice::Long batchBytes;
+                    if(!(is >> batchBytes) || !is.eof() || batchBytes < 0)
+                    {
+                        throw BadQoS("invalid batch bytes (numeric value required): " + p->second);
+                    }
+                    adaptive.maxBytes = batchBytes;
+                }
+            }
+
             //
             // Override the timeout.
             //
@@ -598,7 +771,17 @@ Subscriber::create(
                 newObj = newObj->ice_connectionCached(connectionCached > 0);
             }
 
-            if(reliability == "ordered")
+            if(reliability == "batch-adaptive")
+            {
+                if(newObj->ice_isTwoway())
+                {
+                    throw BadQoS("batch-adaptive reliability requires a oneway or datagram proxy");
+                }
+                newObj = newObj->ice_isDatagram() || newObj->ice_isBatchDatagram() ?
+                    newObj->ice_batchDatagram() : newObj->ice_batchOneway();
+                subscriber = new SubscriberBatch(instance, rec, proxy, retryCount, newObj, &adaptive);
+            }
+            else if(reliability == "ordered")
             {
                 if(!newObj->ice_isTwoway())
                 {
@@ -619,6 +802,7 @@ Subscriber::create(
                 assert(newObj->ice_isTwoway());
                 subscriber = new SubscriberTwoway(instance, rec, proxy, retryCount, 5, newObj);
             }
+            subscriber->_topicBudget = topicBudget;
             per->setSubscriber(subscriber);
         }
         catch(const Ice::Exception&)
@@ -650,7 +834,32 @@ Subscriber::record() const
 }
 
 bool
-Subscriber::queue(bool forwarded, const EventDataSeq& events)
+Subscriber::queue(bool forwarded, const PreparedEventSeq& events)
+{
+    //
+    // The memory budgets are met without the subscriber locked, shedding
+    // locks the subscribers with queued events.
+    //
+    bool shed = false;
+    bool queued = enqueue(forwarded, events, shed);
+    if(shed)
+    {
+        if(_topicBudget)
+        {
+            _topicBudget->shed();
+        }
+
+        MemoryBudgetPtr budget = _instance->memoryBudget();
+        if(budget)
+        {
+            budget->shed();
+        }
+    }
+    return queued;
+}
+
+bool
+Subscriber::enqueue(bool forwarded, const PreparedEventSeq& events, bool& shed)
 {
     IceUtil::Monitor<IceUtil::RecMutex>::Lock sync(_lock);
 
@@ -680,27 +889,91 @@ Subscriber::queue(bool forwarded, const EventDataSeq& events)
 
     case SubscriberStateOnline:
     {
-        for(EventDataSeq::const_iterator p = events.begin(); p != events.end(); ++p)
+        //
+        // The queue can exceed its maximum size when a batch of events
+        // is read from the event log to replay. An event larger than the
+        // memory limit is queued if the queue is empty.
+        //
+        const int sendQueueSizeMax = _instance->sendQueueSizeMax();
+        const Ice::Long sendQueueMemoryMax = _instance->sendQueueMemoryMax();
+        QueueEntry entry;
+        entry.time = IceUtil::Time::now(IceUtil::Time::Monotonic).toMicroSeconds();
+        Ice::Int queued = 0;
+        Ice::Int dropped = 0;
+        Ice::Long bytes = 0; // The size of the last pending events, not yet added to the budgets.
+        ptrdiff_t pending = 0;
+        for(PreparedEventSeq::const_iterator p = events.begin(); p != events.end(); ++p)
         {
-            if(static_cast<int>(_events.size()) == _instance->sendQueueSizeMax())
+            if(_filter && !_filter->match(*p))
+            {
+                continue;
+            }
+
+            //
+            // A link only forwards the events whose cost doesn't exceed
+            // the cost of the link.
+            //
+            if(_rec.cost != 0)
+            {
+                Ice::Context::const_iterator q = (*p)->context.find("cost");
+                if(q != (*p)->context.end() && atoi(q->second.c_str()) > _rec.cost)
+                {
+                    continue;
+                }
+            }
+
+            entry.size = eventSize(*p);
+            if((sendQueueSizeMax >= 0 && static_cast<int>(_events.size()) >= sendQueueSizeMax) ||
+               (sendQueueMemoryMax >= 0 && !_events.empty() && _queuedBytes + bytes + entry.size > sendQueueMemoryMax))
             {
                 if(_instance->sendQueueSizeMaxPolicy() == Instance::RemoveSubscriber)
                 {
+                    addQueued(_events.end() - pending, _events.end(), bytes);
                     error(false, IceStorm::SendQueueSizeMaxReached(__FILE__, __LINE__));
                     return false;
                 }
                 else // DropEvents
                 {
-                    _events.pop_front();
+                    //
+                    // Drop the oldest events until the event fits in the
+                    // memory limit.
+                    //
+                    shed = !addQueued(_events.end() - pending, _events.end(), bytes) || shed;
+                    bytes = 0;
+                    pending = 0;
+                    do
+                    {
+                        dequeue();
+                        ++dropped;
+                    }
+                    while(sendQueueMemoryMax >= 0 && !_events.empty() &&
+                          _queuedBytes + entry.size > sendQueueMemoryMax);
                 }
             }
             _events.push_back(*p);
+            _entries.push_back(entry);
+            bytes += entry.size;
+            ++pending;
+            ++queued;
         }
 
+        //
+        // The events are counted as queued before the dropped events are
+        // removed from the count, the dropped events include the events
+        // queued by this call.
+        //
         if(_observer)
         {
-            _observer->queued(static_cast<Ice::Int>(events.size()));
+            if(queued > 0)
+            {
+                _observer->queued(queued);
+            }
+            if(dropped > 0)
+            {
+                _observer->dropped(dropped);
+            }
         }
+        shed = !addQueued(_events.end() - pending, _events.end(), bytes) || shed;
         flush();
         break;
     }
@@ -714,6 +987,24 @@ Subscriber::queue(bool forwarded, const EventDataSeq& events)
     return true;
 }
 
+void
+Subscriber::replay(const EventLogPtr& log, Ice::Long from, Ice::Long end)
+{
+    IceUtil::Monitor<IceUtil::RecMutex>::Lock sync(_lock);
+
+    if(_state != SubscriberStateOnline || from >= end)
+    {
+        return;
+    }
+
+    _replayLog = log;
+    _replayNext = from;
+    _replayEnd = end;
+    _replayQueued = 0;
+    fetchReplay();
+    flush();
+}
+
 bool
 Subscriber::reap()
 {
@@ -744,6 +1035,60 @@ Subscriber::errored() const
     return _state >= SubscriberStateError;
 }
 
+Ice::Long
+Subscriber::shed(MemoryBudget::Policy policy, Ice::Long bytes, Ice::Long before)
+{
+    IceUtil::Monitor<IceUtil::RecMutex>::Lock sync(_lock);
+
+    if(_events.empty())
+    {
+        return 0;
+    }
+
+    if(policy == MemoryBudget::RemoveSubscriber)
+    {
+        Ice::Long released = _queuedBytes;
+        error(false, IceStorm::SendQueueSizeMaxReached(__FILE__, __LINE__));
+        return released;
+    }
+
+    //
+    // The replay in progress, if any, is abandoned, the events read from
+    // the event log would be shed again.
+    //
+    _replayLog = 0;
+
+    Ice::Long released = 0;
+    Ice::Int dropped = 0;
+    do
+    {
+        released += _entries.front().size;
+        dequeue();
+        ++dropped;
+    }
+    while(!_events.empty() && released < bytes &&
+          (policy != MemoryBudget::EvictOldest || _entries.front().time <= before));
+
+    if(_observer)
+    {
+        _observer->dropped(dropped);
+    }
+    return released;
+}
+
+bool
+Subscriber::oldest(Ice::Long& time) const
+{
+    IceUtil::Monitor<IceUtil::RecMutex>::Lock sync(_lock);
+
+    if(_entries.empty())
+    {
+        return false;
+    }
+    time = _entries.front().time;
+    return true;
+}
+
 void
 Subscriber::destroy()
 {
@@ -766,7 +1111,11 @@ Subscriber::destroy()
         }
     }
 
+    //
+    // Release the queued events from the memory budgets.
+    //
     IceUtil::Monitor<IceUtil::RecMutex>::Lock sync(_lock);
+    clearEvents();
     _observer.detach();
 }
 
@@ -854,13 +1203,13 @@ Subscriber::error(bool dec, const Ice::Exception& e)
         // clear all queued events.
         _next = now + _instance->discardInterval();
         ++_currentRetry;
-        _events.clear();
+        clearEvents();
         setState(SubscriberStateOffline);
     }
     // Errored out.
     else if(_state < SubscriberStateError)
     {
-        _events.clear();
+        clearEvents();
         setState(SubscriberStateError);
 
         TraceLevelsPtr traceLevels = _instance->traceLevels();
@@ -941,13 +1290,13 @@ Subscriber::updateObserver()
     IceUtil::Monitor<IceUtil::RecMutex>::Lock sync(_lock);
     if(_instance->observer())
     {
-        _observer.attach(_instance->observer()->getSubscriberObserver(_instance->serviceName(),
-                                                                      _rec.topicName,
-                                                                      _rec.obj,
-                                                                      _rec.theQoS,
-                                                                      _rec.theTopic,
-                                                                      toSubscriberState(_state),
-                                                                      _observer.get()));
+        attachObserver(_instance->observer()->getSubscriberObserver(_instance->serviceName(),
+                                                                    _rec.topicName,
+                                                                    _rec.obj,
+                                                                    _rec.theQoS,
+                                                                    _rec.theTopic,
+                                                                    toSubscriberState(_state),
+                                                                    _observer.get()));
     }
 }
 
@@ -963,10 +1312,15 @@ Subscriber::Subscriber(
     _maxOutstanding(maxOutstanding),
     _proxy(proxy),
     _proxyReplica(proxy),
+    _filter(EventFilter::create(instance->communicator(), rec.theQoS)),
     _shutdown(false),
     _state(SubscriberStateOnline),
     _outstanding(0),
     _outstandingCount(1),
+    _queuedBytes(0),
+    _replayNext(0),
+    _replayEnd(0),
+    _replayQueued(0),
     _currentRetry(0)
 {
     if(_proxy && _instance->publisherReplicaProxy())
@@ -987,6 +1341,214 @@ Subscriber::Subscriber(
     }
 }
 
+PreparedEventPtr
+Subscriber::dequeue()
+{
+    PreparedEventPtr event = _events.front();
+    removeQueued(_events.begin(), _events.begin() + 1, _entries.front().size);
+    _events.pop_front();
+    _entries.pop_front();
+    if(_replayQueued > 0 && --_replayQueued == 0)
+    {
+        fetchReplay();
+    }
+    return event;
+}
+
+void
+Subscriber::dequeue(PreparedEventSeq& events)
+{
+    if(_replayQueued > 0)
+    {
+        //
+        // The queued events wait for the end of the replay.
+        //
+        const ptrdiff_t count = static_cast<ptrdiff_t>(_replayQueued);
+        Ice::Long bytes = 0;
+        for(deque<QueueEntry>::const_iterator p = _entries.begin(); p != _entries.begin() + count; ++p)
+        {
+            bytes += p->size;
+        }
+        removeQueued(_events.begin(), _events.begin() + count, bytes);
+
+        events.assign(_events.begin(), _events.begin() + count);
+        _events.erase(_events.begin(), _events.begin() + count);
+        _entries.erase(_entries.begin(), _entries.begin() + count);
+
+        _replayQueued = 0;
+        fetchReplay();
+    }
+    else
+    {
+        removeQueued(_events.begin(), _events.end(), _queuedBytes);
+        events.swap(_events);
+        _entries.clear();
+    }
+}
+
+void
+Subscriber::clearEvents()
+{
+    if(_observer && !_events.empty())
+    {
+        _observer->queued(-static_cast<Ice::Int>(_events.size()));
+    }
+    removeQueued(_events.begin(), _events.end(), _queuedBytes);
+    _events.clear();
+    _entries.clear();
+    _replayQueued = 0;
+    _replayLog = 0;
+}
+
+void
+Subscriber::attachObserver(const IceStorm::Instrumentation::SubscriberObserverPtr& observer)
+{
+    //
+    // The queued events are moved to the metrics of the new observer, they
+    // are removed from the metrics of the observer they were counted by.
+    //
+    if(observer.get() != _observer.get() && !_events.empty())
+    {
+        const Ice::Int queued = static_cast<Ice::Int>(_events.size());
+        if(_observer)
+        {
+            _observer->queued(-queued);
+            _observer->queuedBytes(-_queuedBytes);
+        }
+        if(observer)
+        {
+            observer->queued(queued);
+            observer->queuedBytes(_queuedBytes);
+        }
+    }
+    _observer.attach(observer);
+}
+
+void
+Subscriber::fetchReplay()
+{
+    if(!_replayLog)
+    {
+        return;
+    }
+
+    //
+    // Read batches of events until one of them passes the filter.
+    //
+    PreparedEventSeq events;
+    while(_replayLog && events.empty())
+    {
+        PreparedEventSeq batch;
+        try
+        {
+            _replayNext = _replayLog->read(_replayNext, _replayEnd, batch);
+        }
+        catch(const IceDB::LMDBException& ex)
+        {
+            Ice::Error error(_instance->traceLevels()->logger);
+            error << "LMDB error: " << ex;
+        }
+
+        if(batch.empty() || _replayNext >= _replayEnd)
+        {
+            _replayLog = 0;
+        }
+
+        for(PreparedEventSeq::const_iterator p = batch.begin(); p != batch.end(); ++p)
+        {
+            if(!_filter || _filter->match(*p))
+            {
+                events.push_back(*p);
+            }
+        }
+    }
+    if(!events.empty())
+    {
+        //
+        // The replayed events are queued before the other events, they
+        // are as old as the oldest queued event.
+        //
+        QueueEntry entry;
+        entry.time = IceUtil::Time::now(IceUtil::Time::Monotonic).toMicroSeconds();
+        if(!_entries.empty())
+        {
+            entry.time = min(entry.time, _entries.front().time);
+        }
+
+        deque<QueueEntry> entries;
+        Ice::Long bytes = 0;
+        for(PreparedEventSeq::const_iterator p = events.begin(); p != events.end(); ++p)
+        {
+            entry.size = eventSize(*p);
+            entries.push_back(entry);
+            bytes += entry.size;
+        }
+
+        _events.insert(_events.begin(), events.begin(), events.end());
+        _entries.insert(_entries.begin(), entries.begin(), entries.end());
+        _replayQueued = events.size();
+        if(_observer)
+        {
+            _observer->queued(static_cast<Ice::Int>(events.size()));
+        }
+        addQueued(_events.begin(), _events.begin() + static_cast<ptrdiff_t>(events.size()), bytes);
+    }
+}
+
+bool
+Subscriber::addQueued(PreparedEventSeq::const_iterator first, PreparedEventSeq::const_iterator last, Ice::Long bytes)
+{
+    if(first == last)
+    {
+        return true;
+    }
+
+    _queuedBytes += bytes;
+    if(_observer)
+    {
+        _observer->queuedBytes(bytes);
+    }
+
+    bool met = true;
+    if(_topicBudget && !_topicBudget->add(this, first, last))
+    {
+        met = false;
+    }
+
+    MemoryBudgetPtr budget = _instance->memoryBudget();
+    if(budget && !budget->add(this, first, last))
+    {
+        met = false;
+    }
+    return met;
+}
+
+void
+Subscriber::removeQueued(PreparedEventSeq::const_iterator first, PreparedEventSeq::const_iterator last, Ice::Long bytes)
+{
+    if(first == last)
+    {
+        return;
+    }
+
+    _queuedBytes -= bytes;
+    if(_observer)
+    {
+        _observer->queuedBytes(-bytes);
+    }
+
+    if(_topicBudget)
+    {
+        _topicBudget->remove(this, first, last);
+    }
+
+    MemoryBudgetPtr budget = _instance->memoryBudget();
+    if(budget)
+    {
+        budget->remove(this, first, last);
+    }
+}
+
 namespace
 {
 
@@ -1026,13 +1588,13 @@ Subscriber::setState(Subscriber::SubscriberState state)
 
         if(_instance->observer())
         {
-            _observer.attach(_instance->observer()->getSubscriberObserver(_instance->serviceName(),
-                                                                          _rec.topicName,
-                                                                          _rec.obj,
-                                                                          _rec.theQoS,
-                                                                          _rec.theTopic,
-                                                                          toSubscriberState(_state),
-                                                                          _observer.get()));
+            attachObserver(_instance->observer()->getSubscriberObserver(_instance->serviceName(),
+                                                                        _rec.topicName,
+                                                                        _rec.obj,
+                                                                        _rec.theQoS,
+                                                                        _rec.theTopic,
+                                                                        toSubscriberState(_state),
+                                                                        _observer.get()));
         }
     }
 }
@@ -1060,3 +1622,31 @@ IceStorm::operator<(const Subscriber& s1, const Subscriber& s2)
 {
     return &s1 < &s2;
 }
+
+PreparedEventSeq
+IceStorm::moveForwardedEvents(const EventDataSeq& events)
+{
+    PreparedEventSeq prepared;
+    for(EventDataSeq::const_iterator p = events.begin(); p != events.end(); ++p)
+    {
+        PreparedEventPtr event = new PreparedEvent;
+        event->op.swap((*p)->op);
+        event->mode = (*p)->mode;
+        event->data.swap((*p)->data);
+        event->context.swap((*p)->context);
+        prepared.push_back(event);
+    }
+    return prepared;
+}
+
+void
+IceStorm::prepareEvents(const Ice::CommunicatorPtr& communicator, const PreparedEventSeq& events)
+{
+    for(PreparedEventSeq::const_iterator p = events.begin(); p != events.end(); ++p)
+    {
+        if(!(*p)->request)
+        {
+            (*p)->request = new EventRequest(communicator, **p);
+        }
+    }
+}
@@ -8,6 +8,9 @@
 #include <IceStorm/IceStormInternal.h>
 #include <IceStorm/SubscriberRecord.h>
 #include <IceStorm/Instrumentation.h>
+#include <IceStorm/MemoryBudget.h>
+#include <IceStorm/EventFilter.h>
+#include <IceStorm/PreparedEvent.h>
 #include <Ice/ObserverHelper.h>
 #include <IceUtil/RecMutex.h>
 
@@ -20,22 +23,56 @@ typedef IceUtil::Handle<Instance> InstancePtr;
 class Subscriber;
 typedef IceUtil::Handle<Subscriber> SubscriberPtr;
 
+class EventLog;
+typedef IceUtil::Handle<EventLog> EventLogPtr;
+
+//
+// Moves the events of a forward request into prepared events. The forwarded
+// events are left empty.
+//
+PreparedEventSeq moveForwardedEvents(const EventDataSeq&);
+
+// Prepares the requests of the events delivered to several subscribers.
+void prepareEvents(const Ice::CommunicatorPtr&, const PreparedEventSeq&);
+
+// The size in bytes of an event, including the request of a prepared event.
+Ice::Long eventSize(const PreparedEventPtr&);
+
 class Subscriber : public IceUtil::Shared
 {
 public:
 
-    static SubscriberPtr create(const InstancePtr&, const IceStorm::SubscriberRecord&);
+    // The subscriber reports the size of its queued events to the given memory budget of its topic, if any.
+    static SubscriberPtr create(const InstancePtr&, const IceStorm::SubscriberRecord&, const MemoryBudgetPtr&);
 
     Ice::ObjectPrx proxy() const; // Get the per subscriber object.
     Ice::Identity id() const; // Return the id of the subscriber.
     IceStorm::SubscriberRecord record() const; // Get the subscriber record.
 
     // Returns false if the subscriber should be reaped.
-    bool queue(bool, const EventDataSeq&);
+    bool queue(bool, const PreparedEventSeq&);
+
+    //
+    // Replays the events of the event log from the given sequence number
+    // and before the given end. The events are read in batches and sent
+    // before the events queued afterwards.
+    //
+    void replay(const EventLogPtr&, Ice::Long, Ice::Long);
     bool reap();
     void resetIfReaped();
     bool errored() const;
 
+    //
+    // Sheds queued events to release the given number of bytes with the
+    // given policy of a memory budget. With EvictOldest, the oldest event
+    // and the events queued at or before the given time are shed. Returns
+    // the number of bytes released.
+    //
+    Ice::Long shed(MemoryBudget::Policy, Ice::Long, Ice::Long);
+
+    // Gets the time at which the oldest queued event was queued, returns false if no events are queued.
+    bool oldest(Ice::Long&) const;
+
     void destroy();
 
     // To be called by the AMI callbacks only.
@@ -60,6 +97,29 @@ protected:
 
     void setState(SubscriberState);
 
+    // Dequeue the events to send, the replayed events are sent first.
+    PreparedEventPtr dequeue();
+    void dequeue(PreparedEventSeq&);
+    void clearEvents();
+    void attachObserver(const IceStorm::Instrumentation::SubscriberObserverPtr&);
+    void fetchReplay();
+
+    bool enqueue(bool, const PreparedEventSeq&, bool&);
+
+    //
+    // Updates the size of the queued events and the memory budgets with
+    // the given queued events and their size in bytes, addQueued returns
+    // false if a budget is exceeded.
+    //
+    bool addQueued(PreparedEventSeq::const_iterator, PreparedEventSeq::const_iterator, Ice::Long);
+    void removeQueued(PreparedEventSeq::const_iterator, PreparedEventSeq::const_iterator, Ice::Long);
+
+    struct QueueEntry
+    {
+        Ice::Long time; // The monotonic time in microseconds at which the event was queued.
+        Ice::Long size; // The size in bytes of the event.
+    };
+
     Subscriber(const InstancePtr&, const IceStorm::SubscriberRecord&, const Ice::ObjectPrx&, int, int);
 
     // Immutable
@@ -69,6 +129,7 @@ protected:
     const int _maxOutstanding; // The maximum number of oustanding events.
     const Ice::ObjectPrx _proxy; // The per subscriber object proxy, if any.
     const Ice::ObjectPrx _proxyReplica; // The replicated per subscriber object proxy, if any.
+    const EventFilterPtr _filter; // The filter of the events from the QoS, if any.
 
     IceUtil::Monitor<IceUtil::RecMutex> _lock;
 
@@ -78,7 +139,16 @@ protected:
 
     int _outstanding; // The current number of outstanding responses.
     int _outstandingCount; // The current number of outstanding events when batching events (only used for metrics).
-    EventDataSeq _events; // The queue of events to send.
+    PreparedEventSeq _events; // The queue of events to send.
+    std::deque<QueueEntry> _entries; // The entries of the queued events.
+    Ice::Long _queuedBytes; // The size in bytes of the queued events.
+    MemoryBudgetPtr _topicBudget; // The memory budget of the topic, if any.
+
+    // The event log to replay, if any, and the next event to read.
+    EventLogPtr _replayLog;
+    Ice::Long _replayNext;
+    Ice::Long _replayEnd;
+    size_t _replayQueued; // The number of replayed events at the front of the queue.
 
     // The next time to try sending a new event if we're offline.
     IceUtil::Time _next;
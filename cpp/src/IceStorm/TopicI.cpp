@@ -5,11 +5,14 @@
 #include <IceStorm/TopicI.h>
 #include <IceStorm/Instance.h>
 #include <IceStorm/Subscriber.h>
+#include <IceStorm/Delivery.h>
+#include <IceStorm/EventLog.h>
 #include <IceStorm/TraceLevels.h>
 #include <IceStorm/NodeI.h>
 #include <IceStorm/Observers.h>
 #include <IceStorm/Util.h>
 #include <Ice/LoggerUtil.h>
+#include <IceUtil/StringUtil.h>
 #include <algorithm>
 
 using namespace std;
@@ -35,8 +38,8 @@ class PublisherI : public Ice::BlobjectArray
 {
 public:
 
-    PublisherI(const TopicImplPtr& topic, const PersistentInstancePtr& instance) :
-        _topic(topic), _instance(instance)
+    PublisherI(const TopicImplPtr& topic, const PersistentInstancePtr& instance, bool logged) :
+        _topic(topic), _instance(instance), _logged(logged)
     {
     }
 
@@ -45,17 +48,17 @@ public:
                Ice::ByteSeq&,
                const Ice::Current& current)
     {
-        // The publish call does a cached read.
-        EventDataPtr event = new EventData(current.operation, current.mode, Ice::ByteSeq(), current.ctx);
-
         //
-        // COMPILERBUG: gcc 4.0.1 doesn't like this.
+        // The event log sets the sequence number of each event in its
+        // context, the context of a logged event isn't interned so that
+        // the sequence number is set without copying the context.
         //
-        //event->data.swap(Ice::ByteSeq(inParams.first, inParams.second));
-        Ice::ByteSeq data(inParams.first, inParams.second);
-        event->data.swap(data);
+        // The publish call does a cached read.
+        PreparedEventPtr event = new PreparedEvent(current.operation, current.mode,
+                                               EventBytes(inParams.first, inParams.second),
+                                               _logged ? EventContext(current.ctx) : _contexts.intern(current.ctx));
 
-        EventDataSeq v;
+        PreparedEventSeq v;
         v.push_back(event);
         _topic->publish(false, v);
 
@@ -66,6 +69,8 @@ private:
 
     const TopicImplPtr _topic;
     const PersistentInstancePtr _instance;
+    const bool _logged;
+    EventContextInterner _contexts;
 };
 
 //
@@ -85,7 +90,7 @@ public:
     forward(const EventDataSeq& v, const Ice::Current& /*current*/)
     {
         // The publish call does a cached read.
-        _impl->publish(true, v);
+        _impl->publish(true, moveForwardedEvents(v));
     }
 
 private:
@@ -341,6 +346,7 @@ TopicImpl::TopicImpl(
     _instance(instance),
     _name(name),
     _id(id),
+    _memoryBudget(instance->newTopicMemoryBudget()),
     _destroyed(false),
     _lluMap(_instance->lluMap()),
     _subscriberMap(_instance->subscriberMap())
@@ -380,7 +386,16 @@ TopicImpl::TopicImpl(
             linkid.name = _name + ".link";
         }
 
-        _publisherPrx = _instance->publishAdapter()->add(new PublisherI(this, instance), pubid);
+        //
+        // Log the events of the topic if it's configured with
+        // <service>.EventLog.Topics.
+        //
+        if(EventLog::enabled(_instance, _name))
+        {
+            _eventLog = new EventLog(_instance, _id);
+        }
+
+        _publisherPrx = _instance->publishAdapter()->add(new PublisherI(this, instance, _eventLog), pubid);
         _linkPrx = TopicLinkPrx::uncheckedCast(
             _instance->publishAdapter()->add(new TopicLinkI(this, instance), linkid));
 
@@ -407,7 +422,7 @@ TopicImpl::TopicImpl(
                 // Create the subscriber object add it to the set of
                 // subscribers.
                 //
-                SubscriberPtr subscriber = Subscriber::create(_instance, *p);
+                SubscriberPtr subscriber = Subscriber::create(_instance, *p, _memoryBudget);
                 _subscribers.push_back(subscriber);
             }
             catch(const Ice::Exception& ex)
@@ -447,11 +462,41 @@ Ice::ObjectPrx
 TopicImpl::getPublisher() const
 {
     // Immutable
+    Ice::ObjectPrx publisher = _publisherPrx;
     if(_instance->publisherReplicaProxy())
     {
-        return _instance->publisherReplicaProxy()->ice_identity(_publisherPrx->ice_getIdentity());
+        publisher = _instance->publisherReplicaProxy()->ice_identity(_publisherPrx->ice_getIdentity());
+    }
+
+    //
+    // If the topics are partitioned, the endpoints of the replica that owns
+    // the topic come first and the replicated endpoints are kept for
+    // failover: a publisher using ordered endpoint selection publishes
+    // through the owner while it's reachable.
+    //
+    NodeIPtr node = _instance->node();
+    if(_instance->partitioned() && node && node->ownsPartition(_name))
+    {
+        Ice::EndpointSeq endpoints = _publisherPrx->ice_getEndpoints();
+        if(!endpoints.empty())
+        {
+            Ice::EndpointSeq replicated = publisher->ice_getEndpoints();
+            for(Ice::EndpointSeq::const_iterator p = replicated.begin(); p != replicated.end(); ++p)
+            {
+                bool found = false;
+                for(Ice::EndpointSeq::const_iterator q = endpoints.begin(); q != endpoints.end() && !found; ++q)
+                {
+                    found = (*p)->toString() == (*q)->toString();
+                }
+                if(!found)
+                {
+                    endpoints.push_back(*p);
+                }
+            }
+            return publisher->ice_endpoints(endpoints);
+        }
     }
-    return _publisherPrx;
+    return publisher;
 }
 
 Ice::ObjectPrx
@@ -485,6 +530,45 @@ trace(Ice::Trace& out, const PersistentInstancePtr& instance, const vector<Subsc
     }
     out << "]";
 }
+
+//
+// Returns true if the QoS requests the replay of the events of the event
+// log, from a sequence number or from a time in milliseconds since the epoch.
+//
+bool
+replayFrom(const QoS& qos, const PersistentInstancePtr& instance, const EventLogPtr& eventLog, Ice::Long& from)
+{
+    QoS::const_iterator p = qos.find("replayFrom");
+    QoS::const_iterator q = qos.find("replaySince");
+    if(p == qos.end() && q == qos.end())
+    {
+        return false;
+    }
+    if(!eventLog)
+    {
+        //
+        // The log of a replica isn't replicated, the replicas would number
+        // the events differently.
+        //
+        throw BadQoS(instance->nodeAdapter() ? "invalid replay: the events of a replicated topic are not logged" :
+                     "invalid replay: the events of the topic are not logged");
+    }
+    if(p != qos.end() && q != qos.end())
+    {
+        throw BadQoS("invalid replay: replayFrom and replaySince can't be used together");
+    }
+
+    const string& value = p != qos.end() ? p->second : q->second;
+    istringstream is(IceUtilInternal::trim(value));
+    Ice::Long v;
+    if(!(is >> v) || !is.eof() || v < 0)
+    {
+        throw BadQoS("invalid replay (non-negative numeric value required): " + value);
+    }
+    from = p != qos.end() ? v : eventLog->find(IceUtil::Time::milliSeconds(v));
+    return true;
+}
+
 }
 
 Ice::ObjectPrx
@@ -541,9 +625,12 @@ TopicImpl::subscribeAndGetPublisher(const QoS& qos, const Ice::ObjectPrx& obj)
         throw AlreadySubscribed();
     }
 
+    Ice::Long from = 0;
+    const bool replay = replayFrom(qos, _instance, _eventLog, from);
+
     LogUpdate llu;
 
-    SubscriberPtr subscriber = Subscriber::create(_instance, record);
+    SubscriberPtr subscriber = Subscriber::create(_instance, record, _memoryBudget);
     try
     {
         IceDB::ReadWriteTxn txn(_instance->dbEnv());
@@ -565,6 +652,21 @@ TopicImpl::subscribeAndGetPublisher(const QoS& qos, const Ice::ObjectPrx& obj)
     }
 
     _subscribers.push_back(subscriber);
+    _snapshot = 0;
+
+    //
+    // The events are logged with the subscribers mutex locked, the events
+    // logged from now on are queued to the new subscriber.
+    //
+    if(replay)
+    {
+        if(traceLevels->topic > 0)
+        {
+            Ice::Trace out(traceLevels->logger, traceLevels->topicCat);
+            out << _name << ": replay " << _instance->communicator()->identityToString(id) << " from " << from;
+        }
+        subscriber->replay(_eventLog, from, _eventLog->next());
+    }
 
     _instance->observers()->addSubscriber(llu, _name, record);
 
@@ -652,7 +754,7 @@ TopicImpl::link(const TopicPrx& topic, Ice::Int cost)
 
     LogUpdate llu;
 
-    SubscriberPtr subscriber = Subscriber::create(_instance, record);
+    SubscriberPtr subscriber = Subscriber::create(_instance, record, _memoryBudget);
 
     try
     {
@@ -675,6 +777,7 @@ TopicImpl::link(const TopicPrx& topic, Ice::Int cost)
     }
 
     _subscribers.push_back(subscriber);
+    _snapshot = 0;
 
     _instance->observers()->addSubscriber(llu, _name, record);
 }
@@ -751,6 +854,19 @@ TopicImpl::shutdown()
         (*p)->shutdown();
     }
 
+    // Commit the events logged since the last background commit.
+    if(_eventLog)
+    {
+        try
+        {
+            _eventLog->flush();
+        }
+        catch(const IceDB::LMDBException& ex)
+        {
+            logError(_instance->communicator(), ex);
+        }
+    }
+
     _observer.detach();
 }
 
@@ -807,8 +923,7 @@ TopicImpl::destroy()
     }
 
     // destroyInternal clears out the topic content.
-    LogUpdate llu = {0,0};
-    _instance->observers()->destroyTopic(destroyInternal(llu, true), _name);
+    _instance->observers()->destroyTopic(destroyInternal(), _name);
 
     _observer.detach();
 }
@@ -861,6 +976,7 @@ TopicImpl::update(const SubscriberRecordSeq& records)
             {
                 (*p)->destroy();
                 p = _subscribers.erase(p);
+                _snapshot = 0;
             }
             else
             {
@@ -883,8 +999,9 @@ TopicImpl::update(const SubscriberRecordSeq& records)
         }
         if(q == _subscribers.end())
         {
-            SubscriberPtr subscriber = Subscriber::create(_instance, *p);
+            SubscriberPtr subscriber = Subscriber::create(_instance, *p, _memoryBudget);
             _subscribers.push_back(subscriber);
+            _snapshot = 0;
         }
     }
 }
@@ -951,7 +1068,7 @@ private:
 }
 
 void
-TopicImpl::publish(bool forwarded, const EventDataSeq& events)
+TopicImpl::publish(bool forwarded, const PreparedEventSeq& events)
 {
     TopicInternalPrx masterInternal;
     Ice::Long generation = -1;
@@ -961,10 +1078,11 @@ TopicImpl::publish(bool forwarded, const EventDataSeq& events)
         CachedReadHelper unlock(_instance->node(), __FILE__, __LINE__);
 
         //
-        // Copy of the subscriber list so that event publishing can occur
-        // in parallel.
+        // Snapshot of the subscriber list so that event publishing can
+        // occur in parallel. The snapshot is only copied when the
+        // subscribers change.
         //
-        vector<SubscriberPtr> copy;
+        SubscriberSnapshotPtr snapshot;
         {
             IceUtil::Mutex::Lock sync(_subscribersMutex);
             if(_observer)
@@ -978,21 +1096,61 @@ TopicImpl::publish(bool forwarded, const EventDataSeq& events)
                     _observer->published();
                 }
             }
-            copy = _subscribers;
+            if(!_snapshot)
+            {
+                _snapshot = new SubscriberSnapshot(_subscribers);
+            }
+            snapshot = _snapshot;
+
+            //
+            // The events are numbered with the mutex locked, a subscriber
+            // replaying the log is added with the mutex locked.
+            //
+            if(_eventLog)
+            {
+                try
+                {
+                    _eventLog->append(events);
+                }
+                catch(const IceDB::LMDBException& ex)
+                {
+                    logError(_instance->communicator(), ex);
+                }
+            }
         }
 
         //
-        // Queue each event, gathering a list of those subscribers that
-        // must be reaped.
+        // The events are committed to the log before they are queued,
+        // without the mutex locked, unless the log is committed in the
+        // background.
         //
-        for(vector<SubscriberPtr>::const_iterator p = copy.begin(); p != copy.end(); ++p)
+        if(_eventLog)
         {
-            if(!(*p)->queue(forwarded, events) && (*p)->reap())
+            try
             {
-                reap.push_back((*p)->id());
+                _eventLog->commit();
             }
+            catch(const IceDB::LMDBException& ex)
+            {
+                logError(_instance->communicator(), ex);
+            }
+        }
+
+        //
+        // Marshal the requests of the events once if they are delivered
+        // to several subscribers.
+        //
+        if(snapshot->subscribers.size() > 1)
+        {
+            prepareEvents(_instance->communicator(), events);
         }
 
+        //
+        // Queue each event, gathering a list of those subscribers that
+        // must be reaped.
+        //
+        _instance->deliveryWorkers()->deliver(snapshot, forwarded, events, reap);
+
         // If there are no subscribers in error then we're done.
         if(reap.empty())
         {
@@ -1061,29 +1219,16 @@ TopicImpl::observerAddSubscriber(const LogUpdate& llu, const SubscriberRecord& r
         return;
     }
 
-    SubscriberPtr subscriber = Subscriber::create(_instance, record);
     try
     {
-        IceDB::ReadWriteTxn txn(_instance->dbEnv());
-
-        SubscriberRecordKey key;
-        key.topic = _id;
-        key.id = subscriber->id();
-
-        _subscriberMap.put(txn, key, record);
-
-        // Update the LLU.
-        _lluMap.put(txn, lluDbKey, llu);
-
-        txn.commit();
+        _subscribers.push_back(Subscriber::create(_instance, record, _memoryBudget));
+        _snapshot = 0;
     }
-    catch(const IceDB::LMDBException& ex)
+    catch(const Ice::Exception& ex)
     {
-        logError(_instance->communicator(), ex);
-        throw; // will become UnknownException in caller
+        Ice::Warning out(traceLevels->logger);
+        out << _name << " add " << _instance->communicator()->identityToString(record.id) << " failed: " << ex;
     }
-
-    _subscribers.push_back(subscriber);
 }
 
 void
@@ -1107,31 +1252,7 @@ TopicImpl::observerRemoveSubscriber(const LogUpdate& llu, const Ice::IdentitySeq
 
     IceUtil::Mutex::Lock sync(_subscribersMutex);
 
-    // First remove from the database.
-    try
-    {
-        IceDB::ReadWriteTxn txn(_instance->dbEnv());
-
-        for(Ice::IdentitySeq::const_iterator id = ids.begin(); id != ids.end(); ++id)
-        {
-            SubscriberRecordKey key;
-            key.topic = _id;
-            key.id = *id;
-
-            _subscriberMap.del(txn, key);
-        }
-
-        _lluMap.put(txn, lluDbKey, llu);
-
-        txn.commit();
-    }
-    catch(const IceDB::LMDBException& ex)
-    {
-        logError(_instance->communicator(), ex);
-        throw; // will become UnknownException in caller
-    }
-
-    // Then remove the subscriber from the subscribers list. If the
+    // Remove the subscriber from the subscribers list. If the
     // subscriber had a local failure and was removed from the
     // subscriber list it could already be gone. That's not a problem.
     for(Ice::IdentitySeq::const_iterator id = ids.begin(); id != ids.end(); ++id)
@@ -1141,6 +1262,7 @@ TopicImpl::observerRemoveSubscriber(const LogUpdate& llu, const Ice::IdentitySeq
         {
             (*p)->destroy();
             _subscribers.erase(p);
+            _snapshot = 0;
         }
     }
 }
@@ -1163,7 +1285,7 @@ TopicImpl::observerDestroyTopic(const LogUpdate& llu)
         out << _name << ": destroyed";
         out << " llu: " << llu.generation << "/" << llu.iteration;
     }
-    destroyInternal(llu, false);
+    deactivate();
 }
 
 Ice::ObjectPtr
@@ -1193,7 +1315,7 @@ TopicImpl::updateSubscriberObservers()
 }
 
 LogUpdate
-TopicImpl::destroyInternal(const LogUpdate& origLLU, bool master)
+TopicImpl::destroyInternal()
 {
 
     // Clear out the database records related to this topic.
@@ -1219,17 +1341,15 @@ TopicImpl::destroyInternal(const LogUpdate& origLLU, bool master)
             }
         }
 
-        // Update the LLU.
-        if(master)
-        {
-            llu = getIncrementedLLU(txn, _lluMap);
-        }
-        else
+        // Erase the events of the event log.
+        if(_eventLog)
         {
-            llu = origLLU;
-            _lluMap.put(txn, lluDbKey, llu);
+            _eventLog->destroy(txn);
         }
 
+        // Update the LLU.
+        llu = getIncrementedLLU(txn, _lluMap);
+
         txn.commit();
     }
     catch(const IceDB::LMDBException& ex)
@@ -1238,6 +1358,13 @@ TopicImpl::destroyInternal(const LogUpdate& origLLU, bool master)
         throw; // will become UnknownException in caller
     }
 
+    deactivate();
+    return llu;
+}
+
+void
+TopicImpl::deactivate()
+{
     _instance->publishAdapter()->remove(_linkPrx->ice_getIdentity());
     _instance->publishAdapter()->remove(_publisherPrx->ice_getIdentity());
     _instance->topicReaper()->add(_name);
@@ -1248,12 +1375,11 @@ TopicImpl::destroyInternal(const LogUpdate& origLLU, bool master)
         (*p)->destroy();
     }
     _subscribers.clear();
+    _snapshot = 0;
 
     _instance->topicAdapter()->remove(_id);
 
     _servant = 0;
-
-    return llu;
 }
 
 void
@@ -1310,6 +1436,7 @@ TopicImpl::removeSubscribers(const Ice::IdentitySeq& ids)
             {
                 (*p)->destroy();
                 _subscribers.erase(p);
+                _snapshot = 0;
             }
         }
 
@@ -5,7 +5,7 @@
 #ifndef TOPIC_I_H
 #define TOPIC_I_H
 
-#include <IceStorm/IceStormInternal.h>
+#include <IceStorm/PreparedEvent.h>
 #include <IceStorm/Election.h>
 #include <IceStorm/Instrumentation.h>
 #include <IceStorm/Util.h>
@@ -22,6 +22,15 @@ typedef IceUtil::Handle<PersistentInstance> PersistentInstancePtr;
 class Subscriber;
 typedef IceUtil::Handle<Subscriber> SubscriberPtr;
 
+class SubscriberSnapshot;
+typedef IceUtil::Handle<SubscriberSnapshot> SubscriberSnapshotPtr;
+
+class MemoryBudget;
+typedef IceUtil::Handle<MemoryBudget> MemoryBudgetPtr;
+
+class EventLog;
+typedef IceUtil::Handle<EventLog> EventLogPtr;
+
 class TopicImpl : public IceUtil::Shared
 {
 public:
@@ -50,9 +59,12 @@ public:
     Ice::Identity id() const;
     TopicPrx proxy() const;
     void shutdown();
-    void publish(bool, const EventDataSeq&);
+    void publish(bool, const PreparedEventSeq&);
 
-    // Observer methods.
+    //
+    // Observer methods, the topic manager updates the database before
+    // calling them.
+    //
     void observerAddSubscriber(const IceStormElection::LogUpdate&, const SubscriberRecord&);
     void observerRemoveSubscriber(const IceStormElection::LogUpdate&, const Ice::IdentitySeq&);
     void observerDestroyTopic(const IceStormElection::LogUpdate&);
@@ -64,7 +76,8 @@ public:
 
 private:
 
-    IceStormElection::LogUpdate destroyInternal(const IceStormElection::LogUpdate&, bool);
+    IceStormElection::LogUpdate destroyInternal();
+    void deactivate();
     void removeSubscribers(const Ice::IdentitySeq&);
 
     //
@@ -74,6 +87,7 @@ private:
     const PersistentInstancePtr _instance;
     const std::string _name; // The topic name
     const Ice::Identity _id; // The topic identity
+    const MemoryBudgetPtr _memoryBudget; // The memory budget of the subscribers, if limited.
 
     IceInternal::ObserverHelperT<IceStorm::Instrumentation::TopicObserver> _observer;
 
@@ -94,8 +108,14 @@ private:
     //
     std::vector<SubscriberPtr> _subscribers;
 
+    // The copy of the subscribers shared by the publish calls, reset when
+    // the subscribers change.
+    SubscriberSnapshotPtr _snapshot;
+
     bool _destroyed; // Has this Topic been destroyed?
 
+    EventLogPtr _eventLog; // The event log, if the events of the topic are logged.
+
     LLUMap _lluMap;
     SubscriberMap _subscriberMap;
 };
@@ -11,6 +11,7 @@
 #include <IceStorm/Subscriber.h>
 #include <IceStorm/Util.h>
 #include <Ice/SliceChecksums.h>
+#include <Ice/UniquePtr.h>
 
 #include <functional>
 
@@ -63,24 +64,40 @@ public:
             }
             else
             {
-                FinishUpdateHelper unlock(_instance->node());
-                return _impl->create(id);
+                TopicPrx topic;
+                {
+                    FinishUpdateHelper unlock(_instance->node());
+                    topic = _impl->create(id);
+                }
+                return route(id, topic);
             }
         }
     }
 
     virtual TopicPrx retrieve(const string& id, const Ice::Current&) const
     {
-        // Use cached reads.
-        CachedReadHelper unlock(_instance->node(), __FILE__, __LINE__);
-        return _impl->retrieve(id);
+        TopicPrx topic;
+        {
+            // Use cached reads.
+            CachedReadHelper unlock(_instance->node(), __FILE__, __LINE__);
+            topic = _impl->retrieve(id);
+        }
+        return route(id, topic);
     }
 
     virtual TopicDict retrieveAll(const Ice::Current&) const
     {
-        // Use cached reads.
-        CachedReadHelper unlock(_instance->node(), __FILE__, __LINE__);
-        return _impl->retrieveAll();
+        TopicDict all;
+        {
+            // Use cached reads.
+            CachedReadHelper unlock(_instance->node(), __FILE__, __LINE__);
+            all = _impl->retrieveAll();
+        }
+        for(TopicDict::iterator p = all.begin(); p != all.end(); ++p)
+        {
+            p->second = route(p->first, p->second);
+        }
+        return all;
     }
 
     virtual Ice::SliceChecksumDict getSliceChecksums(const Ice::Current&) const
@@ -97,6 +114,22 @@ public:
 
 private:
 
+    //
+    // Returns the proxy of the topic on the replica that owns it when the
+    // topics are partitioned, the publishers of the topic use the
+    // publisher of this replica.
+    //
+    TopicPrx route(const string& id, const TopicPrx& topic) const
+    {
+        NodeIPtr node = _instance->node();
+        if(!topic || !node || !_instance->partitioned())
+        {
+            return topic;
+        }
+        Ice::ObjectPrx owner = node->partitionOwner(id);
+        return owner ? TopicPrx::uncheckedCast(owner->ice_identity(topic->ice_getIdentity())) : topic;
+    }
+
     TopicManagerPrx getMaster(Ice::Long& generation, const char* file, int line) const
     {
         NodeIPtr node = _instance->node();
@@ -200,6 +233,32 @@ public:
         }
     }
 
+    virtual void update(const ReplicaUpdateSeq& updates, const Ice::Current&)
+    {
+        if(updates.empty())
+        {
+            return;
+        }
+
+        //
+        // The updates of a group are sent by the master of a single
+        // generation.
+        //
+        const Ice::Long generation = updates.front().llu.generation;
+        try
+        {
+            ObserverUpdateHelper unlock(_instance->node(), generation, __FILE__, __LINE__);
+            _impl->observerUpdate(updates);
+        }
+        catch(const ObserverInconsistencyException& e)
+        {
+            Ice::Warning warn(_instance->traceLevels()->logger);
+            warn << "ReplicaObserverI::update: ObserverInconsistencyException: " << e.reason;
+            _instance->node()->recovery(generation);
+            throw;
+        }
+    }
+
 private:
 
     const PersistentInstancePtr _instance;
@@ -461,12 +520,8 @@ TopicManagerImpl::observerInit(const LogUpdate& llu, const TopicContentSeq& cont
 
         if(q == content.end())
         {
-            // Note that this destroy should not remove anything from
-            // the database since we've already synced up the db
-            // state.
-            //
-            // TODO: We could short circuit the database operations in
-            // the topic by calling a third form of destroy.
+            // Note that this destroy doesn't remove anything from the
+            // database since we've already synced up the db state.
             p->second->observerDestroyTopic(llu);
             _topics.erase(p++);
         }
@@ -497,29 +552,133 @@ TopicManagerImpl::observerInit(const LogUpdate& llu, const TopicContentSeq& cont
 
 void
 TopicManagerImpl::observerCreateTopic(const LogUpdate& llu, const string& name)
+{
+    ReplicaUpdate update;
+    update.kind = CreateTopicUpdate;
+    update.llu = llu;
+    update.topic = name;
+    observerUpdate(ReplicaUpdateSeq(1, update));
+}
+
+void
+TopicManagerImpl::observerDestroyTopic(const LogUpdate& llu, const string& name)
+{
+    ReplicaUpdate update;
+    update.kind = DestroyTopicUpdate;
+    update.llu = llu;
+    update.topic = name;
+    observerUpdate(ReplicaUpdateSeq(1, update));
+}
+
+void
+TopicManagerImpl::observerAddSubscriber(const LogUpdate& llu, const string& name, const SubscriberRecord& record)
+{
+    ReplicaUpdate update;
+    update.kind = AddSubscriberUpdate;
+    update.llu = llu;
+    update.topic = name;
+    update.record = record;
+    observerUpdate(ReplicaUpdateSeq(1, update));
+}
+
+void
+TopicManagerImpl::observerRemoveSubscriber(const LogUpdate& llu, const string& name, const Ice::IdentitySeq& id)
+{
+    ReplicaUpdate update;
+    update.kind = RemoveSubscriberUpdate;
+    update.llu = llu;
+    update.topic = name;
+    update.subscribers = id;
+    observerUpdate(ReplicaUpdateSeq(1, update));
+}
+
+void
+TopicManagerImpl::observerUpdate(const ReplicaUpdateSeq& updates)
 {
     Lock sync(*this);
-    Ice::Identity id = nameToIdentity(_instance, name);
 
+    //
+    // The updates are written to the database with a single transaction
+    // and applied to the topics once it's committed. The updates are
+    // independent, an inconsistent update is skipped and doesn't prevent
+    // the next updates from being applied.
+    //
+    IceInternal::UniquePtr<ObserverInconsistencyException> inconsistency;
+    vector<const ReplicaUpdate*> written;
     try
     {
         IceDB::ReadWriteTxn txn(_instance->dbEnv());
 
-        SubscriberRecordKey key;
-        key.topic = id;
-        SubscriberRecord rec;
-        rec.link = false;
-        rec.cost = 0;
-
-        if(_subscriberMap.find(txn, key))
+        for(ReplicaUpdateSeq::const_iterator p = updates.begin(); p != updates.end(); ++p)
         {
-            throw ObserverInconsistencyException("topic exists: " + name);
-        }
-        _subscriberMap.put(txn, key, rec);
+            //
+            // The topic record is checked with the transaction, it sees
+            // the topics created and destroyed by the previous updates.
+            //
+            SubscriberRecordKey key;
+            key.topic = nameToIdentity(_instance, p->topic);
+            const bool exists = _subscriberMap.find(txn, key);
+            if(exists == (p->kind == CreateTopicUpdate))
+            {
+                if(!inconsistency.get())
+                {
+                    inconsistency.reset(new ObserverInconsistencyException((exists ? "topic exists: " : "no topic: ") +
+                                                                          p->topic));
+                }
+                continue;
+            }
 
-        _lluMap.put(txn, lluDbKey, llu);
+            switch(p->kind)
+            {
+            case CreateTopicUpdate:
+            {
+                SubscriberRecord rec;
+                rec.link = false;
+                rec.cost = 0;
+                _subscriberMap.put(txn, key, rec);
+                break;
+            }
+            case DestroyTopicUpdate:
+            {
+                // Erase all subscriber records and the topic record.
+                SubscriberMapRWCursor cursor(_subscriberMap, txn);
+                if(cursor.find(key))
+                {
+                    _subscriberMap.del(txn, key);
 
-        txn.commit();
+                    SubscriberRecordKey k;
+                    SubscriberRecord v;
+                    while(cursor.get(k, v, MDB_NEXT) && k.topic == key.topic)
+                    {
+                        _subscriberMap.del(txn, k);
+                    }
+                }
+                break;
+            }
+            case AddSubscriberUpdate:
+            {
+                key.id = p->record.id;
+                _subscriberMap.put(txn, key, p->record);
+                break;
+            }
+            case RemoveSubscriberUpdate:
+            {
+                for(Ice::IdentitySeq::const_iterator q = p->subscribers.begin(); q != p->subscribers.end(); ++q)
+                {
+                    key.id = *q;
+                    _subscriberMap.del(txn, key);
+                }
+                break;
+            }
+            }
+            written.push_back(&*p);
+        }
+
+        if(!written.empty())
+        {
+            _lluMap.put(txn, lluDbKey, written.back()->llu);
+            txn.commit();
+        }
     }
     catch(const IceDB::LMDBException& ex)
     {
@@ -527,58 +686,42 @@ TopicManagerImpl::observerCreateTopic(const LogUpdate& llu, const string& name)
         throw; // will become UnknownException in caller
     }
 
-    installTopic(name, id, true);
-}
-
-void
-TopicManagerImpl::observerDestroyTopic(const LogUpdate& llu, const string& name)
-{
-    Lock sync(*this);
-
-    map<string, TopicImplPtr>::iterator q = _topics.find(name);
-    if(q == _topics.end())
-    {
-        throw ObserverInconsistencyException("no topic: " + name);
-    }
-    q->second->observerDestroyTopic(llu);
-
-    _topics.erase(q);
-}
-
-void
-TopicManagerImpl::observerAddSubscriber(const LogUpdate& llu, const string& name, const SubscriberRecord& record)
-{
-    TopicImplPtr topic;
+    for(vector<const ReplicaUpdate*>::const_iterator p = written.begin(); p != written.end(); ++p)
     {
-        Lock sync(*this);
+        const ReplicaUpdate& update = **p;
+        if(update.kind == CreateTopicUpdate)
+        {
+            installTopic(update.topic, nameToIdentity(_instance, update.topic), true);
+            continue;
+        }
 
-        map<string, TopicImplPtr>::iterator q = _topics.find(name);
+        map<string, TopicImplPtr>::iterator q = _topics.find(update.topic);
         if(q == _topics.end())
         {
-            throw ObserverInconsistencyException("no topic: " + name);
+            continue;
         }
-        assert(q != _topics.end());
-        topic = q->second;
-    }
-    topic->observerAddSubscriber(llu, record);
-}
 
-void
-TopicManagerImpl::observerRemoveSubscriber(const LogUpdate& llu, const string& name, const Ice::IdentitySeq& id)
-{
-    TopicImplPtr topic;
-    {
-        Lock sync(*this);
-
-        map<string, TopicImplPtr>::iterator q = _topics.find(name);
-        if(q == _topics.end())
+        switch(update.kind)
         {
-            throw ObserverInconsistencyException("no topic: " + name);
+        case DestroyTopicUpdate:
+            q->second->observerDestroyTopic(update.llu);
+            _topics.erase(q);
+            break;
+        case AddSubscriberUpdate:
+            q->second->observerAddSubscriber(update.llu, update.record);
+            break;
+        case RemoveSubscriberUpdate:
+            q->second->observerRemoveSubscriber(update.llu, update.subscribers);
+            break;
+        default:
+            break;
         }
-        assert(q != _topics.end());
-        topic = q->second;
     }
-    topic->observerRemoveSubscriber(llu, id);
+
+    if(inconsistency.get())
+    {
+        inconsistency->ice_throw();
+    }
 }
 
 void
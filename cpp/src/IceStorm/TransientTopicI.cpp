@@ -5,6 +5,7 @@
 #include <IceStorm/TransientTopicI.h>
 #include <IceStorm/Instance.h>
 #include <IceStorm/Subscriber.h>
+#include <IceStorm/Delivery.h>
 #include <IceStorm/TraceLevels.h>
 #include <IceStorm/Util.h>
 
@@ -38,20 +39,11 @@ public:
                const Ice::Current& current)
     {
         // Use cached reads.
-        EventDataPtr event = new EventData(
-            current.operation,
-            current.mode,
-            Ice::ByteSeq(),
-            current.ctx);
-
-        //
-        // COMPILERBUG: gcc 4.0.1 doesn't like this.
-        //
-        //event->data.swap(Ice::ByteSeq(inParams.first, inParams.second));
-        Ice::ByteSeq data(inParams.first, inParams.second);
-        event->data.swap(data);
-
-        EventDataSeq v;
+        PreparedEventPtr event = new PreparedEvent(current.operation, current.mode,
+                                               EventBytes(inParams.first, inParams.second),
+                                               _contexts.intern(current.ctx));
+
+        PreparedEventSeq v;
         v.push_back(event);
         _impl->publish(false, v);
 
@@ -61,6 +53,7 @@ public:
 private:
 
     const TransientTopicImplPtr _impl;
+    EventContextInterner _contexts;
 };
 
 //
@@ -79,7 +72,7 @@ public:
     virtual void
     forward(const EventDataSeq& v, const Ice::Current& /*current*/)
     {
-        _impl->publish(true, v);
+        _impl->publish(true, moveForwardedEvents(v));
     }
 
 private:
@@ -96,6 +89,7 @@ TransientTopicImpl::TransientTopicImpl(
     _instance(instance),
     _name(name),
     _id(id),
+    _memoryBudget(instance->newTopicMemoryBudget()),
     _destroyed(false)
 {
     //
@@ -250,10 +244,12 @@ TransientTopicImpl::subscribe(const QoS& origQoS, const Ice::ObjectPrx& obj, con
         // subscriber list and remove it from the database.
         (*p)->destroy();
         _subscribers.erase(p);
+        _snapshot = 0;
     }
 
-    SubscriberPtr subscriber = Subscriber::create(_instance, record);
+    SubscriberPtr subscriber = Subscriber::create(_instance, record, _memoryBudget);
     _subscribers.push_back(subscriber);
+    _snapshot = 0;
 }
 
 Ice::ObjectPrx
@@ -308,8 +304,9 @@ TransientTopicImpl::subscribeAndGetPublisher(const QoS& qos, const Ice::ObjectPr
         throw AlreadySubscribed();
     }
 
-    SubscriberPtr subscriber = Subscriber::create(_instance, record);
+    SubscriberPtr subscriber = Subscriber::create(_instance, record, _memoryBudget);
     _subscribers.push_back(subscriber);
+    _snapshot = 0;
 
     return subscriber->proxy();
 }
@@ -349,6 +346,7 @@ TransientTopicImpl::unsubscribe(const Ice::ObjectPrx& subscriber, const Ice::Cur
     {
         (*p)->destroy();
         _subscribers.erase(p);
+        _snapshot = 0;
     }
 }
 
@@ -391,8 +389,9 @@ TransientTopicImpl::link(const TopicPrx& topic, Ice::Int cost, const Ice::Curren
         throw LinkExists(IceStormInternal::identityToTopicName(id));
     }
 
-    SubscriberPtr subscriber = Subscriber::create(_instance, record);
+    SubscriberPtr subscriber = Subscriber::create(_instance, record, _memoryBudget);
     _subscribers.push_back(subscriber);
+    _snapshot = 0;
 }
 
 void
@@ -434,6 +433,7 @@ TransientTopicImpl::unlink(const TopicPrx& topic, const Ice::Current&)
     {
         (*p)->destroy();
         _subscribers.erase(p);
+        _snapshot = 0;
     }
 }
 
@@ -504,6 +504,7 @@ TransientTopicImpl::destroy(const Ice::Current&)
         (*p)->destroy();
     }
     _subscribers.clear();
+    _snapshot = 0;
 }
 
 void
@@ -526,16 +527,29 @@ TransientTopicImpl::id() const
 }
 
 void
-TransientTopicImpl::publish(bool forwarded, const EventDataSeq& events)
+TransientTopicImpl::publish(bool forwarded, const PreparedEventSeq& events)
 {
     //
-    // Copy of the subscriber list so that event publishing can occur
-    // in parallel.
+    // Snapshot of the subscriber list so that event publishing can occur
+    // in parallel. The snapshot is only copied when the subscribers change.
     //
-    vector<SubscriberPtr> copy;
+    SubscriberSnapshotPtr snapshot;
     {
         Lock sync(*this);
-        copy = _subscribers;
+        if(!_snapshot)
+        {
+            _snapshot = new SubscriberSnapshot(_subscribers);
+        }
+        snapshot = _snapshot;
+    }
+
+    //
+    // Marshal the requests of the events once if they are delivered to
+    // several subscribers.
+    //
+    if(snapshot->subscribers.size() > 1)
+    {
+        prepareEvents(_instance->communicator(), events);
     }
 
     //
@@ -543,13 +557,7 @@ TransientTopicImpl::publish(bool forwarded, const EventDataSeq& events)
     // must be reaped.
     //
     vector<Ice::Identity> e;
-    for(vector<SubscriberPtr>::const_iterator p = copy.begin(); p != copy.end(); ++p)
-    {
-        if(!(*p)->queue(forwarded, events) && (*p)->reap())
-        {
-            e.push_back((*p)->id());
-        }
-    }
+    _instance->deliveryWorkers()->deliver(snapshot, forwarded, events, e);
 
     //
     // Run through the error list removing those subscribers that are
@@ -583,6 +591,7 @@ TransientTopicImpl::publish(bool forwarded, const EventDataSeq& events)
                 //
                 subscriber->destroy();
                 _subscribers.erase(q);
+                _snapshot = 0;
             }
         }
     }
@@ -5,7 +5,7 @@
 #ifndef TRANSIENT_TOPIC_I_H
 #define TRANSIENT_TOPIC_I_H
 
-#include <IceStorm/IceStormInternal.h>
+#include <IceStorm/PreparedEvent.h>
 
 namespace IceStorm
 {
@@ -17,6 +17,12 @@ typedef IceUtil::Handle<Instance> InstancePtr;
 class Subscriber;
 typedef IceUtil::Handle<Subscriber> SubscriberPtr;
 
+class SubscriberSnapshot;
+typedef IceUtil::Handle<SubscriberSnapshot> SubscriberSnapshotPtr;
+
+class MemoryBudget;
+typedef IceUtil::Handle<MemoryBudget> MemoryBudgetPtr;
+
 class TransientTopicImpl : public TopicInternal, public IceUtil::Mutex
 {
 public:
@@ -41,7 +47,7 @@ public:
     // Internal methods
     bool destroyed() const;
     Ice::Identity id() const;
-    void publish(bool, const EventDataSeq&);
+    void publish(bool, const PreparedEventSeq&);
 
     void shutdown();
 
@@ -53,6 +59,7 @@ private:
     const InstancePtr _instance;
     const std::string _name; // The topic name
     const Ice::Identity _id; // The topic identity
+    const MemoryBudgetPtr _memoryBudget; // The memory budget of the subscribers, if limited.
 
     /*const*/ Ice::ObjectPrx _publisherPrx;
     /*const*/ TopicLinkPrx _linkPrx;
@@ -66,6 +73,10 @@ private:
     //
     std::vector<SubscriberPtr> _subscribers;
 
+    // The copy of the subscribers shared by the publish calls, reset when
+    // the subscribers change.
+    SubscriberSnapshotPtr _snapshot;
+
     bool _destroyed; // Has this Topic been destroyed?
 };
 
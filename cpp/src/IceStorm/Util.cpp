@@ -14,6 +14,27 @@ namespace IceStormInternal
 IceDB::IceContext dbContext;
 }
 
+namespace
+{
+
+//
+// Reads a sequence number without an input stream, the keys are compared
+// for each lookup. Longs are encoded in little-endian byte order and the
+// sequence numbers are never negative.
+//
+Ice::Long
+readSeq(const Ice::Byte* p)
+{
+    Ice::Long v = 0;
+    for(int i = static_cast<int>(sizeof(Ice::Long)) - 1; i >= 0; --i)
+    {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+}
+
 string
 IceStormInternal::identityToTopicName(const Ice::Identity& id)
 {
@@ -85,6 +106,45 @@ IceStormInternal::compareSubscriberRecordKey(const MDB_val* v1, const MDB_val* v
     }
 }
 
+int
+IceStormInternal::compareEventRecordKey(const MDB_val* v1, const MDB_val* v2)
+{
+    //
+    // The key is the encoded topic identity followed by the encoded
+    // sequence number. The keys of a topic are ordered by sequence number
+    // and the topics are ordered by their encoded identity, the order of
+    // the topics doesn't matter.
+    //
+    const size_t seqSize = sizeof(Ice::Long);
+    assert(v1->mv_size >= seqSize && v2->mv_size >= seqSize);
+    const size_t sz1 = v1->mv_size - seqSize;
+    const size_t sz2 = v2->mv_size - seqSize;
+    const int c = memcmp(v1->mv_data, v2->mv_data, min(sz1, sz2));
+    if(c != 0)
+    {
+        return c;
+    }
+    else if(sz1 != sz2)
+    {
+        return sz1 < sz2 ? -1 : 1;
+    }
+
+    const Ice::Long seq1 = readSeq(static_cast<const Ice::Byte*>(v1->mv_data) + sz1);
+    const Ice::Long seq2 = readSeq(static_cast<const Ice::Byte*>(v2->mv_data) + sz2);
+    if(seq1 < seq2)
+    {
+        return -1;
+    }
+    else if(seq1 == seq2)
+    {
+        return 0;
+    }
+    else
+    {
+        return 1;
+    }
+}
+
 IceStormElection::LogUpdate
 IceStormInternal::getIncrementedLLU(const IceDB::ReadWriteTxn& txn, LLUMap& lluMap)
 {
@@ -9,6 +9,7 @@
 #include <IceDB/IceDB.h>
 #include <IceStorm/LLURecord.h>
 #include <IceStorm/SubscriberRecord.h>
+#include <IceStorm/EventRecord.h>
 
 namespace IceStorm
 {
@@ -22,6 +23,7 @@ typedef IceUtil::Handle<Instance> InstancePtr;
 typedef IceDB::Dbi<IceStorm::SubscriberRecordKey, IceStorm::SubscriberRecord, IceDB::IceContext, Ice::OutputStream>
         SubscriberMap;
 typedef IceDB::Dbi<std::string, IceStormElection::LogUpdate, IceDB::IceContext, Ice::OutputStream> LLUMap;
+typedef IceDB::Dbi<IceStorm::EventRecordKey, IceStorm::EventRecord, IceDB::IceContext, Ice::OutputStream> EventMap;
 
 const std::string lluDbKey = "_manager";
 
@@ -42,6 +44,9 @@ describeEndpoints(const Ice::ObjectPrx&);
 int
 compareSubscriberRecordKey(const MDB_val* v1, const MDB_val* v2);
 
+int
+compareEventRecordKey(const MDB_val* v1, const MDB_val* v2);
+
 IceStormElection::LogUpdate
 getIncrementedLLU(const IceDB::ReadWriteTxn&, IceStorm::LLUMap&);
 
@@ -6,12 +6,11 @@
 #include <IceUtil/MutexPtrLock.h>
 #include <IceUtil/Mutex.h>
 #include <IceUtil/StringUtil.h>
+#include <IceUtil/Unicode.h>
 
 #ifdef ICE_HAS_CODECVT_UTF8
 #include <codecvt>
 #include <locale>
-#else
-#include <IceUtil/Unicode.h>
 #endif
 
 using namespace IceUtil;
@@ -79,7 +78,6 @@ public:
         char* targetEnd = 0;
         char* targetNext = 0;
 
-        mbstate_t state = mbstate_t(); // must be initialized!
         const wchar_t* sourceNext = sourceStart;
 
         bool more = false;
@@ -99,8 +97,7 @@ public:
             targetEnd = targetStart + chunkSize;
             targetNext = targetStart;
 
-            codecvt_base::result result =
-                _codecvt.out(state, sourceStart, sourceEnd, sourceNext, targetStart, targetEnd, targetNext);
+            codecvt_base::result result = out(sourceStart, sourceEnd, sourceNext, targetStart, targetEnd, targetNext);
 
             switch(result)
             {
@@ -158,19 +155,32 @@ public:
             wchar_t* targetEnd = targetStart + sourceSize;
             wchar_t* targetNext = targetStart;
 
-            const char* sourceNext = reinterpret_cast<const char*>(sourceStart);
-
-            mbstate_t state = mbstate_t();
-
-            codecvt_base::result result = _codecvt.in(state,
-                                                      reinterpret_cast<const char*>(sourceStart),
-                                                      reinterpret_cast<const char*>(sourceEnd),
-                                                      sourceNext,
-                                                      targetStart, targetEnd, targetNext);
-
-            if(result != codecvt_base::ok)
+            while(sourceStart != sourceEnd)
             {
-                throw IllegalConversionException(__FILE__, __LINE__, "codecvt.in failure");
+                size_t count = widenASCII(sourceStart, sourceEnd, targetNext);
+                sourceStart += count;
+                targetNext += count;
+                if(sourceStart == sourceEnd)
+                {
+                    break;
+                }
+
+                //
+                // Convert the non-ASCII run with the codecvt facet.
+                //
+                const char* runStart = reinterpret_cast<const char*>(sourceStart);
+                const char* runEnd = reinterpret_cast<const char*>(skipNonASCII(sourceStart, sourceEnd));
+                const char* runNext = runStart;
+                mbstate_t state = mbstate_t(); // must be initialized!
+
+                codecvt_base::result result = _codecvt.in(state, runStart, runEnd, runNext,
+                                                          targetNext, targetEnd, targetNext);
+
+                if(result != codecvt_base::ok || runNext != runEnd)
+                {
+                    throw IllegalConversionException(__FILE__, __LINE__, "codecvt.in failure");
+                }
+                sourceStart = reinterpret_cast<const Byte*>(runEnd);
             }
 
             target.resize(static_cast<size_t>(targetNext - targetStart));
@@ -179,6 +189,43 @@ public:
 
 private:
 
+    //
+    // Same as codecvt::out, except that ASCII characters are copied directly
+    // and only the non-ASCII runs are converted with the codecvt facet.
+    //
+    codecvt_base::result out(const wchar_t* sourceStart, const wchar_t* sourceEnd, const wchar_t*& sourceNext,
+                             char* targetStart, char* targetEnd, char*& targetNext) const
+    {
+        sourceNext = sourceStart;
+        targetNext = targetStart;
+        while(sourceNext != sourceEnd)
+        {
+            size_t size = static_cast<size_t>(std::min(sourceEnd - sourceNext,
+                                                       static_cast<ptrdiff_t>(targetEnd - targetNext)));
+            size_t count = narrowASCII(sourceNext, sourceNext + size, reinterpret_cast<Byte*>(targetNext));
+            sourceNext += count;
+            targetNext += count;
+            if(sourceNext == sourceEnd)
+            {
+                break;
+            }
+            else if(count == size)
+            {
+                return codecvt_base::partial;
+            }
+
+            const wchar_t* runEnd = skipNonASCII(sourceNext, sourceEnd);
+            mbstate_t state = mbstate_t(); // must be initialized!
+            codecvt_base::result result =
+                _codecvt.out(state, sourceNext, runEnd, sourceNext, targetNext, targetEnd, targetNext);
+            if(result != codecvt_base::ok || sourceNext != runEnd)
+            {
+                return result;
+            }
+        }
+        return codecvt_base::ok;
+    }
+
     typedef SelectCodeCvt<sizeof(wchar_t)>::Type CodeCvt;
     const CodeCvt _codecvt;
 };
@@ -3,22 +3,200 @@
 //
 
 #include <IceUtil/Config.h>
+#include <IceUtil/Unicode.h>
+#include <cstring>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define ICE_UNICODE_SSE2
+#   include <emmintrin.h>
+#endif
+
+using namespace std;
+using namespace IceUtil;
+using namespace IceUtilInternal;
+
+namespace
+{
+
+inline bool
+isASCII(Byte c)
+{
+    return c < 0x80;
+}
+
+inline bool
+isASCII(wchar_t c)
+{
+    // wchar_t is signed with some compilers
+    return static_cast<unsigned int>(c) < 0x80;
+}
+
+template<typename T> const T*
+skipNonASCIIRun(const T* sourceStart, const T* sourceEnd)
+{
+    while(sourceStart != sourceEnd && !isASCII(*sourceStart))
+    {
+        ++sourceStart;
+    }
+    return sourceStart == sourceEnd ? sourceEnd : sourceStart + 1;
+}
+
+#ifdef ICE_UNICODE_SSE2
+
+//
+// Helper class, base never defined
+// Usage: ASCIIHelper<sizeof(wchar_t)>::widen and narrow, which convert
+// 16 characters at a time.
+//
+template<size_t wcharSize> struct ASCIIHelper;
+
+template<>
+struct ASCIIHelper<2>
+{
+    static void widen(__m128i source, wchar_t* target)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target), _mm_unpacklo_epi8(source, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target + 8), _mm_unpackhi_epi8(source, zero));
+    }
+
+    static bool narrow(const wchar_t* source, Byte* target)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 8));
+        __m128i high = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16(static_cast<short>(0xFF80)));
+        if(_mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128())) != 0xFFFF)
+        {
+            return false;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target), _mm_packus_epi16(a, b));
+        return true;
+    }
+};
+
+template<>
+struct ASCIIHelper<4>
+{
+    static void widen(__m128i source, wchar_t* target)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i low = _mm_unpacklo_epi8(source, zero);
+        __m128i high = _mm_unpackhi_epi8(source, zero);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target), _mm_unpacklo_epi16(low, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target + 4), _mm_unpackhi_epi16(low, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target + 8), _mm_unpacklo_epi16(high, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target + 12), _mm_unpackhi_epi16(high, zero));
+    }
+
+    static bool narrow(const wchar_t* source, Byte* target)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 4));
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 8));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 12));
+        __m128i high = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)),
+                                     _mm_set1_epi32(static_cast<int>(0xFFFFFF80)));
+        if(_mm_movemask_epi8(_mm_cmpeq_epi32(high, _mm_setzero_si128())) != 0xFFFF)
+        {
+            return false;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target),
+                         _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+        return true;
+    }
+};
+
+#endif
+
+}
+
+//
+// The conversions below copy ASCII characters 16 at a time with SSE2 (always
+// available with x86-64), or 8 at a time otherwise, and only fall back to the
+// character by character converters for the non-ASCII parts of the string.
+//
+
+size_t
+IceUtilInternal::widenASCII(const Byte* sourceStart, const Byte* sourceEnd, wchar_t* target)
+{
+    const Byte* p = sourceStart;
+#ifdef ICE_UNICODE_SSE2
+    while(sourceEnd - p >= 16)
+    {
+        __m128i source = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        if(_mm_movemask_epi8(source) != 0)
+        {
+            break;
+        }
+        ASCIIHelper<sizeof(wchar_t)>::widen(source, target);
+        p += 16;
+        target += 16;
+    }
+#else
+    while(sourceEnd - p >= 8)
+    {
+        unsigned int words[2];
+        memcpy(words, p, sizeof(words));
+        if((words[0] | words[1]) & 0x80808080U)
+        {
+            break;
+        }
+        for(int i = 0; i < 8; ++i)
+        {
+            target[i] = static_cast<wchar_t>(p[i]);
+        }
+        p += 8;
+        target += 8;
+    }
+#endif
+    while(p != sourceEnd && isASCII(*p))
+    {
+        *target++ = static_cast<wchar_t>(*p++);
+    }
+    return static_cast<size_t>(p - sourceStart);
+}
+
+size_t
+IceUtilInternal::narrowASCII(const wchar_t* sourceStart, const wchar_t* sourceEnd, Byte* target)
+{
+    const wchar_t* p = sourceStart;
+#ifdef ICE_UNICODE_SSE2
+    while(sourceEnd - p >= 16 && ASCIIHelper<sizeof(wchar_t)>::narrow(p, target))
+    {
+        p += 16;
+        target += 16;
+    }
+#endif
+    while(p != sourceEnd && isASCII(*p))
+    {
+        *target++ = static_cast<Byte>(*p++);
+    }
+    return static_cast<size_t>(p - sourceStart);
+}
+
+const Byte*
+IceUtilInternal::skipNonASCII(const Byte* sourceStart, const Byte* sourceEnd)
+{
+    return skipNonASCIIRun(sourceStart, sourceEnd);
+}
+
+const wchar_t*
+IceUtilInternal::skipNonASCII(const wchar_t* sourceStart, const wchar_t* sourceEnd)
+{
+    return skipNonASCIIRun(sourceStart, sourceEnd);
+}
 
 #ifndef ICE_HAS_CODECVT_UTF8
 //
-// It's better to exclude the file from the build, but it's not always
-// easy to do.
+// It's better to exclude the rest of the file from the build, but it's not
+// always easy to do.
 //
 
-#include <IceUtil/Unicode.h>
 #include <IceUtil/Exception.h>
 
 #include <IceUtil/ConvertUTF.h>
 
-using namespace std;
-using namespace IceUtil;
-using namespace IceUtilInternal;
-
 namespace
 {
 //
@@ -104,18 +282,32 @@ bool
 IceUtilInternal::convertUTFWstringToUTF8(const wchar_t*& sourceStart, const wchar_t* sourceEnd,
                                          Byte*& targetStart, Byte* targetEnd)
 {
-    ConversionResult result = WstringHelper<sizeof(wchar_t)>::toUTF8(
-        sourceStart, sourceEnd, targetStart, targetEnd);
-
-    if(result == targetExhausted)
-    {
-        return false;
-    }
-    else
+    while(sourceStart != sourceEnd)
     {
+        size_t size = static_cast<size_t>(std::min(sourceEnd - sourceStart,
+                                                   static_cast<ptrdiff_t>(targetEnd - targetStart)));
+        size_t count = narrowASCII(sourceStart, sourceStart + size, targetStart);
+        sourceStart += count;
+        targetStart += count;
+        if(sourceStart == sourceEnd)
+        {
+            break;
+        }
+        else if(count == size)
+        {
+            return false;
+        }
+
+        ConversionResult result = WstringHelper<sizeof(wchar_t)>::toUTF8(
+            sourceStart, skipNonASCII(sourceStart, sourceEnd), targetStart, targetEnd);
+
+        if(result == targetExhausted)
+        {
+            return false;
+        }
         checkResult(result);
-        return true;
     }
+    return true;
 }
 
 void
@@ -127,11 +319,22 @@ IceUtilInternal::convertUTF8ToUTFWstring(const Byte*& sourceStart, const Byte* s
     wchar_t* targetStart = const_cast<wchar_t*>(target.data());
     wchar_t* targetEnd = targetStart + sourceSize;
 
-    ConversionResult result = WstringHelper<sizeof(wchar_t)>::fromUTF8(sourceStart, sourceEnd,
-                                                                       targetStart, targetEnd);
+    while(sourceStart != sourceEnd)
+    {
+        size_t count = widenASCII(sourceStart, sourceEnd, targetStart);
+        sourceStart += count;
+        targetStart += count;
+        if(sourceStart == sourceEnd)
+        {
+            break;
+        }
+
+        ConversionResult result = WstringHelper<sizeof(wchar_t)>::fromUTF8(
+            sourceStart, skipNonASCII(sourceStart, sourceEnd), targetStart, targetEnd);
 
-    checkResult(result);
-    target.resize(targetStart - target.data());
+        checkResult(result);
+    }
+    target.resize(static_cast<size_t>(targetStart - target.data()));
 }
 
 void
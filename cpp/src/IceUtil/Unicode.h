@@ -14,7 +14,8 @@ namespace IceUtilInternal
 //
 // Convert UTF-8 byte-sequences to and from UTF-16 or UTF-32 (with native endianness)
 //
-// These are wrappers for Unicode's ConvertUTF.h/cpp.
+// These are wrappers for Unicode's ConvertUTF.h/cpp, which are only used
+// when the C++ library doesn't provide std::codecvt_utf8.
 
 //
 // Convert wstring encoded with UTF-16 or UTF-32 to UTF-8.
@@ -38,6 +39,29 @@ convertUTF8ToUTF32(const std::vector<unsigned char>&, std::vector<unsigned int>&
 void
 convertUTF32ToUTF8(const std::vector<unsigned int>&, std::vector<unsigned char>&);
 
+//
+// Copy the leading ASCII characters of a UTF-8 string to a wide string, or
+// the reverse. The target must have room for the whole source. Returns the
+// number of characters copied, i.e. the position of the first non-ASCII
+// character or the size of the source.
+//
+size_t
+widenASCII(const IceUtil::Byte* sourceStart, const IceUtil::Byte* sourceEnd, wchar_t* target);
+
+size_t
+narrowASCII(const wchar_t* sourceStart, const wchar_t* sourceEnd, IceUtil::Byte* target);
+
+//
+// Returns the end of the run of non-ASCII characters at the start of the
+// source, including the ASCII character that ends it. Converting a string
+// run by run this way gives the same result as converting it at once.
+//
+const IceUtil::Byte*
+skipNonASCII(const IceUtil::Byte* sourceStart, const IceUtil::Byte* sourceEnd);
+
+const wchar_t*
+skipNonASCII(const wchar_t* sourceStart, const wchar_t* sourceEnd);
+
 }
 
 #endif
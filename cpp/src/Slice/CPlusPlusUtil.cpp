@@ -37,6 +37,23 @@ string toTemplateArg(const string& arg)
     return fixed;
 }
 
+//
+// Returns true if reserving the marshaling buffer is worthwhile for a value of
+// the given type: the type is variable-length and its wire size can be
+// estimated, unlike classes and proxies.
+//
+bool
+hasWireSizeEstimate(const TypePtr& type)
+{
+    if(!type->isVariableLength() || ClassDeclPtr::dynamicCast(type) || ProxyPtr::dynamicCast(type))
+    {
+        return false;
+    }
+    BuiltinPtr builtin = BuiltinPtr::dynamicCast(type);
+    return !builtin || (builtin->kind() != Builtin::KindObject && builtin->kind() != Builtin::KindObjectProxy &&
+                        builtin->kind() != Builtin::KindValue);
+}
+
 string
 toOptional(const string& s, int typeCtx)
 {
@@ -68,6 +85,10 @@ stringTypeToString(const TypePtr&, const StringList& metaData, int typeCtx)
     {
         return strType;
     }
+    else if(typeCtx & TypeContextArena && strType == "")
+    {
+        return "::Ice::ArenaString";
+    }
     else
     {
         return "::std::string";
@@ -133,6 +154,10 @@ sequenceTypeToString(const SequencePtr& seq, const string& scope, const StringLi
             }
             return "::std::pair<" + s + "::const_iterator, " + s + "::const_iterator>";
         }
+        else if(seqType == "%lazy")
+        {
+            return "::Ice::LazyView<" + toTemplateArg(getUnqualified(fixKwd(seq->scoped()), scope)) + ">";
+        }
         else
         {
             return seqType;
@@ -152,6 +177,10 @@ dictionaryTypeToString(const DictionaryPtr& dict, const string& scope, const Str
     {
         return getUnqualified(fixKwd(dict->scoped()), scope);
     }
+    else if(dictType == "%lazy")
+    {
+        return "::Ice::LazyView<" + toTemplateArg(getUnqualified(fixKwd(dict->scoped()), scope)) + ">";
+    }
     else
     {
         return dictType;
@@ -342,6 +371,40 @@ writeMarshalUnmarshalParams(Output& out, const ParamDeclList& params, const Oper
         }
     }
 
+    //
+    // Reserve the marshaling buffer for the required parameters, so that large
+    // parameters don't reallocate the buffer several times as it grows.
+    //
+    if(marshal)
+    {
+        StringList sized;
+        for(ParamDeclList::const_iterator p = requiredParams.begin(); p != requiredParams.end(); ++p)
+        {
+            if(hasWireSizeEstimate((*p)->type()))
+            {
+                sized.push_back(objPrefix + fixKwd(prefix + (*p)->name()));
+            }
+        }
+        if(op && op->returnType() && !op->returnIsOptional() && hasWireSizeEstimate(op->returnType()))
+        {
+            sized.push_back(objPrefix + returnValueS);
+        }
+
+        if(!sized.empty())
+        {
+            out << nl << stream << "->reserve(";
+            for(StringList::const_iterator p = sized.begin(); p != sized.end(); ++p)
+            {
+                if(p != sized.begin())
+                {
+                    out << " + ";
+                }
+                out << "::Ice::iceWireSize(" << *p << ")";
+            }
+            out << ");";
+        }
+    }
+
     if(!requiredParams.empty() || (op && op->returnType() && !op->returnIsOptional()))
     {
         if(cpp11)
@@ -1695,11 +1758,11 @@ Slice::findMetaData(const StringList& metaData, int typeCtx)
             // is returned.
             // If the form is cpp:view-type:<...> the data after the
             // cpp:view-type: is returned
-            // If the form is cpp:range[:<...>], cpp:array or cpp:class,
+            // If the form is cpp:range[:<...>], cpp:array, cpp:lazy or cpp:class,
             // the return value is % followed by the string after cpp:.
             //
             // The priority of the metadata is as follows:
-            // 1: array, range (C++98 only), view-type for "view" parameters
+            // 1: array, range (C++98 only), lazy, view-type for "view" parameters
             // 2: class (C++98 only), scoped (C++98 only), unscoped (C++11 only)
             //
 
@@ -1735,6 +1798,10 @@ Slice::findMetaData(const StringList& metaData, int typeCtx)
                 {
                     return "%range";
                 }
+                else if(ss == "lazy")
+                {
+                    return "%lazy";
+                }
             }
             //
             // Otherwise if the data is "class", "scoped" or "unscoped" it is returned.
@@ -29,6 +29,7 @@ const int TypeContextAMICallPrivateEnd = 8;
 const int TypeContextUseWstring = 16;
 const int TypeContextLocal = 32;
 const int TypeContextCpp11 = 64;
+const int TypeContextArena = 128;
 
 bool isMovable(const TypePtr&);
 
@@ -422,3 +422,162 @@ Slice::argvToArgs(int argc, char* argv[])
     return args;
 }
 #endif
+
+string
+Slice::getDecodingSchema(const TypePtr& type)
+{
+    BuiltinPtr builtin = BuiltinPtr::dynamicCast(type);
+    if(builtin)
+    {
+        switch(builtin->kind())
+        {
+            case Builtin::KindByte:
+            {
+                return "byte";
+            }
+            case Builtin::KindBool:
+            {
+                return "bool";
+            }
+            case Builtin::KindShort:
+            {
+                return "short";
+            }
+            case Builtin::KindInt:
+            {
+                return "int";
+            }
+            case Builtin::KindLong:
+            {
+                return "long";
+            }
+            case Builtin::KindFloat:
+            {
+                return "float";
+            }
+            case Builtin::KindDouble:
+            {
+                return "double";
+            }
+            case Builtin::KindString:
+            {
+                return "string";
+            }
+            case Builtin::KindObjectProxy:
+            {
+                return "proxy";
+            }
+            default:
+            {
+                return "";
+            }
+        }
+    }
+
+    if(ProxyPtr::dynamicCast(type))
+    {
+        return "proxy";
+    }
+
+    EnumPtr en = EnumPtr::dynamicCast(type);
+    if(en)
+    {
+        ostringstream os;
+        os << "enum(" << en->maxValue() << ")";
+        return os.str();
+    }
+
+    StructPtr st = StructPtr::dynamicCast(type);
+    if(st)
+    {
+        string schema = "struct{";
+        const DataMemberList members = st->dataMembers();
+        for(DataMemberList::const_iterator p = members.begin(); p != members.end(); ++p)
+        {
+            string member = getDecodingSchema((*p)->type());
+            if(member.empty())
+            {
+                return "";
+            }
+            schema += (p == members.begin() ? "" : ", ") + member;
+        }
+        return schema + "}";
+    }
+
+    SequencePtr seq = SequencePtr::dynamicCast(type);
+    if(seq)
+    {
+        string element = getDecodingSchema(seq->type());
+        return element.empty() ? string() : "seq<" + element + ">";
+    }
+
+    DictionaryPtr dict = DictionaryPtr::dynamicCast(type);
+    if(dict)
+    {
+        string key = getDecodingSchema(dict->keyType());
+        string value = getDecodingSchema(dict->valueType());
+        return key.empty() || value.empty() ? string() : "dict<" + key + ", " + value + ">";
+    }
+
+    return ""; // Classes
+}
+
+string
+Slice::getDecodingSchema(const OperationPtr& op, bool reply)
+{
+    //
+    // The required parameters are encoded first, followed by the required
+    // return value and by the optional parameters and return value in tag
+    // order.
+    //
+    vector<string> fields;
+    map<int, string> optionals;
+    const ParamDeclList params = reply ? op->outParameters() : op->inParameters();
+    for(ParamDeclList::const_iterator p = params.begin(); p != params.end(); ++p)
+    {
+        string field = getDecodingSchema((*p)->type());
+        if(field.empty())
+        {
+            return "";
+        }
+        if((*p)->optional())
+        {
+            optionals[(*p)->tag()] = field;
+        }
+        else
+        {
+            fields.push_back(field);
+        }
+    }
+
+    if(reply && op->returnType())
+    {
+        string field = getDecodingSchema(op->returnType());
+        if(field.empty())
+        {
+            return "";
+        }
+        if(op->returnIsOptional())
+        {
+            optionals[op->returnTag()] = field;
+        }
+        else
+        {
+            fields.push_back(field);
+        }
+    }
+
+    for(map<int, string>::const_iterator p = optionals.begin(); p != optionals.end(); ++p)
+    {
+        ostringstream os;
+        os << "?" << p->first << ":" << p->second;
+        fields.push_back(os.str());
+    }
+
+    ostringstream os;
+    for(vector<string>::const_iterator p = fields.begin(); p != fields.end(); ++p)
+    {
+        os << (p == fields.begin() ? "" : ", ") << *p;
+    }
+    return os.str();
+}
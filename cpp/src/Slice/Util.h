@@ -45,6 +45,15 @@ toStringLiteral(const std::string&, const std::string&, const std::string&, Esca
 void
 writeDependencies(const std::string&, const std::string&);
 
+//
+// Returns the type description of an Ice::DecodingProgram for a type, or for the parameters
+// of an operation: the in parameters of a request or the out parameters and the return value
+// of a reply. Returns an empty string if the type or a parameter uses classes, which decoding
+// programs don't support.
+//
+std::string getDecodingSchema(const TypePtr&);
+std::string getDecodingSchema(const OperationPtr&, bool);
+
 }
 
 #endif
@@ -90,6 +90,203 @@ getDeprecateSymbol(const ContainedPtr& p1, const ContainedPtr& p2)
     return deprecateSymbol;
 }
 
+//
+// Determines whether a type contains arena-aware types, the types with the
+// cpp:arena metadata. Class instances are not unmarshaled into an arena.
+//
+bool
+usesArena(const TypePtr& type)
+{
+    SequencePtr seq = SequencePtr::dynamicCast(type);
+    if(seq)
+    {
+        return seq->hasMetaData("cpp:arena") || usesArena(seq->type());
+    }
+
+    DictionaryPtr dict = DictionaryPtr::dynamicCast(type);
+    if(dict)
+    {
+        return dict->hasMetaData("cpp:arena") || usesArena(dict->keyType()) || usesArena(dict->valueType());
+    }
+
+    StructPtr st = StructPtr::dynamicCast(type);
+    if(st)
+    {
+        if(st->hasMetaData("cpp:arena"))
+        {
+            return true;
+        }
+        DataMemberList dataMembers = st->dataMembers();
+        for(DataMemberList::const_iterator q = dataMembers.begin(); q != dataMembers.end(); ++q)
+        {
+            if(usesArena((*q)->type()))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+//
+// Determines whether a type contains arena-aware types in a sequence or
+// dictionary without the cpp:arena metadata, or in a struct mapped to a
+// class. The elements of an arena-aware container are rebound to the heap
+// when they are moved out of the arena, the elements of these types aren't.
+//
+bool
+nestsArena(const TypePtr& type)
+{
+    SequencePtr seq = SequencePtr::dynamicCast(type);
+    if(seq)
+    {
+        return seq->hasMetaData("cpp:arena") ? nestsArena(seq->type()) : usesArena(seq->type());
+    }
+
+    DictionaryPtr dict = DictionaryPtr::dynamicCast(type);
+    if(dict)
+    {
+        if(dict->hasMetaData("cpp:arena"))
+        {
+            return nestsArena(dict->keyType()) || nestsArena(dict->valueType());
+        }
+        return usesArena(dict->keyType()) || usesArena(dict->valueType());
+    }
+
+    StructPtr st = StructPtr::dynamicCast(type);
+    if(st)
+    {
+        if(findMetaData(st->getMetaData(), false) == "%class")
+        {
+            return usesArena(st);
+        }
+        DataMemberList dataMembers = st->dataMembers();
+        for(DataMemberList::const_iterator q = dataMembers.begin(); q != dataMembers.end(); ++q)
+        {
+            if(nestsArena((*q)->type()))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+//
+// Determines whether the dispatch code unmarshals the in parameters of an
+// operation into an arena. The parameters of an AMD operation outlive the
+// dispatch, and so can the class instances kept by the servant and the
+// arena-aware values nested in types that can't rebind them to the heap.
+//
+bool
+dispatchUsesArena(const OperationPtr& p, bool amd)
+{
+    if(amd || p->sendsClasses(true))
+    {
+        return false;
+    }
+
+    bool arena = false;
+    ParamDeclList inParams = p->inParameters();
+    for(ParamDeclList::const_iterator q = inParams.begin(); q != inParams.end(); ++q)
+    {
+        if(nestsArena((*q)->type()))
+        {
+            return false;
+        }
+        arena = arena || usesArena((*q)->type());
+    }
+    return arena;
+}
+
+//
+// Returns the element type as a template argument, for C++98.
+//
+string
+templateArg(const string& s)
+{
+    string arg = s;
+    if(arg[0] == ':')
+    {
+        arg.insert(0, " ");
+    }
+    if(arg[arg.size() - 1] == '>')
+    {
+        arg += ' ';
+    }
+    return arg;
+}
+
+//
+// Generates the wire size estimator of a variable-length struct, the estimator
+// of fixed-length structs uses their minimum wire size.
+//
+void
+writeStreamWireSizeHelper(IceUtilInternal::Output& out, const StructPtr& p, const string& fullName,
+                          const string& category, bool classMetaData)
+{
+    if(!p->isVariableLength())
+    {
+        return;
+    }
+
+    string holder = classMetaData ? "v->" : "v.";
+    DataMemberList dataMembers = p->dataMembers();
+
+    out << nl << "template<>";
+    out << nl << "struct StreamWireSizeHelper<" << templateArg(fullName) << ", " << category << ">";
+    out << sb;
+    out << nl << "static size_t iceWireSize(const " << fullName << "& v)";
+    out << sb;
+    out << nl << "return ";
+    for(DataMemberList::const_iterator q = dataMembers.begin(); q != dataMembers.end(); ++q)
+    {
+        if(q != dataMembers.begin())
+        {
+            out << " +";
+            out.inc();
+            out << nl;
+            out.dec();
+        }
+        out << "::Ice::iceWireSize(" << holder << fixKwd((*q)->name()) << ")";
+    }
+    out << ";";
+    out << eb;
+    out << eb << ";" << nl;
+}
+
+//
+// Generates the helper that rebinds the arena-aware data members of a struct
+// to an arena or to the heap, see Ice::ArenaHelper.
+//
+void
+writeArenaHelper(IceUtilInternal::Output& out, const StructPtr& p, const string& fullName)
+{
+    if(!usesArena(p))
+    {
+        return;
+    }
+
+    bool arena = p->hasMetaData("cpp:arena");
+    DataMemberList dataMembers = p->dataMembers();
+
+    out << nl << "template<>";
+    out << nl << "struct ArenaHelper<" << templateArg(fullName) << ">";
+    out << sb;
+    out << nl << "static void bind(" << fullName << "& v, Arena* arena)";
+    out << sb;
+    for(DataMemberList::const_iterator q = dataMembers.begin(); q != dataMembers.end(); ++q)
+    {
+        BuiltinPtr builtin = BuiltinPtr::dynamicCast((*q)->type());
+        if(usesArena((*q)->type()) || (arena && builtin && builtin->kind() == Builtin::KindString))
+        {
+            out << nl << "::Ice::arenaBind(v." << fixKwd((*q)->name()) << ", arena);";
+        }
+    }
+    out << eb;
+    out << eb << ";" << nl;
+}
+
 void
 writeConstantValue(IceUtilInternal::Output& out, const TypePtr& type, const SyntaxTreeBasePtr& valueType,
                    const string& value, int typeContext, const StringList& metaData, const string& scope)
@@ -291,6 +488,93 @@ throwUserExceptionLambda(IceUtilInternal::Output& C, ExceptionList throws, const
     }
 }
 
+void
+writeCharSwitch(Output& out, const string& var, const StringList& names, const map<string, string>& cases)
+{
+    assert(!names.empty());
+    if(names.size() == 1)
+    {
+        out << nl << "if(" << var << " == \"" << names.front() << "\")";
+        out << sb;
+        out << nl << cases.find(names.front())->second;
+        out << eb;
+        return;
+    }
+
+    //
+    // All the names have the same length, switch on the character position which
+    // splits them in the largest number of groups.
+    //
+    string::size_type length = names.front().size();
+    string::size_type pos = 0;
+    size_t groups = 0;
+    for(string::size_type i = 0; i < length; ++i)
+    {
+        set<char> chars;
+        for(StringList::const_iterator q = names.begin(); q != names.end(); ++q)
+        {
+            chars.insert((*q)[i]);
+        }
+        if(chars.size() > groups)
+        {
+            pos = i;
+            groups = chars.size();
+        }
+    }
+    assert(groups > 1);
+
+    map<char, StringList> byChar;
+    for(StringList::const_iterator q = names.begin(); q != names.end(); ++q)
+    {
+        byChar[(*q)[pos]].push_back(*q);
+    }
+
+    out << nl << "switch(" << var << '[' << pos << "])";
+    out << sb;
+    for(map<char, StringList>::const_iterator q = byChar.begin(); q != byChar.end(); ++q)
+    {
+        out << nl << "case '";
+        if(q->first == '\'' || q->first == '\\')
+        {
+            out << '\\';
+        }
+        out << q->first << "':";
+        out << sb;
+        writeCharSwitch(out, var, q->second, cases);
+        out << nl << "break;";
+        out << eb;
+    }
+    out << eb;
+}
+
+//
+// Writes a switch that runs the code associated with the name equal to var, if
+// any. The names are first switched on their length and then on the characters
+// that tell them apart, which costs at most one string comparison per lookup
+// instead of the several comparisons of a binary search.
+//
+void
+writeStringSwitch(Output& out, const string& var, const map<string, string>& cases)
+{
+    map<string::size_type, StringList> byLength;
+    for(map<string, string>::const_iterator p = cases.begin(); p != cases.end(); ++p)
+    {
+        byLength[p->first.size()].push_back(p->first);
+    }
+
+    out << nl << "switch(" << var << ".size())";
+    out << sb;
+    for(map<string::size_type, StringList>::const_iterator p = byLength.begin(); p != byLength.end(); ++p)
+    {
+        out << nl << "case " << p->first << ':';
+        out << sb;
+        writeCharSwitch(out, var, p->second, cases);
+        out << nl << "break;";
+        out << eb;
+    }
+    out << eb;
+}
+
 string
 resultStructName(const string& name, const string& scope = "", bool marshaledResult = false)
 {
@@ -923,6 +1207,18 @@ Slice::Gen::generate(const UnitPtr& p)
     H << "\n#include <IceUtil/ScopedArray.h>";
     H << "\n#include <Ice/Optional.h>";
 
+    if(p->hasContentsWithMetaData("cpp:lazy") || p->hasContentsWithMetaData("cpp98:lazy") ||
+       p->hasContentsWithMetaData("cpp11:lazy"))
+    {
+        H << "\n#include <Ice/LazyView.h>";
+    }
+
+    if(p->hasContentsWithMetaData("cpp:arena") || p->hasContentsWithMetaData("cpp98:arena") ||
+       p->hasContentsWithMetaData("cpp11:arena"))
+    {
+        H << "\n#include <Ice/Arena.h>";
+    }
+
     if(p->hasExceptions())
     {
         H << "\n#include <Ice/ExceptionHelpers.h>";
@@ -1090,6 +1386,9 @@ Slice::Gen::generate(const UnitPtr& p)
         Cpp11CompatibilityVisitor compatibilityVisitor(H, C, _dllExport);
         p->visit(&compatibilityVisitor, false);
 
+        FactoryTableVisitor factoryTableVisitor(C, true);
+        p->visit(&factoryTableVisitor, false);
+
         generateChecksumMap(p);
     }
     H << sp;
@@ -1167,6 +1466,9 @@ Slice::Gen::generate(const UnitPtr& p)
             p->visit(&implVisitor, false);
         }
 
+        FactoryTableVisitor factoryTableVisitor(C, false);
+        p->visit(&factoryTableVisitor, false);
+
         generateChecksumMap(p);
     }
 
@@ -1387,19 +1689,6 @@ Slice::Gen::TypesVisitor::visitExceptionStart(const ExceptionPtr& p)
     H << nl << "virtual ~" << name << "() throw();";
     H << sp;
 
-    if(!p->isLocal())
-    {
-        string initName = "iceC" + p->flattenedScope() + p->name() + "_init";
-
-        C << sp << nl << "namespace";
-        C << nl << "{";
-
-        C << sp << nl << "const ::IceInternal::DefaultUserExceptionFactoryInit< " << scoped << "> "
-          << initName << "(\"" << p->scoped() << "\");";
-
-        C << sp << nl << "}";
-    }
-
     if(p->isLocal())
     {
         C << sp << nl << scoped.substr(2) << "::" << name << spar << "const char* " + fileParam
@@ -1895,8 +2184,9 @@ Slice::Gen::TypesVisitor::visitSequence(const SequencePtr& p)
     TypePtr type = p->type();
     ContainedPtr cont = ContainedPtr::dynamicCast(p->container());
     string scope = fixKwd(p->scope());
-    string s = typeToString(type, scope, p->typeMetaData(), _useWstring);
     StringList metaData = p->getMetaData();
+    bool arena = find(metaData.begin(), metaData.end(), "cpp:arena") != metaData.end();
+    string s = typeToString(type, scope, p->typeMetaData(), arena ? _useWstring | TypeContextArena : _useWstring);
 
     string seqType = findMetaData(metaData, _useWstring);
     H << sp;
@@ -1907,6 +2197,11 @@ Slice::Gen::TypesVisitor::visitSequence(const SequencePtr& p)
     {
         H << nl << "typedef " << seqType << ' ' << name << ';';
     }
+    else if(arena)
+    {
+        H << nl << "typedef ::std::vector<" << templateArg(s) << ", ::Ice::ArenaAllocator<" << templateArg(s)
+          << "> > " << name << ';';
+    }
     else
     {
         H << nl << "typedef ::std::vector<" << (s[0] == ':' ? " " : "") << s << "> " << name << ';';
@@ -1932,14 +2227,24 @@ Slice::Gen::TypesVisitor::visitDictionary(const DictionaryPtr& p)
 
         TypePtr keyType = p->keyType();
         TypePtr valueType = p->valueType();
-        string ks = typeToString(keyType, scope, p->keyMetaData(), _useWstring);
-        if(ks[0] == ':')
+        int typeCtx = p->hasMetaData("cpp:arena") ? _useWstring | TypeContextArena : _useWstring;
+        string ks = typeToString(keyType, scope, p->keyMetaData(), typeCtx);
+        string vs = typeToString(valueType, scope, p->valueMetaData(), typeCtx);
+
+        if(typeCtx & TypeContextArena)
         {
-            ks.insert(0, " ");
+            H << nl << "typedef ::std::map<" << templateArg(ks) << ", " << vs << ", ::std::less<" << templateArg(ks)
+              << ">, ::Ice::ArenaAllocator< ::std::pair<const " << ks << "," << templateArg(vs) << "> > > "
+              << name << ';';
+        }
+        else
+        {
+            if(ks[0] == ':')
+            {
+                ks.insert(0, " ");
+            }
+            H << nl << "typedef ::std::map<" << ks << ", " << vs << "> " << name << ';';
         }
-        string vs = typeToString(valueType, scope, p->valueMetaData(), _useWstring);
-
-        H << nl << "typedef ::std::map<" << ks << ", " << vs << "> " << name << ';';
     }
     else
     {
@@ -3096,7 +3401,13 @@ Slice::Gen::ObjectVisitor::visitClassDefStart(const ClassDefPtr& p)
         C << nl << "bool" << nl << scoped.substr(2)
           << "::ice_isA(const ::std::string& s, const " << getUnqualified("::Ice::Current&", scope) << ") const";
         C << sb;
-        C << nl << "return ::std::binary_search(" << flatName << ", " << flatName << " + " << ids.size() << ", s);";
+        map<string, string> idCases;
+        for(StringList::const_iterator q = ids.begin(); q != ids.end(); ++q)
+        {
+            idCases[*q] = "return true;";
+        }
+        writeStringSwitch(C, "s", idCases);
+        C << nl << "return false;";
         C << eb;
 
         C << sp;
@@ -3186,56 +3497,21 @@ Slice::Gen::ObjectVisitor::visitClassDefEnd(const ClassDefPtr& p)
               << getUnqualified("::Ice::Current&", scope) << ");";
             H << nl << "/// \\endcond";
 
-            string flatName = "iceC" + p->flattenedScope() + p->name() + "_all";
-            C << sp << nl << "namespace";
-            C << nl << "{";
-            C << nl << "const ::std::string " << flatName << "[] =";
-            C << sb;
-
-            for(StringList::const_iterator q = allOpNames.begin(); q != allOpNames.end();)
-            {
-                C << nl << '"' << *q << '"';
-                if(++q != allOpNames.end())
-                {
-                    C << ',';
-                }
-            }
-            C << eb << ';';
-            C << sp << nl << "}";
             C << sp;
             C << nl << "/// \\cond INTERNAL";
             C << nl << "bool";
             C << nl << scoped.substr(2) << "::_iceDispatch(::IceInternal::Incoming& in, const "
               << getUnqualified("::Ice::Current&", scope) << " current)";
             C << sb;
-
-            C << nl << "::std::pair<const ::std::string*, const ::std::string*> r = "
-              << "::std::equal_range(" << flatName << ", " << flatName << " + " << allOpNames.size()
-              << ", current.operation);";
-            C << nl << "if(r.first == r.second)";
-            C << sb;
-            C << nl << "throw " << getUnqualified("::Ice::OperationNotExistException", scope)
-              << "(__FILE__, __LINE__, current.id, " << "current.facet, current.operation);";
-            C << eb;
-            C << sp;
-            C << nl << "switch(r.first - " << flatName << ')';
-            C << sb;
-            int i = 0;
+            map<string, string> opCases;
             for(StringList::const_iterator q = allOpNames.begin(); q != allOpNames.end(); ++q)
             {
-                C << nl << "case " << i++ << ':';
-                C << sb;
-                C << nl << "return _iceD_" << *q << "(in, current);";
-                C << eb;
+                opCases[*q] = "return _iceD_" + *q + "(in, current);";
             }
-            C << nl << "default:";
-            C << sb;
-            C << nl << "assert(false);";
+            writeStringSwitch(C, "current.operation", opCases);
             C << nl << "throw " << getUnqualified("::Ice::OperationNotExistException", scope)
               << "(__FILE__, __LINE__, current.id, " << "current.facet, current.operation);";
             C << eb;
-            C << eb;
-            C << eb;
             C << nl << "/// \\endcond";
 
             //
@@ -3259,50 +3535,26 @@ Slice::Gen::ObjectVisitor::visitClassDefEnd(const ClassDefPtr& p)
                   << " ice_operationAttributes(const ::std::string&) const;";
                 H << nl << "/// \\endcond";
 
-                string opAttrFlatName = "iceC" + p->flattenedScope() + p->name() + "_operationAttributes";
-
-                C << sp << nl << "namespace";
-                C << nl << "{";
-                C << nl << "const int " << opAttrFlatName << "[] = ";
+                C << sp;
+                C << nl << "::Ice::Int" << nl << scoped.substr(2)
+                  << "::ice_operationAttributes(const ::std::string& opName) const";
                 C << sb;
-
-                for(StringList::const_iterator q = allOpNames.begin(); q != allOpNames.end();)
+                map<string, string> attrCases;
+                for(StringList::const_iterator q = allOpNames.begin(); q != allOpNames.end(); ++q)
                 {
                     int attributes = 0;
-                    string opName = *q;
-                    map<string, int>::iterator it = attributesMap.find(opName);
+                    map<string, int>::iterator it = attributesMap.find(*q);
                     if(it != attributesMap.end())
                     {
                         attributes = it->second;
                     }
-                    C << nl << attributes;
-
-                    if(++q != allOpNames.end())
-                    {
-                        C << ',';
-                    }
-                    C << " // " << opName;
+                    ostringstream os;
+                    os << "return " << attributes << ';';
+                    attrCases[*q] = os.str();
                 }
-
-                C << eb << ';';
-                C << sp << nl << "}";
-
-                C << sp;
-
-                C << nl << "::Ice::Int" << nl << scoped.substr(2)
-                  << "::ice_operationAttributes(const ::std::string& opName) const";
-                C << sb;
-
-                C << nl << "::std::pair<const ::std::string*, const ::std::string*> r = "
-                  << "::std::equal_range(" << flatName << ", " << flatName << " + " << allOpNames.size()
-                  << ", opName);";
-                C << nl << "if(r.first == r.second)";
-                C << sb;
+                writeStringSwitch(C, "opName", attrCases);
                 C << nl << "return -1;";
                 C << eb;
-
-                C << nl << "return " << opAttrFlatName << "[r.first - " << flatName << "];";
-                C << eb;
             }
         }
 
@@ -3402,32 +3654,12 @@ Slice::Gen::ObjectVisitor::visitClassDefEnd(const ClassDefPtr& p)
         C << eb;
         C << nl << "/// \\endcond";
 
-        if(!p->isAbstract() || p->compactId() >= 0)
+        if(!p->isAbstract())
         {
-            C << sp << nl << "namespace";
-            C << nl << "{";
-
-            if(!p->isAbstract())
-            {
-                string initName = "iceC" + p->flattenedScope() + p->name() + "_init";
-                C << nl << "const ::IceInternal::DefaultValueFactoryInit< " << scoped << "> "
-                  << initName << "(\"" << p->scoped() << "\");";
-            }
-            if(p->compactId() >= 0)
-            {
-                string initName = "iceC" + p->flattenedScope() + p->name() + "_compactIdInit";
-                C << nl << "const ::IceInternal::CompactIdInit "
-                  << initName << "(\"" << p->scoped() << "\", " << p->compactId() << ");";
-            }
-            C << nl << "}";
-
-            if(!p->isAbstract())
-            {
-                C << sp << nl << "::Ice::ValueFactoryPtr" << nl << scoped.substr(2) << "::ice_factory()";
-                C << sb;
-                C << nl << "return ::IceInternal::factoryTable->getValueFactory(" << scoped << "::ice_staticId());";
-                C << eb;
-            }
+            C << sp << nl << "::Ice::ValueFactoryPtr" << nl << scoped.substr(2) << "::ice_factory()";
+            C << sb;
+            C << nl << "return ::IceInternal::factoryTable->getValueFactory(" << scoped << "::ice_staticId());";
+            C << eb;
         }
     }
 
@@ -3753,9 +3985,20 @@ Slice::Gen::ObjectVisitor::visitOperation(const OperationPtr& p)
         C << sb;
         C << nl << "_iceCheckMode(" << operationModeToString(p->mode()) << ", current.mode);";
 
-        if(!inParams.empty())
+        if(!inParams.empty() && dispatchUsesArena(p, amd))
+        {
+            //
+            // The arena is released with the parameters once the dispatch completes.
+            //
+            C << nl << getUnqualified("::Ice::Arena", classScope) << " iceArena;";
+            C << nl << getUnqualified("::Ice::InputStream*", classScope) << " istr = inS.startReadParams(iceArena);";
+        }
+        else if(!inParams.empty())
         {
             C << nl << getUnqualified("::Ice::InputStream*", classScope) << " istr = inS.startReadParams();";
+        }
+        if(!inParams.empty())
+        {
             writeAllocateCode(C, inParams, 0, true, classScope, _useWstring | TypeContextInParam);
             writeUnmarshalCode(C, inParams, 0, true, TypeContextInParam);
             if(p->sendsClasses(false))
@@ -5313,6 +5556,10 @@ Slice::Gen::StreamVisitor::visitStructStart(const StructPtr& p)
         {
             H << nl << "static const StreamHelperCategory helper = StreamHelperCategoryStructClass;";
         }
+        else if(p->hasMetaData("cpp:packed"))
+        {
+            H << nl << "static const StreamHelperCategory helper = StreamHelperCategoryPackedStruct;";
+        }
         else
         {
             H << nl << "static const StreamHelperCategory helper = StreamHelperCategoryStruct;";
@@ -5329,6 +5576,12 @@ Slice::Gen::StreamVisitor::visitStructStart(const StructPtr& p)
         H << eb << ";" << nl;
 
         writeStreamHelpers(H, p, p->dataMembers(), false, true, false);
+        writeStreamWireSizeHelper(H, p, fullStructName, classMetaData ? "StreamHelperCategoryStructClass" :
+                                  "StreamHelperCategoryStruct", classMetaData);
+        if(!classMetaData)
+        {
+            writeArenaHelper(H, p, fullStructName);
+        }
     }
     return false;
 }
@@ -5506,6 +5759,47 @@ bool
 Slice::Gen::MetaDataVisitor::visitStructStart(const StructPtr& p)
 {
     StringList metaData = validate(p, p->getMetaData(), p->file(), p->line());
+    metaData = validateArena(p, metaData);
+
+    if(find(metaData.begin(), metaData.end(), "cpp:packed") != metaData.end())
+    {
+        //
+        // A packed struct must have the same layout in memory and on the wire: only
+        // fixed-size numeric members, each naturally aligned without padding.
+        //
+        string reason;
+        if(find(metaData.begin(), metaData.end(), "cpp:class") != metaData.end() ||
+           find(metaData.begin(), metaData.end(), "cpp98:class") != metaData.end())
+        {
+            reason = "it is mapped to a class";
+        }
+
+        DataMemberList dataMembers = p->dataMembers();
+        size_t offset = 0;
+        for(DataMemberList::const_iterator q = dataMembers.begin(); q != dataMembers.end() && reason.empty(); ++q)
+        {
+            BuiltinPtr builtin = BuiltinPtr::dynamicCast((*q)->type());
+            if(!builtin || builtin->kind() == Builtin::KindBool || builtin->isVariableLength())
+            {
+                reason = "data member `" + (*q)->name() + "' is not a byte, short, int, long, float or double";
+            }
+            else if(offset % builtin->minWireSize() != 0)
+            {
+                reason = "data member `" + (*q)->name() + "' is not naturally aligned";
+            }
+            offset += builtin ? builtin->minWireSize() : 0;
+        }
+
+        if(!reason.empty())
+        {
+            const DefinitionContextPtr dc = p->unit()->findDefinitionContext(p->file());
+            assert(dc);
+            dc->warning(InvalidMetaData, p->file(), p->line(), "ignoring metadata `cpp:packed' for struct `" +
+                        p->name() + "': " + reason);
+            metaData.remove("cpp:packed");
+        }
+    }
+
     p->setMetaData(metaData);
     return true;
 }
@@ -5538,7 +5832,7 @@ Slice::Gen::MetaDataVisitor::visitOperation(const OperationPtr& p)
         {
             string s = *q++;
             if(s.find("cpp:type:") == 0 || s.find("cpp:view-type:") == 0 ||
-               s.find("cpp:range") == 0 || s == "cpp:array")
+               s.find("cpp:range") == 0 || s == "cpp:array" || s == "cpp:lazy")
             {
                 dc->warning(InvalidMetaData, p->file(), p->line(),
                             "ignoring invalid metadata `" + s + "' for operation with void return type");
@@ -5549,6 +5843,7 @@ Slice::Gen::MetaDataVisitor::visitOperation(const OperationPtr& p)
     else
     {
         metaData = validate(returnType, metaData, p->file(), p->line(), true);
+        metaData = validateLazy(returnType, p->returnIsOptional(), cl->isLocal(), metaData, p->file(), p->line());
     }
 
     p->setMetaData(metaData);
@@ -5557,6 +5852,7 @@ Slice::Gen::MetaDataVisitor::visitOperation(const OperationPtr& p)
     for(ParamDeclList::iterator q = params.begin(); q != params.end(); ++q)
     {
         metaData = validate((*q)->type(), (*q)->getMetaData(), p->file(), (*q)->line(), true);
+        metaData = validateLazy((*q)->type(), (*q)->optional(), cl->isLocal(), metaData, p->file(), (*q)->line());
         (*q)->setMetaData(metaData);
     }
 }
@@ -5572,6 +5868,7 @@ void
 Slice::Gen::MetaDataVisitor::visitSequence(const SequencePtr& p)
 {
     StringList metaData = validate(p, p->getMetaData(), p->file(), p->line());
+    metaData = validateArena(p, metaData);
     p->setMetaData(metaData);
 }
 
@@ -5579,6 +5876,7 @@ void
 Slice::Gen::MetaDataVisitor::visitDictionary(const DictionaryPtr& p)
 {
     StringList metaData = validate(p, p->getMetaData(), p->file(), p->line());
+    metaData = validateArena(p, metaData);
     p->setMetaData(metaData);
 }
 
@@ -5596,6 +5894,91 @@ Slice::Gen::MetaDataVisitor::visitConst(const ConstPtr& p)
     p->setMetaData(metaData);
 }
 
+StringList
+Slice::Gen::MetaDataVisitor::validateLazy(const TypePtr& type, bool optional, bool local, const StringList& metaData,
+                                          const string& file, const string& line)
+{
+    //
+    // A lazy view decodes its elements from the stream buffer on demand, this
+    // isn't possible for class instances, which are only complete once the
+    // whole encapsulation is unmarshaled.
+    //
+    string reason;
+    if(local)
+    {
+        reason = "local operation";
+    }
+    else if(optional)
+    {
+        reason = "optional parameter";
+    }
+    else if(type->usesClasses())
+    {
+        reason = "type that uses classes";
+    }
+
+    if(reason.empty())
+    {
+        return metaData;
+    }
+
+    const DefinitionContextPtr dc = type->unit()->findDefinitionContext(file);
+    assert(dc);
+    StringList newMetaData = metaData;
+    for(StringList::const_iterator p = metaData.begin(); p != metaData.end(); ++p)
+    {
+        if(*p == "cpp:lazy" || *p == "cpp98:lazy" || *p == "cpp11:lazy")
+        {
+            dc->warning(InvalidMetaData, file, line, "ignoring metadata `" + *p + "' for " + reason);
+            newMetaData.remove(*p);
+        }
+    }
+    return newMetaData;
+}
+
+StringList
+Slice::Gen::MetaDataVisitor::validateArena(const ConstructedPtr& p, const StringList& metaData)
+{
+    //
+    // Arena-aware types are only unmarshaled into an arena by the dispatch
+    // code, and a custom container type has its own allocator.
+    //
+    string reason;
+    if(p->isLocal())
+    {
+        reason = "local type";
+    }
+    else
+    {
+        for(StringList::const_iterator q = metaData.begin(); q != metaData.end() && reason.empty(); ++q)
+        {
+            if(q->find("cpp:type:") == 0 || q->find("cpp98:type:") == 0 || q->find("cpp11:type:") == 0)
+            {
+                reason = "custom type";
+            }
+        }
+    }
+
+    if(reason.empty())
+    {
+        return metaData;
+    }
+
+    const DefinitionContextPtr dc = p->unit()->findDefinitionContext(p->file());
+    assert(dc);
+    StringList newMetaData = metaData;
+    for(StringList::const_iterator q = metaData.begin(); q != metaData.end(); ++q)
+    {
+        if(*q == "cpp:arena" || *q == "cpp98:arena" || *q == "cpp11:arena")
+        {
+            dc->warning(InvalidMetaData, p->file(), p->line(), "ignoring metadata `" + *q + "' for " + reason +
+                        " `" + p->name() + "'");
+            newMetaData.remove(*q);
+        }
+    }
+    return newMetaData;
+}
+
 StringList
 Slice::Gen::MetaDataVisitor::validate(const SyntaxTreeBasePtr& cont, const StringList& metaData,
                                       const string& file, const string& line, bool operation)
@@ -5669,10 +6052,23 @@ Slice::Gen::MetaDataVisitor::validate(const SyntaxTreeBasePtr& cont, const Strin
             {
                 continue;
             }
+            if(operation && (SequencePtr::dynamicCast(cont) || DictionaryPtr::dynamicCast(cont)) && ss == "lazy")
+            {
+                continue;
+            }
             if(!cpp11 && StructPtr::dynamicCast(cont) && (ss == "class" || ss == "comparable"))
             {
                 continue;
             }
+            if(!cpp11 && !cpp98 && StructPtr::dynamicCast(cont) && ss == "packed")
+            {
+                continue;
+            }
+            if(!operation && (StructPtr::dynamicCast(cont) || SequencePtr::dynamicCast(cont) ||
+                              DictionaryPtr::dynamicCast(cont)) && ss == "arena")
+            {
+                continue;
+            }
 
             {
                 ClassDefPtr cl = ClassDefPtr::dynamicCast(cont);
@@ -5865,11 +6261,13 @@ Slice::Gen::NormalizeMetaDataVisitor::normalize(const StringList& metaData)
 
     static const string cppPrefixTable[] =
     {
+        "arena",
         "array",
         "class",
         "comparable",
         "const",
         "ice_print",
+        "lazy",
         "range",
         "scoped",
         "type:",
@@ -5987,6 +6385,14 @@ Slice::Gen::setUseWstring(ContainedPtr p, list<int>& hist, int use)
     {
         use = 0;
     }
+
+    //
+    // The string data members of an arena-aware struct are arena strings.
+    //
+    if(StructPtr::dynamicCast(p) && find(metaData.begin(), metaData.end(), "cpp:arena") != metaData.end())
+    {
+        use |= TypeContextArena;
+    }
     return use;
 }
 
@@ -6037,7 +6443,7 @@ Slice::Gen::Cpp11DeclVisitor::Cpp11DeclVisitor(Output& h, Output& c, const strin
 bool
 Slice::Gen::Cpp11DeclVisitor::visitUnitStart(const UnitPtr& p)
 {
-    if(!p->hasClassDecls() && !p->hasNonLocalExceptions())
+    if(!p->hasClassDecls())
     {
         return false;
     }
@@ -6094,21 +6500,6 @@ Slice::Gen::Cpp11DeclVisitor::visitClassDefStart(const ClassDefPtr& p)
         return false;
     }
 
-    if(!p->isInterface())
-    {
-        C << sp;
-
-        C << nl << "const ::IceInternal::DefaultValueFactoryInit<" << fixKwd(p->scoped()) << "> ";
-        C << "iceC" + p->flattenedScope() + p->name() + "_init" << "(\"" << p->scoped() << "\");";
-
-        if(p->compactId() >= 0)
-        {
-            string n = "iceC" + p->flattenedScope() + p->name() + "_compactIdInit ";
-            C << nl << "const ::IceInternal::CompactIdInit " << n << "(\"" << p->scoped() << "\", " << p->compactId()
-              << ");";
-        }
-    }
-
     OperationList allOps = p->allOperations();
     if(p->isInterface() || !allOps.empty())
     {
@@ -6135,46 +6526,11 @@ Slice::Gen::Cpp11DeclVisitor::visitClassDefStart(const ClassDefPtr& p)
             }
         }
         C << eb << ';';
-
-        StringList allOpNames;
-        transform(allOps.begin(), allOps.end(), back_inserter(allOpNames), ::IceUtil::constMemFun(&Contained::name));
-        allOpNames.push_back("ice_id");
-        allOpNames.push_back("ice_ids");
-        allOpNames.push_back("ice_isA");
-        allOpNames.push_back("ice_ping");
-        allOpNames.sort();
-        allOpNames.unique();
-
-        C << nl << "const ::std::string iceC" << p->flattenedScope() << p->name() << "_ops[] =";
-        C << sb;
-        for(StringList::const_iterator q = allOpNames.begin(); q != allOpNames.end();)
-        {
-            C << nl << '"' << *q << '"';
-            if(++q != allOpNames.end())
-            {
-                C << ',';
-            }
-        }
-        C << eb << ';';
     }
 
     return true;
 }
 
-bool
-Slice::Gen::Cpp11DeclVisitor::visitExceptionStart(const ExceptionPtr& p)
-{
-    if(p->isLocal())
-    {
-        return false;
-    }
-
-    C << sp;
-    C << nl << "const ::IceInternal::DefaultUserExceptionFactoryInit<" << fixKwd(p->scoped()) << "> ";
-    C << "iceC" + p->flattenedScope() + p->name() + "_init" << "(\"" << p->scoped() << "\");";
-    return false;
-}
-
 void
 Slice::Gen::Cpp11DeclVisitor::visitOperation(const OperationPtr& p)
 {
@@ -6640,8 +6996,13 @@ Slice::Gen::Cpp11TypesVisitor::visitSequence(const SequencePtr& p)
     string scope = fixKwd(p->scope());
     TypePtr type = p->type();
     int typeCtx = p->isLocal() ? (_useWstring | TypeContextLocal) : _useWstring;
-    string s = typeToString(type, scope, p->typeMetaData(), typeCtx | TypeContextCpp11);
     StringList metaData = p->getMetaData();
+    bool arena = find(metaData.begin(), metaData.end(), "cpp:arena") != metaData.end();
+    if(arena)
+    {
+        typeCtx |= TypeContextArena;
+    }
+    string s = typeToString(type, scope, p->typeMetaData(), typeCtx | TypeContextCpp11);
 
     string seqType = findMetaData(metaData, _useWstring);
     H << sp;
@@ -6651,6 +7012,10 @@ Slice::Gen::Cpp11TypesVisitor::visitSequence(const SequencePtr& p)
     {
         H << nl << "using " << name << " = " << seqType << ';';
     }
+    else if(arena)
+    {
+        H << nl << "using " << name << " = ::std::vector<" << s << ", ::Ice::ArenaAllocator<" << s << ">>;";
+    }
     else
     {
         H << nl << "using " << name << " = ::std::vector<" << s << ">;";
@@ -6675,10 +7040,22 @@ Slice::Gen::Cpp11TypesVisitor::visitDictionary(const DictionaryPtr& p)
         //
         TypePtr keyType = p->keyType();
         TypePtr valueType = p->valueType();
+        if(p->hasMetaData("cpp:arena"))
+        {
+            typeCtx |= TypeContextArena;
+        }
         string ks = typeToString(keyType, scope, p->keyMetaData(), typeCtx | TypeContextCpp11);
         string vs = typeToString(valueType, scope, p->valueMetaData(), typeCtx | TypeContextCpp11);
 
-        H << nl << "using " << name << " = ::std::map<" << ks << ", " << vs << ">;";
+        if(typeCtx & TypeContextArena)
+        {
+            H << nl << "using " << name << " = ::std::map<" << ks << ", " << vs << ", ::std::less<" << ks
+              << ">, ::Ice::ArenaAllocator<::std::pair<const " << ks << ", " << vs << ">>>;";
+        }
+        else
+        {
+            H << nl << "using " << name << " = ::std::map<" << ks << ", " << vs << ">;";
+        }
     }
     else
     {
@@ -7980,7 +8357,13 @@ Slice::Gen::Cpp11InterfaceVisitor::visitClassDefStart(const ClassDefPtr& p)
     C << nl << "bool" << nl << scoped.substr(2) << "::ice_isA(::std::string s, const "
       << getUnqualified("::Ice::Current&", scope) << ") const";
     C << sb;
-    C << nl << "return ::std::binary_search(" << flatName << ", " << flatName << " + " << ids.size() << ", s);";
+    map<string, string> idCases;
+    for(StringList::const_iterator q = ids.begin(); q != ids.end(); ++q)
+    {
+        idCases[*q] = "return true;";
+    }
+    writeStringSwitch(C, "s", idCases);
+    C << nl << "return false;";
     C << eb;
 
     C << sp;
@@ -8037,8 +8420,6 @@ Slice::Gen::Cpp11InterfaceVisitor::visitClassDefEnd(const ClassDefPtr& p)
         allOpNames.sort();
         allOpNames.unique();
 
-        string flatName = "iceC" + p->flattenedScope() + p->name() + "_ops";
-
         H << sp;
         H << nl << "/// \\cond INTERNAL";
         H << nl << "virtual bool _iceDispatch(::IceInternal::Incoming&, const "
@@ -8051,34 +8432,15 @@ Slice::Gen::Cpp11InterfaceVisitor::visitClassDefEnd(const ClassDefPtr& p)
         C << nl << scoped.substr(2) << "::_iceDispatch(::IceInternal::Incoming& in, const "
           << getUnqualified("::Ice::Current&", scope) << " current)";
         C << sb;
-
-        C << nl << "::std::pair<const ::std::string*, const ::std::string*> r = "
-          << "::std::equal_range(" << flatName << ", " << flatName << " + " << allOpNames.size()
-          << ", current.operation);";
-        C << nl << "if(r.first == r.second)";
-        C << sb;
-        C << nl << "throw " << getUnqualified("::Ice::OperationNotExistException", scope)
-          << "(__FILE__, __LINE__, current.id, current.facet, current.operation);";
-        C << eb;
-        C << sp;
-        C << nl << "switch(r.first - " << flatName << ')';
-        C << sb;
-        int i = 0;
+        map<string, string> opCases;
         for(StringList::const_iterator q = allOpNames.begin(); q != allOpNames.end(); ++q)
         {
-            C << nl << "case " << i++ << ':';
-            C << sb;
-            C << nl << "return _iceD_" << *q << "(in, current);";
-            C << eb;
+            opCases[*q] = "return _iceD_" + *q + "(in, current);";
         }
-        C << nl << "default:";
-        C << sb;
-        C << nl << "assert(false);";
+        writeStringSwitch(C, "current.operation", opCases);
         C << nl << "throw " << getUnqualified("::Ice::OperationNotExistException", scope)
           << "(__FILE__, __LINE__, current.id, current.facet, current.operation);";
         C << eb;
-        C << eb;
-        C << eb;
         C << nl << "/// \\endcond";
     }
 
@@ -8310,9 +8672,20 @@ Slice::Gen::Cpp11InterfaceVisitor::visitOperation(const OperationPtr& p)
     C << nl << "_iceCheckMode(" << getUnqualified(operationModeToString(p->mode(), true), classScope)
       << ", current.mode);";
 
-    if(!inParams.empty())
+    if(!inParams.empty() && dispatchUsesArena(p, amd))
+    {
+        //
+        // The arena is released with the parameters once the dispatch completes.
+        //
+        C << nl << getUnqualified("::Ice::Arena", classScope) << " iceArena;";
+        C << nl << "auto istr = inS.startReadParams(iceArena);";
+    }
+    else if(!inParams.empty())
     {
         C << nl << "auto istr = inS.startReadParams();";
+    }
+    if(!inParams.empty())
+    {
         writeAllocateCode(C, inParams, 0, true, classScope, _useWstring | TypeContextInParam | TypeContextCpp11);
         writeUnmarshalCode(C, inParams, 0, true, _useWstring | TypeContextInParam | TypeContextCpp11);
         if(p->sendsClasses(false))
@@ -8878,12 +9251,21 @@ Slice::Gen::Cpp11StreamVisitor::visitStructStart(const StructPtr& p)
     H << nl << "template<>";
     H << nl << "struct StreamableTraits<" << scoped << ">";
     H << sb;
-    H << nl << "static const StreamHelperCategory helper = StreamHelperCategoryStruct;";
+    if(p->hasMetaData("cpp:packed"))
+    {
+        H << nl << "static const StreamHelperCategory helper = StreamHelperCategoryPackedStruct;";
+    }
+    else
+    {
+        H << nl << "static const StreamHelperCategory helper = StreamHelperCategoryStruct;";
+    }
     H << nl << "static const int minWireSize = " << p->minWireSize() << ";";
     H << nl << "static const bool fixedLength = " << (p->isVariableLength() ? "false" : "true") << ";";
     H << eb << ";" << nl;
 
     writeStreamHelpers(H, p, p->dataMembers(), false, false, true);
+    writeStreamWireSizeHelper(H, p, scoped, "StreamHelperCategoryStruct", false);
+    writeArenaHelper(H, p, scoped);
 
     return false;
 }
@@ -8925,6 +9307,120 @@ Slice::Gen::Cpp11StreamVisitor::visitEnum(const EnumPtr& p)
     }
 }
 
+Slice::Gen::FactoryTableVisitor::FactoryTableVisitor(Output& c, bool cpp11) :
+    C(c), _cpp11(cpp11)
+{
+}
+
+bool
+Slice::Gen::FactoryTableVisitor::visitUnitStart(const UnitPtr& p)
+{
+    return p->hasNonLocalClassDefs() || p->hasNonLocalExceptions();
+}
+
+void
+Slice::Gen::FactoryTableVisitor::visitUnitEnd(const UnitPtr&)
+{
+    if(_factories.empty() && _compactIds.empty())
+    {
+        return;
+    }
+
+    //
+    // The tables are constant-initialized, registering them only records
+    // their address: the factory table sorts and merges them on first use.
+    //
+    C << sp << nl << "namespace";
+    C << nl << "{";
+    if(!_factories.empty())
+    {
+        C << sp << nl << "const ::IceInternal::FactoryTableEntry iceC_factoryTable[] =";
+        C << sb;
+        for(map<string, string>::const_iterator p = _factories.begin(); p != _factories.end();)
+        {
+            C << nl << p->second;
+            if(++p != _factories.end())
+            {
+                C << ',';
+            }
+        }
+        C << eb << ';';
+    }
+    if(!_compactIds.empty())
+    {
+        C << sp << nl << "const ::IceInternal::CompactIdTableEntry iceC_compactIdTable[] =";
+        C << sb;
+        for(map<int, string>::const_iterator p = _compactIds.begin(); p != _compactIds.end();)
+        {
+            C << nl << "{ " << p->first << ", \"" << p->second << "\" }";
+            if(++p != _compactIds.end())
+            {
+                C << ',';
+            }
+        }
+        C << eb << ';';
+    }
+
+    C << sp << nl << "const ::IceInternal::FactoryTableRegistration iceC_factoryTableRegistration(";
+    if(_factories.empty())
+    {
+        C << "0, 0, ";
+    }
+    else
+    {
+        C << "iceC_factoryTable, " << _factories.size() << ", ";
+    }
+    if(_compactIds.empty())
+    {
+        C << "0, 0);";
+    }
+    else
+    {
+        C << "iceC_compactIdTable, " << _compactIds.size() << ");";
+    }
+    C << sp << nl << "}";
+}
+
+bool
+Slice::Gen::FactoryTableVisitor::visitModuleStart(const ModulePtr& p)
+{
+    return p->hasNonLocalClassDefs() || p->hasNonLocalExceptions();
+}
+
+bool
+Slice::Gen::FactoryTableVisitor::visitClassDefStart(const ClassDefPtr& p)
+{
+    if(p->isLocal() || p->isInterface())
+    {
+        return false;
+    }
+
+    //
+    // With the C++98 mapping, abstract classes don't have a default factory.
+    //
+    if(_cpp11 || !p->isAbstract())
+    {
+        _factories[p->scoped()] = "{ \"" + p->scoped() + "\", ::IceInternal::defaultValueFactory<" +
+            templateArg(fixKwd(p->scoped())) + ">, 0 }";
+    }
+    if(p->compactId() >= 0)
+    {
+        _compactIds[p->compactId()] = p->scoped();
+    }
+    return false;
+}
+
+bool
+Slice::Gen::FactoryTableVisitor::visitExceptionStart(const ExceptionPtr& p)
+{
+    if(!p->isLocal())
+    {
+        _factories[p->scoped()] = "{ \"" + p->scoped() + "\", 0, ::IceInternal::defaultUserExceptionFactory<" +
+            templateArg(fixKwd(p->scoped())) + "> }";
+    }
+    return false;
+}
+
 Slice::Gen::Cpp11CompatibilityVisitor::Cpp11CompatibilityVisitor(Output& h, Output&, const string& dllExport) :
     H(h),
     _dllExport(dllExport)
@@ -354,7 +354,6 @@ private:
         virtual void visitModuleEnd(const ModulePtr&);
         virtual void visitClassDecl(const ClassDeclPtr&);
         virtual bool visitClassDefStart(const ClassDefPtr&);
-        virtual bool visitExceptionStart(const ExceptionPtr&);
         virtual void visitOperation(const OperationPtr&);
 
     private:
@@ -557,6 +556,31 @@ private:
 
 private:
 
+    //
+    // Generates the table of the value and user exception factories and of the
+    // compact IDs of the translation unit.
+    //
+    class FactoryTableVisitor : private ::IceUtil::noncopyable, public ParserVisitor
+    {
+    public:
+
+        FactoryTableVisitor(::IceUtilInternal::Output&, bool);
+
+        virtual bool visitUnitStart(const UnitPtr&);
+        virtual void visitUnitEnd(const UnitPtr&);
+        virtual bool visitModuleStart(const ModulePtr&);
+        virtual bool visitClassDefStart(const ClassDefPtr&);
+        virtual bool visitExceptionStart(const ExceptionPtr&);
+
+    private:
+
+        ::IceUtilInternal::Output& C;
+        bool _cpp11;
+
+        std::map<std::string, std::string> _factories;
+        std::map<int, std::string> _compactIds;
+    };
+
     class MetaDataVisitor : public ParserVisitor
     {
     public:
@@ -580,6 +604,8 @@ private:
 
     private:
 
+        StringList validateLazy(const TypePtr&, bool, bool, const StringList&, const std::string&, const std::string&);
+        StringList validateArena(const ConstructedPtr&, const StringList&);
         StringList validate(const SyntaxTreeBasePtr&, const StringList&, const std::string&, const std::string&,
                             bool = false);
     };
@@ -0,0 +1,379 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <Ice/Ice.h>
+#include <TestHelper.h>
+#include <Test.h>
+
+using namespace std;
+
+//
+// In parameters are passed by value with the C++11 mapping and by
+// const reference with the C++98 mapping.
+//
+#ifdef ICE_CPP11_MAPPING
+#   define IN(T) T
+#else
+#   define IN(T) const T&
+#endif
+
+namespace
+{
+
+Ice::ArenaString
+toArena(const string& s)
+{
+    return Ice::ArenaString(s.begin(), s.end());
+}
+
+Test::ItemSeq
+makeItems(int count)
+{
+    Test::ItemSeq items;
+    for(int i = 0; i < count; ++i)
+    {
+        Test::Item item;
+        item.id = i;
+        ostringstream os;
+        os << "an item with a name longer than a small string " << i;
+        item.name = toArena(os.str());
+        for(int j = 0; j < 4; ++j)
+        {
+            ostringstream tag;
+            tag << "a tag longer than a small string " << j;
+            item.tags.push_back(toArena(tag.str()));
+        }
+        for(int j = 0; j < 2; ++j)
+        {
+            ostringstream key;
+            key << "an attribute longer than a small string " << j;
+            item.attributes[toArena(key.str())] = item.name;
+        }
+        items.push_back(item);
+    }
+    return items;
+}
+
+Test::PlainItemSeq
+makePlainItems(int count)
+{
+    Test::ItemSeq items = makeItems(count);
+    Test::PlainItemSeq plainItems;
+    for(Test::ItemSeq::const_iterator p = items.begin(); p != items.end(); ++p)
+    {
+        Test::PlainItem item;
+        item.id = p->id;
+        item.name.assign(p->name.begin(), p->name.end());
+        for(Test::StringSeq::const_iterator q = p->tags.begin(); q != p->tags.end(); ++q)
+        {
+            item.tags.push_back(string(q->begin(), q->end()));
+        }
+        for(Test::StringDict::const_iterator q = p->attributes.begin(); q != p->attributes.end(); ++q)
+        {
+            item.attributes[string(q->first.begin(), q->first.end())] = string(q->second.begin(), q->second.end());
+        }
+        plainItems.push_back(item);
+    }
+    return plainItems;
+}
+
+int
+countItems(const Test::ItemSeq& items)
+{
+    int n = 0;
+    for(Test::ItemSeq::const_iterator p = items.begin(); p != items.end(); ++p)
+    {
+        test(p->tags.size() == 4);
+        test(p->attributes.begin()->second == p->name);
+        n += static_cast<int>(p->tags.size() + p->attributes.size());
+    }
+    return n;
+}
+
+class TestIntfI : public Test::TestIntf
+{
+public:
+
+    virtual int count(IN(Test::ItemSeq) items, const Ice::Current&)
+    {
+        //
+        // The parameters are unmarshaled into the arena of the dispatch.
+        //
+        test(items.get_allocator() != Test::ItemSeq::allocator_type());
+        return countItems(items);
+    }
+
+    virtual Test::ItemSeq echo(IN(Test::ItemSeq) items, const Ice::Current&)
+    {
+        return items;
+    }
+
+    virtual string opWrapper(IN(Test::Wrapper) w, IN(Test::ItemSeqDict) d, const Ice::Current&)
+    {
+        //
+        // Wrapper nests arena-aware items in a sequence that can't rebind them
+        // to the heap, so the parameters are unmarshaled from the heap.
+        //
+        test(d.get_allocator() == Test::ItemSeqDict::allocator_type());
+        ostringstream os;
+        os << w.name << ' ' << w.items.size();
+        for(Test::ItemSeqDict::const_iterator p = d.begin(); p != d.end(); ++p)
+        {
+            os << ' ' << p->first << ':' << countItems(p->second);
+        }
+        return os.str();
+    }
+
+    virtual void keep(IN(Test::ItemSeq) items, const Ice::Current&)
+    {
+        //
+        // The items copied or moved into the member are allocated from the
+        // heap, they outlive the arena of the dispatch.
+        //
+#ifdef ICE_CPP11_MAPPING
+        _kept = move(items);
+#else
+        _kept = items;
+#endif
+        test(_kept.get_allocator() == Test::ItemSeq::allocator_type());
+#ifdef ICE_CPP11_COMPILER
+        for(Test::ItemSeq::const_iterator p = _kept.begin(); p != _kept.end(); ++p)
+        {
+            test(p->name.get_allocator() == Ice::ArenaAllocator<char>());
+            test(p->tags.get_allocator() == Test::StringSeq::allocator_type());
+            test(p->tags.empty() || p->tags[0].get_allocator() == Ice::ArenaAllocator<char>());
+            test(p->attributes.get_allocator() == Test::StringDict::allocator_type());
+        }
+#endif
+    }
+
+    virtual Test::ItemSeq kept(const Ice::Current&)
+    {
+        return _kept;
+    }
+
+#ifdef ICE_CPP11_MAPPING
+    virtual void echoAsyncAsync(Test::ItemSeq items, function<void(const Test::ItemSeq&)> response,
+                                function<void(exception_ptr)>, const Ice::Current&)
+    {
+        response(items);
+    }
+#else
+    virtual void echoAsync_async(const Test::AMD_TestIntf_echoAsyncPtr& cb, const Test::ItemSeq& items,
+                                 const Ice::Current&)
+    {
+        cb->ice_response(items);
+    }
+#endif
+
+    virtual Test::NodePtr opNode(IN(Test::NodePtr) n, IN(Test::StringSeq) tags, const Ice::Current&)
+    {
+        test(n->tags == tags);
+        return n;
+    }
+
+    virtual int sendPlain(IN(Test::PlainItemSeq) items, const Ice::Current&)
+    {
+        return static_cast<int>(items.size());
+    }
+
+    virtual int sendArena(IN(Test::ItemSeq) items, const Ice::Current&)
+    {
+        return static_cast<int>(items.size());
+    }
+
+private:
+
+    Test::ItemSeq _kept;
+};
+
+}
+
+class Client : public Test::TestHelper
+{
+public:
+
+    void run(int, char**);
+};
+
+void
+Client::run(int argc, char** argv)
+{
+    Ice::PropertiesPtr properties = createTestProperties(argc, argv);
+    properties->setProperty("Ice.MessageSizeMax", "0");
+    Ice::CommunicatorHolder communicator = initialize(argc, argv, properties);
+
+    communicator->getProperties()->setProperty("TestAdapter.Endpoints", getTestEndpoint());
+    Ice::ObjectAdapterPtr adapter = communicator->createObjectAdapter("TestAdapter");
+    Test::TestIntfPrxPtr intf = ICE_UNCHECKED_CAST(Test::TestIntfPrx,
+                                                   adapter->add(ICE_MAKE_SHARED(TestIntfI),
+                                                                Ice::stringToIdentity("test")));
+    adapter->activate();
+
+    cout << "testing arena... " << flush;
+    {
+        Ice::Arena arena(256);
+        test(arena.capacity() == 0);
+
+        Ice::Byte* p = static_cast<Ice::Byte*>(arena.allocate(1));
+        Ice::Byte* q = static_cast<Ice::Byte*>(arena.allocate(3));
+        test(reinterpret_cast<size_t>(p) % Ice::Arena::alignment == 0);
+        test(q == p + Ice::Arena::alignment);
+        test(arena.capacity() == 256);
+
+        //
+        // A large allocation gets its own chunk.
+        //
+        arena.allocate(10000);
+        test(arena.capacity() == 256 + 10000);
+        test(arena.allocate(8) == q + Ice::Arena::alignment);
+
+        for(int i = 0; i < 100; ++i)
+        {
+            arena.allocate(100);
+        }
+        test(arena.capacity() > 256 + 10000 + 100 * 100);
+
+        arena.release();
+        test(arena.capacity() == 0);
+        arena.allocate(8);
+        test(arena.capacity() >= 256);
+    }
+    {
+        Test::StringSeq s;
+        s.push_back(toArena("a string allocated from the heap"));
+        Test::StringSeq t = s;
+        test(t == s);
+        s.clear();
+        test(t.size() == 1 && t[0] == toArena("a string allocated from the heap"));
+    }
+    cout << "ok" << endl;
+
+    cout << "testing unmarshaling into an arena... " << flush;
+    {
+        Test::ItemSeq items = makeItems(100);
+        Ice::OutputStream out(communicator.communicator());
+        out.write(items);
+
+        Ice::Arena arena;
+        Ice::InputStream in(communicator.communicator(), out.finished());
+        in.setArena(&arena);
+        test(in.getArena() == &arena);
+        Test::ItemSeq decoded;
+        in.read(decoded);
+        test(decoded == items);
+        size_t capacity = arena.capacity();
+        test(capacity > 0);
+
+        //
+        // The unmarshaled values are bound to the arena, the other values to the heap.
+        //
+        test(decoded.get_allocator() == Test::ItemSeq::allocator_type(&arena));
+        test(decoded[0].name.get_allocator().arena() == &arena);
+        test(decoded[0].attributes.get_allocator().arena() == &arena);
+        test(items.get_allocator() == Test::ItemSeq::allocator_type());
+        test(items.get_allocator().arena() == 0);
+
+        //
+        // Copies of the unmarshaled values and values unmarshaled without
+        // an arena are allocated from the heap.
+        //
+        Test::ItemSeq copy = decoded;
+        copy.push_back(decoded.back());
+        test(arena.capacity() == capacity);
+#ifdef ICE_CPP11_COMPILER
+        test(copy.get_allocator().arena() == 0);
+
+        Test::ItemSeq moved;
+        moved = move(decoded);
+        test(moved == items);
+        test(moved.get_allocator().arena() == 0);
+        test(moved[0].name.get_allocator().arena() == 0);
+        test(moved[0].tags[0].get_allocator().arena() == 0);
+        test(moved[0].attributes.begin()->second.get_allocator().arena() == 0);
+        test(arena.capacity() == capacity);
+#endif
+
+        Ice::InputStream in2(communicator.communicator(), out.finished());
+        Test::ItemSeq heapDecoded;
+        in2.read(heapDecoded);
+        test(heapDecoded == items);
+        test(arena.capacity() == capacity);
+
+        Test::ItemSeqDict d;
+        d[1] = items;
+        d[2] = Test::ItemSeq();
+        Ice::OutputStream out3(communicator.communicator());
+        out3.write(d);
+        Ice::InputStream in3(communicator.communicator(), out3.finished());
+        in3.setArena(&arena);
+        Test::ItemSeqDict decodedDict;
+        in3.read(decodedDict);
+        test(decodedDict == d);
+        test(arena.capacity() > capacity);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing arena-aware parameters... " << flush;
+    {
+        Test::ItemSeq items = makeItems(50);
+        test(intf->count(items) == 50 * 6);
+        test(intf->count(Test::ItemSeq()) == 0);
+        test(intf->echo(items) == items);
+        test(intf->echoAsync(items) == items);
+
+        Test::Wrapper w;
+        w.name = "wrapper";
+        w.items.assign(items.begin(), items.begin() + 10);
+        Test::ItemSeqDict d;
+        d[1] = items;
+        d[7] = Test::ItemSeq(items.begin(), items.begin() + 2);
+        test(intf->opWrapper(w, d) == "wrapper 10 1:300 7:12");
+
+        intf->keep(items);
+        intf->count(makeItems(50));
+        test(intf->kept() == items);
+
+        Test::StringSeq tags;
+        tags.push_back(toArena("a tag longer than a small string"));
+        Test::NodePtr n = ICE_MAKE_SHARED(Test::Node, "node", tags);
+        Test::NodePtr r = intf->opNode(n, tags);
+        test(r->name == "node" && r->tags == tags);
+    }
+    cout << "ok" << endl;
+
+    if(properties->getPropertyAsInt("Test.Benchmark") > 0)
+    {
+        cout << "measuring arena unmarshaling... " << flush;
+        const int count = 20000;
+        const int repetitions = 10;
+        Test::PlainItemSeq plainItems = makePlainItems(count);
+        Test::ItemSeq items = makeItems(count);
+
+        test(intf->sendPlain(plainItems) == count);
+        test(intf->sendArena(items) == count);
+
+        IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+        for(int i = 0; i < repetitions; ++i)
+        {
+            intf->sendPlain(plainItems);
+        }
+        IceUtil::Time plain = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+
+        start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+        for(int i = 0; i < repetitions; ++i)
+        {
+            intf->sendArena(items);
+        }
+        IceUtil::Time arena = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+        cout << "ok" << endl;
+
+        cout << "request with " << count << " items: " << plain.toMilliSecondsDouble() / repetitions << "ms, "
+             << arena.toMilliSecondsDouble() / repetitions << "ms with cpp:arena" << endl;
+    }
+
+    adapter->destroy();
+}
+
+DEFINE_TEST(Client)
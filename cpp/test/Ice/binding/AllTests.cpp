@@ -51,6 +51,26 @@ private:
 typedef IceUtil::Handle<GetAdapterNameCB> GetAdapterNameCBPtr;
 #endif
 
+class DelayedTestI : public Test::TestIntf
+{
+public:
+
+    DelayedTestI(int delay) : _delay(delay)
+    {
+    }
+
+    virtual string
+    getAdapterName(const Ice::Current& current)
+    {
+        IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(_delay));
+        return current.adapter->getName();
+    }
+
+private:
+
+    const int _delay;
+};
+
 string
 getAdapterNameWithAMI(const TestIntfPrxPtr& test)
 {
@@ -1028,6 +1048,152 @@ allTests(Test::TestHelper* helper)
         cout << "ok" << endl;
     }
 
+    cout << "testing latency endpoint selection... " << flush;
+    {
+        Ice::ObjectAdapterPtr slow = communicator->createObjectAdapterWithEndpoints("Slow", "default");
+        Ice::ObjectAdapterPtr fast = communicator->createObjectAdapterWithEndpoints("Fast", "default");
+        slow->add(ICE_MAKE_SHARED(DelayedTestI, 100), Ice::stringToIdentity("test"));
+        fast->add(ICE_MAKE_SHARED(DelayedTestI, 0), Ice::stringToIdentity("test"));
+        slow->activate();
+        fast->activate();
+
+        Ice::InitializationData initData;
+        initData.properties = communicator->getProperties()->clone();
+        initData.properties->setProperty("Ice.Default.EndpointSelection", "Latency");
+        Ice::CommunicatorHolder ich(initData);
+
+        Ice::ObjectPrxPtr slowPrx = ich->stringToProxy(
+            communicator->proxyToString(slow->createProxy(Ice::stringToIdentity("test"))));
+        Ice::ObjectPrxPtr fastPrx = ich->stringToProxy(
+            communicator->proxyToString(fast->createProxy(Ice::stringToIdentity("test"))));
+        Ice::EndpointSeq endpoints = slowPrx->ice_getEndpoints();
+        Ice::EndpointSeq edpts = fastPrx->ice_getEndpoints();
+        endpoints.insert(endpoints.end(), edpts.begin(), edpts.end());
+
+        TestIntfPrxPtr test = ICE_UNCHECKED_CAST(TestIntfPrx, slowPrx->ice_endpoints(endpoints));
+        test = test->ice_connectionCached(false);
+        test(test->ice_getEndpointSelection() == Ice::ICE_ENUM(EndpointSelectionType, Random));
+
+        //
+        // Establish a connection to each endpoint to sample its round-trip time.
+        //
+        test(ICE_UNCHECKED_CAST(TestIntfPrx, slowPrx)->getAdapterName() == "Slow");
+        test(ICE_UNCHECKED_CAST(TestIntfPrx, fastPrx)->getAdapterName() == "Fast");
+
+        for(int i = 0; i < 10; ++i)
+        {
+            test(test->getAdapterName() == "Fast");
+        }
+
+        Ice::PropertyDict props = ich->proxyToProperty(test, "Test");
+        test(props["Test.EndpointSelection"] == "Latency");
+        props = ich->proxyToProperty(test->ice_endpointSelection(Ice::ICE_ENUM(EndpointSelectionType, Random)), "Test");
+        test(props["Test.EndpointSelection"] == "Random");
+
+        fast->destroy();
+        test(test->getAdapterName() == "Slow");
+        slow->destroy();
+    }
+    cout << "ok" << endl;
+
+    cout << "testing parallel connection establishment... " << flush;
+    {
+        Ice::InitializationData initData;
+        initData.properties = communicator->getProperties()->clone();
+        initData.properties->setProperty("Ice.ParallelConnect", "1");
+        initData.properties->setProperty("Ice.ParallelConnect.Stagger", "10000");
+        Ice::CommunicatorHolder ich(initData);
+
+        vector<RemoteObjectAdapterPrxPtr> adapters;
+        adapters.push_back(com->createObjectAdapter("Adapter91", "default"));
+        adapters.push_back(com->createObjectAdapter("Adapter92", "default"));
+        adapters.push_back(com->createObjectAdapter("Adapter93", "default"));
+
+        TestIntfPrxPtr test = createTestIntfPrx(adapters);
+        test = ICE_UNCHECKED_CAST(TestIntfPrx, ich->stringToProxy(communicator->proxyToString(test)));
+        test = ICE_UNCHECKED_CAST(TestIntfPrx, test->ice_endpointSelection(Ice::ICE_ENUM(EndpointSelectionType, Ordered)));
+
+        //
+        // The first endpoint accepts the connection before the stagger delay expires,
+        // no other attempts are made.
+        //
+        test(test->getAdapterName() == "Adapter91");
+        test->ice_getConnection()->close(Ice::ICE_SCOPED_ENUM(ConnectionClose, GracefullyWithWait));
+
+        //
+        // A failed attempt starts the next one without waiting for the stagger delay.
+        //
+        com->deactivateObjectAdapter(adapters[0]);
+        com->deactivateObjectAdapter(adapters[1]);
+        IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+        test(test->getAdapterName() == "Adapter93");
+        test(IceUtil::Time::now(IceUtil::Time::Monotonic) - start < IceUtil::Time::seconds(5));
+        test->ice_getConnection()->close(Ice::ICE_SCOPED_ENUM(ConnectionClose, GracefullyWithWait));
+
+        com->deactivateObjectAdapter(adapters[2]);
+        try
+        {
+            test->ice_connectionId("failed")->ice_ping();
+            test(false);
+        }
+        catch(const Ice::ConnectFailedException&)
+        {
+        }
+        catch(const Ice::ConnectTimeoutException&)
+        {
+        }
+
+        //
+        // Without stagger delay, all the attempts are started right away and a single
+        // connection is used.
+        //
+        initData.properties->setProperty("Ice.ParallelConnect.Stagger", "0");
+        Ice::CommunicatorHolder ich2(initData);
+
+        adapters.clear();
+        adapters.push_back(com->createObjectAdapter("Adapter94", "default"));
+        adapters.push_back(com->createObjectAdapter("Adapter95", "default"));
+        adapters.push_back(com->createObjectAdapter("Adapter96", "default"));
+
+        test = createTestIntfPrx(adapters);
+        test = ICE_UNCHECKED_CAST(TestIntfPrx, ich2->stringToProxy(communicator->proxyToString(test)));
+        for(int i = 0; i < 5; ++i)
+        {
+            ostringstream os;
+            os << i;
+            TestIntfPrxPtr prx = test->ice_connectionId(os.str());
+            string name = prx->getAdapterName();
+            test(name == "Adapter94" || name == "Adapter95" || name == "Adapter96");
+            test(prx->getAdapterName() == name);
+            prx->ice_getConnection()->close(Ice::ICE_SCOPED_ENUM(ConnectionClose, GracefullyWithWait));
+        }
+
+        //
+        // An unresponsive endpoint only delays the connection establishment by the
+        // stagger delay. The connections to an object adapter which isn't activated
+        // are accepted by the kernel but never validated.
+        //
+        initData.properties->setProperty("Ice.ParallelConnect.Stagger", "200");
+        Ice::CommunicatorHolder ich3(initData);
+
+        Ice::ObjectAdapterPtr unresponsive = communicator->createObjectAdapterWithEndpoints("Unresponsive", "default");
+        Ice::EndpointSeq endpoints = unresponsive->getEndpoints();
+        Ice::EndpointSeq edpts = adapters[0]->getTestIntf()->ice_getEndpoints();
+        endpoints.insert(endpoints.end(), edpts.begin(), edpts.end());
+
+        test = ICE_UNCHECKED_CAST(TestIntfPrx, adapters[0]->getTestIntf()->ice_endpoints(endpoints));
+        test = ICE_UNCHECKED_CAST(TestIntfPrx, ich3->stringToProxy(communicator->proxyToString(test)));
+        test = ICE_UNCHECKED_CAST(TestIntfPrx, test->ice_endpointSelection(Ice::ICE_ENUM(EndpointSelectionType, Ordered)));
+        start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+        test(test->getAdapterName() == "Adapter94");
+        IceUtil::Time elapsed = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+        test(elapsed >= IceUtil::Time::milliSeconds(150) && elapsed < IceUtil::Time::seconds(2));
+        unresponsive->destroy();
+
+        deactivate(com, adapters);
+    }
+    cout << "ok" << endl;
+
     //
     // On Windows, the FD limit is very high and there's no way to limit the number of FDs
     // for the server so we don't run this test.
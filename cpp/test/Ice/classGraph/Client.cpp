@@ -0,0 +1,202 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <Ice/Ice.h>
+#include <Ice/HashMap.h>
+#include <TestHelper.h>
+#include <Test.h>
+
+using namespace std;
+
+namespace
+{
+
+//
+// Builds a graph of count nodes where every node also refers to an earlier
+// node, so that most class references are marshaled as indexes.
+//
+Test::NodeSeq
+createGraph(int count)
+{
+    Test::NodeSeq nodes;
+    nodes.reserve(static_cast<size_t>(count));
+    for(int i = 0; i < count; ++i)
+    {
+        Test::NodePtr node;
+        if(i % 2)
+        {
+            ostringstream os;
+            os << "node" << i;
+            node = ICE_MAKE_SHARED(Test::NamedNode, i, ICE_NULLPTR, os.str());
+        }
+        else
+        {
+            node = ICE_MAKE_SHARED(Test::Node, i, ICE_NULLPTR);
+        }
+        if(i > 0)
+        {
+            node->other = nodes[static_cast<size_t>((i * 7919) % i)];
+        }
+        nodes.push_back(node);
+    }
+    return nodes;
+}
+
+void
+checkGraph(const Test::NodeSeq& nodes, int count)
+{
+    test(nodes.size() == static_cast<size_t>(count));
+    for(int i = 0; i < count; ++i)
+    {
+        const Test::NodePtr& node = nodes[static_cast<size_t>(i)];
+        test(node->value == i);
+        if(i % 2)
+        {
+            Test::NamedNodePtr named = ICE_DYNAMIC_CAST(Test::NamedNode, node);
+            test(named);
+            ostringstream os;
+            os << "node" << i;
+            test(named->name == os.str());
+        }
+        if(i > 0)
+        {
+            test(node->other == nodes[static_cast<size_t>((i * 7919) % i)]);
+        }
+        else
+        {
+            test(!node->other);
+        }
+    }
+}
+
+void
+marshal(const Ice::CommunicatorPtr& communicator, const Ice::EncodingVersion& encoding, const Test::NodeSeq& nodes,
+        vector<Ice::Byte>& data)
+{
+    Ice::OutputStream out(communicator, encoding);
+    out.startEncapsulation();
+    out.write(nodes);
+    out.writePendingValues();
+    out.endEncapsulation();
+    out.finished(data);
+}
+
+void
+unmarshal(const Ice::CommunicatorPtr& communicator, const Ice::EncodingVersion& encoding,
+          const vector<Ice::Byte>& data, Test::NodeSeq& nodes)
+{
+    Ice::InputStream in(communicator, encoding, data);
+    in.startEncapsulation();
+    in.read(nodes);
+    in.readPendingValues();
+    in.endEncapsulation();
+}
+
+}
+
+class Client : public Test::TestHelper
+{
+public:
+
+    void run(int, char**);
+};
+
+void
+Client::run(int argc, char** argv)
+{
+    Ice::CommunicatorHolder communicator = initialize(argc, argv);
+
+    cout << "testing hash map... " << flush;
+    {
+        typedef IceInternal::HashMap<Ice::Int, Ice::Int, IceInternal::HashMapIntHash> IntMap;
+        IntMap table;
+        map<Ice::Int, Ice::Int> reference;
+        for(int i = 0; i < 20000; ++i)
+        {
+            //
+            // Multiples of 64 collide in the small tables and exercise the
+            // probe sequences.
+            //
+            Ice::Int key = (i * 2654435761U) % 1000 * ((i % 3) ? 1 : 64);
+            IntMap::iterator p = table.find(key);
+            map<Ice::Int, Ice::Int>::iterator q = reference.find(key);
+            test((p == table.end()) == (q == reference.end()));
+            if(p == table.end())
+            {
+                test(table.insert(make_pair(key, i)).second);
+                reference.insert(make_pair(key, i));
+            }
+            else
+            {
+                test(p->second == q->second);
+                test(!table.insert(make_pair(key, i)).second);
+                if(i % 2)
+                {
+                    table.erase(p);
+                    reference.erase(q);
+                }
+            }
+            test(table.size() == reference.size());
+        }
+
+        size_t count = 0;
+        for(IntMap::const_iterator p = table.begin(); p != table.end(); ++p)
+        {
+            test(reference[p->first] == p->second);
+            ++count;
+        }
+        test(count == reference.size());
+
+        table.clear();
+        test(table.empty() && table.begin() == table.end());
+        table[5] = 10;
+        test(table.find(5)->second == 10 && table.size() == 1);
+    }
+    cout << "ok" << endl;
+
+    const int count = 100000;
+    Test::NodeSeq nodes = createGraph(count);
+
+    cout << "testing class graph marshaling... " << flush;
+    {
+        vector<Ice::Byte> data;
+        Test::NodeSeq result;
+
+        marshal(communicator.communicator(), Ice::Encoding_1_1, nodes, data);
+        unmarshal(communicator.communicator(), Ice::Encoding_1_1, data, result);
+        checkGraph(result, count);
+
+        marshal(communicator.communicator(), Ice::Encoding_1_0, nodes, data);
+        unmarshal(communicator.communicator(), Ice::Encoding_1_0, data, result);
+        checkGraph(result, count);
+    }
+    cout << "ok" << endl;
+
+    cout << "measuring class graph marshaling... " << flush;
+    {
+        const int repetitions = 5;
+        vector<Ice::Byte> data;
+        Test::NodeSeq result;
+        IceUtil::Time marshaling;
+        IceUtil::Time unmarshaling;
+        for(int i = 0; i < repetitions; ++i)
+        {
+            IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+            marshal(communicator.communicator(), Ice::Encoding_1_1, nodes, data);
+            marshaling += IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+
+            start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+            unmarshal(communicator.communicator(), Ice::Encoding_1_1, data, result);
+            unmarshaling += IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+        }
+        checkGraph(result, count);
+        cout << "ok" << endl;
+
+        cout << count << " nodes marshaled in " << marshaling.toMilliSecondsDouble() / repetitions << "ms" << endl;
+        cout << count << " nodes unmarshaled in " << unmarshaling.toMilliSecondsDouble() / repetitions << "ms"
+             << endl;
+    }
+}
+
+DEFINE_TEST(Client)
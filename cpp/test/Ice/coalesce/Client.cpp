@@ -0,0 +1,150 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <Ice/Ice.h>
+#include <TestHelper.h>
+
+using namespace std;
+
+namespace
+{
+
+class ServantI : public Ice::Object
+{
+};
+
+//
+// Sends a burst of pings and returns the time at which the first response
+// and the last response were received.
+//
+void
+pingBurst(const Ice::ObjectPrxPtr& prx, int count, IceUtil::Time& first, IceUtil::Time& last)
+{
+    IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+#ifdef ICE_CPP11_MAPPING
+    vector<future<void>> results;
+    for(int i = 0; i < count; ++i)
+    {
+        results.push_back(prx->ice_pingAsync());
+    }
+    for(vector<future<void>>::iterator p = results.begin(); p != results.end(); ++p)
+    {
+        p->get();
+        if(p == results.begin())
+        {
+            first = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+        }
+    }
+#else
+    vector<Ice::AsyncResultPtr> results;
+    for(int i = 0; i < count; ++i)
+    {
+        results.push_back(prx->begin_ice_ping());
+    }
+    for(vector<Ice::AsyncResultPtr>::const_iterator p = results.begin(); p != results.end(); ++p)
+    {
+        prx->end_ice_ping(*p);
+        if(p == results.begin())
+        {
+            first = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+        }
+    }
+#endif
+    last = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+}
+
+}
+
+class Client : public Test::TestHelper
+{
+public:
+
+    void run(int, char**);
+};
+
+void
+Client::run(int argc, char** argv)
+{
+    Ice::PropertiesPtr properties = createTestProperties(argc, argv);
+    properties->setProperty("TestAdapter.Endpoints", getTestEndpoint(properties, 0));
+    properties->setProperty("CoalesceAdapter.Endpoints", getTestEndpoint(properties, 1));
+    properties->setProperty("CoalesceAdapter.Coalesce.Window", "100000");
+    properties->setProperty("SizeAdapter.Endpoints", getTestEndpoint(properties, 2));
+    properties->setProperty("SizeAdapter.Coalesce.Window", "100000");
+    properties->setProperty("SizeAdapter.Coalesce.Size", "1");
+    Ice::CommunicatorHolder communicator = initialize(argc, argv, properties);
+
+    Ice::ObjectAdapterPtr adapter = communicator->createObjectAdapter("TestAdapter");
+    Ice::ObjectAdapterPtr coalesceAdapter = communicator->createObjectAdapter("CoalesceAdapter");
+    Ice::ObjectAdapterPtr sizeAdapter = communicator->createObjectAdapter("SizeAdapter");
+    adapter->add(ICE_MAKE_SHARED(ServantI), Ice::stringToIdentity("test"));
+    coalesceAdapter->add(ICE_MAKE_SHARED(ServantI), Ice::stringToIdentity("test"));
+    sizeAdapter->add(ICE_MAKE_SHARED(ServantI), Ice::stringToIdentity("test"));
+    adapter->activate();
+    coalesceAdapter->activate();
+    sizeAdapter->activate();
+
+    Ice::ObjectPrxPtr prx = adapter->createProxy(Ice::stringToIdentity("test"))->ice_collocationOptimized(false);
+    Ice::ObjectPrxPtr coalescePrx =
+        coalesceAdapter->createProxy(Ice::stringToIdentity("test"))->ice_collocationOptimized(false);
+    Ice::ObjectPrxPtr sizePrx = sizeAdapter->createProxy(Ice::stringToIdentity("test"))->ice_collocationOptimized(false);
+
+    //
+    // The sockets are only corked on platforms with TCP_CORK, elsewhere the
+    // responses are sent right away and only the pings are checked.
+    //
+#ifdef __linux__
+    const string protocol = getTestProtocol(properties);
+    const bool corked = protocol != "bt" && protocol != "bts";
+#else
+    const bool corked = false;
+#endif
+
+    cout << "testing response coalescing... " << flush;
+    {
+        prx->ice_getConnection();
+        coalescePrx->ice_getConnection();
+        sizePrx->ice_getConnection();
+
+        //
+        // Without a coalescing window, the responses are sent right away.
+        //
+        IceUtil::Time first;
+        IceUtil::Time last;
+        pingBurst(prx, 20, first, last);
+        test(first < IceUtil::Time::milliSeconds(50));
+
+        //
+        // The first response opens the window, the responses sent within the
+        // window are held in the socket and received together once it expires.
+        //
+        pingBurst(coalescePrx, 20, first, last);
+        if(corked)
+        {
+            test(first >= IceUtil::Time::milliSeconds(100));
+            test(last - first < IceUtil::Time::milliSeconds(50));
+        }
+
+        //
+        // The window is closed as soon as the coalescing size is reached, the
+        // responses aren't held until the window expires.
+        //
+        IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+        for(int i = 0; i < 10; ++i)
+        {
+            sizePrx->ice_ping();
+        }
+        if(corked)
+        {
+            test(IceUtil::Time::now(IceUtil::Time::Monotonic) - start < IceUtil::Time::milliSeconds(500));
+        }
+    }
+    cout << "ok" << endl;
+
+    adapter->destroy();
+    coalesceAdapter->destroy();
+    sizeAdapter->destroy();
+}
+
+DEFINE_TEST(Client)
@@ -0,0 +1,325 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <Ice/Ice.h>
+#include <TestHelper.h>
+#include <Test.h>
+
+using namespace std;
+
+namespace
+{
+
+const string pointSchema = "struct{int, int}";
+const string itemSchema = "struct{string, long, enum(2), seq<" + pointSchema + ">, dict<string, int>, proxy}";
+const string paramsSchema = "int, seq<" + itemSchema + ">, ?1:string, ?2:int, ?3:" + itemSchema + ", ?4:seq<" +
+    pointSchema + ">";
+
+class TraceVisitor : public Ice::DecodingVisitor
+{
+public:
+
+    virtual void visitInt(Ice::Int v)
+    {
+        os << v << ' ';
+    }
+
+    virtual void visitLong(Ice::Long v)
+    {
+        os << v << "L ";
+    }
+
+    virtual void visitString(const string& v)
+    {
+        os << '"' << v << "\" ";
+    }
+
+    virtual void visitEnum(Ice::Int v)
+    {
+        os << 'e' << v << ' ';
+    }
+
+    virtual void visitProxy(const Ice::ObjectPrxPtr& v)
+    {
+        os << (v ? v->ice_getIdentity().name : string("nil")) << ' ';
+    }
+
+    virtual void startStruct()
+    {
+        os << "{ ";
+    }
+
+    virtual void endStruct()
+    {
+        os << "} ";
+    }
+
+    virtual void startSequence(Ice::Int sz)
+    {
+        os << '[' << sz << ' ';
+    }
+
+    virtual void endSequence()
+    {
+        os << "] ";
+    }
+
+    virtual void startDictionary(Ice::Int sz)
+    {
+        os << '<' << sz << ' ';
+    }
+
+    virtual void endDictionary()
+    {
+        os << "> ";
+    }
+
+    virtual void visitOptional(Ice::Int tag, bool present)
+    {
+        os << '?' << tag << (present ? " " : "- ");
+    }
+
+    ostringstream os;
+};
+
+Test::ItemSeq
+makeItems(const Ice::CommunicatorPtr& communicator, int count)
+{
+    Test::ItemSeq items;
+    for(int i = 0; i < count; ++i)
+    {
+        Test::Item item;
+        ostringstream os;
+        os << "item " << i;
+        item.name = os.str();
+        item.id = i;
+        item.color = i % 2 ? Test::ICE_ENUM(Color, blue) : Test::ICE_ENUM(Color, green);
+        for(int j = 0; j < 4; ++j)
+        {
+            Test::Point p;
+            p.x = i;
+            p.y = j;
+            item.points.push_back(p);
+        }
+        item.attributes["index"] = i;
+        ostringstream target;
+        target << "item" << i << ":tcp -h localhost -p 10000";
+        item.target = communicator->stringToProxy(target.str());
+        items.push_back(item);
+    }
+    return items;
+}
+
+template<typename T> vector<Ice::Byte>
+encode(const Ice::CommunicatorPtr& communicator, const T& v)
+{
+    Ice::OutputStream out(communicator);
+    out.write(v);
+    vector<Ice::Byte> bytes;
+    out.finished(bytes);
+    return bytes;
+}
+
+bool
+extractEquals(const Ice::CommunicatorPtr& communicator, const Ice::DecodingProgram& program,
+              const vector<Ice::Byte>& data, size_t field, const vector<Ice::Byte>& expected)
+{
+    Ice::InputStream in(communicator, data);
+    in.startEncapsulation();
+    pair<const Ice::Byte*, const Ice::Byte*> bytes = program.extract(&in, field);
+    return vector<Ice::Byte>(bytes.first, bytes.second) == expected;
+}
+
+}
+
+class Client : public Test::TestHelper
+{
+public:
+
+    void run(int, char**);
+};
+
+void
+Client::run(int argc, char** argv)
+{
+    Ice::CommunicatorHolder ich = initialize(argc, argv);
+    Ice::CommunicatorPtr communicator = ich.communicator();
+
+    cout << "testing type descriptions... " << flush;
+    {
+        test(Ice::DecodingProgram("").fieldCount() == 0);
+        test(Ice::DecodingProgram(" int ").fieldCount() == 1);
+        test(Ice::DecodingProgram(itemSchema).fieldCount() == 1);
+        test(Ice::DecodingProgram(paramsSchema).fieldCount() == 6);
+        test(Ice::DecodingProgram("dict<string, seq<seq<" + itemSchema + ">>>, ?5:proxy").fieldCount() == 2);
+
+        const char* invalid[] =
+        {
+            "foo", "int,", ",int", "seq<int", "seq<>", "dict<int>", "struct{}", "struct{int", "enum", "enum(a)",
+            "?1:int, int", "?2:int, ?1:int", "?1 int", "int int"
+        };
+        for(size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i)
+        {
+            try
+            {
+                Ice::DecodingProgram program(invalid[i]);
+                test(false);
+            }
+            catch(const IceUtil::IllegalArgumentException&)
+            {
+            }
+        }
+    }
+    cout << "ok" << endl;
+
+    Test::ItemSeq items = makeItems(communicator, 2);
+    items[1].points.clear();
+    items[1].attributes.clear();
+    items[1].target = ICE_NULLPTR;
+
+    Test::PointSeq points;
+    Test::Point point;
+    point.x = 9;
+    point.y = 8;
+    points.push_back(point);
+
+    vector<Ice::Byte> data;
+    {
+        Ice::OutputStream out(communicator);
+        out.startEncapsulation();
+        out.write(7);
+        out.write(items);
+        out.write(1, IceUtil::Optional<string>("optional"));
+        out.write(3, IceUtil::Optional<Test::Item>(items[0]));
+        out.write(4, IceUtil::Optional<Test::PointSeq>(points));
+        out.endEncapsulation();
+        out.finished(data);
+    }
+    Ice::DecodingProgram program(paramsSchema);
+
+    cout << "testing decoding... " << flush;
+    {
+        const string item0 = "{ \"item 0\" 0L e1 [4 { 0 0 } { 0 1 } { 0 2 } { 0 3 } ] <1 \"index\" 0 > item0 } ";
+        const string item1 = "{ \"item 1\" 1L e2 [0 ] <0 > nil } ";
+
+        Ice::InputStream in(communicator, data);
+        in.startEncapsulation();
+        TraceVisitor visitor;
+        program.decode(&in, visitor);
+        in.endEncapsulation();
+        test(visitor.os.str() == "7 [2 " + item0 + item1 + "] ?1 \"optional\" ?2- ?3 " + item0 + "?4 [1 { 9 8 } ] ");
+
+        //
+        // Optional fields that are not known to the description are skipped
+        // with the encapsulation.
+        //
+        Ice::InputStream in2(communicator, data);
+        in2.startEncapsulation();
+        TraceVisitor visitor2;
+        Ice::DecodingProgram("int, seq<" + itemSchema + ">, ?2:int").decode(&in2, visitor2);
+        in2.endEncapsulation();
+        test(visitor2.os.str() == "7 [2 " + item0 + item1 + "] ?2- ");
+    }
+    cout << "ok" << endl;
+
+    cout << "testing skipping and extracting fields... " << flush;
+    {
+        Ice::InputStream in(communicator, data);
+        in.startEncapsulation();
+        program.skip(&in);
+        in.endEncapsulation();
+
+        test(extractEquals(communicator, program, data, 0, encode(communicator, 7)));
+        test(extractEquals(communicator, program, data, 1, encode(communicator, items)));
+        test(extractEquals(communicator, program, data, 2, encode(communicator, string("optional"))));
+        test(extractEquals(communicator, program, data, 3, vector<Ice::Byte>()));
+        test(extractEquals(communicator, program, data, 4, encode(communicator, items[0])));
+
+        vector<Ice::Byte> pointsData = encode(communicator, points);
+        test(extractEquals(communicator, program, data, 5, pointsData));
+
+        //
+        // The extracted bytes are decoded by a program for the field.
+        //
+        Ice::InputStream in2(communicator, data);
+        in2.startEncapsulation();
+        pair<const Ice::Byte*, const Ice::Byte*> bytes = program.extract(&in2, 1);
+        Ice::InputStream in3(communicator, bytes);
+        Ice::DecodingProgram("seq<" + itemSchema + ">").skip(&in3);
+        test(in3.i == in3.b.end());
+
+        try
+        {
+            Ice::InputStream in4(communicator, data);
+            in4.startEncapsulation();
+            program.extract(&in4, 6);
+            test(false);
+        }
+        catch(const IceUtil::IllegalArgumentException&)
+        {
+        }
+
+        //
+        // A description that doesn't match the encoding fails like the
+        // generated code.
+        //
+        try
+        {
+            vector<Ice::Byte> intData = encode(communicator, 1000);
+            Ice::InputStream in4(communicator, intData);
+            Ice::DecodingProgram("seq<long>").skip(&in4);
+            test(false);
+        }
+        catch(const Ice::UnmarshalOutOfBoundsException&)
+        {
+        }
+    }
+    cout << "ok" << endl;
+
+    if(communicator->getProperties()->getPropertyAsInt("Test.Benchmark") > 0)
+    {
+        cout << "measuring decoding programs... " << flush;
+        const int repetitions = 20;
+        Test::ItemSeq manyItems = makeItems(communicator, 10000);
+        Ice::OutputStream out(communicator);
+        out.write(manyItems);
+        vector<Ice::Byte> manyData;
+        out.finished(manyData);
+        Ice::DecodingProgram itemsProgram("seq<" + itemSchema + ">");
+
+        IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+        for(int i = 0; i < repetitions; ++i)
+        {
+            Ice::InputStream in(communicator, manyData);
+            Test::ItemSeq decoded;
+            in.read(decoded);
+        }
+        IceUtil::Time generated = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+
+        start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+        for(int i = 0; i < repetitions; ++i)
+        {
+            Ice::InputStream in(communicator, manyData);
+            Ice::DecodingVisitor visitor;
+            itemsProgram.decode(&in, visitor);
+        }
+        IceUtil::Time decoded = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+
+        start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+        for(int i = 0; i < repetitions; ++i)
+        {
+            Ice::InputStream in(communicator, manyData);
+            itemsProgram.skip(&in);
+            test(in.i == in.b.end());
+        }
+        IceUtil::Time skipped = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+        cout << "ok" << endl;
+
+        cout << "10000 items: " << generated.toMilliSecondsDouble() / repetitions << "ms generated code, "
+             << decoded.toMilliSecondsDouble() / repetitions << "ms decode, "
+             << skipped.toMilliSecondsDouble() / repetitions << "ms skip" << endl;
+    }
+}
+
+DEFINE_TEST(Client)
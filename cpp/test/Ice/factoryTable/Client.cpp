@@ -0,0 +1,219 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <Ice/Ice.h>
+#include <TestHelper.h>
+#include <Test.h>
+
+using namespace std;
+
+namespace
+{
+
+Ice::ValuePtr
+createValue(const string& typeId)
+{
+    ICE_DELEGATE(Ice::ValueFactory) factory = IceInternal::factoryTable->getValueFactory(typeId);
+    test(factory);
+#ifdef ICE_CPP11_MAPPING
+    return factory(typeId);
+#else
+    return factory->create(typeId);
+#endif
+}
+
+template<typename E> void
+testException(const string& typeId)
+{
+    ICE_DELEGATE(Ice::UserExceptionFactory) factory = IceInternal::factoryTable->getExceptionFactory(typeId);
+    test(factory);
+    try
+    {
+#ifdef ICE_CPP11_MAPPING
+        factory(typeId);
+#else
+        factory->createAndThrow(typeId);
+#endif
+        test(false);
+    }
+    catch(const E& ex)
+    {
+        test(ex.ice_id() == typeId);
+    }
+}
+
+}
+
+class Client : public Test::TestHelper
+{
+public:
+
+    void run(int, char**);
+};
+
+void
+Client::run(int argc, char** argv)
+{
+    Ice::CommunicatorHolder communicator = initialize(argc, argv);
+
+    cout << "testing generated factory tables... " << flush;
+    {
+        test(ICE_DYNAMIC_CAST(Test::Base, createValue("::Test::Base")));
+        test(ICE_DYNAMIC_CAST(Test::Derived, createValue("::Test::Derived")));
+        test(ICE_DYNAMIC_CAST(Test::Compact, createValue("::Test::Compact")));
+        test(ICE_DYNAMIC_CAST(Test::Sub::Nested, createValue("::Test::Sub::Nested")));
+
+        testException<Test::BaseException>("::Test::BaseException");
+        testException<Test::DerivedException>("::Test::DerivedException");
+        testException<Test::Sub::NestedException>("::Test::Sub::NestedException");
+
+        //
+        // Value and exception factories are looked up separately.
+        //
+        test(!IceInternal::factoryTable->getValueFactory("::Test::BaseException"));
+        test(!IceInternal::factoryTable->getExceptionFactory("::Test::Base"));
+        test(!IceInternal::factoryTable->getValueFactory("::Test::Unknown"));
+        test(!IceInternal::factoryTable->getValueFactory(""));
+
+        test(IceInternal::factoryTable->getTypeId(42) == "::Test::Compact");
+        test(IceInternal::factoryTable->getTypeId(43).empty());
+
+#ifndef ICE_CPP11_MAPPING
+        //
+        // The factories are created once.
+        //
+        test(IceInternal::factoryTable->getValueFactory("::Test::Base") ==
+             IceInternal::factoryTable->getValueFactory("::Test::Base"));
+#endif
+
+        //
+        // The values are unmarshaled with the factories of the table.
+        //
+        Test::DerivedPtr d = ICE_MAKE_SHARED(Test::Derived, "derived", 5);
+        Ice::OutputStream out(communicator.communicator());
+        out.write(d);
+        out.writePendingValues();
+        Ice::InputStream in(communicator.communicator(), out.finished());
+        Test::DerivedPtr d2;
+        in.read(d2);
+        in.readPendingValues();
+        test(d2 && d2->name == "derived" && d2->value == 5);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing factory table registration... " << flush;
+    {
+        const IceInternal::FactoryTableEntry factories[] =
+        {
+            { "::Test::Added", IceInternal::defaultValueFactory<Test::Base>, 0 },
+            { "::Test::Base", IceInternal::defaultValueFactory<Test::Base>, 0 },
+            { "::Test::ZAdded", 0, IceInternal::defaultUserExceptionFactory<Test::BaseException> }
+        };
+        const IceInternal::CompactIdTableEntry compactIds[] =
+        {
+            { 7, "::Test::Added" },
+            { 42, "::Test::Compact" }
+        };
+
+#ifndef ICE_CPP11_MAPPING
+        Ice::ValueFactoryPtr baseFactory = IceInternal::factoryTable->getValueFactory("::Test::Base");
+#endif
+        {
+            IceInternal::FactoryTableRegistration registration(factories, 3, compactIds, 2);
+            test(IceInternal::factoryTable->getValueFactory("::Test::Added"));
+            test(IceInternal::factoryTable->getExceptionFactory("::Test::ZAdded"));
+            test(IceInternal::factoryTable->getTypeId(7) == "::Test::Added");
+            test(IceInternal::factoryTable->getTypeId(42) == "::Test::Compact");
+            test(IceInternal::factoryTable->getValueFactory("::Test::Derived"));
+        }
+
+        //
+        // Removing a table doesn't remove the entries registered by other tables.
+        //
+        test(!IceInternal::factoryTable->getValueFactory("::Test::Added"));
+        test(!IceInternal::factoryTable->getExceptionFactory("::Test::ZAdded"));
+        test(IceInternal::factoryTable->getTypeId(7).empty());
+        test(IceInternal::factoryTable->getTypeId(42) == "::Test::Compact");
+        test(IceInternal::factoryTable->getValueFactory("::Test::Base"));
+        test(ICE_DYNAMIC_CAST(Test::Base, createValue("::Test::Base")));
+#ifndef ICE_CPP11_MAPPING
+        test(IceInternal::factoryTable->getValueFactory("::Test::Base") == baseFactory);
+#endif
+
+        //
+        // A table removed before its first use is never merged.
+        //
+        {
+            IceInternal::FactoryTableRegistration registration(factories, 3, compactIds, 2);
+        }
+        test(!IceInternal::factoryTable->getValueFactory("::Test::Added"));
+        test(IceInternal::factoryTable->getValueFactory("::Test::Base"));
+    }
+    cout << "ok" << endl;
+
+    if(communicator->getProperties()->getPropertyAsInt("Test.Benchmark") > 0)
+    {
+        cout << "measuring factory registration... " << flush;
+        const int count = 4000;
+        vector<string> typeIds;
+        for(int i = 0; i < count; ++i)
+        {
+            ostringstream os;
+            os << "::Test::Generated" << i;
+            typeIds.push_back(os.str());
+        }
+        vector<string> sortedTypeIds = typeIds;
+        sort(sortedTypeIds.begin(), sortedTypeIds.end());
+        vector<IceInternal::FactoryTableEntry> factories;
+        for(vector<string>::const_iterator p = sortedTypeIds.begin(); p != sortedTypeIds.end(); ++p)
+        {
+            IceInternal::FactoryTableEntry entry = { p->c_str(), IceInternal::defaultValueFactory<Test::Base>, 0 };
+            factories.push_back(entry);
+        }
+
+        //
+        // One factory registered per type, as done by the code generated by
+        // previous versions of slice2cpp.
+        //
+        IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+        for(vector<string>::const_iterator p = typeIds.begin(); p != typeIds.end(); ++p)
+        {
+#ifdef ICE_CPP11_MAPPING
+            IceInternal::factoryTable->addValueFactory(*p, IceInternal::defaultValueFactory<Test::Base>);
+#else
+            IceInternal::factoryTable->addValueFactory(*p, new IceInternal::DefaultValueFactory<Test::Base>(*p));
+#endif
+        }
+        IceUtil::Time perType = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+        test(IceInternal::factoryTable->getValueFactory(typeIds.back()));
+        for(vector<string>::const_iterator p = typeIds.begin(); p != typeIds.end(); ++p)
+        {
+            IceInternal::factoryTable->removeValueFactory(*p);
+        }
+        test(!IceInternal::factoryTable->getValueFactory(typeIds.back()));
+
+        //
+        // One table registered, and merged on first use.
+        //
+        IceUtil::Time perTable;
+        IceUtil::Time firstUse;
+        {
+            start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+            IceInternal::FactoryTableRegistration registration(&factories[0], factories.size(), 0, 0);
+            perTable = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+
+            start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+            test(IceInternal::factoryTable->getValueFactory(typeIds.back()));
+            firstUse = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+        }
+        test(!IceInternal::factoryTable->getValueFactory(typeIds.back()));
+        cout << "ok" << endl;
+
+        cout << "registering " << count << " types: " << perType.toMilliSecondsDouble()
+             << "ms with one registration per type, " << perTable.toMilliSecondsDouble()
+             << "ms with one table (" << firstUse.toMilliSecondsDouble() << "ms on first use)" << endl;
+    }
+}
+
+DEFINE_TEST(Client)
@@ -0,0 +1,368 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <Ice/Ice.h>
+#include <IceUtil/Thread.h>
+#include <TestHelper.h>
+
+using namespace std;
+
+namespace
+{
+
+class BlobjectI : public Ice::Blobject
+{
+public:
+
+#ifdef ICE_CPP11_MAPPING
+    virtual bool ice_invoke(vector<Ice::Byte>, vector<Ice::Byte>&, const Ice::Current&)
+#else
+    virtual bool ice_invoke(const vector<Ice::Byte>&, vector<Ice::Byte>&, const Ice::Current&)
+#endif
+    {
+        return true;
+    }
+};
+
+class Callback : public IceUtil::Shared, public IceUtil::Monitor<IceUtil::Mutex>
+{
+public:
+
+    Callback() : _sent(0), _failed(0)
+    {
+    }
+
+    void response(bool, const vector<Ice::Byte>&)
+    {
+    }
+
+    void exception(const Ice::Exception& ex)
+    {
+        test(dynamic_cast<const Ice::InvocationTimeoutException*>(&ex));
+        Lock sync(*this);
+        ++_failed;
+        notifyAll();
+    }
+
+    void sent(bool)
+    {
+        Lock sync(*this);
+        ++_sent;
+        notifyAll();
+    }
+
+    int sent()
+    {
+        Lock sync(*this);
+        return _sent;
+    }
+
+    int failed()
+    {
+        Lock sync(*this);
+        return _failed;
+    }
+
+    void waitForCompleted(int count)
+    {
+        Lock sync(*this);
+        while(_sent + _failed < count)
+        {
+            wait();
+        }
+    }
+
+private:
+
+    int _sent;
+    int _failed;
+};
+ICE_DEFINE_PTR(CallbackPtr, Callback);
+
+void
+invokeAsync(const Ice::ObjectPrxPtr& prx, const vector<Ice::Byte>& inEncaps, const CallbackPtr& cb)
+{
+#ifdef ICE_CPP11_MAPPING
+    prx->ice_invokeAsync("send", Ice::OperationMode::Normal, inEncaps,
+        [cb](bool ok, const vector<Ice::Byte>& outEncaps)
+        {
+            cb->response(ok, outEncaps);
+        },
+        [cb](exception_ptr e)
+        {
+            try
+            {
+                rethrow_exception(e);
+            }
+            catch(const Ice::Exception& ex)
+            {
+                cb->exception(ex);
+            }
+        },
+        [cb](bool sentSynchronously)
+        {
+            cb->sent(sentSynchronously);
+        });
+#else
+    prx->begin_ice_invoke("send", Ice::Normal, inEncaps,
+                          Ice::newCallback_Object_ice_invoke(cb, &Callback::response, &Callback::exception,
+                                                             &Callback::sent));
+#endif
+}
+
+class ProducerThread : public IceUtil::Thread, public IceUtil::Monitor<IceUtil::Mutex>
+{
+public:
+
+    ProducerThread(const Ice::ObjectPrxPtr& prx, const vector<Ice::Byte>& inEncaps, int count) :
+        _prx(prx),
+        _inEncaps(inEncaps),
+        _count(count),
+        _sent(0)
+    {
+    }
+
+    virtual void run()
+    {
+        for(int i = 0; i < _count; ++i)
+        {
+            //
+            // Synchronous invocations wait for the send queue to drop below the flow
+            // control window before queuing their message.
+            //
+            vector<Ice::Byte> outEncaps;
+            _prx->ice_invoke("send", Ice::ICE_ENUM(OperationMode, Normal), _inEncaps, outEncaps);
+
+            Lock sync(*this);
+            ++_sent;
+            notifyAll();
+        }
+    }
+
+    int sent()
+    {
+        Lock sync(*this);
+        return _sent;
+    }
+
+    bool waitForSent(int count, const IceUtil::Time& timeout)
+    {
+        Lock sync(*this);
+        IceUtil::Time end = IceUtil::Time::now(IceUtil::Time::Monotonic) + timeout;
+        while(_sent < count)
+        {
+            IceUtil::Time remaining = end - IceUtil::Time::now(IceUtil::Time::Monotonic);
+            if(remaining <= IceUtil::Time() || !timedWait(remaining))
+            {
+                return _sent >= count;
+            }
+        }
+        return true;
+    }
+
+private:
+
+    const Ice::ObjectPrxPtr _prx;
+    const vector<Ice::Byte> _inEncaps;
+    const int _count;
+    int _sent;
+};
+typedef IceUtil::Handle<ProducerThread> ProducerThreadPtr;
+
+void
+getQueueMetrics(const IceMX::MetricsAdminPrxPtr& metrics, Ice::Long& queuedBytes, Ice::Long& sendWindowFull)
+{
+    Ice::Long timestamp;
+    IceMX::MetricsView view = metrics->getMetricsView("View", timestamp);
+    queuedBytes = 0;
+    sendWindowFull = 0;
+    for(IceMX::MetricsMap::const_iterator p = view["Connection"].begin(); p != view["Connection"].end(); ++p)
+    {
+        IceMX::ConnectionMetricsPtr m = ICE_DYNAMIC_CAST(IceMX::ConnectionMetrics, *p);
+        test(m);
+        if(m->queuedBytes)
+        {
+            queuedBytes += *m->queuedBytes;
+        }
+        if(m->sendWindowFull)
+        {
+            sendWindowFull += *m->sendWindowFull;
+        }
+    }
+}
+
+}
+
+class Client : public Test::TestHelper
+{
+public:
+
+    void run(int, char**);
+
+private:
+
+    Ice::ObjectPrxPtr connect(const Ice::CommunicatorPtr&, const Ice::ObjectAdapterPtr&);
+};
+
+Ice::ObjectPrxPtr
+Client::connect(const Ice::CommunicatorPtr& communicator, const Ice::ObjectAdapterPtr& adapter)
+{
+    Ice::ObjectPrxPtr prx = communicator->stringToProxy("test:" + getTestEndpoint(0))->ice_oneway();
+
+    //
+    // Establish the connection and put the adapter on hold, the queued
+    // messages are no longer read by the server.
+    //
+    prx->ice_ping();
+    adapter->hold();
+    adapter->waitForHold();
+    return prx;
+}
+
+void
+Client::run(int argc, char** argv)
+{
+    Ice::PropertiesPtr properties = createTestProperties(argc, argv);
+    properties->setProperty("Ice.TCP.SndSize", "65536");
+    properties->setProperty("Ice.TCP.RcvSize", "65536");
+    properties->setProperty("TestAdapter.Endpoints", getTestEndpoint(properties, 0));
+    Ice::CommunicatorHolder communicator = initialize(argc, argv, properties);
+
+    Ice::ObjectAdapterPtr adapter = communicator->createObjectAdapter("TestAdapter");
+    adapter->add(ICE_MAKE_SHARED(BlobjectI), Ice::stringToIdentity("test"));
+    adapter->activate();
+
+    Ice::OutputStream out(communicator.communicator());
+    out.startEncapsulation();
+    out.write(vector<Ice::Byte>(64 * 1024));
+    out.endEncapsulation();
+    vector<Ice::Byte> inEncaps;
+    out.finished(inEncaps);
+
+    const int count = 100; // 6.4MB, well above the socket buffers and the flow control window.
+
+    cout << "testing flow control... " << flush;
+    {
+        Ice::InitializationData initData;
+        initData.properties = properties->clone();
+        initData.properties->setProperty("Ice.FlowControl.Window", "256");
+        initData.properties->setProperty("Ice.Admin.Endpoints", "default");
+        initData.properties->setProperty("Ice.Admin.InstanceName", "client");
+        initData.properties->setProperty("IceMX.Metrics.View.GroupBy", "none");
+        Ice::CommunicatorHolder ich = Ice::initialize(initData);
+        IceMX::MetricsAdminPrxPtr metrics =
+            ICE_CHECKED_CAST(IceMX::MetricsAdminPrx, ich->getAdmin(), "Metrics");
+
+        Ice::ObjectPrxPtr prx = connect(ich.communicator(), adapter);
+
+        //
+        // Asynchronous invocations aren't throttled, the messages are queued
+        // and the application waits for the sent callbacks.
+        //
+        CallbackPtr cb = ICE_MAKE_SHARED(Callback);
+        for(int i = 0; i < count; ++i)
+        {
+            invokeAsync(prx, inEncaps, cb);
+        }
+        test(cb->sent() < count);
+
+        Ice::Long queuedBytes;
+        Ice::Long sendWindowFull;
+        getQueueMetrics(metrics, queuedBytes, sendWindowFull);
+        test(queuedBytes >= 256 * 1024);
+        test(sendWindowFull == 1);
+
+        //
+        // A synchronous invocation fails once the invocation timeout expires,
+        // without queuing its message.
+        //
+        try
+        {
+            vector<Ice::Byte> outEncaps;
+            prx->ice_invocationTimeout(100)->ice_invoke("send", Ice::ICE_ENUM(OperationMode, Normal), inEncaps,
+                                                         outEncaps);
+            test(false);
+        }
+        catch(const Ice::InvocationTimeoutException&)
+        {
+        }
+
+        //
+        // Otherwise, it waits for the send queue to drop below the window.
+        //
+        ProducerThreadPtr thread = new ProducerThread(prx, inEncaps, 1);
+        thread->start();
+        test(!thread->waitForSent(1, IceUtil::Time::milliSeconds(500)));
+
+        Ice::Long queuedBytes2;
+        getQueueMetrics(metrics, queuedBytes2, sendWindowFull);
+        test(queuedBytes2 == queuedBytes);
+
+        adapter->activate();
+        thread->getThreadControl().join();
+        test(thread->sent() == 1);
+        cb->waitForCompleted(count);
+        test(cb->sent() == count);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing flow control with the Fail policy... " << flush;
+    {
+        Ice::InitializationData initData;
+        initData.properties = properties->clone();
+        initData.properties->setProperty("Ice.FlowControl.Window", "256");
+        initData.properties->setProperty("Ice.FlowControl.Policy", "Fail");
+        Ice::CommunicatorHolder ich = Ice::initialize(initData);
+
+        Ice::ObjectPrxPtr prx = connect(ich.communicator(), adapter);
+
+        //
+        // The invocations fail once the send queue is over the window.
+        //
+        CallbackPtr cb = ICE_MAKE_SHARED(Callback);
+        for(int i = 0; i < count; ++i)
+        {
+            invokeAsync(prx, inEncaps, cb);
+        }
+
+        IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+        try
+        {
+            vector<Ice::Byte> outEncaps;
+            prx->ice_invoke("send", Ice::ICE_ENUM(OperationMode, Normal), inEncaps, outEncaps);
+            test(false);
+        }
+        catch(const Ice::InvocationTimeoutException&)
+        {
+        }
+        test(IceUtil::Time::now(IceUtil::Time::Monotonic) - start < IceUtil::Time::seconds(5));
+
+        adapter->activate();
+        cb->waitForCompleted(count);
+        test(cb->sent() > 0);
+        test(cb->failed() > 0);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing invalid flow control policy... " << flush;
+    {
+        Ice::InitializationData initData;
+        initData.properties = properties->clone();
+        initData.properties->setProperty("Ice.FlowControl.Window", "256");
+        initData.properties->setProperty("Ice.FlowControl.Policy", "Queue");
+        try
+        {
+            Ice::initialize(initData);
+            test(false);
+        }
+        catch(const Ice::InitializationException&)
+        {
+        }
+    }
+    cout << "ok" << endl;
+
+    adapter->destroy();
+}
+
+DEFINE_TEST(Client)
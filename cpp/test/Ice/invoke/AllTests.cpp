@@ -778,5 +778,165 @@ allTests(Test::TestHelper* helper)
     }
 #endif
     cout << "ok" << endl;
+
+    cout << "testing prepared requests... " << flush;
+    {
+        Ice::ByteSeq inEncaps, outEncaps;
+        Ice::OutputStream out(communicator);
+        out.startEncapsulation();
+        out.write(testString);
+        out.endEncapsulation();
+        out.finished(inEncaps);
+
+        Ice::PreparedRequestPtr request =
+            ICE_MAKE_SHARED(Ice::PreparedRequest, communicator, "opString", Ice::ICE_ENUM(OperationMode, Normal),
+                            inEncaps);
+        test(request->getOperation() == "opString");
+        test(request->size() > inEncaps.size());
+
+        //
+        // The same request is sent to several targets, including a proxy
+        // bound to a connection.
+        //
+        vector<Ice::ObjectPrxPtr> targets;
+        targets.push_back(cl);
+        targets.push_back(cl->ice_identity(Ice::stringToIdentity("other")));
+        targets.push_back(cl->ice_facet("facet"));
+        targets.push_back(cl->ice_getConnection()->createProxy(Ice::stringToIdentity("fixed")));
+        for(vector<Ice::ObjectPrxPtr>::const_iterator p = targets.begin(); p != targets.end(); ++p)
+        {
+            test((*p)->ice_invoke(request, outEncaps));
+            Ice::InputStream in(communicator, out.getEncoding(), outEncaps);
+            in.startEncapsulation();
+            string s;
+            in.read(s);
+            test(s == testString);
+            in.read(s);
+            test(s == testString);
+            in.endEncapsulation();
+        }
+
+        //
+        // The parameters of a large request are shared by the messages
+        // sent with the request.
+        //
+        {
+            string largeString(256 * 1024, 'x');
+            Ice::OutputStream largeOut(communicator);
+            largeOut.startEncapsulation();
+            largeOut.write(largeString);
+            largeOut.endEncapsulation();
+            Ice::ByteSeq largeEncaps;
+            largeOut.finished(largeEncaps);
+
+            Ice::PreparedRequestPtr large =
+                ICE_MAKE_SHARED(Ice::PreparedRequest, communicator, "opString", Ice::ICE_ENUM(OperationMode, Normal),
+                                largeEncaps);
+            test(large->size() > largeEncaps.size());
+            for(int i = 0; i < 10; ++i)
+            {
+                test(targets[static_cast<size_t>(i) % targets.size()]->ice_invoke(large, outEncaps));
+                Ice::InputStream in(communicator, largeOut.getEncoding(), outEncaps);
+                in.startEncapsulation();
+                string s;
+                in.read(s);
+                test(s == largeString);
+                in.read(s);
+                test(s == largeString);
+                in.endEncapsulation();
+            }
+            test(oneway->ice_invoke(large, outEncaps));
+        }
+
+        //
+        // The context of the request replaces the proxy context.
+        //
+        Ice::Context ctx;
+        ctx["raise"] = "";
+        Ice::PreparedRequestPtr raise =
+            ICE_MAKE_SHARED(Ice::PreparedRequest, communicator, "opException", Ice::ICE_ENUM(OperationMode, Normal),
+                            Ice::ByteSeq(), ctx);
+        test(raise->getContext() == ctx);
+        for(int i = 0; i < 2; ++i)
+        {
+            Ice::ObjectPrxPtr prx = i == 0 ? cl : cl->ice_context(Ice::Context());
+            test(!prx->ice_invoke(raise, outEncaps));
+            Ice::InputStream in(communicator, cl->ice_getEncodingVersion(), outEncaps);
+            in.startEncapsulation();
+            try
+            {
+                in.throwException();
+                test(false);
+            }
+            catch(const Test::MyException&)
+            {
+            }
+            in.endEncapsulation();
+        }
+
+        Ice::PreparedRequestPtr opOneway =
+            ICE_MAKE_SHARED(Ice::PreparedRequest, communicator, "opOneway", Ice::ICE_ENUM(OperationMode, Normal),
+                            Ice::ByteSeq());
+        test(oneway->ice_invoke(opOneway, outEncaps));
+        for(int i = 0; i < 4; ++i)
+        {
+            test(batchOneway->ice_invoke(opOneway, outEncaps));
+        }
+        batchOneway->ice_flushBatchRequests();
+
+#ifdef ICE_CPP11_MAPPING
+        auto result = cl->ice_invokeAsync(request).get();
+        test(result.returnValue);
+
+        promise<bool> sent;
+        promise<vector<Ice::Byte>> response;
+        cl->ice_invokeAsync(request,
+            [&response](bool ok, vector<Ice::Byte> outParams)
+            {
+                test(ok);
+                response.set_value(move(outParams));
+            },
+            [](exception_ptr)
+            {
+                test(false);
+            },
+            [&sent](bool sentSynchronously)
+            {
+                sent.set_value(sentSynchronously);
+            });
+        sent.get_future().get();
+        test(response.get_future().get() == result.outParams);
+#else
+        Ice::AsyncResultPtr r = cl->begin_ice_invoke(request);
+        test(cl->end_ice_invoke(outEncaps, r));
+
+        ::CallbackPtr cb = new ::Callback(communicator, false);
+        cl->begin_ice_invoke(request, Ice::newCallback(cb, &Callback::opString));
+        cb->check();
+
+        cb = new ::Callback(communicator, false);
+        cl->begin_ice_invoke(request, Ice::newCallback_Object_ice_invoke(cb, &Callback::opStringNC, nullEx));
+        cb->check();
+#endif
+
+        //
+        // A prepared request can only be sent with the proxies of its
+        // communicator.
+        //
+        Ice::CommunicatorHolder other(Ice::initialize());
+        Ice::PreparedRequestPtr foreign =
+            ICE_MAKE_SHARED(Ice::PreparedRequest, other.communicator(), "opString",
+                            Ice::ICE_ENUM(OperationMode, Normal), inEncaps);
+        try
+        {
+            cl->ice_invoke(foreign, outEncaps);
+            test(false);
+        }
+        catch(const IceUtil::IllegalArgumentException&)
+        {
+        }
+    }
+    cout << "ok" << endl;
+
     return cl;
 }
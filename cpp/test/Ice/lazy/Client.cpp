@@ -0,0 +1,407 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <Ice/Ice.h>
+#include <TestHelper.h>
+#include <Test.h>
+
+using namespace std;
+
+//
+// In parameters are passed by value with the C++11 mapping and by
+// const reference with the C++98 mapping.
+//
+#ifdef ICE_CPP11_MAPPING
+#   define IN(T) T
+#else
+#   define IN(T) const T&
+#endif
+
+namespace
+{
+
+class EchoI : public Test::Echo
+{
+public:
+
+    virtual Test::IntStringDict echoDict(IN(Ice::LazyView<Test::IntStringDict>) d, const Ice::Current&)
+    {
+        return d.decode();
+    }
+};
+
+class RouterI : public Test::Router
+{
+public:
+
+    RouterI(const Test::EchoPrxPtr& echo) :
+        _echo(echo)
+    {
+    }
+
+    virtual int opIntSeq(IN(Test::Header) h, IN(Ice::LazyView<Test::IntSeq>) s, int trailer, const Ice::Current&)
+    {
+        test(h.route == "ints");
+        int sum = trailer;
+        for(Ice::LazyView<Test::IntSeq>::const_iterator p = s.begin(); p != s.end(); ++p)
+        {
+            sum += *p;
+        }
+        return sum;
+    }
+
+    virtual Test::StringSeq opStringSeq(IN(Ice::LazyView<Test::StringSeq>) s, int count, string& trailer,
+                                        const Ice::Current&)
+    {
+        Test::StringSeq result;
+        for(Ice::LazyView<Test::StringSeq>::const_iterator p = s.begin(); p != s.end() && count-- > 0; p++)
+        {
+            result.push_back(*p);
+        }
+        ostringstream os;
+        os << "end" << s.size();
+        trailer = os.str();
+        return result;
+    }
+
+    virtual Test::Point opPointSeq(IN(Ice::LazyView<Test::PointSeq>) s, int index, const Ice::Current&)
+    {
+        Ice::LazyView<Test::PointSeq>::const_iterator p = s.begin();
+        for(int i = 0; i < index; ++i)
+        {
+            ++p;
+        }
+        return *p;
+    }
+
+    virtual string opStringSeqSeq(IN(Ice::LazyView<Test::StringSeqSeq>) s, IN(Ice::LazyView<Test::StringSeq>) t,
+                                  const Ice::Current&)
+    {
+        string result;
+        for(Ice::LazyView<Test::StringSeqSeq>::const_iterator p = s.begin(); p != s.end(); ++p)
+        {
+            //
+            // Only decode every other element.
+            //
+            if(++p == s.end())
+            {
+                break;
+            }
+            result += p->empty() ? string("-") : p->back();
+        }
+        for(Ice::LazyView<Test::StringSeq>::const_iterator p = t.begin(); p != t.end(); ++p)
+        {
+            result += *p;
+        }
+        return result;
+    }
+
+    virtual string opIntStringDict(IN(Ice::LazyView<Test::IntStringDict>) d, int key, const Ice::Current&)
+    {
+        for(Ice::LazyView<Test::IntStringDict>::const_iterator p = d.begin(); p != d.end(); ++p)
+        {
+            if(p->first == key)
+            {
+                return p->second;
+            }
+        }
+        return "";
+    }
+
+    virtual Test::IntSeq opStringIntSeqDict(IN(Ice::LazyView<Test::StringIntSeqDict>) d, IN(string) key,
+                                            const Ice::Current&)
+    {
+        Test::StringIntSeqDict all = d.decode();
+        test(all.size() == d.size());
+        return all[key];
+    }
+
+    virtual Test::IntStringDict opOut(int size, Test::IntSeq& s, const Ice::Current&)
+    {
+        Test::IntStringDict d;
+        for(int i = 0; i < size; ++i)
+        {
+            s.push_back(i);
+            ostringstream os;
+            os << i;
+            d[i] = os.str();
+        }
+        return d;
+    }
+
+    virtual Test::IntStringDict forward(IN(Test::Header) h, IN(Ice::LazyView<Test::IntStringDict>) d,
+                                        const Ice::Current&)
+    {
+        test(h.route == "echo");
+        return _echo->echoDict(d);
+    }
+
+    virtual int route(IN(Test::Header) h, IN(Test::IntStringDict), const Ice::Current&)
+    {
+        return h.id;
+    }
+
+    virtual int routeLazy(IN(Test::Header) h, IN(Ice::LazyView<Test::IntStringDict>), const Ice::Current&)
+    {
+        return h.id;
+    }
+
+private:
+
+    const Test::EchoPrxPtr _echo;
+};
+
+#ifndef ICE_CPP11_MAPPING
+class OutCallback : public IceUtil::Shared, private IceUtil::Monitor<IceUtil::Mutex>
+{
+public:
+
+    OutCallback() :
+        _size(-1)
+    {
+    }
+
+    void response(const Ice::LazyView<Test::IntStringDict>& d, const Ice::LazyView<Test::IntSeq>& s)
+    {
+        check(d, s);
+        Lock sync(*this);
+        _size = static_cast<int>(s.size());
+        notify();
+    }
+
+    void exception(const Ice::Exception&)
+    {
+        test(false);
+    }
+
+    int wait()
+    {
+        Lock sync(*this);
+        while(_size < 0)
+        {
+            IceUtil::Monitor<IceUtil::Mutex>::wait();
+        }
+        return _size;
+    }
+
+    static void check(const Ice::LazyView<Test::IntStringDict>& d, const Ice::LazyView<Test::IntSeq>& s)
+    {
+        test(d.size() == s.size());
+        int i = 0;
+        Ice::LazyView<Test::IntStringDict>::const_iterator q = d.begin();
+        for(Ice::LazyView<Test::IntSeq>::const_iterator p = s.begin(); p != s.end(); ++p, ++q, ++i)
+        {
+            ostringstream os;
+            os << i;
+            test(*p == i);
+            test(q->first == i && q->second == os.str());
+        }
+        test(q == d.end());
+    }
+
+private:
+
+    int _size;
+};
+typedef IceUtil::Handle<OutCallback> OutCallbackPtr;
+#endif
+
+}
+
+class Client : public Test::TestHelper
+{
+public:
+
+    void run(int, char**);
+};
+
+void
+Client::run(int argc, char** argv)
+{
+    Ice::PropertiesPtr properties = createTestProperties(argc, argv);
+    properties->setProperty("Ice.MessageSizeMax", "0");
+    Ice::CommunicatorHolder communicator = initialize(argc, argv, properties);
+
+    communicator->getProperties()->setProperty("TestAdapter.Endpoints", getTestEndpoint());
+    Ice::ObjectAdapterPtr adapter = communicator->createObjectAdapter("TestAdapter");
+    Test::EchoPrxPtr echo = ICE_UNCHECKED_CAST(Test::EchoPrx,
+                                               adapter->add(ICE_MAKE_SHARED(EchoI), Ice::stringToIdentity("echo")));
+    Test::RouterPrxPtr router =
+        ICE_UNCHECKED_CAST(Test::RouterPrx, adapter->add(ICE_MAKE_SHARED(RouterI, echo),
+                                                         Ice::stringToIdentity("router")));
+    adapter->activate();
+
+    Test::Header h;
+    h.id = 5;
+
+    cout << "testing sequences... " << flush;
+    {
+        h.route = "ints";
+        Test::IntSeq ints;
+        for(int i = 0; i < 100; ++i)
+        {
+            ints.push_back(i);
+        }
+        test(router->opIntSeq(h, ints, 99) == 4950 + 99);
+        test(router->opIntSeq(h, Test::IntSeq(), 99) == 99);
+        test(router->opIntSeq(h, Ice::LazyView<Test::IntSeq>(), 1) == 1);
+
+        Test::StringSeq strings;
+        for(int i = 0; i < 10; ++i)
+        {
+            ostringstream os;
+            os << string(static_cast<size_t>(i * 10), 'x') << i;
+            strings.push_back(os.str());
+        }
+        string trailer;
+        Test::StringSeq result = router->opStringSeq(strings, 3, trailer);
+        test(result.size() == 3 && equal(result.begin(), result.end(), strings.begin()));
+        test(trailer == "end10");
+        result = router->opStringSeq(strings, 20, trailer);
+        test(result == strings);
+
+        Test::PointSeq points;
+        for(int i = 0; i < 50; ++i)
+        {
+            Test::Point pt;
+            pt.x = i;
+            pt.y = -i;
+            points.push_back(pt);
+        }
+        Test::Point pt = router->opPointSeq(points, 0);
+        test(pt.x == 0 && pt.y == 0);
+        pt = router->opPointSeq(points, 37);
+        test(pt.x == 37 && pt.y == -37);
+
+        Test::StringSeqSeq nested;
+        for(int i = 0; i < 6; ++i)
+        {
+            Test::StringSeq s;
+            for(int j = 0; j < i; ++j)
+            {
+                s.push_back(string(1, static_cast<char>('a' + j)));
+            }
+            nested.push_back(s);
+        }
+        Test::StringSeq tail;
+        tail.push_back("X");
+        tail.push_back("Y");
+        test(router->opStringSeqSeq(nested, tail) == "aceXY");
+    }
+    cout << "ok" << endl;
+
+    cout << "testing dictionaries... " << flush;
+    {
+        Test::IntStringDict d;
+        for(int i = 0; i < 100; ++i)
+        {
+            ostringstream os;
+            os << "v" << i;
+            d[i] = os.str();
+        }
+        test(router->opIntStringDict(d, 42) == "v42");
+        test(router->opIntStringDict(d, 100) == "");
+
+        Test::StringIntSeqDict sd;
+        sd["a"] = Test::IntSeq(3, 1);
+        sd["b"] = Test::IntSeq();
+        sd["c"] = Test::IntSeq(10, 7);
+        test(router->opStringIntSeqDict(sd, "c") == Test::IntSeq(10, 7));
+        test(router->opStringIntSeqDict(sd, "b").empty());
+    }
+    cout << "ok" << endl;
+
+    cout << "testing out parameters and return values... " << flush;
+    {
+        Test::IntSeq s;
+        Test::IntStringDict d = router->opOut(20, s);
+        test(d.size() == 20 && s.size() == 20);
+
+#ifdef ICE_CPP11_MAPPING
+        promise<int> received;
+        router->opOutAsync(20,
+                           [&received](Ice::LazyView<Test::IntStringDict> rd, Ice::LazyView<Test::IntSeq> rs)
+                           {
+                               test(rd.size() == rs.size());
+                               int i = 0;
+                               auto q = rd.begin();
+                               for(auto p = rs.begin(); p != rs.end(); ++p, ++q, ++i)
+                               {
+                                   test(*p == i);
+                                   test(q->first == i && q->second == to_string(i));
+                               }
+                               test(q == rd.end());
+                               received.set_value(static_cast<int>(rs.size()));
+                           },
+                           [](exception_ptr)
+                           {
+                               test(false);
+                           });
+        test(received.get_future().get() == 20);
+#else
+        OutCallbackPtr cb = new OutCallback();
+        router->begin_opOut(20, Test::newCallback_Router_opOut(cb, &OutCallback::response, &OutCallback::exception));
+        test(cb->wait() == 20);
+#endif
+    }
+    cout << "ok" << endl;
+
+    cout << "testing forwarding... " << flush;
+    {
+        h.route = "echo";
+        Test::IntStringDict d;
+        for(int i = 0; i < 1000; ++i)
+        {
+            ostringstream os;
+            os << "v" << i;
+            d[i] = os.str();
+        }
+        test(router->forward(h, d) == d);
+
+        //
+        // Forwarding a view received with another encoding re-encodes it.
+        //
+        test(router->ice_encodingVersion(Ice::Encoding_1_0)->forward(h, d) == d);
+        test(router->forward(h, Test::IntStringDict()).empty());
+    }
+    cout << "ok" << endl;
+
+    if(properties->getPropertyAsInt("Test.Benchmark") > 0)
+    {
+        cout << "measuring lazy dictionary parameter... " << flush;
+        Test::IntStringDict d;
+        for(int i = 0; i < 100000; ++i)
+        {
+            ostringstream os;
+            os << "value" << i;
+            d[i] = os.str();
+        }
+        const int repetitions = 20;
+
+        test(router->route(h, d) == h.id);
+        test(router->routeLazy(h, d) == h.id);
+
+        IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+        for(int i = 0; i < repetitions; ++i)
+        {
+            router->route(h, d);
+        }
+        IceUtil::Time eager = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+
+        start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+        for(int i = 0; i < repetitions; ++i)
+        {
+            router->routeLazy(h, d);
+        }
+        IceUtil::Time lazy = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+        cout << "ok" << endl;
+
+        cout << "request with a " << d.size() << " entries dictionary: " << eager.toMilliSecondsDouble() / repetitions
+             << "ms, " << lazy.toMilliSecondsDouble() / repetitions << "ms with cpp:lazy" << endl;
+    }
+
+    adapter->destroy();
+}
+
+DEFINE_TEST(Client)
@@ -3189,6 +3189,91 @@ allTests(Test::TestHelper* helper)
     }
     cout << "ok" << endl;
 
+    cout << "preserved classes in pass-through mode... " << flush;
+    if(test->ice_getEncodingVersion() != Ice::Encoding_1_0)
+    {
+        Ice::InitializationData initData;
+        initData.properties = communicator->getProperties()->clone();
+        initData.properties->setProperty("Ice.PassThroughSlices", "1");
+        Ice::CommunicatorHolder ich(initData);
+        TestIntfPrxPtr passThrough = ICE_UNCHECKED_CAST(TestIntfPrx,
+                                                        ich->stringToProxy(communicator->proxyToString(test)));
+
+        try
+        {
+            //
+            // The preserved slice doesn't refer to instances, it's kept and
+            // written back verbatim.
+            //
+            PreservedPtr p = passThrough->PBSUnknown3AsPreserved();
+            Ice::SlicedDataPtr slicedData = p->ice_getSlicedData();
+            test(slicedData);
+            test(!slicedData->encoding.empty());
+            test(slicedData->slices.size() == 1);
+            test(slicedData->slices[0]->typeId == "::Test::PSUnknown3");
+            test(slicedData->slices[0]->bytes.empty());
+            passThrough->checkPBSUnknown3(p);
+            test->checkPBSUnknown3(p);
+
+            //
+            // Forward two instances in the same encapsulation, the type IDs
+            // of the known slices of the second instance are encoded as
+            // indexes which must account for the type IDs of the first
+            // instance's verbatim slices.
+            //
+            PreservedPtr p2 = passThrough->PBSUnknown3AsPreserved();
+            Ice::OutputStream out(ich.communicator());
+            out.startEncapsulation(test->ice_getEncodingVersion(), Ice::ICE_ENUM(FormatType, SlicedFormat));
+            out.write(p);
+            out.write(p2);
+            out.writePendingValues();
+            out.endEncapsulation();
+
+            Ice::InputStream in(communicator, out.finished());
+            in.startEncapsulation();
+            PreservedPtr q;
+            PreservedPtr q2;
+            in.read(q);
+            in.read(q2);
+            in.readPendingValues();
+            in.endEncapsulation();
+            test(q && q2 && q != q2);
+            test(q->pi == p->pi && q->ps == p->ps);
+            test(q2->pi == p2->pi && q2->ps == p2->ps);
+            test(q2->ice_getSlicedData()->slices.size() == 1);
+            test(q2->ice_getSlicedData()->slices[0]->bytes == q->ice_getSlicedData()->slices[0]->bytes);
+            test->checkPBSUnknown3(q2);
+
+            breakCycles(p);
+            breakCycles(p2);
+            breakCycles(q);
+            breakCycles(q2);
+        }
+        catch(const Ice::OperationNotExistException&)
+        {
+        }
+
+        try
+        {
+            //
+            // The preserved slice refers to instances, its bytes are kept
+            // and it's re-marshaled as usual.
+            //
+            PreservedPtr p = passThrough->PBSUnknownAsPreservedWithGraph();
+            Ice::SlicedDataPtr slicedData = p->ice_getSlicedData();
+            test(slicedData);
+            test(slicedData->encoding.empty());
+            test(!slicedData->slices[0]->bytes.empty());
+            passThrough->checkPBSUnknownWithGraph(p);
+            slicedData->clear();
+            breakCycles(p);
+        }
+        catch(const Ice::OperationNotExistException&)
+        {
+        }
+    }
+    cout << "ok" << endl;
+
 #ifndef ICE_CPP11_MAPPING
     cout << "garbage collection for preserved classes... " << flush;
     try
@@ -426,6 +426,41 @@ TestI::checkPBSUnknownAsync(shared_ptr<::Test::Preserved> p,
     response();
 }
 
+void
+TestI::PBSUnknown3AsPreservedAsync(function<void(const shared_ptr<::Test::Preserved>&)> response,
+                                    function<void(exception_ptr)>,
+                                    const ::Ice::Current&)
+{
+    auto r = make_shared<PSUnknown3>();
+    r->pi = 5;
+    r->ps = "preserved";
+    r->psu = "unknown";
+    response(r);
+}
+
+void
+TestI::checkPBSUnknown3Async(shared_ptr<::Test::Preserved> p,
+                              function<void()> response,
+                              function<void(exception_ptr)>,
+                              const ::Ice::Current& current)
+{
+    auto pu = dynamic_pointer_cast<PSUnknown3>(p);
+    if(current.encoding == Ice::Encoding_1_0)
+    {
+        test(!pu);
+        test(p->pi == 5);
+        test(p->ps == "preserved");
+    }
+    else
+    {
+        test(pu);
+        test(pu->pi == 5);
+        test(pu->ps == "preserved");
+        test(pu->psu == "unknown");
+    }
+    response();
+}
+
 void
 TestI::PBSUnknownAsPreservedWithGraphAsync(function<void(const shared_ptr<::Test::Preserved>&)> response,
                                             function<void(exception_ptr)>,
@@ -1025,6 +1060,37 @@ TestI::checkPBSUnknown_async(const Test::AMD_TestIntf_checkPBSUnknownPtr& cb, co
     cb->ice_response();
 }
 
+void
+TestI::PBSUnknown3AsPreserved_async(const Test::AMD_TestIntf_PBSUnknown3AsPreservedPtr& cb, const Ice::Current&)
+{
+    PSUnknown3Ptr r = new PSUnknown3;
+    r->pi = 5;
+    r->ps = "preserved";
+    r->psu = "unknown";
+    cb->ice_response(r);
+}
+
+void
+TestI::checkPBSUnknown3_async(const Test::AMD_TestIntf_checkPBSUnknown3Ptr& cb, const Test::PreservedPtr& p,
+                              const Ice::Current& current)
+{
+    PSUnknown3Ptr pu = PSUnknown3Ptr::dynamicCast(p);
+    if(current.encoding == Ice::Encoding_1_0)
+    {
+        test(!pu);
+        test(p->pi == 5);
+        test(p->ps == "preserved");
+    }
+    else
+    {
+        test(pu);
+        test(pu->pi == 5);
+        test(pu->ps == "preserved");
+        test(pu->psu == "unknown");
+    }
+    cb->ice_response();
+}
+
 void
 TestI::PBSUnknownAsPreservedWithGraph_async(const Test::AMD_TestIntf_PBSUnknownAsPreservedWithGraphPtr& cb,
                                             const Ice::Current&)
@@ -130,6 +130,15 @@ public:
                                       std::function<void(std::exception_ptr)>,
                                       const ::Ice::Current&);
 
+    virtual void PBSUnknown3AsPreservedAsync(std::function<void(const std::shared_ptr<::Test::Preserved>&)>,
+                                             std::function<void(std::exception_ptr)>,
+                                             const ::Ice::Current&);
+
+    virtual void checkPBSUnknown3Async(std::shared_ptr<::Test::Preserved>,
+                                       std::function<void()>,
+                                       std::function<void(std::exception_ptr)>,
+                                       const ::Ice::Current&);
+
     virtual void PBSUnknownAsPreservedWithGraphAsync(std::function<void(const std::shared_ptr<::Test::Preserved>&)>,
                                                      std::function<void(std::exception_ptr)>,
                                                      const ::Ice::Current&);
@@ -229,6 +238,11 @@ public:
     virtual void checkPBSUnknown_async(const ::Test::AMD_TestIntf_checkPBSUnknownPtr&, const ::Test::PreservedPtr&,
                                        const ::Ice::Current&);
 
+    virtual void PBSUnknown3AsPreserved_async(const ::Test::AMD_TestIntf_PBSUnknown3AsPreservedPtr&,
+                                              const ::Ice::Current&);
+    virtual void checkPBSUnknown3_async(const ::Test::AMD_TestIntf_checkPBSUnknown3Ptr&, const ::Test::PreservedPtr&,
+                                        const ::Ice::Current&);
+
     virtual void PBSUnknownAsPreservedWithGraph_async(const ::Test::AMD_TestIntf_PBSUnknownAsPreservedWithGraphPtr&,
                                                       const ::Ice::Current&);
     virtual void checkPBSUnknownWithGraph_async(const ::Test::AMD_TestIntf_checkPBSUnknownWithGraphPtr&,
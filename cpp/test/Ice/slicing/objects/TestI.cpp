@@ -553,6 +553,35 @@ TestI::checkPBSUnknown(ICE_IN(Test::PreservedPtr) p, const Ice::Current& current
     }
 }
 
+Test::PreservedPtr
+TestI::PBSUnknown3AsPreserved(const Ice::Current&)
+{
+    PSUnknown3Ptr r = ICE_MAKE_SHARED(PSUnknown3);
+    r->pi = 5;
+    r->ps = "preserved";
+    r->psu = "unknown";
+    return r;
+}
+
+void
+TestI::checkPBSUnknown3(ICE_IN(Test::PreservedPtr) p, const Ice::Current& current)
+{
+    PSUnknown3Ptr pu = ICE_DYNAMIC_CAST(PSUnknown3, p);
+    if(current.encoding == Ice::Encoding_1_0)
+    {
+        test(!pu);
+        test(p->pi == 5);
+        test(p->ps == "preserved");
+    }
+    else
+    {
+        test(pu);
+        test(pu->pi == 5);
+        test(pu->ps == "preserved");
+        test(pu->psu == "unknown");
+    }
+}
+
 #ifdef ICE_CPP11_MAPPING
 void
 TestI::PBSUnknownAsPreservedWithGraphAsync(function<void(const shared_ptr<Test::Preserved>&)> response,
@@ -51,6 +51,9 @@ public:
     virtual ::Test::PreservedPtr PBSUnknownAsPreserved(const ::Ice::Current&);
     virtual void checkPBSUnknown(ICE_IN(::Test::PreservedPtr), const ::Ice::Current&);
 
+    virtual ::Test::PreservedPtr PBSUnknown3AsPreserved(const ::Ice::Current&);
+    virtual void checkPBSUnknown3(ICE_IN(::Test::PreservedPtr), const ::Ice::Current&);
+
 #ifdef ICE_CPP11_MAPPING
     virtual void PBSUnknownAsPreservedWithGraphAsync(std::function<void(const std::shared_ptr<Test::Preserved>&)>,
                                                       std::function<void(std::exception_ptr)>,
@@ -224,6 +224,14 @@ public:
 };
 #endif
 
+template<typename T> size_t
+wireSize(const Ice::CommunicatorPtr& communicator, const T& v)
+{
+    Ice::OutputStream out(communicator);
+    out.write(v);
+    return out.b.size();
+}
+
 void
 allTests(Test::TestHelper* helper)
 {
@@ -404,6 +412,110 @@ allTests(Test::TestHelper* helper)
         test(s2 == s);
     }
 
+    {
+        PaddedStruct s;
+        s.l = 1;
+        s.d = 2.0;
+        s.i = 3;
+
+        //
+        // Packed structs are encoded like other structs.
+        //
+        Ice::OutputStream out(communicator);
+        out.write(s);
+        out.finished(data);
+        test(data.size() == 20);
+
+        Ice::OutputStream out2(communicator);
+        out2.write(s.l);
+        out2.write(s.d);
+        out2.write(s.i);
+        vector<Ice::Byte> data2;
+        out2.finished(data2);
+        test(data == data2);
+
+        Ice::InputStream in(communicator, data);
+        PaddedStruct s2;
+        in.read(s2);
+        test(s2 == s);
+    }
+
+    {
+        PackedStructS arr;
+        PaddedStructS paddedArr;
+        for(int i = 0; i < 10; ++i)
+        {
+            PackedStruct s;
+            s.i = i;
+            s.f = static_cast<Ice::Float>(i) / 2;
+            s.l = static_cast<Ice::Long>(i) << 40;
+            arr.push_back(s);
+
+            PaddedStruct p;
+            p.l = -i;
+            p.d = i * 1.5;
+            p.i = i * 3;
+            paddedArr.push_back(p);
+        }
+
+        Ice::OutputStream out(communicator);
+        out.write(arr);
+        out.write(paddedArr);
+        out.write(PackedStructS());
+        out.finished(data);
+        test(data.size() == 1 + 10 * 16 + 1 + 10 * 20 + 1);
+
+        Ice::InputStream in(communicator, data);
+        PackedStructS arr2;
+        PaddedStructS paddedArr2;
+        PackedStructS empty;
+        empty.push_back(arr[0]);
+        in.read(arr2);
+        in.read(paddedArr2);
+        in.read(empty);
+        test(arr2 == arr);
+        test(paddedArr2 == paddedArr);
+        test(empty.empty());
+
+        Ice::InputStream in2(communicator, data);
+        test(in2.readSize() == 10);
+        for(PackedStructS::const_iterator p = arr.begin(); p != arr.end(); ++p)
+        {
+            Ice::Int i2;
+            Ice::Float f2;
+            Ice::Long l2;
+            in2.read(i2);
+            in2.read(f2);
+            in2.read(l2);
+            test(i2 == p->i && f2 == p->f && l2 == p->l);
+        }
+        test(in2.readSize() == 10);
+        for(PaddedStructS::const_iterator p = paddedArr.begin(); p != paddedArr.end(); ++p)
+        {
+            Ice::Long l2;
+            Ice::Double d2;
+            Ice::Int i2;
+            in2.read(l2);
+            in2.read(d2);
+            in2.read(i2);
+            test(l2 == p->l && d2 == p->d && i2 == p->i);
+        }
+
+        //
+        // A truncated sequence is rejected.
+        //
+        data.resize(1 + 5 * 16);
+        Ice::InputStream in3(communicator, data);
+        try
+        {
+            in3.read(arr2);
+            test(false);
+        }
+        catch(const Ice::UnmarshalOutOfBoundsException&)
+        {
+        }
+    }
+
 #ifndef ICE_CPP11_MAPPING
     {
         Ice::OutputStream out(communicator);
@@ -1353,6 +1465,60 @@ allTests(Test::TestHelper* helper)
     }
 
     cout << "ok" << endl;
+
+    cout << "testing wire size estimates... " << flush;
+    {
+        test(wireSize(communicator, string("hello")) == Ice::iceWireSize(string("hello")));
+        test(wireSize(communicator, string(300, 'a')) == Ice::iceWireSize(string(300, 'a')));
+        test(wireSize(communicator, wstring(L"hello")) <= Ice::iceWireSize(wstring(L"hello")));
+
+        Ice::StringSeq strings;
+        for(int i = 0; i < 300; ++i)
+        {
+            strings.push_back(string(static_cast<size_t>(i), 'a'));
+        }
+        test(wireSize(communicator, strings) == Ice::iceWireSize(strings));
+
+        vector<bool> bools(300, true);
+        test(wireSize(communicator, bools) == Ice::iceWireSize(bools));
+
+        MyEnumS enums(10, ICE_ENUM(MyEnum, enum2));
+        test(wireSize(communicator, enums) == Ice::iceWireSize(enums));
+
+        StringStringD dict;
+        dict["key1"] = "value1";
+        dict["key2"] = string(1000, 'b');
+        test(wireSize(communicator, dict) == Ice::iceWireSize(dict));
+
+        NestedStruct s;
+        s.str = "nested";
+        s.e = ICE_ENUM(NestedEnum, nestedEnum3);
+        vector<NestedStruct> structs(20, s);
+        test(wireSize(communicator, structs) == Ice::iceWireSize(structs));
+
+        PackedStructS packed(100);
+        test(wireSize(communicator, packed) == Ice::iceWireSize(packed));
+
+        StringSS stringss(3, strings);
+        test(wireSize(communicator, stringss) == Ice::iceWireSize(stringss));
+
+        //
+        // Proxies only count for their minimum size.
+        //
+        SmallStruct small;
+        small.p = ICE_UNCHECKED_CAST(MyInterfacePrx, communicator->stringToProxy("test:default"));
+        test(wireSize(communicator, small) > Ice::iceWireSize(small));
+    }
+    {
+        Ice::StringSeq strings(1000, string(1000, 'a'));
+        Ice::OutputStream out(communicator);
+        out.write(Ice::Int(1));
+        out.reserve(Ice::iceWireSize(strings));
+        const Ice::Byte* p = out.b.begin();
+        out.write(strings);
+        test(out.b.begin() == p); // Verify the stream hasn't reallocated.
+    }
+    cout << "ok" << endl;
 }
 
 class Client : public Test::TestHelper
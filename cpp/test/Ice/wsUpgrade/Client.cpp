@@ -0,0 +1,69 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <Ice/Ice.h>
+#include <TestHelper.h>
+
+using namespace std;
+
+class Client : public Test::TestHelper
+{
+public:
+
+    void run(int, char**);
+};
+
+void
+Client::run(int argc, char** argv)
+{
+    Ice::PropertiesPtr properties = createTestProperties(argc, argv);
+    properties->setProperty("TestAdapter.Endpoints", getTestEndpoint(properties, 0, "ws"));
+    Ice::CommunicatorHolder communicator = initialize(argc, argv, properties);
+
+    Ice::ObjectAdapterPtr adapter = communicator->createObjectAdapter("TestAdapter");
+    adapter->activate();
+    Ice::ObjectPrxPtr prx = adapter->createProxy(Ice::stringToIdentity("test"))->ice_collocationOptimized(false);
+
+    cout << "testing WebSocket upgrade... " << flush;
+    {
+        Ice::ConnectionPtr connection = prx->ice_getConnection();
+        Ice::WSConnectionInfoPtr info = ICE_DYNAMIC_CAST(Ice::WSConnectionInfo, connection->getInfo());
+        test(info);
+        test(info->headers["Upgrade"] == "websocket");
+        test(info->headers["Connection"] == "Upgrade");
+        test(info->headers["Sec-WebSocket-Protocol"] == "ice.zeroc.com");
+        test(info->headers.find("Sec-WebSocket-Accept") != info->headers.end());
+        connection->close(Ice::ICE_SCOPED_ENUM(ConnectionClose, GracefullyWithWait));
+    }
+    cout << "ok" << endl;
+
+    if(properties->getPropertyAsInt("Test.Benchmark") > 0)
+    {
+        cout << "measuring WebSocket upgrades... " << flush;
+        const int upgrades = properties->getPropertyAsIntWithDefault("Test.Upgrades", 1000);
+
+        //
+        // Each iteration establishes a new connection, which includes the
+        // WebSocket upgrade request and response and the Ice connection
+        // validation, and closes it. A distinct connection ID ensures the
+        // proxy doesn't reuse a cached connection.
+        //
+        IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+        for(int i = 0; i < upgrades; ++i)
+        {
+            ostringstream os;
+            os << "upgrade-" << i;
+            prx->ice_connectionId(os.str())->ice_getConnection()->close(
+                Ice::ICE_SCOPED_ENUM(ConnectionClose, GracefullyWithWait));
+        }
+        IceUtil::Time elapsed = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+        cout << "ok" << endl;
+        cout << upgrades << " upgrades in " << elapsed.toMilliSecondsDouble() << "ms ("
+             << static_cast<int>(upgrades / elapsed.toSecondsDouble()) << " upgrades/s)" << endl;
+    }
+
+    adapter->destroy();
+}
+
+DEFINE_TEST(Client)
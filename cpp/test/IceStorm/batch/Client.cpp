@@ -0,0 +1,202 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <Ice/Ice.h>
+#include <IceStorm/IceStorm.h>
+#include <TestHelper.h>
+
+using namespace std;
+using namespace Ice;
+using namespace IceStorm;
+using namespace Test;
+
+namespace
+{
+
+//
+// Counts the events it receives.
+//
+class EventI : public Ice::Blobject, public IceUtil::Monitor<IceUtil::Mutex>
+{
+public:
+
+    EventI() :
+        _count(0)
+    {
+    }
+
+    virtual bool
+    ice_invoke(const vector<Byte>&, vector<Byte>&, const Current&)
+    {
+        Lock sync(*this);
+        ++_count;
+        notifyAll();
+        return true;
+    }
+
+    int
+    waitForEvents(int count, const IceUtil::Time& timeout)
+    {
+        Lock sync(*this);
+        IceUtil::Time end = IceUtil::Time::now(IceUtil::Time::Monotonic) + timeout;
+        while(_count < count)
+        {
+            IceUtil::Time now = IceUtil::Time::now(IceUtil::Time::Monotonic);
+            if(now >= end || !timedWait(end - now))
+            {
+                break;
+            }
+        }
+        return _count;
+    }
+
+private:
+
+    int _count;
+};
+typedef IceUtil::Handle<EventI> EventIPtr;
+
+void
+publish(const ObjectPrx& publisher, int count)
+{
+    vector<Byte> inParams;
+    vector<Byte> outParams;
+    for(int i = 0; i < count; ++i)
+    {
+        test(publisher->ice_invoke("event", Normal, inParams, outParams));
+    }
+}
+
+void
+testBadQoS(const TopicPrx& topic, const QoS& qos, const ObjectPrx& subscriber)
+{
+    try
+    {
+        topic->subscribeAndGetPublisher(qos, subscriber);
+        test(false);
+    }
+    catch(const BadQoS&)
+    {
+    }
+}
+
+}
+
+class Client : public Test::TestHelper
+{
+public:
+
+    void run(int, char**);
+};
+
+void
+Client::run(int argc, char** argv)
+{
+    Ice::CommunicatorHolder communicator = initialize(argc, argv);
+    PropertiesPtr properties = communicator->getProperties();
+    string managerProxy = properties->getProperty("IceStormAdmin.TopicManager.Default");
+    if(managerProxy.empty())
+    {
+        ostringstream os;
+        os << argv[0] << ": property `IceStormAdmin.TopicManager.Default' is not set";
+        throw invalid_argument(os.str());
+    }
+
+    TopicManagerPrx manager = TopicManagerPrx::checkedCast(communicator->stringToProxy(managerProxy));
+    if(!manager)
+    {
+        ostringstream os;
+        os << argv[0] << ": `" << managerProxy << "' is not running";
+        throw invalid_argument(os.str());
+    }
+
+    ObjectAdapterPtr adapter = communicator->createObjectAdapterWithEndpoints("BatchAdapter", "default");
+    adapter->activate();
+
+    TopicPrx topic = manager->create("batch");
+
+    //
+    // Twoway invocations return once the events are queued to the
+    // subscribers.
+    //
+    ObjectPrx publisher = topic->getPublisher()->ice_twoway();
+
+    QoS qos;
+    qos["reliability"] = "batch-adaptive";
+    qos["batchLatency"] = "1000";
+
+    cout << "testing adaptive batching with a low event rate... " << flush;
+    {
+        //
+        // The batch subscriber waits for the flush timeout, the adaptive
+        // batch subscriber sends the events right away: with an event
+        // every 1.5s, less than one event is expected within the 1s
+        // latency target.
+        //
+        EventIPtr batch = new EventI();
+        topic->subscribeAndGetPublisher(QoS(), adapter->addWithUUID(batch)->ice_batchOneway());
+
+        EventIPtr adaptive = new EventI();
+        topic->subscribeAndGetPublisher(qos, adapter->addWithUUID(adaptive)->ice_oneway());
+
+        publish(publisher, 1);
+        test(adaptive->waitForEvents(1, IceUtil::Time::milliSeconds(500)) == 1);
+        test(batch->waitForEvents(1, IceUtil::Time::milliSeconds(100)) == 0);
+
+        for(int i = 0; i < 3; ++i)
+        {
+            IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(1500));
+            publish(publisher, 1);
+            test(adaptive->waitForEvents(i + 2, IceUtil::Time::milliSeconds(500)) == i + 2);
+        }
+    }
+    cout << "ok" << endl;
+
+    cout << "testing adaptive batching with a high event rate... " << flush;
+    {
+        //
+        // The batches are limited to 10 events and flushed after 500ms.
+        //
+        EventIPtr subscriber = new EventI();
+        QoS batchQoS = qos;
+        batchQoS["batchLatency"] = "500";
+        batchQoS["batchSize"] = "10";
+        topic->subscribeAndGetPublisher(batchQoS, adapter->addWithUUID(subscriber)->ice_oneway());
+
+        publish(publisher, 1000);
+        test(subscriber->waitForEvents(1000, IceUtil::Time::seconds(30)) == 1000);
+
+        subscriber = new EventI();
+        batchQoS.erase("batchSize");
+        batchQoS["batchBytes"] = "1024";
+        topic->subscribeAndGetPublisher(batchQoS, adapter->addWithUUID(subscriber)->ice_oneway());
+
+        publish(publisher, 100);
+        test(subscriber->waitForEvents(100, IceUtil::Time::seconds(30)) == 100);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing invalid adaptive batching... " << flush;
+    {
+        ObjectPrx subscriber = adapter->addWithUUID(new EventI());
+        testBadQoS(topic, qos, subscriber->ice_twoway());
+
+        QoS badQoS = qos;
+        badQoS["batchLatency"] = "0";
+        testBadQoS(topic, badQoS, subscriber->ice_oneway());
+
+        badQoS = qos;
+        badQoS["batchSize"] = "abc";
+        testBadQoS(topic, badQoS, subscriber->ice_oneway());
+
+        badQoS = qos;
+        badQoS["batchBytes"] = "-1";
+        testBadQoS(topic, badQoS, subscriber->ice_oneway());
+    }
+    cout << "ok" << endl;
+
+    topic->destroy();
+}
+
+DEFINE_TEST(Client)
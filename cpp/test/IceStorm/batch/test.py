@@ -0,0 +1,29 @@
+# -*- coding: utf-8 -*-
+#
+# Copyright (c) ZeroC, Inc. All rights reserved.
+#
+
+#
+# The batches of the subscribers without adaptive batching are flushed every
+# 10 seconds.
+#
+icestorm = IceStorm(props = { "IceStorm.Flush.Timeout" : 10000 })
+
+class BatchClient(IceStormProcess, Client):
+
+    processType = "client"
+
+    def __init__(self, instanceName=None, instance=None, *args, **kargs):
+        Client.__init__(self, *args, **kargs)
+        IceStormProcess.__init__(self, instanceName, instance)
+
+    getParentProps = Client.getProps # Used by IceStormProcess to get the client properties
+
+class IceStormBatchTestCase(IceStormTestCase):
+
+    def teardownClientSide(self, current, success):
+        self.shutdown(current)
+
+TestSuite(__file__, [
+    IceStormBatchTestCase("batch", icestorm=icestorm, client=ClientTestCase(client=BatchClient(instance=icestorm))),
+], multihost=False)
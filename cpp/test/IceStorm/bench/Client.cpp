@@ -0,0 +1,505 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <IceUtil/IceUtil.h>
+#include <IceUtil/Options.h>
+#include <Ice/Ice.h>
+#include <IceStorm/IceStorm.h>
+#include <TestHelper.h>
+#include <algorithm>
+#include <fstream>
+
+#ifdef __linux__
+#   include <unistd.h>
+#endif
+
+using namespace std;
+using namespace Ice;
+using namespace IceStorm;
+using namespace Test;
+
+namespace
+{
+
+//
+// The latencies of the events received by all the subscribers.
+//
+class Results : public IceUtil::Shared, public IceUtil::Monitor<IceUtil::Mutex>
+{
+public:
+
+    Results() :
+        _received(0)
+    {
+    }
+
+    void
+    received(Ice::Long latency)
+    {
+        Lock sync(*this);
+        ++_received;
+        if(latency >= 0)
+        {
+            _latencies.push_back(latency);
+        }
+        notifyAll();
+    }
+
+    // Waits for the given number of events and returns the number of
+    // events received.
+    Ice::Long
+    waitForEvents(Ice::Long count, const IceUtil::Time& timeout)
+    {
+        Lock sync(*this);
+        IceUtil::Time end = IceUtil::Time::now(IceUtil::Time::Monotonic) + timeout;
+        while(_received < count)
+        {
+            IceUtil::Time now = IceUtil::Time::now(IceUtil::Time::Monotonic);
+            if(now >= end || !timedWait(end - now))
+            {
+                break;
+            }
+        }
+        return _received;
+    }
+
+    void
+    reset()
+    {
+        Lock sync(*this);
+        _received = 0;
+        _latencies.clear();
+    }
+
+    vector<Ice::Long>
+    latencies() const
+    {
+        Lock sync(*this);
+        return _latencies;
+    }
+
+private:
+
+    Ice::Long _received;
+    vector<Ice::Long> _latencies; // In microseconds.
+};
+typedef IceUtil::Handle<Results> ResultsPtr;
+
+//
+// The events carry the time at which they were published, or -1 for the
+// warm-up events.
+//
+class SubscriberI : public Ice::Blobject
+{
+public:
+
+    SubscriberI(const ResultsPtr& results) :
+        _results(results)
+    {
+    }
+
+    virtual bool
+    ice_invoke(const vector<Byte>& inParams, vector<Byte>&, const Current& current)
+    {
+        Ice::Long now = IceUtil::Time::now(IceUtil::Time::Monotonic).toMicroSeconds();
+        Ice::InputStream in(current.adapter->getCommunicator(), inParams);
+        in.startEncapsulation();
+        Ice::Long published;
+        in.read(published);
+        pair<const Ice::Byte*, const Ice::Byte*> payload;
+        in.read(payload);
+        in.endEncapsulation();
+        _results->received(published < 0 ? -1 : now - published);
+        return true;
+    }
+
+private:
+
+    const ResultsPtr _results;
+};
+
+class PublisherThread : public IceUtil::Thread
+{
+public:
+
+    PublisherThread(const ObjectPrx& publisher, int events, int payload, int rate, bool warmup) :
+        _publisher(publisher),
+        _events(events),
+        _payload(static_cast<size_t>(payload)),
+        _rate(rate),
+        _warmup(warmup)
+    {
+    }
+
+    virtual void
+    run()
+    {
+        try
+        {
+            Ice::CommunicatorPtr communicator = _publisher->ice_getCommunicator();
+            const Ice::ByteSeq payload(_payload);
+            const IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+            vector<Byte> inParams;
+            vector<Byte> outParams;
+            for(int i = 0; i < _events; ++i)
+            {
+                IceUtil::Time now = IceUtil::Time::now(IceUtil::Time::Monotonic);
+                if(_rate > 0)
+                {
+                    IceUtil::Time next = start + IceUtil::Time::microSeconds(static_cast<Ice::Long>(i) * 1000000 / _rate);
+                    if(next > now)
+                    {
+                        IceUtil::ThreadControl::sleep(next - now);
+                        now = IceUtil::Time::now(IceUtil::Time::Monotonic);
+                    }
+                }
+
+                Ice::OutputStream out(communicator);
+                out.startEncapsulation();
+                out.write(_warmup ? static_cast<Ice::Long>(-1) : now.toMicroSeconds());
+                out.write(payload);
+                out.endEncapsulation();
+                out.finished(inParams);
+                _publisher->ice_invoke("event", Normal, inParams, outParams);
+            }
+        }
+        catch(const Ice::Exception& ex)
+        {
+            ostringstream os;
+            os << ex;
+            _error = os.str();
+        }
+    }
+
+    string
+    error() const
+    {
+        return _error;
+    }
+
+private:
+
+    const ObjectPrx _publisher;
+    const int _events;
+    const size_t _payload;
+    const int _rate;
+    const bool _warmup;
+    string _error;
+};
+typedef IceUtil::Handle<PublisherThread> PublisherThreadPtr;
+
+void
+publish(const vector<ObjectPrx>& publishers, int events, int payload, int rate, bool warmup)
+{
+    vector<PublisherThreadPtr> threads;
+    vector<IceUtil::ThreadControl> controls;
+    for(vector<ObjectPrx>::const_iterator p = publishers.begin(); p != publishers.end(); ++p)
+    {
+        PublisherThreadPtr thread = new PublisherThread(*p, events, payload, rate, warmup);
+        controls.push_back(thread->start());
+        threads.push_back(thread);
+    }
+    for(vector<IceUtil::ThreadControl>::iterator p = controls.begin(); p != controls.end(); ++p)
+    {
+        p->join();
+    }
+    for(vector<PublisherThreadPtr>::const_iterator p = threads.begin(); p != threads.end(); ++p)
+    {
+        if(!(*p)->error().empty())
+        {
+            throw runtime_error("publisher failed:\n" + (*p)->error());
+        }
+    }
+}
+
+//
+// The CPU time in seconds used by the given processes, or -1 if it isn't
+// available.
+//
+double
+cpuTime(const vector<string>& pids)
+{
+#ifdef __linux__
+    if(pids.empty())
+    {
+        return -1;
+    }
+
+    double total = 0;
+    for(vector<string>::const_iterator p = pids.begin(); p != pids.end(); ++p)
+    {
+        ifstream is(("/proc/" + *p + "/stat").c_str());
+        string line;
+        if(!getline(is, line) || line.rfind(')') == string::npos)
+        {
+            return -1;
+        }
+
+        //
+        // The user and system times are the 12th and 13th fields after the
+        // command name.
+        //
+        istringstream fields(line.substr(line.rfind(')') + 1));
+        string field;
+        for(int i = 0; i < 11; ++i)
+        {
+            fields >> field;
+        }
+        double utime;
+        double stime;
+        if(!(fields >> utime >> stime))
+        {
+            return -1;
+        }
+        total += (utime + stime) / static_cast<double>(sysconf(_SC_CLK_TCK));
+    }
+    return total;
+#else
+    return -1;
+#endif
+}
+
+string
+jsonString(const string& s)
+{
+    ostringstream os;
+    os << '"';
+    for(string::const_iterator p = s.begin(); p != s.end(); ++p)
+    {
+        if(*p == '"' || *p == '\\')
+        {
+            os << '\\' << *p;
+        }
+        else if(static_cast<unsigned char>(*p) < 0x20)
+        {
+            os << "\\u00" << "0123456789abcdef"[(*p >> 4) & 0xf] << "0123456789abcdef"[*p & 0xf];
+        }
+        else
+        {
+            os << *p;
+        }
+    }
+    os << '"';
+    return os.str();
+}
+
+Ice::Long
+percentile(const vector<Ice::Long>& sorted, double q)
+{
+    if(sorted.empty())
+    {
+        return -1;
+    }
+    return sorted[min(sorted.size() - 1, static_cast<size_t>(q * static_cast<double>(sorted.size())))];
+}
+
+}
+
+class Client : public Test::TestHelper
+{
+public:
+
+    void run(int, char**);
+};
+
+void
+Client::run(int argc, char** argv)
+{
+    Ice::CommunicatorHolder communicator = initialize(argc, argv);
+    IceUtilInternal::Options opts;
+    opts.addOpt("", "label", IceUtilInternal::Options::NeedArg, "");
+    opts.addOpt("", "publishers", IceUtilInternal::Options::NeedArg, "1");
+    opts.addOpt("", "subscribers", IceUtilInternal::Options::NeedArg, "1");
+    opts.addOpt("", "events", IceUtilInternal::Options::NeedArg, "10000");
+    opts.addOpt("", "warmup", IceUtilInternal::Options::NeedArg, "1000");
+    opts.addOpt("", "payload", IceUtilInternal::Options::NeedArg, "0");
+    opts.addOpt("", "rate", IceUtilInternal::Options::NeedArg, "0");
+    opts.addOpt("", "publish-mode", IceUtilInternal::Options::NeedArg, "oneway");
+    opts.addOpt("", "subscriber-mode", IceUtilInternal::Options::NeedArg, "oneway");
+    opts.addOpt("", "qos", IceUtilInternal::Options::NeedArg, "", IceUtilInternal::Options::Repeat);
+    opts.addOpt("", "broker-pid", IceUtilInternal::Options::NeedArg, "", IceUtilInternal::Options::Repeat);
+    opts.addOpt("", "timeout", IceUtilInternal::Options::NeedArg, "60");
+    opts.addOpt("", "output", IceUtilInternal::Options::NeedArg);
+
+    try
+    {
+        opts.parse(argc, (const char**)argv);
+    }
+    catch(const IceUtilInternal::BadOptException& e)
+    {
+        ostringstream os;
+        os << argv[0] << ": error: " << e.reason;
+        throw invalid_argument(os.str());
+    }
+
+    const int publisherCount = atoi(opts.optArg("publishers").c_str());
+    const int subscriberCount = atoi(opts.optArg("subscribers").c_str());
+    const int events = atoi(opts.optArg("events").c_str());
+    const int warmup = atoi(opts.optArg("warmup").c_str());
+    const int payload = atoi(opts.optArg("payload").c_str());
+    const int rate = atoi(opts.optArg("rate").c_str());
+    const IceUtil::Time timeout = IceUtil::Time::seconds(atoi(opts.optArg("timeout").c_str()));
+    const string publishMode = opts.optArg("publish-mode");
+    const string subscriberMode = opts.optArg("subscriber-mode");
+    if(publisherCount <= 0 || subscriberCount <= 0 || events <= 0 || warmup < 0 || payload < 0 || rate < 0)
+    {
+        ostringstream os;
+        os << argv[0] << ": error: invalid number of publishers, subscribers or events, payload or rate";
+        throw invalid_argument(os.str());
+    }
+    if(publishMode != "oneway" && publishMode != "twoway")
+    {
+        ostringstream os;
+        os << argv[0] << ": error: invalid publish mode `" << publishMode << "'";
+        throw invalid_argument(os.str());
+    }
+    if(subscriberMode != "oneway" && subscriberMode != "twoway" && subscriberMode != "batch")
+    {
+        ostringstream os;
+        os << argv[0] << ": error: invalid subscriber mode `" << subscriberMode << "'";
+        throw invalid_argument(os.str());
+    }
+
+    QoS qos;
+    vector<string> qosArgs = opts.argVec("qos");
+    for(vector<string>::const_iterator p = qosArgs.begin(); p != qosArgs.end(); ++p)
+    {
+        string::size_type pos = p->find('=');
+        if(pos == string::npos)
+        {
+            ostringstream os;
+            os << argv[0] << ": error: invalid QoS `" << *p << "' (key=value required)";
+            throw invalid_argument(os.str());
+        }
+        qos[p->substr(0, pos)] = p->substr(pos + 1);
+    }
+
+    PropertiesPtr properties = communicator->getProperties();
+    string managerProxy = properties->getProperty("IceStormAdmin.TopicManager.Default");
+    if(managerProxy.empty())
+    {
+        ostringstream os;
+        os << argv[0] << ": property `IceStormAdmin.TopicManager.Default' is not set";
+        throw invalid_argument(os.str());
+    }
+
+    TopicManagerPrx manager = TopicManagerPrx::checkedCast(communicator->stringToProxy(managerProxy));
+    if(!manager)
+    {
+        ostringstream os;
+        os << argv[0] << ": `" << managerProxy << "' is not running";
+        throw invalid_argument(os.str());
+    }
+
+    //
+    // Each run uses its own topic: a transient service keeps the destroyed
+    // topics.
+    //
+    TopicPrx topic = manager->create("bench." + IceUtil::generateUUID());
+
+    ResultsPtr results = new Results();
+    ObjectAdapterPtr adapter = communicator->createObjectAdapterWithEndpoints("BenchAdapter", "default");
+    adapter->activate();
+    for(int i = 0; i < subscriberCount; ++i)
+    {
+        ObjectPrx subscriber = adapter->addWithUUID(new SubscriberI(results));
+        if(subscriberMode == "oneway")
+        {
+            subscriber = subscriber->ice_oneway();
+        }
+        else if(subscriberMode == "batch")
+        {
+            subscriber = subscriber->ice_batchOneway();
+        }
+        topic->subscribeAndGetPublisher(qos, subscriber);
+    }
+
+    //
+    // Each publisher has its own connection to the service.
+    //
+    vector<ObjectPrx> publishers;
+    ObjectPrx publisher = topic->getPublisher();
+    for(int i = 0; i < publisherCount; ++i)
+    {
+        ostringstream os;
+        os << "publisher" << i;
+        ObjectPrx p = publisher->ice_connectionId(os.str());
+        publishers.push_back(publishMode == "twoway" ? p->ice_twoway() : p->ice_oneway());
+    }
+
+    if(warmup > 0)
+    {
+        publish(publishers, warmup, payload, rate, true);
+        results->waitForEvents(static_cast<Ice::Long>(warmup) * publisherCount * subscriberCount, timeout);
+    }
+    results->reset();
+
+    const vector<string> brokerPids = opts.argVec("broker-pid");
+    const double cpuStart = cpuTime(brokerPids);
+    const IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+
+    publish(publishers, events, payload, rate, false);
+    const Ice::Long published = static_cast<Ice::Long>(events) * publisherCount;
+    const double publishTime = (IceUtil::Time::now(IceUtil::Time::Monotonic) - start).toSecondsDouble();
+
+    const Ice::Long delivered = results->waitForEvents(published * subscriberCount, timeout);
+    const double elapsed = (IceUtil::Time::now(IceUtil::Time::Monotonic) - start).toSecondsDouble();
+    const double cpuEnd = cpuTime(brokerPids);
+
+    vector<Ice::Long> latencies = results->latencies();
+    sort(latencies.begin(), latencies.end());
+
+    ostringstream os;
+    os << "{\"label\": " << jsonString(opts.optArg("label"))
+       << ", \"publishers\": " << publisherCount
+       << ", \"subscribers\": " << subscriberCount
+       << ", \"payload\": " << payload
+       << ", \"rate\": " << rate
+       << ", \"publishMode\": " << jsonString(publishMode)
+       << ", \"subscriberMode\": " << jsonString(subscriberMode)
+       << ", \"qos\": {";
+    for(QoS::const_iterator p = qos.begin(); p != qos.end(); ++p)
+    {
+        os << (p == qos.begin() ? "" : ", ") << jsonString(p->first) << ": " << jsonString(p->second);
+    }
+    os << "}"
+       << ", \"published\": " << published
+       << ", \"delivered\": " << delivered
+       << ", \"lost\": " << published * subscriberCount - delivered
+       << ", \"elapsed\": " << elapsed
+       << ", \"publishedPerSecond\": " << static_cast<double>(published) / max(publishTime, 0.000001)
+       << ", \"deliveredPerSecond\": " << static_cast<double>(delivered) / max(elapsed, 0.000001)
+       << ", \"latency\": {\"p50\": " << percentile(latencies, 0.5)
+       << ", \"p99\": " << percentile(latencies, 0.99)
+       << ", \"p999\": " << percentile(latencies, 0.999)
+       << ", \"max\": " << (latencies.empty() ? -1 : latencies.back())
+       << "}, \"brokerCpuPerEvent\": ";
+    if(cpuStart < 0 || cpuEnd < 0)
+    {
+        os << "null";
+    }
+    else
+    {
+        // In microseconds per published event.
+        os << (cpuEnd - cpuStart) * 1000000 / static_cast<double>(published);
+    }
+    os << "}";
+
+    cout << os.str() << endl;
+    if(!opts.optArg("output").empty())
+    {
+        ofstream out(opts.optArg("output").c_str(), ios_base::app);
+        if(!out)
+        {
+            ostringstream err;
+            err << argv[0] << ": error: cannot open `" << opts.optArg("output") << "'";
+            throw invalid_argument(err.str());
+        }
+        out << os.str() << endl;
+    }
+
+    topic->destroy();
+}
+
+DEFINE_TEST(Client)
@@ -0,0 +1,76 @@
+# -*- coding: utf-8 -*-
+#
+# Copyright (c) ZeroC, Inc. All rights reserved.
+#
+
+import os
+
+#
+# Benchmarks the delivery of events by transient, persistent and replicated
+# IceStorm services. Each run prints a JSON object with the throughput, the
+# latency percentiles in microseconds and the CPU time of the service in
+# microseconds per published event. Set the BENCH_OUTPUT environment
+# variable to also append the results to a file.
+#
+# The benchmark doesn't check anything, it only runs when it's selected with
+# --filter=IceStorm/bench or when BENCH_OUTPUT is set.
+#
+props = {
+    "IceStorm.Election.MasterTimeout" : 2,
+    "IceStorm.Election.ElectionTimeout" : 2,
+    "IceStorm.Election.ResponseTimeout" : 2
+}
+
+persistent = IceStorm(props = props)
+transient = IceStorm(props = props, transient=True)
+replicated = [ IceStorm(replica=i, nreplicas=3, props = props) for i in range(0,3) ]
+
+runs = [
+    [],
+    ["--subscribers", "10"],
+    ["--payload", "1024"],
+    ["--subscribers", "10", "--payload", "4096"],
+    ["--publishers", "4", "--subscribers", "4"],
+    ["--subscriber-mode", "twoway", "--qos", "reliability=ordered"],
+    ["--subscriber-mode", "batch"],
+    ["--rate", "1000", "--events", "2000"],
+]
+
+class BenchClient(IceStormProcess, Client):
+
+    processType = "client"
+
+    def __init__(self, instanceName=None, instance=None, *args, **kargs):
+        Client.__init__(self, *args, **kargs)
+        IceStormProcess.__init__(self, instanceName, instance)
+
+    getParentProps = Client.getProps # Used by IceStormProcess to get the client properties
+
+class IceStormBenchTestCase(IceStormTestCase):
+
+    def canRun(self, current):
+        return "BENCH_OUTPUT" in os.environ or \
+            any("IceStorm/bench" in f.pattern for f in current.driver.filters)
+
+    def runClientSide(self, current):
+        args = ["--label", self.name]
+        if os.environ.get("BENCH_OUTPUT"):
+            args += ["--output", os.environ["BENCH_OUTPUT"]]
+
+        # The CPU time of the service can only be measured for local processes
+        for icestorm in self.icestorm:
+            process = current.processes.get(icestorm)
+            if getattr(process, "p", None):
+                args += ["--broker-pid", str(process.p.pid)]
+
+        for run in runs:
+            BenchClient(args=args + run).run(current)
+
+    def teardownClientSide(self, current, success):
+        self.shutdown(current)
+
+TestSuite(__file__, [
+    IceStormBenchTestCase("transient", icestorm=transient),
+    IceStormBenchTestCase("persistent", icestorm=persistent),
+    IceStormBenchTestCase("replicated", icestorm=replicated),
+], options={ "ipv6" : [False] }, multihost=False, runOnMainThread=True)
@@ -0,0 +1,223 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <Ice/Ice.h>
+#include <IceStorm/IceStorm.h>
+#include <TestHelper.h>
+
+using namespace std;
+using namespace Ice;
+using namespace IceStorm;
+using namespace Test;
+
+namespace
+{
+
+//
+// Records the operation and the "id" context entry of the events it
+// receives.
+//
+class EventI : public Ice::Blobject, public IceUtil::Monitor<IceUtil::Mutex>
+{
+public:
+
+    virtual bool
+    ice_invoke(const vector<Byte>&, vector<Byte>&, const Current& current)
+    {
+        Lock sync(*this);
+        Context::const_iterator p = current.ctx.find("id");
+        _events.push_back(current.operation + (p != current.ctx.end() ? p->second : string()));
+        notifyAll();
+        return true;
+    }
+
+    vector<string>
+    waitForEvents(size_t count)
+    {
+        Lock sync(*this);
+        IceUtil::Time timeout = IceUtil::Time::now(IceUtil::Time::Monotonic) + IceUtil::Time::seconds(30);
+        while(_events.size() < count)
+        {
+            IceUtil::Time now = IceUtil::Time::now(IceUtil::Time::Monotonic);
+            if(now >= timeout || !timedWait(timeout - now))
+            {
+                break;
+            }
+        }
+        return _events;
+    }
+
+private:
+
+    vector<string> _events;
+};
+typedef IceUtil::Handle<EventI> EventIPtr;
+
+void
+publish(const CommunicatorPtr& communicator, const ObjectPrx& publisher, const string& operation,
+        const string& region, Int priority, const string& name, const string& id)
+{
+    OutputStream out(communicator);
+    out.startEncapsulation();
+    out.write(priority);
+    out.write(name);
+    out.endEncapsulation();
+
+    Context ctx;
+    ctx["region"] = region;
+    ctx["id"] = id;
+
+    vector<Byte> outParams;
+    test(publisher->ice_invoke(operation, Normal, out.finished(), outParams, ctx));
+}
+
+void
+testEvents(const vector<string>& events, const string& expected)
+{
+    //
+    // The expected events are the concatenation of their operation and id.
+    //
+    string received;
+    for(vector<string>::const_iterator p = events.begin(); p != events.end(); ++p)
+    {
+        received += *p;
+    }
+    test(received == expected);
+}
+
+}
+
+class Client : public Test::TestHelper
+{
+public:
+
+    void run(int, char**);
+};
+
+void
+Client::run(int argc, char** argv)
+{
+    Ice::CommunicatorHolder communicator = initialize(argc, argv);
+    PropertiesPtr properties = communicator->getProperties();
+    string managerProxy = properties->getProperty("IceStormAdmin.TopicManager.Default");
+    if(managerProxy.empty())
+    {
+        ostringstream os;
+        os << argv[0] << ": property `IceStormAdmin.TopicManager.Default' is not set";
+        throw invalid_argument(os.str());
+    }
+
+    TopicManagerPrx manager = TopicManagerPrx::checkedCast(communicator->stringToProxy(managerProxy));
+    if(!manager)
+    {
+        ostringstream os;
+        os << argv[0] << ": `" << managerProxy << "' is not running";
+        throw invalid_argument(os.str());
+    }
+
+    ObjectAdapterPtr adapter = communicator->createObjectAdapterWithEndpoints("FilterAdapter", "default");
+    adapter->activate();
+
+    TopicPrx topic = manager->create("filter");
+    ObjectPrx publisher = topic->getPublisher()->ice_twoway();
+
+    QoS qos;
+    qos["reliability"] = "ordered";
+
+    cout << "testing filters... " << flush;
+    {
+        EventIPtr all = new EventI();
+        topic->subscribeAndGetPublisher(qos, adapter->addWithUUID(all));
+
+        EventIPtr operations = new EventI();
+        QoS operationsQoS = qos;
+        operationsQoS["filter.operations"] = "a, c";
+        topic->subscribeAndGetPublisher(operationsQoS, adapter->addWithUUID(operations));
+
+        EventIPtr context = new EventI();
+        QoS contextQoS = qos;
+        contextQoS["filter.context.region"] = "eu";
+        topic->subscribeAndGetPublisher(contextQoS, adapter->addWithUUID(context));
+
+        EventIPtr params = new EventI();
+        QoS paramsQoS = qos;
+        paramsQoS["filter.params"] = "int, string";
+        paramsQoS["filter.param.0"] = "2";
+        paramsQoS["filter.param.1"] = "x";
+        topic->subscribeAndGetPublisher(paramsQoS, adapter->addWithUUID(params));
+
+        EventIPtr combined = new EventI();
+        QoS combinedQoS = qos;
+        combinedQoS["filter.operations"] = "b";
+        combinedQoS["filter.context.region"] = "us";
+        combinedQoS["filter.params"] = "int";
+        combinedQoS["filter.param.0"] = "1";
+        topic->subscribeAndGetPublisher(combinedQoS, adapter->addWithUUID(combined));
+
+        publish(communicator.communicator(), publisher, "a", "eu", 1, "x", "1");
+        publish(communicator.communicator(), publisher, "b", "us", 2, "x", "2");
+        publish(communicator.communicator(), publisher, "c", "us", 2, "y", "3");
+        publish(communicator.communicator(), publisher, "b", "eu", 2, "x", "4");
+        publish(communicator.communicator(), publisher, "b", "us", 1, "z", "5");
+
+        //
+        // The subscribers receive the events in order, the last event
+        // published is received once all the events are delivered.
+        //
+        testEvents(all->waitForEvents(5), "a1b2c3b4b5");
+        testEvents(operations->waitForEvents(2), "a1c3");
+        testEvents(context->waitForEvents(2), "a1b4");
+        testEvents(params->waitForEvents(2), "b2b4");
+        testEvents(combined->waitForEvents(1), "b5");
+
+        IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(200));
+        testEvents(operations->waitForEvents(0), "a1c3");
+        testEvents(context->waitForEvents(0), "a1b4");
+        testEvents(params->waitForEvents(0), "b2b4");
+        testEvents(combined->waitForEvents(0), "b5");
+    }
+    cout << "ok" << endl;
+
+    cout << "testing invalid filters... " << flush;
+    {
+        const char* invalid[][2] =
+        {
+            { "filter.operations", "" },
+            { "filter.params", "int, unknown" },
+            { "filter.param.0", "1" },
+            { "filter.unknown", "1" }
+        };
+
+        for(size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i)
+        {
+            QoS invalidQoS;
+            invalidQoS[invalid[i][0]] = invalid[i][1];
+            try
+            {
+                topic->subscribeAndGetPublisher(invalidQoS, adapter->addWithUUID(new EventI()));
+                test(false);
+            }
+            catch(const BadQoS&)
+            {
+            }
+        }
+
+        QoS invalidQoS;
+        invalidQoS["filter.params"] = "int";
+        invalidQoS["filter.param.1"] = "1";
+        try
+        {
+            topic->subscribeAndGetPublisher(invalidQoS, adapter->addWithUUID(new EventI()));
+            test(false);
+        }
+        catch(const BadQoS&)
+        {
+        }
+    }
+    cout << "ok" << endl;
+
+    topic->destroy();
+}
+
+DEFINE_TEST(Client)
@@ -0,0 +1,25 @@
+# -*- coding: utf-8 -*-
+#
+# Copyright (c) ZeroC, Inc. All rights reserved.
+#
+
+icestorm = IceStorm()
+
+class FilterClient(IceStormProcess, Client):
+
+    processType = "client"
+
+    def __init__(self, instanceName=None, instance=None, *args, **kargs):
+        Client.__init__(self, *args, **kargs)
+        IceStormProcess.__init__(self, instanceName, instance)
+
+    getParentProps = Client.getProps # Used by IceStormProcess to get the client properties
+
+class IceStormFilterTestCase(IceStormTestCase):
+
+    def teardownClientSide(self, current, success):
+        self.shutdown(current)
+
+TestSuite(__file__, [
+    IceStormFilterTestCase("filter", icestorm=icestorm, client=ClientTestCase(client=FilterClient(instance=icestorm))),
+], multihost=False)
@@ -0,0 +1,213 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <Ice/Ice.h>
+#include <IceStorm/IceStorm.h>
+#include <TestHelper.h>
+
+using namespace std;
+using namespace Ice;
+using namespace IceStorm;
+using namespace Test;
+
+namespace
+{
+
+//
+// Records the number of the events it receives, the events are not
+// dispatched until the subscriber is released.
+//
+class EventI : public Ice::Blobject, public IceUtil::Monitor<IceUtil::Mutex>
+{
+public:
+
+    EventI() :
+        _released(false)
+    {
+    }
+
+    virtual bool
+    ice_invoke(const vector<Byte>&, vector<Byte>&, const Current& current)
+    {
+        Lock sync(*this);
+        while(!_released)
+        {
+            wait();
+        }
+
+        int n = 0;
+        Context::const_iterator p = current.ctx.find("n");
+        if(p != current.ctx.end())
+        {
+            n = atoi(p->second.c_str());
+        }
+        _events.push_back(n);
+        notifyAll();
+        return true;
+    }
+
+    void
+    release()
+    {
+        Lock sync(*this);
+        _released = true;
+        notifyAll();
+    }
+
+    vector<int>
+    waitForEvent(int n)
+    {
+        Lock sync(*this);
+        IceUtil::Time timeout = IceUtil::Time::now(IceUtil::Time::Monotonic) + IceUtil::Time::seconds(30);
+        while(_events.empty() || _events.back() != n)
+        {
+            IceUtil::Time now = IceUtil::Time::now(IceUtil::Time::Monotonic);
+            if(now >= timeout || !timedWait(timeout - now))
+            {
+                break;
+            }
+        }
+        return _events;
+    }
+
+private:
+
+    bool _released;
+    vector<int> _events;
+};
+typedef IceUtil::Handle<EventI> EventIPtr;
+
+void
+publish(const ObjectPrx& publisher, int count)
+{
+    //
+    // Events of about 8KB.
+    //
+    OutputStream out(publisher->ice_getCommunicator());
+    out.startEncapsulation();
+    out.write(vector<Byte>(8 * 1024));
+    out.endEncapsulation();
+    vector<Byte> inParams;
+    out.finished(inParams);
+
+    vector<Byte> outParams;
+    for(int i = 1; i <= count; ++i)
+    {
+        Context ctx;
+        ostringstream os;
+        os << i;
+        ctx["n"] = os.str();
+        test(publisher->ice_invoke("event", Normal, inParams, outParams, ctx));
+    }
+}
+
+void
+testEvents(const vector<int>& events, int last, size_t max)
+{
+    //
+    // The events are received in order, the most recent events are kept.
+    //
+    test(!events.empty() && events.size() <= max && events.back() == last);
+    for(size_t i = 1; i < events.size(); ++i)
+    {
+        test(events[i - 1] < events[i]);
+    }
+}
+
+}
+
+class Client : public Test::TestHelper
+{
+public:
+
+    void run(int, char**);
+};
+
+void
+Client::run(int argc, char** argv)
+{
+    Ice::CommunicatorHolder communicator = initialize(argc, argv);
+    PropertiesPtr properties = communicator->getProperties();
+    string managerProxy = properties->getProperty("IceStormAdmin.TopicManager.Default");
+    if(managerProxy.empty())
+    {
+        ostringstream os;
+        os << argv[0] << ": property `IceStormAdmin.TopicManager.Default' is not set";
+        throw invalid_argument(os.str());
+    }
+
+    TopicManagerPrx manager = TopicManagerPrx::checkedCast(communicator->stringToProxy(managerProxy));
+    if(!manager)
+    {
+        ostringstream os;
+        os << argv[0] << ": `" << managerProxy << "' is not running";
+        throw invalid_argument(os.str());
+    }
+
+    ObjectAdapterPtr adapter = communicator->createObjectAdapterWithEndpoints("MemoryAdapter", "default");
+    adapter->activate();
+
+    TopicPrx topic = manager->create("memory");
+    ObjectPrx publisher = topic->getPublisher()->ice_twoway();
+
+    QoS qos;
+    qos["reliability"] = "ordered";
+
+    cout << "testing subscriber memory limit... " << flush;
+    {
+        //
+        // The first event is sent to the subscriber and the next events
+        // are queued, 7 events fit in 64KB.
+        //
+        EventIPtr subscriber = new EventI();
+        ObjectPrx proxy = adapter->addWithUUID(subscriber);
+        topic->subscribeAndGetPublisher(qos, proxy);
+
+        publish(publisher, 50);
+        subscriber->release();
+        testEvents(subscriber->waitForEvent(50), 50, 1 + 7);
+        topic->unsubscribe(proxy);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing service memory limit... " << flush;
+    {
+        //
+        // The subscribers are subscribed to different topics, an event
+        // queued for several subscribers of a topic is only counted once.
+        //
+        TopicPrx topic2 = manager->create("memory2");
+        ObjectPrx publisher2 = topic2->getPublisher()->ice_twoway();
+
+        EventIPtr subscriber1 = new EventI();
+        ObjectPrx proxy1 = adapter->addWithUUID(subscriber1);
+        topic->subscribeAndGetPublisher(qos, proxy1);
+
+        EventIPtr subscriber2 = new EventI();
+        ObjectPrx proxy2 = adapter->addWithUUID(subscriber2);
+        topic2->subscribeAndGetPublisher(qos, proxy2);
+
+        //
+        // The oldest events queued for the subscribers are evicted once
+        // more than 96KB of events are queued, 11 events fit in 96KB.
+        //
+        publish(publisher, 50);
+        publish(publisher2, 50);
+        subscriber1->release();
+        subscriber2->release();
+        vector<int> events1 = subscriber1->waitForEvent(50);
+        vector<int> events2 = subscriber2->waitForEvent(50);
+        testEvents(events1, 50, 1 + 7);
+        testEvents(events2, 50, 1 + 7);
+        test(events1.size() + events2.size() <= 2 + 11);
+        topic->unsubscribe(proxy1);
+        topic2->unsubscribe(proxy2);
+        topic2->destroy();
+    }
+    cout << "ok" << endl;
+
+    topic->destroy();
+}
+
+DEFINE_TEST(Client)
@@ -0,0 +1,36 @@
+# -*- coding: utf-8 -*-
+#
+# Copyright (c) ZeroC, Inc. All rights reserved.
+#
+
+#
+# The queue of a subscriber is limited to 64KB and the queues of all the
+# subscribers to 96KB.
+#
+props = {
+    "IceStorm.Send.QueueMemoryMax" : 64,
+    "IceStorm.Send.QueueSizeMaxPolicy" : "DropEvents",
+    "IceStorm.Send.MemoryMax" : 96,
+    "IceStorm.Send.MemoryMaxPolicy" : "EvictOldest"
+}
+
+icestorm = IceStorm(props = props)
+
+class MemoryClient(IceStormProcess, Client):
+
+    processType = "client"
+
+    def __init__(self, instanceName=None, instance=None, *args, **kargs):
+        Client.__init__(self, *args, **kargs)
+        IceStormProcess.__init__(self, instanceName, instance)
+
+    getParentProps = Client.getProps # Used by IceStormProcess to get the client properties
+
+class IceStormMemoryTestCase(IceStormTestCase):
+
+    def teardownClientSide(self, current, success):
+        self.shutdown(current)
+
+TestSuite(__file__, [
+    IceStormMemoryTestCase("memory", icestorm=icestorm, client=ClientTestCase(client=MemoryClient(instance=icestorm))),
+], multihost=False)
@@ -0,0 +1,202 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <Ice/Ice.h>
+#include <IceStorm/IceStorm.h>
+#include <TestHelper.h>
+#include <set>
+
+using namespace std;
+using namespace Ice;
+using namespace IceStorm;
+using namespace Test;
+
+namespace
+{
+
+//
+// Counts the events it receives.
+//
+class EventI : public Ice::Blobject, public IceUtil::Monitor<IceUtil::Mutex>
+{
+public:
+
+    EventI() :
+        _count(0)
+    {
+    }
+
+    virtual bool
+    ice_invoke(const vector<Byte>&, vector<Byte>&, const Current&)
+    {
+        Lock sync(*this);
+        ++_count;
+        notifyAll();
+        return true;
+    }
+
+    int
+    waitForEvents(int count)
+    {
+        Lock sync(*this);
+        IceUtil::Time end = IceUtil::Time::now(IceUtil::Time::Monotonic) + IceUtil::Time::seconds(30);
+        while(_count < count)
+        {
+            IceUtil::Time now = IceUtil::Time::now(IceUtil::Time::Monotonic);
+            if(now >= end || !timedWait(end - now))
+            {
+                break;
+            }
+        }
+        return _count;
+    }
+
+private:
+
+    int _count;
+};
+typedef IceUtil::Handle<EventI> EventIPtr;
+
+}
+
+class Client : public Test::TestHelper
+{
+public:
+
+    void run(int, char**);
+};
+
+void
+Client::run(int argc, char** argv)
+{
+    Ice::CommunicatorHolder communicator = initialize(argc, argv);
+    PropertiesPtr properties = communicator->getProperties();
+    string managerProxy = properties->getProperty("IceStormAdmin.TopicManager.Default");
+    if(managerProxy.empty())
+    {
+        ostringstream os;
+        os << argv[0] << ": property `IceStormAdmin.TopicManager.Default' is not set";
+        throw invalid_argument(os.str());
+    }
+
+    TopicManagerPrx manager = TopicManagerPrx::checkedCast(communicator->stringToProxy(managerProxy));
+    if(!manager)
+    {
+        ostringstream os;
+        os << argv[0] << ": `" << managerProxy << "' is not running";
+        throw invalid_argument(os.str());
+    }
+
+    ObjectAdapterPtr adapter = communicator->createObjectAdapterWithEndpoints("PartitionAdapter", "default");
+    adapter->activate();
+
+    const int topicCount = 20;
+    vector<TopicPrx> topics;
+    for(int i = 0; i < topicCount; ++i)
+    {
+        ostringstream os;
+        os << "partition" << i;
+        topics.push_back(manager->create(os.str()));
+    }
+
+    cout << "testing topic partitioning... " << flush;
+    {
+        //
+        // Each topic is retrieved from the replica that owns it once the
+        // replicas know the other replicas of the group, the replicated
+        // proxy is returned meanwhile.
+        //
+        IceUtil::Time end = IceUtil::Time::now(IceUtil::Time::Monotonic) + IceUtil::Time::seconds(30);
+        for(int i = 0; i < topicCount; ++i)
+        {
+            topics[i] = manager->retrieve(topics[i]->getName());
+            while(topics[i]->ice_getEndpoints().size() != 1)
+            {
+                test(IceUtil::Time::now(IceUtil::Time::Monotonic) < end);
+                IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(100));
+                topics[i] = manager->retrieve(topics[i]->getName());
+            }
+        }
+
+        //
+        // The topics are assigned to several replicas.
+        //
+        set<string> owners;
+        for(int i = 0; i < topicCount; ++i)
+        {
+            const string owner = topics[i]->ice_getEndpoints()[0]->toString();
+            owners.insert(owner);
+
+            //
+            // The same owner is returned by all the replicas.
+            //
+            Ice::EndpointSeq endpoints = manager->ice_getEndpoints();
+            for(Ice::EndpointSeq::const_iterator p = endpoints.begin(); p != endpoints.end(); ++p)
+            {
+                Ice::EndpointSeq replicaEndpoints;
+                replicaEndpoints.push_back(*p);
+                TopicDict all = manager->ice_endpoints(replicaEndpoints)->retrieveAll();
+                TopicDict::const_iterator q = all.find(topics[i]->getName());
+                while(q == all.end() || q->second->ice_getEndpoints().size() != 1)
+                {
+                    test(IceUtil::Time::now(IceUtil::Time::Monotonic) < end);
+                    IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(100));
+                    all = manager->ice_endpoints(replicaEndpoints)->retrieveAll();
+                    q = all.find(topics[i]->getName());
+                }
+                test(q->second->ice_getEndpoints()[0]->toString() == owner);
+            }
+
+            //
+            // The publisher lists the endpoints of the owner first, followed
+            // by the endpoints of the other replicas for failover.
+            //
+            Ice::EndpointSeq publisher = topics[i]->getPublisher()->ice_getEndpoints();
+            Ice::EndpointSeq ownerPublisher = topics[i]->getNonReplicatedPublisher()->ice_getEndpoints();
+            test(publisher.size() > ownerPublisher.size());
+            for(size_t j = 0; j < ownerPublisher.size(); ++j)
+            {
+                test(publisher[j]->toString() == ownerPublisher[j]->toString());
+            }
+        }
+        test(owners.size() > 1);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing publishing to partitioned topics... " << flush;
+    {
+        vector<EventIPtr> subscribers;
+        for(int i = 0; i < topicCount; ++i)
+        {
+            EventIPtr subscriber = new EventI();
+            topics[i]->subscribeAndGetPublisher(QoS(), adapter->addWithUUID(subscriber));
+            subscribers.push_back(subscriber);
+        }
+
+        vector<Byte> inParams;
+        vector<Byte> outParams;
+        for(int i = 0; i < topicCount; ++i)
+        {
+            ObjectPrx publisher = topics[i]->getPublisher()->ice_endpointSelection(
+                ICE_ENUM(EndpointSelectionType, Ordered))->ice_twoway();
+            for(int j = 0; j < 10; ++j)
+            {
+                test(publisher->ice_invoke("event", Normal, inParams, outParams));
+            }
+        }
+
+        for(int i = 0; i < topicCount; ++i)
+        {
+            test(subscribers[i]->waitForEvents(10) == 10);
+        }
+    }
+    cout << "ok" << endl;
+
+    for(vector<TopicPrx>::const_iterator p = topics.begin(); p != topics.end(); ++p)
+    {
+        (*p)->destroy();
+    }
+}
+
+DEFINE_TEST(Client)
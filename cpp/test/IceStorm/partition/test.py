@@ -0,0 +1,36 @@
+# -*- coding: utf-8 -*-
+#
+# Copyright (c) ZeroC, Inc. All rights reserved.
+#
+
+#
+# The topics are partitioned across the 3 replicas.
+#
+props = {
+    "IceStorm.Partitioned" : 1,
+    "IceStorm.Election.MasterTimeout" : 2,
+    "IceStorm.Election.ElectionTimeout" : 2,
+    "IceStorm.Election.ResponseTimeout" : 2
+}
+
+icestorm = [ IceStorm(replica=i, nreplicas=3, props = props) for i in range(0,3) ]
+
+class PartitionClient(IceStormProcess, Client):
+
+    processType = "client"
+
+    def __init__(self, instanceName=None, instance=None, *args, **kargs):
+        Client.__init__(self, *args, **kargs)
+        IceStormProcess.__init__(self, instanceName, instance)
+
+    getParentProps = Client.getProps # Used by IceStormProcess to get the client properties
+
+class IceStormPartitionTestCase(IceStormTestCase):
+
+    def teardownClientSide(self, current, success):
+        self.shutdown(current)
+
+TestSuite(__file__,
+          [ IceStormPartitionTestCase("partitioned", icestorm=icestorm, client=ClientTestCase(client=PartitionClient())) ],
+          options={ "ipv6" : [False] },
+          multihost=False)
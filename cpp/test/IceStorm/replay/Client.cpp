@@ -0,0 +1,236 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <Ice/Ice.h>
+#include <IceStorm/IceStorm.h>
+#include <IceUtil/InputUtil.h>
+#include <TestHelper.h>
+
+using namespace std;
+using namespace Ice;
+using namespace IceStorm;
+using namespace Test;
+
+namespace
+{
+
+//
+// Records the sequence number of the events it receives.
+//
+class EventI : public Ice::Blobject, public IceUtil::Monitor<IceUtil::Mutex>
+{
+public:
+
+    virtual bool
+    ice_invoke(const vector<Byte>&, vector<Byte>&, const Current& current)
+    {
+        Lock sync(*this);
+        Long seq = -1;
+        Context::const_iterator p = current.ctx.find("IceStorm.Sequence");
+        if(p != current.ctx.end())
+        {
+            IceUtilInternal::stringToInt64(p->second, seq);
+        }
+        _events.push_back(seq);
+        notifyAll();
+        return true;
+    }
+
+    vector<Long>
+    waitForEvents(size_t count)
+    {
+        Lock sync(*this);
+        IceUtil::Time timeout = IceUtil::Time::now(IceUtil::Time::Monotonic) + IceUtil::Time::seconds(30);
+        while(_events.size() < count)
+        {
+            IceUtil::Time now = IceUtil::Time::now(IceUtil::Time::Monotonic);
+            if(now >= timeout || !timedWait(timeout - now))
+            {
+                break;
+            }
+        }
+        return _events;
+    }
+
+private:
+
+    vector<Long> _events;
+};
+typedef IceUtil::Handle<EventI> EventIPtr;
+
+void
+publish(const ObjectPrx& publisher, int count)
+{
+    vector<Byte> inParams;
+    vector<Byte> outParams;
+    for(int i = 0; i < count; ++i)
+    {
+        //
+        // Twoway invocations return once the event is logged.
+        //
+        test(publisher->ice_invoke("event", Normal, inParams, outParams));
+    }
+}
+
+void
+testEvents(const vector<Long>& events, Long first, Long last)
+{
+    test(static_cast<Long>(events.size()) == last - first + 1);
+    for(size_t i = 0; i < events.size(); ++i)
+    {
+        test(events[i] == first + static_cast<Long>(i));
+    }
+}
+
+}
+
+class Client : public Test::TestHelper
+{
+public:
+
+    void run(int, char**);
+};
+
+void
+Client::run(int argc, char** argv)
+{
+    Ice::CommunicatorHolder communicator = initialize(argc, argv);
+    PropertiesPtr properties = communicator->getProperties();
+    string managerProxy = properties->getProperty("IceStormAdmin.TopicManager.Default");
+    if(managerProxy.empty())
+    {
+        ostringstream os;
+        os << argv[0] << ": property `IceStormAdmin.TopicManager.Default' is not set";
+        throw invalid_argument(os.str());
+    }
+
+    TopicManagerPrx manager = TopicManagerPrx::checkedCast(communicator->stringToProxy(managerProxy));
+    if(!manager)
+    {
+        ostringstream os;
+        os << argv[0] << ": `" << managerProxy << "' is not running";
+        throw invalid_argument(os.str());
+    }
+
+    ObjectAdapterPtr adapter = communicator->createObjectAdapterWithEndpoints("ReplayAdapter", "default");
+    adapter->activate();
+
+    TopicPrx topic = manager->create("replay");
+    ObjectPrx publisher = topic->getPublisher()->ice_twoway();
+
+    //
+    // The replayed events are delivered in order to ordered subscribers.
+    //
+    QoS qos;
+    qos["reliability"] = "ordered";
+
+    cout << "testing replay from a sequence number... " << flush;
+    {
+        publish(publisher, 10);
+
+        EventIPtr subscriber = new EventI();
+        QoS replayQoS = qos;
+        replayQoS["replayFrom"] = "4";
+        topic->subscribeAndGetPublisher(replayQoS, adapter->addWithUUID(subscriber));
+        testEvents(subscriber->waitForEvents(6), 4, 9);
+
+        //
+        // The events published after the subscription follow the replayed
+        // events.
+        //
+        publish(publisher, 2);
+        testEvents(subscriber->waitForEvents(8), 4, 11);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing replay from a time... " << flush;
+    {
+        EventIPtr subscriber = new EventI();
+        QoS replayQoS = qos;
+        replayQoS["replaySince"] = "0";
+        topic->subscribeAndGetPublisher(replayQoS, adapter->addWithUUID(subscriber));
+        testEvents(subscriber->waitForEvents(12), 0, 11);
+
+        IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(100));
+        ostringstream os;
+        os << IceUtil::Time::now().toMilliSeconds();
+        publish(publisher, 3);
+
+        subscriber = new EventI();
+        replayQoS["replaySince"] = os.str();
+        topic->subscribeAndGetPublisher(replayQoS, adapter->addWithUUID(subscriber));
+        testEvents(subscriber->waitForEvents(3), 12, 14);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing event log retention... " << flush;
+    {
+        //
+        // The event log is limited to 8KB, the oldest events are removed.
+        //
+        publish(publisher, 500);
+
+        //
+        // Wait for the events to be committed if the log is committed in
+        // the background, the events removed while replaying are skipped.
+        //
+        IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(200));
+
+        EventIPtr subscriber = new EventI();
+        QoS replayQoS = qos;
+        replayQoS["replayFrom"] = "0";
+        topic->subscribeAndGetPublisher(replayQoS, adapter->addWithUUID(subscriber));
+
+        IceUtil::ThreadControl::sleep(IceUtil::Time::seconds(1));
+        vector<Long> events = subscriber->waitForEvents(1);
+        test(!events.empty() && events.front() > 0);
+        testEvents(subscriber->waitForEvents(static_cast<size_t>(514 - events.front() + 1)), events.front(), 514);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing invalid replay... " << flush;
+    {
+        QoS replayQoS;
+        replayQoS["replayFrom"] = "abc";
+        try
+        {
+            topic->subscribeAndGetPublisher(replayQoS, adapter->addWithUUID(new EventI()));
+            test(false);
+        }
+        catch(const BadQoS&)
+        {
+        }
+
+        replayQoS["replayFrom"] = "0";
+        replayQoS["replaySince"] = "0";
+        try
+        {
+            topic->subscribeAndGetPublisher(replayQoS, adapter->addWithUUID(new EventI()));
+            test(false);
+        }
+        catch(const BadQoS&)
+        {
+        }
+
+        //
+        // The events of the other topics are not logged.
+        //
+        TopicPrx other = manager->create("other");
+        replayQoS.erase("replaySince");
+        try
+        {
+            other->subscribeAndGetPublisher(replayQoS, adapter->addWithUUID(new EventI()));
+            test(false);
+        }
+        catch(const BadQoS&)
+        {
+        }
+        other->destroy();
+    }
+    cout << "ok" << endl;
+
+    topic->destroy();
+}
+
+DEFINE_TEST(Client)
@@ -0,0 +1,44 @@
+# -*- coding: utf-8 -*-
+#
+# Copyright (c) ZeroC, Inc. All rights reserved.
+#
+
+#
+# The event log of the topic is limited to a few hundred events to check
+# that the oldest events are removed.
+#
+props = {
+    "IceStorm.EventLog.Topics" : "replay",
+    "IceStorm.EventLog.MaxSize" : 8,
+    "IceStorm.EventLog.ReplayBatchSize" : 5
+}
+
+icestorm = IceStorm(props = props)
+
+#
+# The same test with the event log committed in the background.
+#
+flushProps = dict(props)
+flushProps["IceStorm.EventLog.FlushInterval"] = 10
+flushIceStorm = IceStorm(props = flushProps)
+
+class ReplayClient(IceStormProcess, Client):
+
+    processType = "client"
+
+    def __init__(self, instanceName=None, instance=None, *args, **kargs):
+        Client.__init__(self, *args, **kargs)
+        IceStormProcess.__init__(self, instanceName, instance)
+
+    getParentProps = Client.getProps # Used by IceStormProcess to get the client properties
+
+class IceStormReplayTestCase(IceStormTestCase):
+
+    def teardownClientSide(self, current, success):
+        self.shutdown(current)
+
+TestSuite(__file__, [
+    IceStormReplayTestCase("replay", icestorm=icestorm, client=ClientTestCase(client=ReplayClient(instance=icestorm))),
+    IceStormReplayTestCase("replay with background commits", icestorm=flushIceStorm,
+                           client=ClientTestCase(client=ReplayClient(instance=flushIceStorm))),
+], multihost=False)
@@ -0,0 +1,154 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <IceUtil/IceUtil.h>
+#include <IceUtil/Options.h>
+#include <Ice/Ice.h>
+#include <IceStorm/IceStorm.h>
+#include <TestHelper.h>
+
+using namespace std;
+using namespace Ice;
+using namespace IceStorm;
+using namespace Test;
+
+namespace
+{
+
+//
+// Subscribes or unsubscribes a range of subscribers.
+//
+class SubscribeThread : public IceUtil::Thread
+{
+public:
+
+    SubscribeThread(const TopicPrx& topic, const vector<ObjectPrx>& subscribers, bool subscribe) :
+        _topic(topic),
+        _subscribers(subscribers),
+        _subscribe(subscribe)
+    {
+    }
+
+    virtual void
+    run()
+    {
+        for(vector<ObjectPrx>::const_iterator p = _subscribers.begin(); p != _subscribers.end(); ++p)
+        {
+            if(_subscribe)
+            {
+                _topic->subscribeAndGetPublisher(QoS(), *p);
+            }
+            else
+            {
+                _topic->unsubscribe(*p);
+            }
+        }
+    }
+
+private:
+
+    const TopicPrx _topic;
+    const vector<ObjectPrx> _subscribers;
+    const bool _subscribe;
+};
+
+void
+run(const TopicPrx& topic, const vector<ObjectPrx>& subscribers, int threads, bool subscribe)
+{
+    IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+
+    vector<IceUtil::ThreadControl> controls;
+    for(int i = 0; i < threads; ++i)
+    {
+        vector<ObjectPrx> range(subscribers.begin() + subscribers.size() * i / threads,
+                                subscribers.begin() + subscribers.size() * (i + 1) / threads);
+        IceUtil::ThreadPtr thread = new SubscribeThread(topic, range, subscribe);
+        controls.push_back(thread->start());
+    }
+    for(vector<IceUtil::ThreadControl>::iterator p = controls.begin(); p != controls.end(); ++p)
+    {
+        p->join();
+    }
+
+    IceUtil::Time elapsed = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+    cout << (subscribe ? "subscribe" : "unsubscribe") << ": " << subscribers.size() << " subscribers, "
+         << threads << " threads: " << elapsed.toMilliSeconds() << "ms, "
+         << static_cast<Ice::Long>(static_cast<double>(subscribers.size()) / max(elapsed.toSecondsDouble(), 0.001))
+         << " subscribers/s" << endl;
+}
+
+}
+
+class Client : public Test::TestHelper
+{
+public:
+
+    void run(int, char**);
+};
+
+void
+Client::run(int argc, char** argv)
+{
+    Ice::CommunicatorHolder communicator = initialize(argc, argv);
+    IceUtilInternal::Options opts;
+    opts.addOpt("", "subscribers", IceUtilInternal::Options::NeedArg, "1000");
+    opts.addOpt("", "threads", IceUtilInternal::Options::NeedArg, "10");
+
+    try
+    {
+        opts.parse(argc, (const char**)argv);
+    }
+    catch(const IceUtilInternal::BadOptException& e)
+    {
+        ostringstream os;
+        os << argv[0] << ": error: " << e.reason;
+        throw invalid_argument(os.str());
+    }
+
+    const int count = atoi(opts.optArg("subscribers").c_str());
+    const int threads = atoi(opts.optArg("threads").c_str());
+    if(count <= 0 || threads <= 0)
+    {
+        ostringstream os;
+        os << argv[0] << ": error: invalid number of subscribers or threads";
+        throw invalid_argument(os.str());
+    }
+
+    PropertiesPtr properties = communicator->getProperties();
+    string managerProxy = properties->getProperty("IceStormAdmin.TopicManager.Default");
+    if(managerProxy.empty())
+    {
+        ostringstream os;
+        os << argv[0] << ": property `IceStormAdmin.TopicManager.Default' is not set";
+        throw invalid_argument(os.str());
+    }
+
+    TopicManagerPrx manager = TopicManagerPrx::checkedCast(communicator->stringToProxy(managerProxy));
+    if(!manager)
+    {
+        ostringstream os;
+        os << argv[0] << ": `" << managerProxy << "' is not running";
+        throw invalid_argument(os.str());
+    }
+
+    TopicPrx topic = manager->retrieve("subscribe");
+
+    //
+    // The subscribers are not contacted, no events are published.
+    //
+    ObjectAdapterPtr adapter = communicator->createObjectAdapterWithEndpoints("SubscribeAdapter", "default");
+    vector<ObjectPrx> subscribers;
+    for(int i = 0; i < count; ++i)
+    {
+        subscribers.push_back(adapter->createProxy(stringToIdentity(IceUtil::generateUUID())));
+    }
+
+    ::run(topic, subscribers, threads, true);
+    test(static_cast<int>(topic->getSubscribers().size()) == count);
+
+    ::run(topic, subscribers, threads, false);
+    test(topic->getSubscribers().empty());
+}
+
+DEFINE_TEST(Client)
@@ -0,0 +1,44 @@
+# -*- coding: utf-8 -*-
+#
+# Copyright (c) ZeroC, Inc. All rights reserved.
+#
+
+#
+# Measures the throughput of the subscriptions to a replicated topic, the
+# updates of the subscribers are replicated to the other replicas.
+#
+props = {
+    "IceStorm.Election.MasterTimeout" : 2,
+    "IceStorm.Election.ElectionTimeout" : 2,
+    "IceStorm.Election.ResponseTimeout" : 2
+}
+
+icestorm = [ IceStorm(replica=i, nreplicas=3, props = props) for i in range(0,3) ]
+
+class SubscribeClient(IceStormProcess, Client):
+
+    processType = "client"
+
+    def __init__(self, instanceName=None, instance=None, *args, **kargs):
+        Client.__init__(self, *args, **kargs)
+        IceStormProcess.__init__(self, instanceName, instance)
+
+    getParentProps = Client.getProps # Used by IceStormProcess to get the client properties
+
+class IceStormRepSubscribeTestCase(IceStormTestCase):
+
+    def runClientSide(self, current):
+        current.write("creating topic... ")
+        self.runadmin(current, "create subscribe")
+        current.writeln("ok")
+
+        for threads in [1, 10, 50]:
+            SubscribeClient(args=["--subscribers", "1000", "--threads", str(threads)]).run(current)
+
+    def teardownClientSide(self, current, success):
+        self.shutdown(current)
+
+TestSuite(__file__,
+          [ IceStormRepSubscribeTestCase("replicated", icestorm=icestorm) ],
+          options={ "ipv6" : [False] },
+          multihost=False, runOnMainThread=True)
@@ -15,6 +15,14 @@ persistent = IceStorm(props = props)
 transient = IceStorm(props = props, transient=True)
 replicated = [ IceStorm(replica=i, nreplicas=3, props = props) for i in range(0,3) ]
 
+#
+# The events are queued to the subscribers by the publishing thread and two
+# delivery workers, each queues the events to a shard of the subscribers.
+#
+workersProps = dict(props)
+workersProps.update({ "IceStorm.Delivery.Workers" : 2, "IceStorm.Delivery.MinShardSize" : 1 })
+workers = IceStorm(props = workersProps)
+
 sub = Subscriber(args=["{testcase.parent.name}"], props = { "Ice.UDP.RcvSize" : 1024 * 1024 }, readyCount=3)
 pub = Publisher(args=["{testcase.parent.name}"])
 
@@ -31,4 +39,5 @@ TestSuite(__file__, [
     IceStormSingleTestCase("persistent", icestorm=persistent, client=ClientServerTestCase(client=pub, server=sub)),
     IceStormSingleTestCase("transient", icestorm=transient, client=ClientServerTestCase(client=pub, server=sub)),
     IceStormSingleTestCase("replicated", icestorm=replicated, client=ClientServerTestCase(client=pub, server=sub)),
+    IceStormSingleTestCase("workers", icestorm=workers, client=ClientServerTestCase(client=pub, server=sub)),
 ], multihost=False)
@@ -242,6 +242,40 @@ main(int argc, char* argv[])
         cout << "ok" << endl;
     }
 
+    {
+        cout << "testing mixed ASCII and non-ASCII strings... ";
+
+        //
+        // ASCII characters are converted in blocks, put the non-ASCII
+        // characters at every position around the block boundaries.
+        //
+        for(size_t size = 0; size < 70; ++size)
+        {
+            for(size_t pos = 0; pos <= size; ++pos)
+            {
+                wstring ws(size, L'a');
+                string ns(size, 'a');
+                for(size_t i = 0; i < size; ++i)
+                {
+                    ws[i] = static_cast<wchar_t>(L'a' + i % 26);
+                    ns[i] = static_cast<char>('a' + i % 26);
+                }
+                ws.insert(pos, L"\u20ac\u00e9");
+                ns.insert(pos, "\xE2\x82\xAC\xC3\xA9");
+                if(pos % 3 == 0)
+                {
+                    ws.append(L"\u00e9");
+                    ns.append("\xC3\xA9");
+                }
+
+                test(wstringToString(ws) == ns);
+                test(stringToWstring(ns) == ws);
+            }
+        }
+
+        cout << "ok" << endl;
+    }
+
 #ifdef TEST_PERF
     {
         // The only performance-critical code is the UnicodeWstringConverter
@@ -290,6 +324,9 @@ main(int argc, char* argv[])
             "\xf0\x28\x8c\x28",
             "\xf8\xa1\xa1\xa1\xa1",
             "\xfc\xa1\xa1\xa1\xa1\xa1",
+            "abcdefghijklmnopqrstuvwxyz\xc3\x28",
+            "abcdefghijklmnopqrstuvwxyz\xe2\x82",
+            "\xf4\x7b\xbf\xbf",
             ""
         };
 
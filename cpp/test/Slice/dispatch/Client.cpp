@@ -0,0 +1,469 @@
+//
+// Copyright (c) ZeroC, Inc. All rights reserved.
+//
+
+#include <Ice/Ice.h>
+#include <TestHelper.h>
+#include <Test.h>
+
+using namespace std;
+
+namespace
+{
+
+class DerivedI : public Test::Derived
+{
+public:
+
+    DerivedI() :
+        _last(-1)
+    {
+    }
+
+    int last() const
+    {
+        return _last;
+    }
+
+    virtual void derivedOp(const Ice::Current&)
+    {
+        _last = 60;
+    }
+
+    virtual void otherOp(const Ice::Current&)
+    {
+        _last = 61;
+    }
+
+    virtual void op00(const Ice::Current&)
+    {
+        _last = 0;
+    }
+
+    virtual void op01(const Ice::Current&)
+    {
+        _last = 1;
+    }
+
+    virtual void op02(const Ice::Current&)
+    {
+        _last = 2;
+    }
+
+    virtual void op03(const Ice::Current&)
+    {
+        _last = 3;
+    }
+
+    virtual void op04(const Ice::Current&)
+    {
+        _last = 4;
+    }
+
+    virtual void op05(const Ice::Current&)
+    {
+        _last = 5;
+    }
+
+    virtual void op06(const Ice::Current&)
+    {
+        _last = 6;
+    }
+
+    virtual void op07(const Ice::Current&)
+    {
+        _last = 7;
+    }
+
+    virtual void op08(const Ice::Current&)
+    {
+        _last = 8;
+    }
+
+    virtual void op09(const Ice::Current&)
+    {
+        _last = 9;
+    }
+
+    virtual void op10(const Ice::Current&)
+    {
+        _last = 10;
+    }
+
+    virtual void op11(const Ice::Current&)
+    {
+        _last = 11;
+    }
+
+    virtual void op12(const Ice::Current&)
+    {
+        _last = 12;
+    }
+
+    virtual void op13(const Ice::Current&)
+    {
+        _last = 13;
+    }
+
+    virtual void op14(const Ice::Current&)
+    {
+        _last = 14;
+    }
+
+    virtual void op15(const Ice::Current&)
+    {
+        _last = 15;
+    }
+
+    virtual void op16(const Ice::Current&)
+    {
+        _last = 16;
+    }
+
+    virtual void op17(const Ice::Current&)
+    {
+        _last = 17;
+    }
+
+    virtual void op18(const Ice::Current&)
+    {
+        _last = 18;
+    }
+
+    virtual void op19(const Ice::Current&)
+    {
+        _last = 19;
+    }
+
+    virtual void op20(const Ice::Current&)
+    {
+        _last = 20;
+    }
+
+    virtual void op21(const Ice::Current&)
+    {
+        _last = 21;
+    }
+
+    virtual void op22(const Ice::Current&)
+    {
+        _last = 22;
+    }
+
+    virtual void op23(const Ice::Current&)
+    {
+        _last = 23;
+    }
+
+    virtual void op24(const Ice::Current&)
+    {
+        _last = 24;
+    }
+
+    virtual void op25(const Ice::Current&)
+    {
+        _last = 25;
+    }
+
+    virtual void op26(const Ice::Current&)
+    {
+        _last = 26;
+    }
+
+    virtual void op27(const Ice::Current&)
+    {
+        _last = 27;
+    }
+
+    virtual void op28(const Ice::Current&)
+    {
+        _last = 28;
+    }
+
+    virtual void op29(const Ice::Current&)
+    {
+        _last = 29;
+    }
+
+    virtual void op30(const Ice::Current&)
+    {
+        _last = 30;
+    }
+
+    virtual void op31(const Ice::Current&)
+    {
+        _last = 31;
+    }
+
+    virtual void op32(const Ice::Current&)
+    {
+        _last = 32;
+    }
+
+    virtual void op33(const Ice::Current&)
+    {
+        _last = 33;
+    }
+
+    virtual void op34(const Ice::Current&)
+    {
+        _last = 34;
+    }
+
+    virtual void op35(const Ice::Current&)
+    {
+        _last = 35;
+    }
+
+    virtual void op36(const Ice::Current&)
+    {
+        _last = 36;
+    }
+
+    virtual void op37(const Ice::Current&)
+    {
+        _last = 37;
+    }
+
+    virtual void op38(const Ice::Current&)
+    {
+        _last = 38;
+    }
+
+    virtual void op39(const Ice::Current&)
+    {
+        _last = 39;
+    }
+
+    virtual void op40(const Ice::Current&)
+    {
+        _last = 40;
+    }
+
+    virtual void op41(const Ice::Current&)
+    {
+        _last = 41;
+    }
+
+    virtual void op42(const Ice::Current&)
+    {
+        _last = 42;
+    }
+
+    virtual void op43(const Ice::Current&)
+    {
+        _last = 43;
+    }
+
+    virtual void op44(const Ice::Current&)
+    {
+        _last = 44;
+    }
+
+    virtual void op45(const Ice::Current&)
+    {
+        _last = 45;
+    }
+
+    virtual void op46(const Ice::Current&)
+    {
+        _last = 46;
+    }
+
+    virtual void op47(const Ice::Current&)
+    {
+        _last = 47;
+    }
+
+    virtual void op48(const Ice::Current&)
+    {
+        _last = 48;
+    }
+
+    virtual void op49(const Ice::Current&)
+    {
+        _last = 49;
+    }
+
+    virtual void op50(const Ice::Current&)
+    {
+        _last = 50;
+    }
+
+    virtual void op51(const Ice::Current&)
+    {
+        _last = 51;
+    }
+
+    virtual void op52(const Ice::Current&)
+    {
+        _last = 52;
+    }
+
+    virtual void op53(const Ice::Current&)
+    {
+        _last = 53;
+    }
+
+    virtual void op54(const Ice::Current&)
+    {
+        _last = 54;
+    }
+
+    virtual void op55(const Ice::Current&)
+    {
+        _last = 55;
+    }
+
+    virtual void op56(const Ice::Current&)
+    {
+        _last = 56;
+    }
+
+    virtual void op57(const Ice::Current&)
+    {
+        _last = 57;
+    }
+
+    virtual void op58(const Ice::Current&)
+    {
+        _last = 58;
+    }
+
+    virtual void op59(const Ice::Current&)
+    {
+        _last = 59;
+    }
+
+private:
+
+    int _last;
+};
+ICE_DEFINE_PTR(DerivedIPtr, DerivedI);
+
+const string ids[] =
+{
+    "::Ice::Object",
+    "::Test::Bench",
+    "::Test::Derived",
+    "::Test::Other"
+};
+
+IceUtil::Time
+invokeBurst(const Test::DerivedPrxPtr& prx, int count)
+{
+    IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+    for(int i = 0; i < count; ++i)
+    {
+        prx->op30();
+    }
+    return IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+}
+
+}
+
+class Client : public Test::TestHelper
+{
+public:
+
+    void run(int, char**);
+};
+
+void
+Client::run(int argc, char** argv)
+{
+    Ice::PropertiesPtr properties = createTestProperties(argc, argv);
+    properties->setProperty("TestAdapter.Endpoints", getTestEndpoint(properties, 0));
+    Ice::CommunicatorHolder communicator = initialize(argc, argv, properties);
+
+    Ice::ObjectAdapterPtr adapter = communicator->createObjectAdapter("TestAdapter");
+    DerivedIPtr servant = ICE_MAKE_SHARED(DerivedI);
+    adapter->add(servant, Ice::stringToIdentity("test"));
+    adapter->activate();
+
+    Test::DerivedPrxPtr prx =
+        ICE_UNCHECKED_CAST(Test::DerivedPrx, adapter->createProxy(Ice::stringToIdentity("test")));
+
+    cout << "testing operation dispatch... " << flush;
+    {
+        vector<Ice::Byte> inEncaps;
+        vector<Ice::Byte> outEncaps;
+        for(int i = 0; i < 60; ++i)
+        {
+            ostringstream os;
+            os << "op" << (i < 10 ? "0" : "") << i;
+            test(prx->ice_invoke(os.str(), Ice::ICE_ENUM(OperationMode, Normal), inEncaps, outEncaps));
+            test(servant->last() == i);
+        }
+        prx->derivedOp();
+        test(servant->last() == 60);
+        prx->otherOp();
+        test(servant->last() == 61);
+        prx->ice_ping();
+        test(prx->ice_id() == "::Test::Derived");
+        test(prx->ice_ids().size() == 4);
+
+        const char* unknown[] =
+        {
+            "", "o", "op", "op6", "op60", "op0", "Op00", "op00 ", "ice_isa", "derivedOpx", "otherO"
+        };
+        for(size_t i = 0; i < sizeof(unknown) / sizeof(unknown[0]); ++i)
+        {
+            try
+            {
+                prx->ice_invoke(unknown[i], Ice::ICE_ENUM(OperationMode, Normal), inEncaps, outEncaps);
+                test(false);
+            }
+            catch(const Ice::OperationNotExistException&)
+            {
+            }
+        }
+    }
+    cout << "ok" << endl;
+
+    cout << "testing ice_isA... " << flush;
+    {
+        Ice::Current current;
+        for(size_t i = 0; i < sizeof(ids) / sizeof(ids[0]); ++i)
+        {
+            test(servant->ice_isA(ids[i], current));
+            test(prx->ice_isA(ids[i]));
+        }
+        test(!servant->ice_isA("", current));
+        test(!servant->ice_isA("::Test::Bencj", current));
+        test(!servant->ice_isA("::Test::Derive", current));
+        test(!servant->ice_isA("::Test::Derivedd", current));
+        test(!prx->ice_isA("::Test::Unknown"));
+    }
+    cout << "ok" << endl;
+
+    //
+    // The dispatch benchmark only runs with --Test.Benchmark=1.
+    //
+    if(properties->getPropertyAsInt("Test.Benchmark") > 0)
+    {
+        const int requests = properties->getPropertyAsIntWithDefault("Test.Requests", 100000);
+        invokeBurst(prx, requests / 10);
+        IceUtil::Time elapsed = invokeBurst(prx, requests);
+
+        Ice::Current current;
+        const string lookupIds[] = { "::Test::Derived", "::Test::Other", "::Test::Unknown" };
+        const int lookups = requests * 10;
+        int found = 0;
+        IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+        for(int i = 0; i < lookups; ++i)
+        {
+            found += servant->ice_isA(lookupIds[i % 3], current) ? 1 : 0;
+        }
+        IceUtil::Time isA = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+        test(found == lookups / 3 * 2 + (lookups % 3 > 0 ? 1 : 0) + (lookups % 3 > 1 ? 1 : 0));
+
+        cout << requests << " collocated requests in " << elapsed.toMilliSecondsDouble() << "ms ("
+             << static_cast<int>(requests / elapsed.toSecondsDouble()) << " requests/s)" << endl;
+        cout << lookups << " ice_isA lookups in " << isA.toMilliSecondsDouble() << "ms" << endl;
+    }
+
+    adapter->destroy();
+}
+
+DEFINE_TEST(Client)
@@ -1,7 +1,7 @@
 //
 // Copyright (c) ZeroC, Inc. All rights reserved.
 //
-// Generated by makeprops.py from file ./config/PropertyNames.xml, Thu Jul  2 14:55:02 2020
+// Generated by makeprops.py from file ./config/PropertyNames.xml, Mon Oct 19 05:31:33 2026
 
 // IMPORTANT: Do not edit this file -- any edits made here will be lost!
 
@@ -31,6 +31,8 @@ namespace IceInternal
              new Property(@"^Ice\.Admin\.ACM\.Close$", false, null),
              new Property(@"^Ice\.Admin\.ACM$", false, null),
              new Property(@"^Ice\.Admin\.AdapterId$", false, null),
+             new Property(@"^Ice\.Admin\.Coalesce\.Size$", false, null),
+             new Property(@"^Ice\.Admin\.Coalesce\.Window$", false, null),
              new Property(@"^Ice\.Admin\.Endpoints$", false, null),
              new Property(@"^Ice\.Admin\.Locator\.EndpointSelection$", false, null),
              new Property(@"^Ice\.Admin\.Locator\.ConnectionCached$", false, null),
@@ -115,6 +117,8 @@ namespace IceInternal
              new Property(@"^Ice\.Default\.Timeout$", false, null),
              new Property(@"^Ice\.EventLog\.Source$", false, null),
              new Property(@"^Ice\.FactoryAssemblies$", false, null),
+             new Property(@"^Ice\.FlowControl\.Policy$", false, null),
+             new Property(@"^Ice\.FlowControl\.Window$", false, null),
              new Property(@"^Ice\.HTTPProxyHost$", false, null),
              new Property(@"^Ice\.HTTPProxyPort$", false, null),
              new Property(@"^Ice\.ImplicitContext$", false, null),
@@ -133,6 +137,9 @@ namespace IceInternal
              new Property(@"^Ice\.Override\.Timeout$", false, null),
              new Property(@"^Ice\.Override\.Secure$", false, null),
              new Property(@"^Ice\.Package\.[^\s]+$", false, null),
+             new Property(@"^Ice\.ParallelConnect$", false, null),
+             new Property(@"^Ice\.ParallelConnect\.Stagger$", false, null),
+             new Property(@"^Ice\.PassThroughSlices$", false, null),
              new Property(@"^Ice\.Plugin\.[^\s]+$", false, null),
              new Property(@"^Ice\.PluginLoadOrder$", false, null),
              new Property(@"^Ice\.PreferIPv6Address$", false, null),
@@ -212,6 +219,8 @@ namespace IceInternal
              new Property(@"^IceDiscovery\.Multicast\.ACM\.Close$", false, null),
              new Property(@"^IceDiscovery\.Multicast\.ACM$", false, null),
              new Property(@"^IceDiscovery\.Multicast\.AdapterId$", false, null),
+             new Property(@"^IceDiscovery\.Multicast\.Coalesce\.Size$", false, null),
+             new Property(@"^IceDiscovery\.Multicast\.Coalesce\.Window$", false, null),
              new Property(@"^IceDiscovery\.Multicast\.Endpoints$", false, null),
              new Property(@"^IceDiscovery\.Multicast\.Locator\.EndpointSelection$", false, null),
              new Property(@"^IceDiscovery\.Multicast\.Locator\.ConnectionCached$", false, null),
@@ -249,6 +258,8 @@ namespace IceInternal
              new Property(@"^IceDiscovery\.Reply\.ACM\.Close$", false, null),
              new Property(@"^IceDiscovery\.Reply\.ACM$", false, null),
              new Property(@"^IceDiscovery\.Reply\.AdapterId$", false, null),
+             new Property(@"^IceDiscovery\.Reply\.Coalesce\.Size$", false, null),
+             new Property(@"^IceDiscovery\.Reply\.Coalesce\.Window$", false, null),
              new Property(@"^IceDiscovery\.Reply\.Endpoints$", false, null),
              new Property(@"^IceDiscovery\.Reply\.Locator\.EndpointSelection$", false, null),
              new Property(@"^IceDiscovery\.Reply\.Locator\.ConnectionCached$", false, null),
@@ -286,6 +297,8 @@ namespace IceInternal
              new Property(@"^IceDiscovery\.Locator\.ACM\.Close$", false, null),
              new Property(@"^IceDiscovery\.Locator\.ACM$", false, null),
              new Property(@"^IceDiscovery\.Locator\.AdapterId$", false, null),
+             new Property(@"^IceDiscovery\.Locator\.Coalesce\.Size$", false, null),
+             new Property(@"^IceDiscovery\.Locator\.Coalesce\.Window$", false, null),
              new Property(@"^IceDiscovery\.Locator\.Endpoints$", false, null),
              new Property(@"^IceDiscovery\.Locator\.Locator\.EndpointSelection$", false, null),
              new Property(@"^IceDiscovery\.Locator\.Locator\.ConnectionCached$", false, null),
@@ -336,6 +349,8 @@ namespace IceInternal
              new Property(@"^IceLocatorDiscovery\.Reply\.ACM\.Close$", false, null),
              new Property(@"^IceLocatorDiscovery\.Reply\.ACM$", false, null),
              new Property(@"^IceLocatorDiscovery\.Reply\.AdapterId$", false, null),
+             new Property(@"^IceLocatorDiscovery\.Reply\.Coalesce\.Size$", false, null),
+             new Property(@"^IceLocatorDiscovery\.Reply\.Coalesce\.Window$", false, null),
              new Property(@"^IceLocatorDiscovery\.Reply\.Endpoints$", false, null),
              new Property(@"^IceLocatorDiscovery\.Reply\.Locator\.EndpointSelection$", false, null),
              new Property(@"^IceLocatorDiscovery\.Reply\.Locator\.ConnectionCached$", false, null),
@@ -373,6 +388,8 @@ namespace IceInternal
              new Property(@"^IceLocatorDiscovery\.Locator\.ACM\.Close$", false, null),
              new Property(@"^IceLocatorDiscovery\.Locator\.ACM$", false, null),
              new Property(@"^IceLocatorDiscovery\.Locator\.AdapterId$", false, null),
+             new Property(@"^IceLocatorDiscovery\.Locator\.Coalesce\.Size$", false, null),
+             new Property(@"^IceLocatorDiscovery\.Locator\.Coalesce\.Window$", false, null),
              new Property(@"^IceLocatorDiscovery\.Locator\.Endpoints$", false, null),
              new Property(@"^IceLocatorDiscovery\.Locator\.Locator\.EndpointSelection$", false, null),
              new Property(@"^IceLocatorDiscovery\.Locator\.Locator\.ConnectionCached$", false, null),
@@ -461,6 +478,8 @@ namespace IceInternal
              new Property(@"^IceBridge\.Source\.ACM\.Close$", false, null),
              new Property(@"^IceBridge\.Source\.ACM$", false, null),
              new Property(@"^IceBridge\.Source\.AdapterId$", false, null),
+             new Property(@"^IceBridge\.Source\.Coalesce\.Size$", false, null),
+             new Property(@"^IceBridge\.Source\.Coalesce\.Window$", false, null),
              new Property(@"^IceBridge\.Source\.Endpoints$", false, null),
              new Property(@"^IceBridge\.Source\.Locator\.EndpointSelection$", false, null),
              new Property(@"^IceBridge\.Source\.Locator\.ConnectionCached$", false, null),
@@ -513,6 +532,8 @@ namespace IceInternal
              new Property(@"^IceGridAdmin\.Server\.ACM\.Close$", false, null),
              new Property(@"^IceGridAdmin\.Server\.ACM$", false, null),
              new Property(@"^IceGridAdmin\.Server\.AdapterId$", false, null),
+             new Property(@"^IceGridAdmin\.Server\.Coalesce\.Size$", false, null),
+             new Property(@"^IceGridAdmin\.Server\.Coalesce\.Window$", false, null),
              new Property(@"^IceGridAdmin\.Server\.Endpoints$", false, null),
              new Property(@"^IceGridAdmin\.Server\.Locator\.EndpointSelection$", false, null),
              new Property(@"^IceGridAdmin\.Server\.Locator\.ConnectionCached$", false, null),
@@ -553,6 +574,8 @@ namespace IceInternal
              new Property(@"^IceGridAdmin\.Discovery\.Reply\.ACM\.Close$", false, null),
              new Property(@"^IceGridAdmin\.Discovery\.Reply\.ACM$", false, null),
              new Property(@"^IceGridAdmin\.Discovery\.Reply\.AdapterId$", false, null),
+             new Property(@"^IceGridAdmin\.Discovery\.Reply\.Coalesce\.Size$", false, null),
+             new Property(@"^IceGridAdmin\.Discovery\.Reply\.Coalesce\.Window$", false, null),
              new Property(@"^IceGridAdmin\.Discovery\.Reply\.Endpoints$", false, null),
              new Property(@"^IceGridAdmin\.Discovery\.Reply\.Locator\.EndpointSelection$", false, null),
              new Property(@"^IceGridAdmin\.Discovery\.Reply\.Locator\.ConnectionCached$", false, null),
@@ -590,6 +613,8 @@ namespace IceInternal
              new Property(@"^IceGridAdmin\.Discovery\.Locator\.ACM\.Close$", false, null),
              new Property(@"^IceGridAdmin\.Discovery\.Locator\.ACM$", false, null),
              new Property(@"^IceGridAdmin\.Discovery\.Locator\.AdapterId$", false, null),
+             new Property(@"^IceGridAdmin\.Discovery\.Locator\.Coalesce\.Size$", false, null),
+             new Property(@"^IceGridAdmin\.Discovery\.Locator\.Coalesce\.Window$", false, null),
              new Property(@"^IceGridAdmin\.Discovery\.Locator\.Endpoints$", false, null),
              new Property(@"^IceGridAdmin\.Discovery\.Locator\.Locator\.EndpointSelection$", false, null),
              new Property(@"^IceGridAdmin\.Discovery\.Locator\.Locator\.ConnectionCached$", false, null),
@@ -634,6 +659,8 @@ namespace IceInternal
              new Property(@"^IceGrid\.AdminRouter\.ACM\.Close$", false, null),
              new Property(@"^IceGrid\.AdminRouter\.ACM$", false, null),
              new Property(@"^IceGrid\.AdminRouter\.AdapterId$", false, null),
+             new Property(@"^IceGrid\.AdminRouter\.Coalesce\.Size$", false, null),
+             new Property(@"^IceGrid\.AdminRouter\.Coalesce\.Window$", false, null),
              new Property(@"^IceGrid\.AdminRouter\.Endpoints$", false, null),
              new Property(@"^IceGrid\.AdminRouter\.Locator\.EndpointSelection$", false, null),
              new Property(@"^IceGrid\.AdminRouter\.Locator\.ConnectionCached$", false, null),
@@ -672,6 +699,8 @@ namespace IceInternal
              new Property(@"^IceGrid\.Node\.ACM\.Close$", false, null),
              new Property(@"^IceGrid\.Node\.ACM$", false, null),
              new Property(@"^IceGrid\.Node\.AdapterId$", false, null),
+             new Property(@"^IceGrid\.Node\.Coalesce\.Size$", false, null),
+             new Property(@"^IceGrid\.Node\.Coalesce\.Window$", false, null),
              new Property(@"^IceGrid\.Node\.Endpoints$", false, null),
              new Property(@"^IceGrid\.Node\.Locator\.EndpointSelection$", false, null),
              new Property(@"^IceGrid\.Node\.Locator\.ConnectionCached$", false, null),
@@ -750,6 +779,8 @@ namespace IceInternal
              new Property(@"^IceGrid\.Registry\.AdminSessionManager\.ACM\.Close$", false, null),
              new Property(@"^IceGrid\.Registry\.AdminSessionManager\.ACM$", false, null),
              new Property(@"^IceGrid\.Registry\.AdminSessionManager\.AdapterId$", false, null),
+             new Property(@"^IceGrid\.Registry\.AdminSessionManager\.Coalesce\.Size$", false, null),
+             new Property(@"^IceGrid\.Registry\.AdminSessionManager\.Coalesce\.Window$", false, null),
              new Property(@"^IceGrid\.Registry\.AdminSessionManager\.Endpoints$", false, null),
              new Property(@"^IceGrid\.Registry\.AdminSessionManager\.Locator\.EndpointSelection$", false, null),
              new Property(@"^IceGrid\.Registry\.AdminSessionManager\.Locator\.ConnectionCached$", false, null),
@@ -797,6 +828,8 @@ namespace IceInternal
              new Property(@"^IceGrid\.Registry\.Client\.ACM\.Close$", false, null),
              new Property(@"^IceGrid\.Registry\.Client\.ACM$", false, null),
              new Property(@"^IceGrid\.Registry\.Client\.AdapterId$", false, null),
+             new Property(@"^IceGrid\.Registry\.Client\.Coalesce\.Size$", false, null),
+             new Property(@"^IceGrid\.Registry\.Client\.Coalesce\.Window$", false, null),
              new Property(@"^IceGrid\.Registry\.Client\.Endpoints$", false, null),
              new Property(@"^IceGrid\.Registry\.Client\.Locator\.EndpointSelection$", false, null),
              new Property(@"^IceGrid\.Registry\.Client\.Locator\.ConnectionCached$", false, null),
@@ -836,6 +869,8 @@ namespace IceInternal
              new Property(@"^IceGrid\.Registry\.Discovery\.ACM\.Close$", false, null),
              new Property(@"^IceGrid\.Registry\.Discovery\.ACM$", false, null),
              new Property(@"^IceGrid\.Registry\.Discovery\.AdapterId$", false, null),
+             new Property(@"^IceGrid\.Registry\.Discovery\.Coalesce\.Size$", false, null),
+             new Property(@"^IceGrid\.Registry\.Discovery\.Coalesce\.Window$", false, null),
              new Property(@"^IceGrid\.Registry\.Discovery\.Endpoints$", false, null),
              new Property(@"^IceGrid\.Registry\.Discovery\.Locator\.EndpointSelection$", false, null),
              new Property(@"^IceGrid\.Registry\.Discovery\.Locator\.ConnectionCached$", false, null),
@@ -878,6 +913,8 @@ namespace IceInternal
              new Property(@"^IceGrid\.Registry\.Internal\.ACM\.Close$", false, null),
              new Property(@"^IceGrid\.Registry\.Internal\.ACM$", false, null),
              new Property(@"^IceGrid\.Registry\.Internal\.AdapterId$", false, null),
+             new Property(@"^IceGrid\.Registry\.Internal\.Coalesce\.Size$", false, null),
+             new Property(@"^IceGrid\.Registry\.Internal\.Coalesce\.Window$", false, null),
              new Property(@"^IceGrid\.Registry\.Internal\.Endpoints$", false, null),
              new Property(@"^IceGrid\.Registry\.Internal\.Locator\.EndpointSelection$", false, null),
              new Property(@"^IceGrid\.Registry\.Internal\.Locator\.ConnectionCached$", false, null),
@@ -932,6 +969,8 @@ namespace IceInternal
              new Property(@"^IceGrid\.Registry\.Server\.ACM\.Close$", false, null),
              new Property(@"^IceGrid\.Registry\.Server\.ACM$", false, null),
              new Property(@"^IceGrid\.Registry\.Server\.AdapterId$", false, null),
+             new Property(@"^IceGrid\.Registry\.Server\.Coalesce\.Size$", false, null),
+             new Property(@"^IceGrid\.Registry\.Server\.Coalesce\.Window$", false, null),
              new Property(@"^IceGrid\.Registry\.Server\.Endpoints$", false, null),
              new Property(@"^IceGrid\.Registry\.Server\.Locator\.EndpointSelection$", false, null),
              new Property(@"^IceGrid\.Registry\.Server\.Locator\.ConnectionCached$", false, null),
@@ -970,6 +1009,8 @@ namespace IceInternal
              new Property(@"^IceGrid\.Registry\.SessionManager\.ACM\.Close$", false, null),
              new Property(@"^IceGrid\.Registry\.SessionManager\.ACM$", false, null),
              new Property(@"^IceGrid\.Registry\.SessionManager\.AdapterId$", false, null),
+             new Property(@"^IceGrid\.Registry\.SessionManager\.Coalesce\.Size$", false, null),
+             new Property(@"^IceGrid\.Registry\.SessionManager\.Coalesce\.Window$", false, null),
              new Property(@"^IceGrid\.Registry\.SessionManager\.Endpoints$", false, null),
              new Property(@"^IceGrid\.Registry\.SessionManager\.Locator\.EndpointSelection$", false, null),
              new Property(@"^IceGrid\.Registry\.SessionManager\.Locator\.ConnectionCached$", false, null),
@@ -1038,6 +1079,8 @@ namespace IceInternal
              new Property(@"^IcePatch2\.ACM\.Close$", false, null),
              new Property(@"^IcePatch2\.ACM$", false, null),
              new Property(@"^IcePatch2\.AdapterId$", false, null),
+             new Property(@"^IcePatch2\.Coalesce\.Size$", false, null),
+             new Property(@"^IcePatch2\.Coalesce\.Window$", false, null),
              new Property(@"^IcePatch2\.Endpoints$", false, null),
              new Property(@"^IcePatch2\.Locator\.EndpointSelection$", false, null),
              new Property(@"^IcePatch2\.Locator\.ConnectionCached$", false, null),
@@ -1156,6 +1199,8 @@ namespace IceInternal
              new Property(@"^Glacier2\.Client\.ACM\.Close$", false, null),
              new Property(@"^Glacier2\.Client\.ACM$", false, null),
              new Property(@"^Glacier2\.Client\.AdapterId$", false, null),
+             new Property(@"^Glacier2\.Client\.Coalesce\.Size$", false, null),
+             new Property(@"^Glacier2\.Client\.Coalesce\.Window$", false, null),
              new Property(@"^Glacier2\.Client\.Endpoints$", false, null),
              new Property(@"^Glacier2\.Client\.Locator\.EndpointSelection$", false, null),
              new Property(@"^Glacier2\.Client\.Locator\.ConnectionCached$", false, null),
@@ -1231,6 +1276,8 @@ namespace IceInternal
              new Property(@"^Glacier2\.Server\.ACM\.Close$", false, null),
              new Property(@"^Glacier2\.Server\.ACM$", false, null),
              new Property(@"^Glacier2\.Server\.AdapterId$", false, null),
+             new Property(@"^Glacier2\.Server\.Coalesce\.Size$", false, null),
+             new Property(@"^Glacier2\.Server\.Coalesce\.Window$", false, null),
              new Property(@"^Glacier2\.Server\.Endpoints$", false, null),
              new Property(@"^Glacier2\.Server\.Locator\.EndpointSelection$", false, null),
              new Property(@"^Glacier2\.Server\.Locator\.ConnectionCached$", false, null),
@@ -1,7 +1,7 @@
 //
 // Copyright (c) ZeroC, Inc. All rights reserved.
 //
-// Generated by makeprops.py from file ./config/PropertyNames.xml, Thu Jul  2 14:55:02 2020
+// Generated by makeprops.py from file ./config/PropertyNames.xml, Mon Oct 19 05:31:33 2026
 
 // IMPORTANT: Do not edit this file -- any edits made here will be lost!
 
@@ -34,6 +34,8 @@ PropertyNames.IceProps =
     new Property("/^Ice\.Admin\.ACM\.Close/", false, null),
     new Property("/^Ice\.Admin\.ACM/", false, null),
     new Property("/^Ice\.Admin\.AdapterId/", false, null),
+    new Property("/^Ice\.Admin\.Coalesce\.Size/", false, null),
+    new Property("/^Ice\.Admin\.Coalesce\.Window/", false, null),
     new Property("/^Ice\.Admin\.Endpoints/", false, null),
     new Property("/^Ice\.Admin\.Locator\.EndpointSelection/", false, null),
     new Property("/^Ice\.Admin\.Locator\.ConnectionCached/", false, null),
@@ -118,6 +120,8 @@ PropertyNames.IceProps =
     new Property("/^Ice\.Default\.Timeout/", false, null),
     new Property("/^Ice\.EventLog\.Source/", false, null),
     new Property("/^Ice\.FactoryAssemblies/", false, null),
+    new Property("/^Ice\.FlowControl\.Policy/", false, null),
+    new Property("/^Ice\.FlowControl\.Window/", false, null),
     new Property("/^Ice\.HTTPProxyHost/", false, null),
     new Property("/^Ice\.HTTPProxyPort/", false, null),
     new Property("/^Ice\.ImplicitContext/", false, null),
@@ -136,6 +140,9 @@ PropertyNames.IceProps =
     new Property("/^Ice\.Override\.Timeout/", false, null),
     new Property("/^Ice\.Override\.Secure/", false, null),
     new Property("/^Ice\.Package\../", false, null),
+    new Property("/^Ice\.ParallelConnect/", false, null),
+    new Property("/^Ice\.ParallelConnect\.Stagger/", false, null),
+    new Property("/^Ice\.PassThroughSlices/", false, null),
     new Property("/^Ice\.Plugin\../", false, null),
     new Property("/^Ice\.PluginLoadOrder/", false, null),
     new Property("/^Ice\.PreferIPv6Address/", false, null),